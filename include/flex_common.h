@@ -13,6 +13,8 @@
 #include <cstdlib>
 #include <stdexcept>
 #include <algorithm>
+#include <cstdio>
+#include <cstdint>
 
 // FlexTools 命名空间
 namespace FlexTools {
@@ -57,6 +59,66 @@ enum class FlexLogLevel {
     CRITICAL
 };
 
+// JSON 字符串转义 (引号、反斜杠与控制字符)
+inline std::string flexEscapeJSON(const std::string& value) {
+    std::string escaped;
+    escaped.reserve(value.size());
+    for (char c : value) {
+        switch (c) {
+            case '"':  escaped += "\\\""; break;
+            case '\\': escaped += "\\\\"; break;
+            case '\n': escaped += "\\n"; break;
+            case '\r': escaped += "\\r"; break;
+            case '\t': escaped += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buffer[8];
+                    std::snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned char>(c));
+                    escaped += buffer;
+                } else {
+                    escaped.push_back(c);
+                }
+                break;
+        }
+    }
+    return escaped;
+}
+
+// CSV 字段: 含逗号、引号或换行时加引号, 内部引号双写
+inline std::string flexEscapeCSV(const std::string& value) {
+    if (value.find_first_of(",\"\r\n") == std::string::npos) {
+        return value;
+    }
+    std::string escaped = "\"";
+    for (char c : value) {
+        if (c == '"') escaped.push_back('"');
+        escaped.push_back(c);
+    }
+    escaped.push_back('"');
+    return escaped;
+}
+
+// 本地时间 "YYYY-MM-DD HH:MM:SS", 0 表示未知, 返回空串
+inline std::string flexFormatTime(int64_t when) {
+    if (when == 0) {
+        return "";
+    }
+    time_t value = static_cast<time_t>(when);
+    char buffer[32];
+    struct tm local;
+    localtime_r(&value, &local);
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &local);
+    return buffer;
+}
+
+// 写入同目录的临时文件后 rename 替换 path, 必要时先创建上级目录; 新文件权限为 0644
+bool flexAtomicWriteFile(const std::string& path, const std::string& data);
+
+// 日志切词用的空白 (空格与制表符)
+inline bool flexIsSpace(char c) {
+    return c == ' ' || c == '\t';
+}
+
 } // namespace FlexTools
 
 #endif // FLEX_COMMON_H
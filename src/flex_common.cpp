@@ -0,0 +1,48 @@
+#include "flex_common.h"
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+
+namespace FlexTools {
+
+bool flexAtomicWriteFile(const std::string& path, const std::string& data) {
+    size_t slash = path.rfind('/');
+    if (path.empty() || slash == std::string::npos) {
+        return false;
+    }
+    std::string dir = path.substr(0, slash);
+    for (size_t pos = 1; pos <= dir.size(); ++pos) {
+        if (pos == dir.size() || dir[pos] == '/') {
+            if (mkdir(dir.substr(0, pos).c_str(), 0755) != 0 && errno != EEXIST) {
+                return false;
+            }
+        }
+    }
+    
+    // 同目录下的唯一临时文件写完后 rename, 并发的读者与写者不会看到写了一半的文件
+    std::string tempPath = path + ".XXXXXX";
+    int fd = mkstemp(&tempPath[0]);
+    if (fd < 0) {
+        return false;
+    }
+    size_t written = 0;
+    while (written < data.size()) {
+        ssize_t n = ::write(fd, data.data() + written, data.size() - written);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        written += static_cast<size_t>(n);
+    }
+    // mkstemp 创建的文件为 0600, 缓存应与其他用户共享
+    bool ok = written == data.size() && fchmod(fd, 0644) == 0;
+    ok = (close(fd) == 0) && ok;
+    if (!ok || rename(tempPath.c_str(), path.c_str()) != 0) {
+        unlink(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+} // namespace FlexTools
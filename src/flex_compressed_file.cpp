@@ -0,0 +1,114 @@
+#include "flex_compressed_file.h"
+#include "flex_proc_file.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#ifdef FLEX_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace FlexTools {
+
+bool flexIsGzipPath(const std::string& path) {
+    return path.size() > 3 && path.compare(path.size() - 3, 3, ".gz") == 0;
+}
+
+bool flexReadMaybeCompressed(const std::string& path, std::string& out) {
+    out.clear();
+    if (!flexIsGzipPath(path)) {
+        return flexReadWholeFile(path, out);
+    }
+    
+    FlexCompressedStream stream(path);
+    if (!stream.isOpen()) {
+        return false;
+    }
+    std::array<char, 64 * 1024> buffer;
+    ssize_t n;
+    while ((n = stream.read(buffer.data(), buffer.size())) > 0) {
+        out.append(buffer.data(), static_cast<size_t>(n));
+    }
+    return n == 0;
+}
+
+FlexCompressedStream::FlexCompressedStream(const std::string& path) {
+    if (!flexIsGzipPath(path)) {
+        flexFd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        return;
+    }
+    
+#ifdef FLEX_HAVE_ZLIB
+    gzFile file = gzopen(path.c_str(), "rb");
+    if (file != nullptr) {
+        gzbuffer(file, 128 * 1024);
+        flexGzip = file;
+    }
+#else
+    // 路径来自日志目录枚举, 仍按单引号转义以防特殊字符
+    std::string quoted = "'";
+    for (char c : path) {
+        if (c == '\'') quoted += "'\\''";
+        else quoted += c;
+    }
+    quoted += "'";
+    flexPipe = popen(("gzip -dc " + quoted + " 2>/dev/null").c_str(), "r");
+#endif
+}
+
+FlexCompressedStream::~FlexCompressedStream() {
+#ifdef FLEX_HAVE_ZLIB
+    if (flexGzip != nullptr) {
+        gzclose(static_cast<gzFile>(flexGzip));
+    }
+#endif
+    if (flexPipe != nullptr) {
+        pclose(flexPipe);
+    }
+    if (flexFd >= 0) {
+        close(flexFd);
+    }
+}
+
+ssize_t FlexCompressedStream::read(char* buffer, size_t size) {
+#ifdef FLEX_HAVE_ZLIB
+    if (flexGzip != nullptr) {
+        int n = gzread(static_cast<gzFile>(flexGzip), buffer, static_cast<unsigned>(std::min<size_t>(size, 1u << 30)));
+        if (n == 0) {
+            // 截断的文件: gzread 只返回 0, 错误码为 Z_BUF_ERROR
+            int error = Z_OK;
+            gzerror(static_cast<gzFile>(flexGzip), &error);
+            return error == Z_OK ? 0 : -1;
+        }
+        return n < 0 ? -1 : n;
+    }
+#endif
+    if (flexPipe != nullptr) {
+        size_t n = fread(buffer, 1, size, flexPipe);
+        if (n > 0) {
+            return static_cast<ssize_t>(n);
+        }
+        if (ferror(flexPipe)) {
+            return -1;
+        }
+        // 读到结尾后回收子进程; gzip 对损坏或截断的输入以非零状态退出
+        int status = pclose(flexPipe);
+        flexPipe = nullptr;
+        flexEnded = true;
+        return status == 0 ? 0 : -1;
+    }
+    if (flexEnded) {
+        return 0;
+    }
+    if (flexFd >= 0) {
+        ssize_t n;
+        do {
+            n = ::read(flexFd, buffer, size);
+        } while (n < 0 && errno == EINTR);
+        return n;
+    }
+    return -1;
+}
+
+} // namespace FlexTools
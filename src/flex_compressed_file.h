@@ -0,0 +1,39 @@
+#ifndef FLEX_COMPRESSED_FILE_H
+#define FLEX_COMPRESSED_FILE_H
+
+#include "flex_common.h"
+#include <sys/types.h>
+
+namespace FlexTools {
+
+// 根据扩展名判断是否为 gzip 压缩 (logrotate 生成的 .gz 代次)
+bool flexIsGzipPath(const std::string& path);
+
+// 读取普通或 .gz 文件的完整内容. 编译时启用 zlib (FLEX_HAVE_ZLIB) 则进程内解压,
+// 否则退回 gzip -dc 子进程
+bool flexReadMaybeCompressed(const std::string& path, std::string& out);
+
+// 顺序读取普通或 .gz 文件, 不整体载入内存; 解压方式同上
+class FlexCompressedStream {
+public:
+    explicit FlexCompressedStream(const std::string& path);
+    ~FlexCompressedStream();
+    
+    FlexCompressedStream(const FlexCompressedStream&) = delete;
+    FlexCompressedStream& operator=(const FlexCompressedStream&) = delete;
+    
+    bool isOpen() const { return flexGzip != nullptr || flexPipe != nullptr || flexFd >= 0 || flexEnded; }
+    
+    // 读取至多 size 字节; 返回 0 表示结束, -1 表示出错 (包括截断的 .gz 与 gzip 子进程非零退出)
+    ssize_t read(char* buffer, size_t size);
+
+private:
+    void* flexGzip = nullptr; // gzFile
+    FILE* flexPipe = nullptr; // gzip -dc 子进程
+    int flexFd = -1;          // 未压缩文件
+    bool flexEnded = false;   // 子进程已回收
+};
+
+} // namespace FlexTools
+
+#endif // FLEX_COMPRESSED_FILE_H
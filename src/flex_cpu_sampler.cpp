@@ -0,0 +1,206 @@
+#include "flex_cpu_sampler.h"
+#include <unistd.h>
+#include <utility>
+
+namespace FlexTools {
+
+namespace {
+
+// /proc/stat 中单行 cpuN 的最大长度估计
+constexpr size_t FLEX_STAT_BYTES_PER_CPU = 160;
+
+// 解析 "cpuN" 行前缀, 返回 CPU 编号; 汇总行 "cpu " 与其它行返回 -1
+int flexParseCPULineId(std::string_view& line) {
+    if (line.size() < 4 || line.compare(0, 3, "cpu") != 0 || line[3] < '0' || line[3] > '9') {
+        return -1;
+    }
+    line.remove_prefix(3);
+    uint64_t id = 0;
+    flexParseUnsigned(line, id);
+    return static_cast<int>(id);
+}
+
+std::string_view flexNextLine(std::string_view& content) {
+    size_t eol = content.find('\n');
+    std::string_view line = content.substr(0, eol);
+    content.remove_prefix(eol == std::string_view::npos ? content.size() : eol + 1);
+    return line;
+}
+
+} // namespace
+
+void FlexCPUJiffies::resize(size_t count) {
+    user.assign(count, 0);
+    system.assign(count, 0);
+    idle.assign(count, 0);
+    iowait.assign(count, 0);
+    steal.assign(count, 0);
+}
+
+void FlexCPUUsage::resize(size_t count) {
+    user.assign(count, 0.0f);
+    system.assign(count, 0.0f);
+    iowait.assign(count, 0.0f);
+    steal.assign(count, 0.0f);
+    busy.assign(count, 0.0f);
+    totalBusy = 0.0f;
+}
+
+FlexCPUSampler::FlexCPUSampler() : flexStatFile("/proc/stat") {
+    long configured = sysconf(_SC_NPROCESSORS_CONF);
+    size_t cpus = configured > 0 ? static_cast<size_t>(configured) : 1;
+    flexStatBuffer.resize((cpus + 1) * FLEX_STAT_BYTES_PER_CPU + 4096);
+}
+
+void FlexCPUSampler::flexRebuildLayout(std::string_view content) {
+    flexCPUIds.clear();
+    flexFreqFiles.clear();
+    flexNextLine(content); // 汇总行
+    while (!content.empty()) {
+        std::string_view line = flexNextLine(content);
+        int id = flexParseCPULineId(line);
+        if (id < 0) break;
+        flexCPUIds.push_back(id);
+        flexFreqFiles.emplace_back("/sys/devices/system/cpu/cpu" + std::to_string(id) +
+                                   "/cpufreq/scaling_cur_freq");
+    }
+    
+    size_t count = flexCPUIds.size();
+    flexPrevious.resize(count);
+    flexCurrent.resize(count);
+    flexUsage.resize(count);
+    flexFrequencies.assign(count, 0.0);
+    flexHasPrevious = false;
+    flexHasUsage = false;
+}
+
+bool FlexCPUSampler::flexParseStat(std::string_view content, bool& layoutChanged) {
+    layoutChanged = false;
+    flexNextLine(content); // 汇总行
+    
+    uint64_t* user = flexCurrent.user.data();
+    uint64_t* system = flexCurrent.system.data();
+    uint64_t* idle = flexCurrent.idle.data();
+    uint64_t* iowait = flexCurrent.iowait.data();
+    uint64_t* steal = flexCurrent.steal.data();
+    size_t count = flexCPUIds.size();
+    size_t slot = 0;
+    
+    while (!content.empty()) {
+        std::string_view line = flexNextLine(content);
+        int id = flexParseCPULineId(line);
+        if (id < 0) break;
+        if (slot >= count || flexCPUIds[slot] != id) {
+            // CPU 热插拔导致布局变化
+            layoutChanged = true;
+            return false;
+        }
+        
+        // user nice system idle iowait irq softirq steal
+        uint64_t fields[8] = {0};
+        for (int i = 0; i < 8; ++i) {
+            flexSkipSpaces(line);
+            if (!flexParseUnsigned(line, fields[i])) break;
+        }
+        user[slot] = fields[0] + fields[1];
+        system[slot] = fields[2] + fields[5] + fields[6];
+        idle[slot] = fields[3];
+        iowait[slot] = fields[4];
+        steal[slot] = fields[7];
+        ++slot;
+    }
+    
+    if (slot != count) {
+        layoutChanged = true;
+        return false;
+    }
+    return true;
+}
+
+void FlexCPUSampler::flexComputeUsage() {
+    size_t count = flexCPUIds.size();
+    const uint64_t* __restrict curUser = flexCurrent.user.data();
+    const uint64_t* __restrict curSystem = flexCurrent.system.data();
+    const uint64_t* __restrict curIdle = flexCurrent.idle.data();
+    const uint64_t* __restrict curIowait = flexCurrent.iowait.data();
+    const uint64_t* __restrict curSteal = flexCurrent.steal.data();
+    const uint64_t* __restrict prevUser = flexPrevious.user.data();
+    const uint64_t* __restrict prevSystem = flexPrevious.system.data();
+    const uint64_t* __restrict prevIdle = flexPrevious.idle.data();
+    const uint64_t* __restrict prevIowait = flexPrevious.iowait.data();
+    const uint64_t* __restrict prevSteal = flexPrevious.steal.data();
+    float* __restrict outUser = flexUsage.user.data();
+    float* __restrict outSystem = flexUsage.system.data();
+    float* __restrict outIowait = flexUsage.iowait.data();
+    float* __restrict outSteal = flexUsage.steal.data();
+    float* __restrict outBusy = flexUsage.busy.data();
+    
+    // 各循环均为无分支的逐元素运算, 便于自动向量化.
+    // CPU 热插拔或部分虚拟机上计数器会回退, 差值钳到 0 (比较后选择, 不引入分支)
+    auto delta = [](uint64_t cur, uint64_t prev) { return static_cast<float>(cur > prev ? cur - prev : 0); };
+    for (size_t i = 0; i < count; ++i) {
+        outUser[i] = delta(curUser[i], prevUser[i]);
+        outSystem[i] = delta(curSystem[i], prevSystem[i]);
+        outIowait[i] = delta(curIowait[i], prevIowait[i]);
+        outSteal[i] = delta(curSteal[i], prevSteal[i]);
+        outBusy[i] = delta(curIdle[i], prevIdle[i]);
+    }
+    
+    float totalBusy = 0.0f;
+    float totalAll = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        float busy = outUser[i] + outSystem[i] + outSteal[i];
+        float all = busy + outIowait[i] + outBusy[i];
+        float scale = all > 0.0f ? 100.0f / all : 0.0f;
+        totalBusy += busy;
+        totalAll += all;
+        outUser[i] *= scale;
+        outSystem[i] *= scale;
+        outIowait[i] *= scale;
+        outSteal[i] *= scale;
+        outBusy[i] = busy * scale;
+    }
+    flexUsage.totalBusy = totalAll > 0.0f ? 100.0f * totalBusy / totalAll : 0.0f;
+}
+
+void FlexCPUSampler::flexSampleFrequencies() {
+    for (size_t i = 0; i < flexFreqFiles.size(); ++i) {
+        uint64_t khz = 0;
+        flexFrequencies[i] = flexFreqFiles[i].flexReadUnsigned(khz) ? static_cast<double>(khz) / 1000.0 : 0.0;
+    }
+}
+
+bool FlexCPUSampler::sample() {
+    std::string_view content = flexStatFile.flexRead(flexStatBuffer.data(), flexStatBuffer.size());
+    while (content.size() == flexStatBuffer.size() && content.find("\nintr ") == std::string_view::npos) {
+        // 缓冲区不足以容纳所有 cpuN 行时扩容 (只在首次或热插拔后发生)
+        flexStatBuffer.resize(flexStatBuffer.size() * 2);
+        content = flexStatFile.flexRead(flexStatBuffer.data(), flexStatBuffer.size());
+    }
+    if (content.empty()) {
+        return false;
+    }
+    
+    bool layoutChanged = flexCPUIds.empty();
+    if (layoutChanged || !flexParseStat(content, layoutChanged)) {
+        if (!layoutChanged) {
+            return false;
+        }
+        flexRebuildLayout(content);
+        if (!flexParseStat(content, layoutChanged)) {
+            return false;
+        }
+    }
+    
+    if (flexHasPrevious) {
+        flexComputeUsage();
+        flexHasUsage = true;
+    }
+    std::swap(flexPrevious, flexCurrent);
+    flexHasPrevious = true;
+    
+    flexSampleFrequencies();
+    return true;
+}
+
+} // namespace FlexTools
@@ -0,0 +1,70 @@
+#ifndef FLEX_CPU_SAMPLER_H
+#define FLEX_CPU_SAMPLER_H
+
+#include "flex_common.h"
+#include "flex_proc_file.h"
+#include <cstdint>
+
+namespace FlexTools {
+
+// 每核 jiffies, 按字段分列存放 (struct-of-arrays), 增量计算可被编译器向量化
+struct FlexCPUJiffies {
+    std::vector<uint64_t> user;   // user + nice
+    std::vector<uint64_t> system; // system + irq + softirq
+    std::vector<uint64_t> idle;
+    std::vector<uint64_t> iowait;
+    std::vector<uint64_t> steal;
+    
+    void resize(size_t count);
+};
+
+// 两次采样之间每核各类时间的占比 (%)
+struct FlexCPUUsage {
+    std::vector<float> user;
+    std::vector<float> system;
+    std::vector<float> iowait;
+    std::vector<float> steal;
+    std::vector<float> busy;
+    float totalBusy = 0.0f; // 全部核心汇总
+    
+    void resize(size_t count);
+};
+
+// 每核 CPU 使用率与频率采样器: /proc/stat 与各核 scaling_cur_freq 保持打开,
+// 每次采样只做 pread 与线性解析, 可支撑 512+ 逻辑 CPU 下 10 Hz 采样
+class FlexCPUSampler {
+public:
+    FlexCPUSampler();
+    
+    // 采样一次; 从第二次开始 usage() 反映两次采样之间的占比
+    bool sample();
+    
+    // 只刷新各核当前频率
+    void flexSampleFrequencies();
+    
+    size_t coreCount() const { return flexCPUIds.size(); }
+    const std::vector<int>& cpuIds() const { return flexCPUIds; }
+    const FlexCPUUsage& usage() const { return flexUsage; }
+    const std::vector<double>& frequencies() const { return flexFrequencies; } // MHz, 不可用时为 0
+    bool hasUsage() const { return flexHasUsage; }
+    
+private:
+    FlexProcFile flexStatFile;
+    std::vector<char> flexStatBuffer;
+    std::vector<FlexProcFile> flexFreqFiles;
+    std::vector<int> flexCPUIds;
+    FlexCPUJiffies flexPrevious;
+    FlexCPUJiffies flexCurrent;
+    FlexCPUUsage flexUsage;
+    std::vector<double> flexFrequencies;
+    bool flexHasPrevious = false;
+    bool flexHasUsage = false;
+    
+    bool flexParseStat(std::string_view content, bool& layoutChanged);
+    void flexRebuildLayout(std::string_view content);
+    void flexComputeUsage();
+};
+
+} // namespace FlexTools
+
+#endif // FLEX_CPU_SAMPLER_H
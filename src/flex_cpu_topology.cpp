@@ -0,0 +1,198 @@
+#include "flex_cpu_topology.h"
+#include "flex_proc_file.h"
+#include <charconv>
+#include <dirent.h>
+#include <set>
+#include <utility>
+
+namespace FlexTools {
+
+namespace {
+
+// 每个逻辑 CPU 所属的插槽与核心
+struct FlexCPUPlacement {
+    int package = -1;
+    int core = -1;
+};
+
+std::string_view flexTrimView(std::string_view view) {
+    while (!view.empty() && (view.front() == ' ' || view.front() == '\t')) view.remove_prefix(1);
+    while (!view.empty() && (view.back() == ' ' || view.back() == '\t' || view.back() == '\r')) view.remove_suffix(1);
+    return view;
+}
+
+template <typename T>
+bool flexParseNumber(std::string_view view, T& value) {
+    view = flexTrimView(view);
+    auto result = std::from_chars(view.data(), view.data() + view.size(), value);
+    return result.ec == std::errc();
+}
+
+// 解析 cpuinfo 同时记录每个处理器块的 physical id / core id, 作为 sysfs 缺失时的后备
+void flexParseCPUInfoBlocks(std::string_view content, FlexCPUTopology& topology,
+                            std::vector<FlexCPUPlacement>& placements) {
+    bool firstProcessor = true;
+    bool flagsParsed = false;
+    
+    while (!content.empty()) {
+        size_t eol = content.find('\n');
+        std::string_view line = content.substr(0, eol);
+        content.remove_prefix(eol == std::string_view::npos ? content.size() : eol + 1);
+        
+        size_t colon = line.find(':');
+        if (colon == std::string_view::npos) {
+            continue;
+        }
+        std::string_view key = flexTrimView(line.substr(0, colon));
+        std::string_view value = flexTrimView(line.substr(colon + 1));
+        
+        if (key == "processor") {
+            placements.emplace_back();
+            topology.logicalCPUs++;
+            firstProcessor = topology.logicalCPUs == 1;
+            continue;
+        }
+        
+        if (key == "physical id") {
+            if (!placements.empty()) flexParseNumber(value, placements.back().package);
+            continue;
+        }
+        if (key == "core id") {
+            if (!placements.empty()) flexParseNumber(value, placements.back().core);
+            continue;
+        }
+        
+        // 其余字段各处理器相同, 只取第一个处理器的值
+        if (!firstProcessor && topology.logicalCPUs > 0) {
+            continue;
+        }
+        
+        if (key == "model name" && topology.model.empty()) {
+            topology.model = std::string(value);
+        } else if (key == "vendor_id" && topology.vendor.empty()) {
+            topology.vendor = std::string(value);
+        } else if (key == "cpu MHz") {
+            flexParseNumber(value, topology.cpuMHz);
+        } else if (key == "cache size") {
+            size_t space = value.find(' ');
+            flexParseNumber(value.substr(0, space), topology.cacheSize);
+        } else if ((key == "flags" || key == "Features") && !flagsParsed) {
+            flagsParsed = true;
+            while (!value.empty()) {
+                size_t space = value.find(' ');
+                std::string_view flag = value.substr(0, space);
+                value.remove_prefix(space == std::string_view::npos ? value.size() : space + 1);
+                if (!flag.empty()) {
+                    topology.flags.emplace_back(flag);
+                }
+            }
+        }
+    }
+}
+
+bool flexReadTopologyValue(const std::string& path, int& value) {
+    std::string content;
+    return flexReadWholeFile(path, content) && flexParseNumber(content, value);
+}
+
+// 从 sysfs 读取每个在线逻辑 CPU 的插槽与核心编号
+std::vector<FlexCPUPlacement> flexReadSysfsPlacements() {
+    std::vector<FlexCPUPlacement> placements;
+    DIR* dir = opendir("/sys/devices/system/cpu");
+    if (dir == nullptr) {
+        return placements;
+    }
+    
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        std::string_view name = entry->d_name;
+        if (name.size() < 4 || name.substr(0, 3) != "cpu" ||
+            name.find_first_not_of("0123456789", 3) != std::string_view::npos) {
+            continue;
+        }
+        
+        std::string base = "/sys/devices/system/cpu/" + std::string(name) + "/topology/";
+        FlexCPUPlacement placement;
+        if (flexReadTopologyValue(base + "physical_package_id", placement.package) &&
+            flexReadTopologyValue(base + "core_id", placement.core)) {
+            placements.push_back(placement);
+        }
+    }
+    closedir(dir);
+    return placements;
+}
+
+void flexSummarizePlacements(const std::vector<FlexCPUPlacement>& placements,
+                             FlexCPUTopology& topology) {
+    std::map<int, std::set<int>> coresPerSocket;
+    std::map<int, int> threadsPerSocket;
+    std::map<std::pair<int, int>, int> threadsPerCore;
+    
+    for (const auto& placement : placements) {
+        if (placement.package < 0 || placement.core < 0) {
+            continue;
+        }
+        coresPerSocket[placement.package].insert(placement.core);
+        threadsPerSocket[placement.package]++;
+        threadsPerCore[{placement.package, placement.core}]++;
+    }
+    
+    if (coresPerSocket.empty()) {
+        // 没有任何拓扑信息时按每个逻辑 CPU 一个核心处理
+        topology.sockets = topology.logicalCPUs > 0 ? 1 : 0;
+        topology.physicalCores = topology.logicalCPUs;
+        topology.threadsPerCore = topology.logicalCPUs > 0 ? 1 : 0;
+        topology.socketInfo.clear();
+        if (topology.logicalCPUs > 0) {
+            topology.socketInfo.push_back({0, topology.logicalCPUs, topology.logicalCPUs});
+        }
+        return;
+    }
+    
+    topology.sockets = static_cast<int>(coresPerSocket.size());
+    topology.physicalCores = static_cast<int>(threadsPerCore.size());
+    topology.threadsPerCore = 0;
+    for (const auto& [core, threads] : threadsPerCore) {
+        topology.threadsPerCore = std::max(topology.threadsPerCore, threads);
+    }
+    
+    topology.socketInfo.clear();
+    for (const auto& [socket, cores] : coresPerSocket) {
+        topology.socketInfo.push_back({socket, static_cast<int>(cores.size()), threadsPerSocket[socket]});
+    }
+}
+
+FlexCPUTopology flexLoadCPUTopology() {
+    FlexCPUTopology topology;
+    std::vector<FlexCPUPlacement> cpuinfoPlacements;
+    
+    std::string content;
+    if (flexReadWholeFile("/proc/cpuinfo", content)) {
+        flexParseCPUInfoBlocks(content, topology, cpuinfoPlacements);
+    }
+    
+    std::vector<FlexCPUPlacement> placements = flexReadSysfsPlacements();
+    if (placements.empty()) {
+        // 部分容器/架构下没有 sysfs 拓扑, 使用 cpuinfo 中的 physical id / core id
+        placements = std::move(cpuinfoPlacements);
+    }
+    topology.logicalCPUs = std::max(topology.logicalCPUs, static_cast<int>(placements.size()));
+    flexSummarizePlacements(placements, topology);
+    
+    return topology;
+}
+
+} // namespace
+
+void flexParseCPUInfoBuffer(std::string_view content, FlexCPUTopology& topology) {
+    std::vector<FlexCPUPlacement> placements;
+    flexParseCPUInfoBlocks(content, topology, placements);
+    flexSummarizePlacements(placements, topology);
+}
+
+const FlexCPUTopology& flexGetCPUTopology() {
+    static const FlexCPUTopology topology = flexLoadCPUTopology();
+    return topology;
+}
+
+} // namespace FlexTools
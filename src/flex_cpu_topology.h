@@ -0,0 +1,38 @@
+#ifndef FLEX_CPU_TOPOLOGY_H
+#define FLEX_CPU_TOPOLOGY_H
+
+#include "flex_common.h"
+#include <string_view>
+
+namespace FlexTools {
+
+// 单个物理插槽 (socket) 的拓扑
+struct FlexCPUSocket {
+    int id;
+    int cores;    // 物理核心数
+    int threads;  // 逻辑 CPU 数
+};
+
+// /proc/cpuinfo 与 /sys/devices/system/cpu/*/topology 的汇总结果
+struct FlexCPUTopology {
+    std::string model;
+    std::string vendor;
+    std::vector<std::string> flags; // 只取第一个处理器的 flags
+    int cacheSize = 0;              // KB
+    double cpuMHz = 0.0;            // 第一个处理器报告的频率
+    int logicalCPUs = 0;
+    int sockets = 0;
+    int physicalCores = 0;
+    int threadsPerCore = 0;         // SMT 兄弟线程数
+    std::vector<FlexCPUSocket> socketInfo;
+};
+
+// 进程内只读取一次 cpuinfo 与拓扑信息, 各模块共享同一份结果 (线程安全)
+const FlexCPUTopology& flexGetCPUTopology();
+
+// 单次遍历解析 cpuinfo 内容, 不分配逐行字符串, 不抛异常
+void flexParseCPUInfoBuffer(std::string_view content, FlexCPUTopology& topology);
+
+} // namespace FlexTools
+
+#endif // FLEX_CPU_TOPOLOGY_H
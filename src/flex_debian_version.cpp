@@ -0,0 +1,112 @@
+#include "flex_debian_version.h"
+
+namespace FlexTools {
+
+namespace {
+
+struct FlexVersionParts {
+    unsigned long epoch = 0;
+    std::string_view upstream;
+    std::string_view revision;
+};
+
+FlexVersionParts flexSplitVersion(std::string_view version) {
+    FlexVersionParts parts;
+    size_t colon = version.find(':');
+    if (colon != std::string_view::npos) {
+        for (size_t i = 0; i < colon; ++i) {
+            if (version[i] < '0' || version[i] > '9') break;
+            parts.epoch = parts.epoch * 10 + static_cast<unsigned long>(version[i] - '0');
+        }
+        version.remove_prefix(colon + 1);
+    }
+    size_t dash = version.rfind('-');
+    if (dash != std::string_view::npos) {
+        parts.upstream = version.substr(0, dash);
+        parts.revision = version.substr(dash + 1);
+    } else {
+        parts.upstream = version;
+    }
+    return parts;
+}
+
+inline bool flexIsDigit(int c) {
+    return c >= '0' && c <= '9';
+}
+
+inline bool flexIsAlpha(int c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+// 字符排序权重: '~' 最小 (比结尾还小), 字母其次, 其他符号最大
+inline int flexOrder(int c) {
+    if (flexIsDigit(c)) return 0;
+    if (flexIsAlpha(c)) return c;
+    if (c == '~') return -1;
+    if (c) return c + 256;
+    return 0;
+}
+
+// dpkg 的 verrevcmp: 交替比较非数字段与数字段
+int flexCompareFragment(std::string_view a, std::string_view b) {
+    size_t i = 0;
+    size_t j = 0;
+    auto at = [](std::string_view s, size_t k) -> int {
+        return k < s.size() ? static_cast<unsigned char>(s[k]) : 0;
+    };
+    
+    while (i < a.size() || j < b.size()) {
+        int firstDiff = 0;
+        
+        while ((i < a.size() && !flexIsDigit(at(a, i))) || (j < b.size() && !flexIsDigit(at(b, j)))) {
+            int ac = flexOrder(at(a, i));
+            int bc = flexOrder(at(b, j));
+            if (ac != bc) return ac - bc;
+            ++i;
+            ++j;
+        }
+        
+        while (at(a, i) == '0') ++i;
+        while (at(b, j) == '0') ++j;
+        while (flexIsDigit(at(a, i)) && flexIsDigit(at(b, j))) {
+            if (!firstDiff) firstDiff = at(a, i) - at(b, j);
+            ++i;
+            ++j;
+        }
+        if (flexIsDigit(at(a, i))) return 1;
+        if (flexIsDigit(at(b, j))) return -1;
+        if (firstDiff) return firstDiff;
+    }
+    return 0;
+}
+
+} // namespace
+
+int flexCompareDebianVersions(std::string_view a, std::string_view b) {
+    FlexVersionParts left = flexSplitVersion(a);
+    FlexVersionParts right = flexSplitVersion(b);
+    
+    if (left.epoch != right.epoch) {
+        return left.epoch > right.epoch ? 1 : -1;
+    }
+    int result = flexCompareFragment(left.upstream, right.upstream);
+    if (result != 0) {
+        return result;
+    }
+    return flexCompareFragment(left.revision, right.revision);
+}
+
+bool flexDebianVersionSatisfies(std::string_view version, std::string_view relation, std::string_view constraint) {
+    if (relation.empty()) {
+        return true;
+    }
+    int result = flexCompareDebianVersions(version, constraint);
+    if (relation == "<<") return result < 0;
+    if (relation == "<=" || relation == "<") return result <= 0;
+    if (relation == "=") return result == 0;
+    if (relation == ">=" || relation == ">") return result >= 0;
+    if (relation == ">>") return result > 0;
+    return false;
+}
+
+} // namespace FlexTools
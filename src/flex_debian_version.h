@@ -0,0 +1,17 @@
+#ifndef FLEX_DEBIAN_VERSION_H
+#define FLEX_DEBIAN_VERSION_H
+
+#include <string_view>
+
+namespace FlexTools {
+
+// 按 dpkg 规则比较两个 Debian 版本号 ([epoch:]upstream[-revision]).
+// 直接在输入上比较, 不分配内存. 返回 <0 / 0 / >0
+int flexCompareDebianVersions(std::string_view a, std::string_view b);
+
+// 判断 "version relation constraint" 是否成立, relation 为 <<, <=, =, >=, >> (以及旧式 <, >)
+bool flexDebianVersionSatisfies(std::string_view version, std::string_view relation, std::string_view constraint);
+
+} // namespace FlexTools
+
+#endif // FLEX_DEBIAN_VERSION_H
@@ -0,0 +1,129 @@
+#include "flex_decompress_pipeline.h"
+#include "flex_compressed_file.h"
+#include <thread>
+
+namespace FlexTools {
+
+FlexDecompressPipeline::FlexDecompressPipeline(std::vector<std::string> files, size_t workers,
+                                               size_t queueChunks, size_t chunkSize)
+    : flexFiles(std::move(files)), flexQueueChunks(std::max<size_t>(1, queueChunks)),
+      flexChunkSize(std::max<size_t>(4096, chunkSize)) {
+    if (workers == 0) {
+        workers = std::max(1u, std::thread::hardware_concurrency());
+    }
+    flexWorkers = std::max<size_t>(1, std::min(workers, flexFiles.size()));
+}
+
+void FlexDecompressPipeline::flexWork() {
+    while (true) {
+        size_t file;
+        {
+            std::unique_lock<std::mutex> lock(flexMutex);
+            // 只领取消费者之后 workers 个文件以内的任务, 避免远处的文件占满缓冲
+            flexSpace.wait(lock, [this] {
+                return flexNextFile >= flexFiles.size() || flexNextFile < flexConsumerFile + flexWorkers;
+            });
+            if (flexNextFile >= flexFiles.size()) {
+                return;
+            }
+            file = flexNextFile++;
+        }
+        
+        FlexCompressedStream stream(flexFiles[file]);
+        bool ok = stream.isOpen();
+        bool eof = !ok;
+        while (!eof) {
+            Chunk chunk;
+            {
+                std::lock_guard<std::mutex> lock(flexMutex);
+                if (!flexPool.empty()) {
+                    chunk = std::move(flexPool.back());
+                    flexPool.pop_back();
+                }
+            }
+            chunk.data.resize(flexChunkSize);
+            chunk.size = 0;
+            // 尽量填满一块, 减少消费者的唤醒次数
+            while (chunk.size < flexChunkSize) {
+                ssize_t count = stream.read(chunk.data.data() + chunk.size, flexChunkSize - chunk.size);
+                if (count <= 0) {
+                    ok = count == 0;
+                    eof = true;
+                    break;
+                }
+                chunk.size += static_cast<size_t>(count);
+            }
+            if (chunk.size == 0) {
+                break;
+            }
+            
+            std::unique_lock<std::mutex> lock(flexMutex);
+            FileQueue& queue = flexQueues[file];
+            flexSpace.wait(lock, [&] { return queue.chunks.size() < flexQueueChunks; });
+            flexBuffered += chunk.size;
+            flexPeakBuffered = std::max(flexPeakBuffered, flexBuffered);
+            queue.chunks.push_back(std::move(chunk));
+            if (file == flexConsumerFile) {
+                flexReady.notify_one();
+            }
+        }
+        
+        std::lock_guard<std::mutex> lock(flexMutex);
+        flexQueues[file].done = true;
+        flexQueues[file].ok = ok;
+        if (file == flexConsumerFile) {
+            flexReady.notify_one();
+        }
+    }
+}
+
+void FlexDecompressPipeline::run(const std::function<void(size_t, const char*, size_t)>& onChunk,
+                                 const std::function<void(size_t, bool)>& onFileEnd) {
+    flexQueues.assign(flexFiles.size(), FileQueue());
+    flexPool.clear();
+    flexNextFile = 0;
+    flexConsumerFile = 0;
+    flexBuffered = 0;
+    flexPeakBuffered = 0;
+    
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < flexWorkers && i < flexFiles.size(); ++i) {
+        threads.emplace_back(&FlexDecompressPipeline::flexWork, this);
+    }
+    
+    // 调用线程按顺序消费; 当前文件总有工作线程负责 (更早的文件都已读完), 不会死锁
+    for (size_t file = 0; file < flexFiles.size(); ++file) {
+        FileQueue& queue = flexQueues[file];
+        while (true) {
+            Chunk chunk;
+            {
+                std::unique_lock<std::mutex> lock(flexMutex);
+                flexReady.wait(lock, [&] { return !queue.chunks.empty() || queue.done; });
+                if (queue.chunks.empty()) {
+                    break;
+                }
+                chunk = std::move(queue.chunks.front());
+                queue.chunks.pop_front();
+            }
+            flexSpace.notify_all();
+            onChunk(file, chunk.data.data(), chunk.size);
+            
+            std::lock_guard<std::mutex> lock(flexMutex);
+            flexBuffered -= chunk.size;
+            flexPool.push_back(std::move(chunk));
+        }
+        onFileEnd(file, queue.ok);
+        
+        {
+            std::lock_guard<std::mutex> lock(flexMutex);
+            flexConsumerFile = file + 1;
+        }
+        flexSpace.notify_all();
+    }
+    
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+} // namespace FlexTools
@@ -0,0 +1,63 @@
+#ifndef FLEX_DECOMPRESS_PIPELINE_H
+#define FLEX_DECOMPRESS_PIPELINE_H
+
+#include "flex_common.h"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+namespace FlexTools {
+
+// 并发读取 (解压) 一组文件, 每个工作线程一次处理一个流, 数据按 files 的顺序逐块交给调用线程.
+// 每个文件最多缓冲 queueChunks 块, 工作线程最多领先消费者 workers 个文件, 队列满时阻塞;
+// 因此缓冲上限约为 workers * queueChunks * chunkSize, 与文件个数和大小无关
+class FlexDecompressPipeline {
+public:
+    explicit FlexDecompressPipeline(std::vector<std::string> files, size_t workers = 0,
+                                    size_t queueChunks = 4, size_t chunkSize = 1024 * 1024);
+    
+    // onChunk(file, data, size) 按文件顺序调用, data 只在调用期间有效;
+    // 每个文件读完后调用一次 onFileEnd(file, ok), ok 为 false 表示打开或解压失败
+    void run(const std::function<void(size_t, const char*, size_t)>& onChunk,
+             const std::function<void(size_t, bool)>& onFileEnd);
+    
+    size_t workers() const { return flexWorkers; }
+    
+    // 运行期间同时缓冲的最多字节数
+    uint64_t peakBuffered() const { return flexPeakBuffered; }
+
+private:
+    struct Chunk {
+        std::vector<char> data;
+        size_t size = 0;
+    };
+    
+    struct FileQueue {
+        std::deque<Chunk> chunks;
+        bool done = false;
+        bool ok = true;
+    };
+    
+    std::vector<std::string> flexFiles;
+    size_t flexWorkers;
+    size_t flexQueueChunks;
+    size_t flexChunkSize;
+    
+    std::mutex flexMutex;
+    std::condition_variable flexReady; // 消费者等待数据
+    std::condition_variable flexSpace; // 工作线程等待队列空位或文件窗口前移
+    std::vector<FileQueue> flexQueues;
+    std::vector<Chunk> flexPool;       // 已消费的块, 复用其缓冲区
+    size_t flexNextFile = 0;
+    size_t flexConsumerFile = 0;
+    uint64_t flexBuffered = 0;
+    uint64_t flexPeakBuffered = 0;
+    
+    void flexWork();
+};
+
+} // namespace FlexTools
+
+#endif // FLEX_DECOMPRESS_PIPELINE_H
@@ -0,0 +1,325 @@
+#include "flex_dependency_graph.h"
+#include "flex_debian_version.h"
+
+namespace FlexTools {
+
+namespace {
+
+std::string_view flexTrimRelation(std::string_view view) {
+    while (!view.empty() && (view.front() == ' ' || view.front() == '\t')) view.remove_prefix(1);
+    while (!view.empty() && (view.back() == ' ' || view.back() == '\t')) view.remove_suffix(1);
+    return view;
+}
+
+// "libc6:any (>= 2.34)" -> ("libc6", ">=", "2.34")
+void flexParseRelation(std::string_view item, std::string_view& name, std::string_view& relation,
+                       std::string_view& version) {
+    item = flexTrimRelation(item);
+    relation = std::string_view();
+    version = std::string_view();
+    
+    size_t open = item.find(" (");
+    if (open != std::string_view::npos && item.back() == ')') {
+        std::string_view constraint = flexTrimRelation(item.substr(open + 2, item.size() - open - 3));
+        size_t opEnd = 0;
+        while (opEnd < constraint.size() &&
+               (constraint[opEnd] == '<' || constraint[opEnd] == '>' || constraint[opEnd] == '=')) {
+            ++opEnd;
+        }
+        relation = constraint.substr(0, opEnd);
+        version = flexTrimRelation(constraint.substr(opEnd));
+        item = flexTrimRelation(item.substr(0, open));
+    }
+    
+    // 去掉多架构限定 ":any" / ":amd64"; RPM 的 "perl(Foo::Bar)" 之类保持原样
+    size_t colon = item.rfind(':');
+    if (colon != std::string_view::npos && item.find('(') == std::string_view::npos) {
+        item = item.substr(0, colon);
+    }
+    name = item;
+}
+
+// 提供者版本是否满足备选的约束. 无版本的 Provides 只满足无版本依赖;
+// RPM 版本沿用 dpkg 的排序 (两者对常见版本号一致)
+bool flexProviderSatisfies(std::string_view provided, std::string_view relation, std::string_view constraint,
+                           FlexSystemType systemType) {
+    if (relation.empty()) {
+        return true;
+    }
+    if (provided.empty()) {
+        return false;
+    }
+    if (systemType == FlexSystemType::RPM_BASED) {
+        if (relation == "<") relation = "<<";
+        else if (relation == ">") relation = ">>";
+        // "foo >= 1.2" 不限定 release, 比较前去掉提供者的 release
+        size_t dash = provided.rfind('-');
+        if (constraint.find('-') == std::string_view::npos && dash != std::string_view::npos) {
+            provided = provided.substr(0, dash);
+        }
+    }
+    return flexDebianVersionSatisfies(provided, relation, constraint);
+}
+
+// 由 (行, 值) 对构建 CSR, 每行内排序去重
+void flexBuildCSR(size_t rows, std::vector<std::pair<uint32_t, uint32_t>>& pairs,
+                  std::vector<uint32_t>& offsets, std::vector<uint32_t>& values) {
+    std::sort(pairs.begin(), pairs.end());
+    pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+    
+    offsets.assign(rows + 1, 0);
+    for (const auto& pair : pairs) {
+        ++offsets[pair.first + 1];
+    }
+    for (size_t i = 0; i < rows; ++i) {
+        offsets[i + 1] += offsets[i];
+    }
+    values.resize(pairs.size());
+    for (size_t i = 0; i < pairs.size(); ++i) {
+        values[i] = pairs[i].second;
+    }
+}
+
+} // namespace
+
+FlexDependencyGraph::FlexDependencyGraph(const FlexPackageStore& packages, FlexSystemType systemType) {
+    // 节点: 每个包名一个 ID (多架构同名包合并)
+    std::vector<uint32_t> nodePackages;
+    for (uint32_t index = 0; index < packages.size(); ++index) {
+        std::string name(packages.name(index));
+        if (flexNodeIds.emplace(name, static_cast<uint32_t>(flexNames.size())).second) {
+            flexNames.push_back(std::move(name));
+            nodePackages.push_back(index);
+        }
+    }
+    size_t nodes = flexNames.size();
+    
+    std::unordered_map<std::string, uint32_t> targetIds;
+    auto internTarget = [&](std::string_view name) {
+        auto result = targetIds.emplace(std::string(name), static_cast<uint32_t>(flexTargetNames.size()));
+        if (result.second) {
+            flexTargetNames.emplace_back(name);
+        }
+        return result.first->second;
+    };
+    
+    std::unordered_map<std::string, uint32_t> stringIds;
+    auto internString = [&](std::string_view value) {
+        auto result = stringIds.emplace(std::string(value), static_cast<uint32_t>(flexStrings.size()));
+        if (result.second) {
+            flexStrings.emplace_back(value);
+        }
+        return result.first->second;
+    };
+    internString("");
+    
+    // 包名本身 (以包的版本) 与 Provides (以声明的版本, 可能为空) 都能满足依赖;
+    // 对的值是 providerEntries 下标, 即 (提供者, 提供的版本)
+    std::vector<std::pair<uint32_t, uint32_t>> providerPairs;
+    std::vector<std::pair<uint32_t, std::string_view>> providerEntries;
+    for (uint32_t node = 0; node < nodes; ++node) {
+        providerPairs.emplace_back(internTarget(flexNames[node]), static_cast<uint32_t>(providerEntries.size()));
+        providerEntries.emplace_back(node, packages.version(nodePackages[node]));
+        for (std::string_view provide : packages.relations(FlexRelationKind::PROVIDES, nodePackages[node])) {
+            std::string_view name, relation, version;
+            flexParseRelation(provide, name, relation, version);
+            if (!name.empty()) {
+                providerPairs.emplace_back(internTarget(name), static_cast<uint32_t>(providerEntries.size()));
+                providerEntries.emplace_back(node, relation == "=" ? version : std::string_view());
+            }
+        }
+    }
+    
+    // 子句与备选
+    flexClauseOffsets.reserve(nodes + 1);
+    flexClauseOffsets.push_back(0);
+    flexAlternativeOffsets.push_back(0);
+    for (uint32_t node = 0; node < nodes; ++node) {
+        for (std::string_view clause : packages.relations(FlexRelationKind::DEPENDS, nodePackages[node])) {
+            size_t before = flexAlternatives.size();
+            while (!clause.empty()) {
+                size_t bar = clause.find('|');
+                std::string_view name, relation, version;
+                flexParseRelation(clause.substr(0, bar), name, relation, version);
+                clause.remove_prefix(bar == std::string_view::npos ? clause.size() : bar + 1);
+                if (!name.empty()) {
+                    flexAlternatives.push_back(Alternative{internTarget(name), internString(relation),
+                                                           internString(version)});
+                }
+            }
+            if (flexAlternatives.size() != before) {
+                flexAlternativeOffsets.push_back(static_cast<uint32_t>(flexAlternatives.size()));
+            }
+        }
+        flexClauseOffsets.push_back(static_cast<uint32_t>(flexAlternativeOffsets.size() - 1));
+    }
+    
+    std::vector<uint32_t> providerOffsets;
+    std::vector<uint32_t> providers;
+    flexBuildCSR(flexTargetNames.size(), providerPairs, providerOffsets, providers);
+    
+    // 每个备选筛出版本满足约束的提供者
+    std::vector<std::pair<uint32_t, uint32_t>> candidatePairs;
+    for (uint32_t a = 0; a < flexAlternatives.size(); ++a) {
+        const Alternative& alternative = flexAlternatives[a];
+        for (uint32_t p = providerOffsets[alternative.name]; p < providerOffsets[alternative.name + 1]; ++p) {
+            const auto& entry = providerEntries[providers[p]];
+            if (flexProviderSatisfies(entry.second, flexStrings[alternative.relation],
+                                      flexStrings[alternative.version], systemType)) {
+                candidatePairs.emplace_back(a, entry.first);
+            }
+        }
+    }
+    flexBuildCSR(flexAlternatives.size(), candidatePairs, flexCandidateOffsets, flexCandidates);
+    
+    // 展开为包到包的边
+    std::vector<std::pair<uint32_t, uint32_t>> forwardPairs;
+    for (uint32_t node = 0; node < nodes; ++node) {
+        uint32_t firstAlternative = flexAlternativeOffsets[flexClauseOffsets[node]];
+        uint32_t lastAlternative = flexAlternativeOffsets[flexClauseOffsets[node + 1]];
+        for (uint32_t a = firstAlternative; a < lastAlternative; ++a) {
+            for (uint32_t p = flexCandidateOffsets[a]; p < flexCandidateOffsets[a + 1]; ++p) {
+                if (flexCandidates[p] != node) {
+                    forwardPairs.emplace_back(node, flexCandidates[p]);
+                }
+            }
+        }
+    }
+    
+    std::vector<std::pair<uint32_t, uint32_t>> reversePairs;
+    reversePairs.reserve(forwardPairs.size());
+    for (const auto& pair : forwardPairs) {
+        reversePairs.emplace_back(pair.second, pair.first);
+    }
+    flexBuildCSR(nodes, forwardPairs, flexForwardOffsets, flexForwardTargets);
+    flexBuildCSR(nodes, reversePairs, flexReverseOffsets, flexReverseSources);
+}
+
+uint32_t FlexDependencyGraph::nodeId(const std::string& name) const {
+    auto it = flexNodeIds.find(name);
+    return it == flexNodeIds.end() ? FLEX_NO_NODE : it->second;
+}
+
+std::vector<uint32_t> FlexDependencyGraph::dependencies(uint32_t node) const {
+    return std::vector<uint32_t>(flexForwardTargets.begin() + flexForwardOffsets[node],
+                                 flexForwardTargets.begin() + flexForwardOffsets[node + 1]);
+}
+
+std::vector<uint32_t> FlexDependencyGraph::dependents(uint32_t node) const {
+    return std::vector<uint32_t>(flexReverseSources.begin() + flexReverseOffsets[node],
+                                 flexReverseSources.begin() + flexReverseOffsets[node + 1]);
+}
+
+std::vector<std::vector<FlexDependencyAlternative>> FlexDependencyGraph::clauses(uint32_t node) const {
+    std::vector<std::vector<FlexDependencyAlternative>> result;
+    for (uint32_t c = flexClauseOffsets[node]; c < flexClauseOffsets[node + 1]; ++c) {
+        std::vector<FlexDependencyAlternative> clause;
+        for (uint32_t a = flexAlternativeOffsets[c]; a < flexAlternativeOffsets[c + 1]; ++a) {
+            const Alternative& alternative = flexAlternatives[a];
+            FlexDependencyAlternative item;
+            item.name = flexTargetNames[alternative.name];
+            item.relation = flexStrings[alternative.relation];
+            item.version = flexStrings[alternative.version];
+            item.providers.assign(flexCandidates.begin() + flexCandidateOffsets[a],
+                                  flexCandidates.begin() + flexCandidateOffsets[a + 1]);
+            clause.push_back(std::move(item));
+        }
+        result.push_back(std::move(clause));
+    }
+    return result;
+}
+
+std::vector<uint32_t> FlexDependencyGraph::flexTraverse(uint32_t node, const std::vector<uint32_t>& offsets,
+                                                        const std::vector<uint32_t>& targets) const {
+    std::vector<uint32_t> result;
+    if (node >= nodeCount()) {
+        return result;
+    }
+    
+    std::vector<uint64_t> visited((nodeCount() + 63) / 64, 0);
+    visited[node / 64] |= 1ULL << (node % 64);
+    std::vector<uint32_t> queue{node};
+    
+    for (size_t head = 0; head < queue.size(); ++head) {
+        uint32_t current = queue[head];
+        for (uint32_t e = offsets[current]; e < offsets[current + 1]; ++e) {
+            uint32_t next = targets[e];
+            uint64_t bit = 1ULL << (next % 64);
+            if (!(visited[next / 64] & bit)) {
+                visited[next / 64] |= bit;
+                queue.push_back(next);
+            }
+        }
+    }
+    
+    // 按 ID (即包名顺序) 从位图输出
+    visited[node / 64] &= ~(1ULL << (node % 64));
+    result.reserve(queue.size() - 1);
+    for (size_t word = 0; word < visited.size(); ++word) {
+        for (uint64_t bits = visited[word]; bits != 0; bits &= bits - 1) {
+            result.push_back(static_cast<uint32_t>(word * 64 + __builtin_ctzll(bits)));
+        }
+    }
+    return result;
+}
+
+std::vector<uint32_t> FlexDependencyGraph::closure(uint32_t node) const {
+    return flexTraverse(node, flexForwardOffsets, flexForwardTargets);
+}
+
+std::vector<uint32_t> FlexDependencyGraph::reverseClosure(uint32_t node) const {
+    return flexTraverse(node, flexReverseOffsets, flexReverseSources);
+}
+
+std::vector<uint32_t> FlexDependencyGraph::removalImpact(const std::vector<uint32_t>& removed) const {
+    std::vector<uint64_t> gone((nodeCount() + 63) / 64, 0);
+    auto isGone = [&](uint32_t node) { return (gone[node / 64] >> (node % 64)) & 1; };
+    auto markGone = [&](uint32_t node) { gone[node / 64] |= 1ULL << (node % 64); };
+    
+    std::vector<uint32_t> queue;
+    for (uint32_t node : removed) {
+        if (node < nodeCount() && !isGone(node)) {
+            markGone(node);
+            queue.push_back(node);
+        }
+    }
+    size_t initial = queue.size();
+    
+    // 子句原本可满足、且所有满足约束的提供者都已移除时, 该包损坏
+    auto isBroken = [&](uint32_t node) {
+        for (uint32_t c = flexClauseOffsets[node]; c < flexClauseOffsets[node + 1]; ++c) {
+            bool hadProvider = false;
+            bool satisfied = false;
+            for (uint32_t a = flexAlternativeOffsets[c]; a < flexAlternativeOffsets[c + 1] && !satisfied; ++a) {
+                for (uint32_t p = flexCandidateOffsets[a]; p < flexCandidateOffsets[a + 1]; ++p) {
+                    hadProvider = true;
+                    if (!isGone(flexCandidates[p])) {
+                        satisfied = true;
+                        break;
+                    }
+                }
+            }
+            if (hadProvider && !satisfied) {
+                return true;
+            }
+        }
+        return false;
+    };
+    
+    for (size_t head = 0; head < queue.size(); ++head) {
+        uint32_t current = queue[head];
+        for (uint32_t e = flexReverseOffsets[current]; e < flexReverseOffsets[current + 1]; ++e) {
+            uint32_t dependent = flexReverseSources[e];
+            if (!isGone(dependent) && isBroken(dependent)) {
+                markGone(dependent);
+                queue.push_back(dependent);
+            }
+        }
+    }
+    
+    std::vector<uint32_t> result(queue.begin() + initial, queue.end());
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+} // namespace FlexTools
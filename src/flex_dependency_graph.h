@@ -0,0 +1,84 @@
+#ifndef FLEX_DEPENDENCY_GRAPH_H
+#define FLEX_DEPENDENCY_GRAPH_H
+
+#include "flex_common.h"
+#include "flex_package_store.h"
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+
+namespace FlexTools {
+
+// 依赖子句中的一个备选项, 例如 "libc6 (>= 2.34)"
+struct FlexDependencyAlternative {
+    std::string name;
+    std::string relation; // <<, <=, =, >=, >> 或空
+    std::string version;
+    std::vector<uint32_t> providers; // 满足名称与版本约束的已安装包 (含虚包提供者)
+};
+
+// 已安装包的依赖图, 以整数包 ID 的 CSR (压缩稀疏行) 存储正反向边.
+// 每个包的依赖拆为子句, 子句内是 "a | b" 备选, 任一备选满足即可.
+// 带版本约束的备选只由版本满足约束的包或带版本的 Provides 满足; 无版本的 Provides 只满足无版本依赖
+class FlexDependencyGraph {
+public:
+    static constexpr uint32_t FLEX_NO_NODE = 0xffffffffu;
+    
+    // systemType 决定约束的写法: RPM 的 "<"/">" 为严格比较, 不带 release 的约束匹配任意 release
+    explicit FlexDependencyGraph(const FlexPackageStore& packages,
+                                 FlexSystemType systemType = FlexSystemType::DEBIAN_BASED);
+    
+    size_t nodeCount() const { return flexNames.size(); }
+    size_t edgeCount() const { return flexForwardTargets.size(); }
+    uint32_t nodeId(const std::string& name) const;
+    const std::string& nodeName(uint32_t node) const { return flexNames[node]; }
+    
+    // 直接依赖 / 直接被依赖 (已展开备选与虚包)
+    std::vector<uint32_t> dependencies(uint32_t node) const;
+    std::vector<uint32_t> dependents(uint32_t node) const;
+    
+    // 依赖子句及其约束
+    std::vector<std::vector<FlexDependencyAlternative>> clauses(uint32_t node) const;
+    
+    // 传递闭包 (不含起点), 基于位图的广度优先遍历
+    std::vector<uint32_t> closure(uint32_t node) const;
+    std::vector<uint32_t> reverseClosure(uint32_t node) const;
+    
+    // 移除给定包后会失去依赖的包: 某个子句的全部备选都被移除才算损坏, 逐轮传播直到不动点
+    std::vector<uint32_t> removalImpact(const std::vector<uint32_t>& removed) const;
+    
+private:
+    struct Alternative {
+        uint32_t name;     // flexTargetNames 下标
+        uint32_t relation; // flexStrings 下标
+        uint32_t version;  // flexStrings 下标
+    };
+    
+    std::vector<std::string> flexNames;
+    std::unordered_map<std::string, uint32_t> flexNodeIds;
+    
+    std::vector<std::string> flexTargetNames;
+    
+    // 包 -> 子句 -> 备选 (两级 CSR)
+    std::vector<uint32_t> flexClauseOffsets;
+    std::vector<uint32_t> flexAlternativeOffsets;
+    std::vector<Alternative> flexAlternatives;
+    std::vector<std::string> flexStrings;
+    
+    // 备选 -> 满足它的包 (CSR)
+    std::vector<uint32_t> flexCandidateOffsets;
+    std::vector<uint32_t> flexCandidates;
+    
+    // 展开后的正向 / 反向邻接 (CSR, 去重)
+    std::vector<uint32_t> flexForwardOffsets;
+    std::vector<uint32_t> flexForwardTargets;
+    std::vector<uint32_t> flexReverseOffsets;
+    std::vector<uint32_t> flexReverseSources;
+    
+    std::vector<uint32_t> flexTraverse(uint32_t node, const std::vector<uint32_t>& offsets,
+                                       const std::vector<uint32_t>& targets) const;
+};
+
+} // namespace FlexTools
+
+#endif // FLEX_DEPENDENCY_GRAPH_H
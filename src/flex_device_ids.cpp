@@ -0,0 +1,287 @@
+#include "flex_device_ids.h"
+#include "flex_proc_file.h"
+#include <dirent.h>
+#include <cstdio>
+
+namespace FlexTools {
+
+namespace {
+
+enum FlexIdKind : uint64_t {
+    FLEX_ID_VENDOR = 1,
+    FLEX_ID_DEVICE = 2,
+    FLEX_ID_CLASS = 3,
+    FLEX_ID_SUBCLASS = 4
+};
+
+constexpr uint64_t flexMakeKey(uint64_t kind, uint64_t id) {
+    return (kind << 48) | id;
+}
+
+int flexHexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// 解析 view 开头恰好 digits 位十六进制数, 其后必须是空格
+bool flexParseHexField(std::string_view view, size_t digits, uint32_t& value) {
+    if (view.size() <= digits || view[digits] != ' ') {
+        return false;
+    }
+    value = 0;
+    for (size_t i = 0; i < digits; ++i) {
+        int nibble = flexHexValue(view[i]);
+        if (nibble < 0) return false;
+        value = (value << 4) | static_cast<uint32_t>(nibble);
+    }
+    return true;
+}
+
+// 解析 sysfs 中 "0x8086" 或 "8086" 形式的十六进制属性
+bool flexReadHexAttribute(const std::string& path, uint32_t& value) {
+    std::string content;
+    if (!flexReadWholeFile(path, content)) {
+        return false;
+    }
+    std::string_view view = content;
+    if (view.substr(0, 2) == "0x") {
+        view.remove_prefix(2);
+    }
+    value = 0;
+    size_t digits = 0;
+    while (digits < view.size() && flexHexValue(view[digits]) >= 0) {
+        value = (value << 4) | static_cast<uint32_t>(flexHexValue(view[digits]));
+        ++digits;
+    }
+    return digits > 0;
+}
+
+std::string flexReadTrimmed(const std::string& path) {
+    std::string content;
+    flexReadWholeFile(path, content);
+    while (!content.empty() && (content.back() == '\n' || content.back() == ' ')) {
+        content.pop_back();
+    }
+    return content;
+}
+
+std::vector<std::string> flexListEntries(const std::string& path) {
+    std::vector<std::string> names;
+    DIR* dir = opendir(path.c_str());
+    if (dir == nullptr) {
+        return names;
+    }
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        if (entry->d_name[0] != '.') {
+            names.emplace_back(entry->d_name);
+        }
+    }
+    closedir(dir);
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+} // namespace
+
+FlexDeviceIdDatabase::FlexDeviceIdDatabase(const std::vector<std::string>& candidatePaths) {
+    for (const auto& path : candidatePaths) {
+        FlexMappedFile file(path);
+        if (file.isOpen() && file.size() > 0) {
+            flexFile = std::move(file);
+            break;
+        }
+    }
+    flexBuildIndex();
+}
+
+const FlexDeviceIdDatabase& FlexDeviceIdDatabase::flexPCI() {
+    static const FlexDeviceIdDatabase database({
+        "/usr/share/hwdata/pci.ids",
+        "/usr/share/misc/pci.ids",
+        "/usr/share/pci.ids"
+    });
+    return database;
+}
+
+const FlexDeviceIdDatabase& FlexDeviceIdDatabase::flexUSB() {
+    static const FlexDeviceIdDatabase database({
+        "/usr/share/hwdata/usb.ids",
+        "/usr/share/misc/usb.ids",
+        "/var/lib/usbutils/usb.ids",
+        "/usr/share/usb.ids"
+    });
+    return database;
+}
+
+void FlexDeviceIdDatabase::flexBuildIndex() {
+    std::string_view content = flexFile.view();
+    const char* base = content.data();
+    
+    // 当前所在的顶层段落: 厂商段或 PCI 类别段, 其余段 (usb.ids 中的 HID 等) 忽略
+    enum class FlexSection { NONE, VENDOR, CLASS } section = FlexSection::NONE;
+    uint32_t current = 0;
+    
+    while (!content.empty()) {
+        size_t eol = content.find('\n');
+        std::string_view line = content.substr(0, eol);
+        content.remove_prefix(eol == std::string_view::npos ? content.size() : eol + 1);
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        
+        uint32_t id = 0;
+        uint64_t key = 0;
+        std::string_view name;
+        
+        if (line[0] != '\t') {
+            if (flexParseHexField(line, 4, id)) {
+                section = FlexSection::VENDOR;
+                current = id;
+                key = flexMakeKey(FLEX_ID_VENDOR, id);
+                name = line.substr(4);
+            } else if (line.size() > 2 && line[0] == 'C' && line[1] == ' ' &&
+                       flexParseHexField(line.substr(2), 2, id)) {
+                section = FlexSection::CLASS;
+                current = id;
+                key = flexMakeKey(FLEX_ID_CLASS, id);
+                name = line.substr(4);
+            } else {
+                section = FlexSection::NONE;
+                continue;
+            }
+        } else if (line.size() > 1 && line[1] != '\t') {
+            // 一级缩进: 厂商下的设备或类别下的子类别; 二级缩进 (子系统) 不索引
+            std::string_view child = line.substr(1);
+            if (section == FlexSection::VENDOR && flexParseHexField(child, 4, id)) {
+                key = flexMakeKey(FLEX_ID_DEVICE, (static_cast<uint64_t>(current) << 16) | id);
+                name = child.substr(4);
+            } else if (section == FlexSection::CLASS && flexParseHexField(child, 2, id)) {
+                key = flexMakeKey(FLEX_ID_SUBCLASS, (static_cast<uint64_t>(current) << 8) | id);
+                name = child.substr(2);
+            } else {
+                continue;
+            }
+        } else {
+            continue;
+        }
+        
+        while (!name.empty() && (name.front() == ' ' || name.front() == '\t')) name.remove_prefix(1);
+        while (!name.empty() && (name.back() == '\r' || name.back() == ' ')) name.remove_suffix(1);
+        flexIndex.push_back({key, static_cast<uint32_t>(name.data() - base),
+                             static_cast<uint32_t>(name.size())});
+    }
+    
+    std::sort(flexIndex.begin(), flexIndex.end(),
+              [](const FlexIdEntry& a, const FlexIdEntry& b) { return a.key < b.key; });
+    flexIndex.shrink_to_fit();
+}
+
+std::string_view FlexDeviceIdDatabase::flexLookup(uint64_t key) const {
+    auto it = std::lower_bound(flexIndex.begin(), flexIndex.end(), key,
+                               [](const FlexIdEntry& entry, uint64_t k) { return entry.key < k; });
+    if (it == flexIndex.end() || it->key != key) {
+        return {};
+    }
+    return std::string_view(flexFile.data() + it->offset, it->length);
+}
+
+std::string_view FlexDeviceIdDatabase::vendorName(uint16_t vendor) const {
+    return flexLookup(flexMakeKey(FLEX_ID_VENDOR, vendor));
+}
+
+std::string_view FlexDeviceIdDatabase::deviceName(uint16_t vendor, uint16_t device) const {
+    return flexLookup(flexMakeKey(FLEX_ID_DEVICE, (static_cast<uint64_t>(vendor) << 16) | device));
+}
+
+std::string_view FlexDeviceIdDatabase::className(uint8_t classCode) const {
+    return flexLookup(flexMakeKey(FLEX_ID_CLASS, classCode));
+}
+
+std::string_view FlexDeviceIdDatabase::subclassName(uint8_t classCode, uint8_t subclass) const {
+    return flexLookup(flexMakeKey(FLEX_ID_SUBCLASS, (static_cast<uint64_t>(classCode) << 8) | subclass));
+}
+
+std::vector<std::string> flexEnumeratePCIDevices(const std::string& sysfsRoot) {
+    std::vector<std::string> devices;
+    const FlexDeviceIdDatabase& ids = FlexDeviceIdDatabase::flexPCI();
+    
+    for (const auto& slot : flexListEntries(sysfsRoot)) {
+        std::string dir = sysfsRoot + "/" + slot + "/";
+        uint32_t vendor = 0, device = 0, classValue = 0;
+        if (!flexReadHexAttribute(dir + "vendor", vendor) || !flexReadHexAttribute(dir + "device", device)) {
+            continue;
+        }
+        flexReadHexAttribute(dir + "class", classValue);
+        uint8_t classCode = static_cast<uint8_t>(classValue >> 16);
+        uint8_t subclass = static_cast<uint8_t>(classValue >> 8);
+        
+        char hex[32];
+        std::string line = slot + " ";
+        std::string_view className = ids.subclassName(classCode, subclass);
+        if (className.empty()) className = ids.className(classCode);
+        if (!className.empty()) {
+            line += className;
+        } else {
+            std::snprintf(hex, sizeof(hex), "Class %02x%02x", classCode, subclass);
+            line += hex;
+        }
+        line += ": ";
+        
+        std::string_view vendorName = ids.vendorName(static_cast<uint16_t>(vendor));
+        std::string_view deviceName = ids.deviceName(static_cast<uint16_t>(vendor), static_cast<uint16_t>(device));
+        if (!vendorName.empty()) {
+            line += vendorName;
+            line += " ";
+        }
+        if (!deviceName.empty()) {
+            line += deviceName;
+            line += " ";
+        }
+        std::snprintf(hex, sizeof(hex), "[%04x:%04x]", vendor, device);
+        line += hex;
+        devices.push_back(std::move(line));
+    }
+    return devices;
+}
+
+std::vector<std::string> flexEnumerateUSBDevices(const std::string& sysfsRoot) {
+    std::vector<std::string> devices;
+    const FlexDeviceIdDatabase& ids = FlexDeviceIdDatabase::flexUSB();
+    
+    for (const auto& name : flexListEntries(sysfsRoot)) {
+        // 含 ':' 的条目是接口而非设备
+        if (name.find(':') != std::string::npos) {
+            continue;
+        }
+        std::string dir = sysfsRoot + "/" + name + "/";
+        uint32_t vendor = 0, product = 0;
+        if (!flexReadHexAttribute(dir + "idVendor", vendor) || !flexReadHexAttribute(dir + "idProduct", product)) {
+            continue;
+        }
+        int bus = std::atoi(flexReadTrimmed(dir + "busnum").c_str());
+        int dev = std::atoi(flexReadTrimmed(dir + "devnum").c_str());
+        
+        char header[64];
+        std::snprintf(header, sizeof(header), "Bus %03d Device %03d: ID %04x:%04x", bus, dev, vendor, product);
+        std::string line = header;
+        
+        // 数据库中没有的设备使用设备自身上报的字符串
+        std::string_view vendorName = ids.vendorName(static_cast<uint16_t>(vendor));
+        std::string_view productName = ids.deviceName(static_cast<uint16_t>(vendor), static_cast<uint16_t>(product));
+        std::string manufacturer = vendorName.empty() ? flexReadTrimmed(dir + "manufacturer") : std::string(vendorName);
+        std::string productText = productName.empty() ? flexReadTrimmed(dir + "product") : std::string(productName);
+        if (!manufacturer.empty()) {
+            line += " " + manufacturer;
+        }
+        if (!productText.empty()) {
+            line += " " + productText;
+        }
+        devices.push_back(std::move(line));
+    }
+    return devices;
+}
+
+} // namespace FlexTools
@@ -0,0 +1,52 @@
+#ifndef FLEX_DEVICE_IDS_H
+#define FLEX_DEVICE_IDS_H
+
+#include "flex_common.h"
+#include "flex_mapped_file.h"
+#include <cstdint>
+#include <string_view>
+
+namespace FlexTools {
+
+// pci.ids / usb.ids 名称数据库: 文件以 mmap 方式映射, 首次使用时建立
+// 按 ID 排序的紧凑偏移索引, 之后每次查找都是一次二分查找
+class FlexDeviceIdDatabase {
+public:
+    explicit FlexDeviceIdDatabase(const std::vector<std::string>& candidatePaths);
+    
+    // 系统 pci.ids / usb.ids 的进程级单例, 首次调用时映射并建立索引
+    static const FlexDeviceIdDatabase& flexPCI();
+    static const FlexDeviceIdDatabase& flexUSB();
+    
+    bool isAvailable() const { return flexFile.isOpen(); }
+    
+    // 未找到时返回空视图
+    std::string_view vendorName(uint16_t vendor) const;
+    std::string_view deviceName(uint16_t vendor, uint16_t device) const;
+    std::string_view className(uint8_t classCode) const;
+    std::string_view subclassName(uint8_t classCode, uint8_t subclass) const;
+    
+private:
+    // key 高位为记录类别, 低位为 ID; 名称以 (offset, length) 指向映射区
+    struct FlexIdEntry {
+        uint64_t key;
+        uint32_t offset;
+        uint32_t length;
+    };
+    
+    FlexMappedFile flexFile;
+    std::vector<FlexIdEntry> flexIndex;
+    
+    void flexBuildIndex();
+    std::string_view flexLookup(uint64_t key) const;
+};
+
+// 遍历 /sys/bus/pci/devices, 格式类似 lspci: "槽位 类别: 厂商 设备 [vvvv:dddd]"
+std::vector<std::string> flexEnumeratePCIDevices(const std::string& sysfsRoot = "/sys/bus/pci/devices");
+
+// 遍历 /sys/bus/usb/devices, 格式类似 lsusb: "Bus 001 Device 002: ID vvvv:pppp 厂商 产品"
+std::vector<std::string> flexEnumerateUSBDevices(const std::string& sysfsRoot = "/sys/bus/usb/devices");
+
+} // namespace FlexTools
+
+#endif // FLEX_DEVICE_IDS_H
@@ -0,0 +1,271 @@
+#include "flex_disk_collector.h"
+#include "flex_proc_file.h"
+#include <sys/statvfs.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace FlexTools {
+
+namespace {
+
+enum class FlexMountState {
+    PENDING,
+    RUNNING,
+    DONE,
+    STALE
+};
+
+// 工作线程与主线程共享的状态; 挂死在 statvfs 中的线程被分离,
+// 通过 shared_ptr 保证其返回时状态仍然有效
+struct FlexStatvfsJob {
+    std::vector<FlexMountEntry> mounts;
+    std::vector<FlexDiskInfo> results;
+    std::vector<FlexMountState> states;
+    std::vector<std::chrono::steady_clock::time_point> started;
+    size_t next = 0;
+    size_t finished = 0;
+    size_t activeWorkers = 0;
+    std::mutex mutex;
+    std::condition_variable cv;
+};
+
+void flexFillUsage(FlexDiskInfo& disk, const struct statvfs& vfs) {
+    // 与 df 一致: used = blocks - bfree, 可用空间取非特权用户可用的 bavail
+    unsigned long long unit = vfs.f_frsize ? vfs.f_frsize : vfs.f_bsize;
+    disk.total = static_cast<long long>((vfs.f_blocks * unit) / 1024);
+    disk.used = static_cast<long long>(((vfs.f_blocks - vfs.f_bfree) * unit) / 1024);
+    disk.free = static_cast<long long>((vfs.f_bavail * unit) / 1024);
+    
+    long long denominator = disk.used + disk.free;
+    if (denominator > 0) {
+        disk.usagePercent = static_cast<int>((disk.used * 100 + denominator - 1) / denominator);
+    }
+    
+    disk.inodesTotal = static_cast<long long>(vfs.f_files);
+    disk.inodesFree = static_cast<long long>(vfs.f_ffree);
+    disk.inodesUsed = disk.inodesTotal - disk.inodesFree;
+    if (disk.inodesTotal > 0) {
+        disk.inodeUsagePercent = static_cast<int>((disk.inodesUsed * 100.0) / disk.inodesTotal);
+    }
+}
+
+void flexStatvfsWorker(std::shared_ptr<FlexStatvfsJob> job) {
+    std::unique_lock<std::mutex> lock(job->mutex);
+    while (job->next < job->mounts.size()) {
+        size_t index = job->next++;
+        job->states[index] = FlexMountState::RUNNING;
+        job->started[index] = std::chrono::steady_clock::now();
+        std::string path = job->mounts[index].mountPoint;
+        lock.unlock();
+        
+        struct statvfs vfs;
+        int rc = statvfs(path.c_str(), &vfs);
+        
+        lock.lock();
+        if (job->states[index] == FlexMountState::STALE) {
+            // 主线程已判定超时并补充了新的工作线程, 本线程直接退出
+            return;
+        }
+        if (rc == 0) {
+            flexFillUsage(job->results[index], vfs);
+        }
+        job->states[index] = FlexMountState::DONE;
+        job->finished++;
+        job->cv.notify_all();
+    }
+    job->activeWorkers--;
+    job->cv.notify_all();
+}
+
+bool flexSpawnStatvfsWorker(const std::shared_ptr<FlexStatvfsJob>& job) {
+    try {
+        std::thread(flexStatvfsWorker, job).detach();
+    } catch (const std::system_error&) {
+        return false;
+    }
+    job->activeWorkers++;
+    return true;
+}
+
+} // namespace
+
+FlexDiskCollector::FlexDiskCollector(std::chrono::milliseconds timeout, size_t maxWorkers)
+    : flexTimeout(timeout), flexMaxWorkers(maxWorkers > 0 ? maxWorkers : 1) {
+}
+
+bool FlexDiskCollector::flexIsPseudoFilesystem(std::string_view fsType) {
+    static const std::string_view pseudoTypes[] = {
+        "proc", "sysfs", "devtmpfs", "tmpfs", "devpts", "cgroup", "cgroup2",
+        "mqueue", "debugfs", "tracefs", "securityfs", "pstore", "bpf",
+        "configfs", "fusectl", "hugetlbfs", "autofs", "binfmt_misc", "nsfs",
+        "rpc_pipefs", "selinuxfs", "efivarfs", "ramfs", "overlay_internal"
+    };
+    for (const auto& type : pseudoTypes) {
+        if (fsType == type) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string FlexDiskCollector::flexUnescapeMountField(std::string_view field) {
+    // 内核以 \040 形式转义空格、制表符、换行和反斜杠
+    std::string result;
+    result.reserve(field.size());
+    for (size_t i = 0; i < field.size(); ++i) {
+        if (field[i] == '\\' && i + 3 < field.size() &&
+            field[i + 1] >= '0' && field[i + 1] <= '7' &&
+            field[i + 2] >= '0' && field[i + 2] <= '7' &&
+            field[i + 3] >= '0' && field[i + 3] <= '7') {
+            result.push_back(static_cast<char>(((field[i + 1] - '0') << 6) |
+                                               ((field[i + 2] - '0') << 3) |
+                                               (field[i + 3] - '0')));
+            i += 3;
+        } else {
+            result.push_back(field[i]);
+        }
+    }
+    return result;
+}
+
+std::vector<FlexMountEntry> FlexDiskCollector::flexParseMountInfo(std::string_view content) {
+    std::vector<FlexMountEntry> mounts;
+    std::unordered_map<std::string, size_t> byMountPoint;
+    
+    while (!content.empty()) {
+        size_t eol = content.find('\n');
+        std::string_view line = content.substr(0, eol);
+        content.remove_prefix(eol == std::string_view::npos ? content.size() : eol + 1);
+        
+        // 格式: id parent major:minor root mountpoint options [optional...] - fstype source superopts
+        std::string_view fields[6];
+        size_t fieldCount = 0;
+        std::string_view fsType;
+        std::string_view source;
+        bool afterSeparator = false;
+        size_t afterCount = 0;
+        
+        while (!line.empty()) {
+            size_t space = line.find(' ');
+            std::string_view token = line.substr(0, space);
+            line.remove_prefix(space == std::string_view::npos ? line.size() : space + 1);
+            if (token.empty()) continue;
+            
+            if (afterSeparator) {
+                if (afterCount == 0) fsType = token;
+                else if (afterCount == 1) source = token;
+                afterCount++;
+            } else if (fieldCount < 6) {
+                fields[fieldCount++] = token;
+            } else if (token == "-") {
+                afterSeparator = true;
+            }
+        }
+        
+        if (fieldCount < 6 || !afterSeparator || fsType.empty()) {
+            continue;
+        }
+        if (flexIsPseudoFilesystem(fsType)) {
+            continue;
+        }
+        
+        FlexMountEntry entry;
+        entry.device = flexUnescapeMountField(source);
+        entry.mountPoint = flexUnescapeMountField(fields[4]);
+        entry.filesystem = std::string(fsType);
+        
+        // 同一挂载点被多次挂载时, 以最上层 (最后出现) 的为准
+        auto it = byMountPoint.find(entry.mountPoint);
+        if (it != byMountPoint.end()) {
+            mounts[it->second] = std::move(entry);
+        } else {
+            byMountPoint.emplace(entry.mountPoint, mounts.size());
+            mounts.push_back(std::move(entry));
+        }
+    }
+    
+    return mounts;
+}
+
+std::vector<FlexDiskInfo> FlexDiskCollector::collect() const {
+    std::vector<FlexDiskInfo> disks;
+    std::string content;
+    if (!flexReadWholeFile("/proc/self/mountinfo", content)) {
+        return disks;
+    }
+    
+    auto job = std::make_shared<FlexStatvfsJob>();
+    job->mounts = flexParseMountInfo(content);
+    size_t count = job->mounts.size();
+    if (count == 0) {
+        return disks;
+    }
+    
+    job->results.resize(count);
+    job->states.assign(count, FlexMountState::PENDING);
+    job->started.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        FlexDiskInfo& disk = job->results[i];
+        disk = FlexDiskInfo{};
+        disk.device = job->mounts[i].device;
+        disk.mountPoint = job->mounts[i].mountPoint;
+        disk.filesystem = job->mounts[i].filesystem;
+    }
+    
+    std::unique_lock<std::mutex> lock(job->mutex);
+    size_t workers = std::min(flexMaxWorkers, count);
+    for (size_t i = 0; i < workers; ++i) {
+        flexSpawnStatvfsWorker(job);
+    }
+    
+    while (job->finished < count) {
+        // 无可用工作线程时剩余挂载无法推进, 全部记为 stale
+        if (job->activeWorkers == 0) {
+            for (size_t i = 0; i < count; ++i) {
+                if (job->states[i] == FlexMountState::PENDING) {
+                    job->states[i] = FlexMountState::STALE;
+                    job->results[i].stale = true;
+                    job->finished++;
+                }
+            }
+            job->next = count;
+            break;
+        }
+        
+        auto now = std::chrono::steady_clock::now();
+        auto deadline = now + flexTimeout;
+        for (size_t i = 0; i < count; ++i) {
+            if (job->states[i] == FlexMountState::RUNNING) {
+                deadline = std::min(deadline, job->started[i] + flexTimeout);
+            }
+        }
+        job->cv.wait_until(lock, deadline);
+        
+        now = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < count; ++i) {
+            if (job->states[i] == FlexMountState::RUNNING &&
+                now - job->started[i] >= flexTimeout) {
+                job->states[i] = FlexMountState::STALE;
+                job->results[i].stale = true;
+                job->finished++;
+                job->activeWorkers--;
+                if (job->next < count) {
+                    flexSpawnStatvfsWorker(job);
+                }
+            }
+        }
+    }
+    
+    // 与 df 默认行为一致, 跳过容量为 0 的文件系统
+    disks.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        if (job->results[i].stale || job->results[i].total > 0) {
+            disks.push_back(job->results[i]);
+        }
+    }
+    return disks;
+}
+
+} // namespace FlexTools
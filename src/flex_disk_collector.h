@@ -0,0 +1,41 @@
+#ifndef FLEX_DISK_COLLECTOR_H
+#define FLEX_DISK_COLLECTOR_H
+
+#include "flex_common.h"
+#include "flex_hardware_info.h"
+#include <chrono>
+#include <string_view>
+
+namespace FlexTools {
+
+// /proc/self/mountinfo 中的一条挂载记录
+struct FlexMountEntry {
+    std::string device;
+    std::string mountPoint;
+    std::string filesystem;
+};
+
+// 原生磁盘信息收集器: 读取一次 mountinfo, 用小型线程池并行 statvfs,
+// 超过单挂载点超时时间的挂载 (如挂死的 NFS) 标记为 stale, 不阻塞其他结果
+class FlexDiskCollector {
+public:
+    explicit FlexDiskCollector(std::chrono::milliseconds timeout = std::chrono::milliseconds(2000),
+                               size_t maxWorkers = 8);
+    
+    // 收集所有真实文件系统的使用信息
+    std::vector<FlexDiskInfo> collect() const;
+    
+    // 解析 mountinfo 内容, 过滤伪文件系统并按挂载点去重
+    static std::vector<FlexMountEntry> flexParseMountInfo(std::string_view content);
+    
+private:
+    std::chrono::milliseconds flexTimeout;
+    size_t flexMaxWorkers;
+    
+    static bool flexIsPseudoFilesystem(std::string_view fsType);
+    static std::string flexUnescapeMountField(std::string_view field);
+};
+
+} // namespace FlexTools
+
+#endif // FLEX_DISK_COLLECTOR_H
@@ -0,0 +1,316 @@
+#include "flex_file_owner_index.h"
+#include "flex_mapped_file.h"
+#include <dirent.h>
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+namespace FlexTools {
+
+namespace {
+
+// 每轮最多解析的 .list 文件数, 轮次之间合并并释放临时缓冲
+constexpr size_t FLEX_OWNER_ROUND_FILES = 512;
+constexpr size_t FLEX_OWNER_MAX_WORKERS = 8;
+
+uint64_t flexHashBytes(std::string_view text) {
+    uint64_t hash = 1469598103934665603ULL;
+    for (char c : text) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+uint64_t flexHashKey(uint32_t directory, uint64_t nameHash) {
+    uint64_t hash = nameHash ^ (static_cast<uint64_t>(directory) * 0x9E3779B97F4A7C15ULL);
+    hash ^= hash >> 31;
+    hash *= 0xBF58476D1CE4E5B9ULL;
+    hash ^= hash >> 29;
+    return hash;
+}
+
+// "/usr/lib/x.so" -> ("/usr/lib", "x.so"); "/usr" -> ("/", "usr")
+bool flexSplitPath(std::string_view path, std::string_view& directory, std::string_view& name) {
+    size_t slash = path.rfind('/');
+    if (slash == std::string_view::npos || slash + 1 == path.size()) {
+        return false;
+    }
+    directory = slash == 0 ? std::string_view("/") : path.substr(0, slash);
+    name = path.substr(slash + 1);
+    return true;
+}
+
+// 合并重复斜杠并去掉结尾斜杠
+std::string flexNormalizePath(const std::string& path) {
+    std::string normalized;
+    normalized.reserve(path.size());
+    for (char c : path) {
+        if (c == '/' && !normalized.empty() && normalized.back() == '/') continue;
+        normalized.push_back(c);
+    }
+    while (normalized.size() > 1 && normalized.back() == '/') {
+        normalized.pop_back();
+    }
+    return normalized;
+}
+
+// usrmerge 系统上 /bin、/lib 等是 /usr 下的符号链接, 包列表可能只记录其中一种写法
+std::string flexUsrMergeAlias(const std::string& path) {
+    static const char* merged[] = {"/bin/", "/sbin/", "/lib/", "/lib32/", "/lib64/", "/libx32/"};
+    for (const char* prefix : merged) {
+        if (path.compare(0, std::strlen(prefix), prefix) == 0) {
+            return "/usr" + path;
+        }
+        if (path.compare(0, 4, "/usr") == 0 && path.compare(4, std::strlen(prefix), prefix) == 0) {
+            return path.substr(4);
+        }
+    }
+    return "";
+}
+
+// 单个工作线程一轮的解析结果
+struct FlexListChunk {
+    struct Line {
+        uint32_t offset;        // 在 text 中的起点
+        uint32_t directoryLength;
+        uint32_t nameLength;    // 文件名紧跟在目录与 '/' 之后
+        uint32_t package;
+        uint64_t nameHash;
+    };
+    
+    std::string text;
+    std::vector<Line> lines;
+};
+
+void flexParseListFile(const std::string& path, uint32_t package, FlexListChunk& chunk) {
+    FlexMappedFile file(path);
+    if (!file.isOpen()) {
+        return;
+    }
+    
+    std::string_view content = file.view();
+    while (!content.empty()) {
+        size_t end = content.find('\n');
+        std::string_view line = content.substr(0, end);
+        content.remove_prefix(end == std::string_view::npos ? content.size() : end + 1);
+        
+        std::string_view directory;
+        std::string_view name;
+        if (line == "/." || !flexSplitPath(line, directory, name)) {
+            continue;
+        }
+        
+        FlexListChunk::Line entry;
+        entry.offset = static_cast<uint32_t>(chunk.text.size());
+        entry.directoryLength = static_cast<uint32_t>(directory.size());
+        entry.nameLength = static_cast<uint32_t>(name.size());
+        entry.package = package;
+        entry.nameHash = flexHashBytes(name);
+        chunk.text.append(directory);
+        chunk.text.push_back('/');
+        chunk.text.append(name);
+        chunk.lines.push_back(entry);
+    }
+}
+
+} // namespace
+
+FlexFileOwnerIndex::FlexFileOwnerIndex(const std::string& infoDir)
+    : flexInfoDir(infoDir) {
+    if (!flexInfoDir.empty() && flexInfoDir.back() != '/') {
+        flexInfoDir += '/';
+    }
+}
+
+bool FlexFileOwnerIndex::build(size_t workers) {
+    flexPackages.clear();
+    flexDirectoryIds.clear();
+    flexNamePool.clear();
+    flexEntries.assign(1, Entry{});
+    flexSlots.assign(1024, 0);
+    flexUniquePaths = 0;
+    
+    DIR* dir = opendir(flexInfoDir.c_str());
+    if (dir == nullptr) {
+        return false;
+    }
+    std::vector<std::string> listFiles;
+    while (struct dirent* entry = readdir(dir)) {
+        std::string name = entry->d_name;
+        if (name.size() > 5 && name.compare(name.size() - 5, 5, ".list") == 0) {
+            listFiles.push_back(name);
+        }
+    }
+    closedir(dir);
+    std::sort(listFiles.begin(), listFiles.end());
+    
+    // 包名取自文件名, 去掉 ".list" 与多架构 ":arch" 后缀
+    for (const auto& name : listFiles) {
+        std::string package = name.substr(0, name.size() - 5);
+        size_t colon = package.find(':');
+        flexPackages.push_back(colon == std::string::npos ? package : package.substr(0, colon));
+    }
+    
+    if (workers == 0) {
+        workers = std::max(1u, std::thread::hardware_concurrency());
+    }
+    workers = std::min(workers, FLEX_OWNER_MAX_WORKERS);
+    
+    std::vector<FlexListChunk> chunks(workers);
+    for (size_t roundStart = 0; roundStart < listFiles.size(); roundStart += FLEX_OWNER_ROUND_FILES) {
+        size_t roundEnd = std::min(listFiles.size(), roundStart + FLEX_OWNER_ROUND_FILES);
+        std::atomic<size_t> next{roundStart};
+        
+        auto work = [&](FlexListChunk& chunk) {
+            for (size_t i = next++; i < roundEnd; i = next++) {
+                flexParseListFile(flexInfoDir + listFiles[i], static_cast<uint32_t>(i), chunk);
+            }
+        };
+        
+        std::vector<std::thread> threads;
+        for (size_t w = 1; w < workers; ++w) {
+            threads.emplace_back(work, std::ref(chunks[w]));
+        }
+        work(chunks[0]);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        
+        // 串行合并: 目录去重并插入哈希表, 然后释放本轮缓冲
+        for (auto& chunk : chunks) {
+            std::string_view previousDirectory;
+            uint32_t previousId = 0;
+            for (const auto& line : chunk.lines) {
+                std::string_view directory(chunk.text.data() + line.offset, line.directoryLength);
+                std::string_view name(chunk.text.data() + line.offset + line.directoryLength + 1, line.nameLength);
+                
+                // .list 中同一目录的文件通常相邻
+                if (previousDirectory.data() == nullptr || directory != previousDirectory) {
+                    previousId = flexInternDirectory(directory);
+                    previousDirectory = directory;
+                }
+                
+                uint32_t* slot = flexSlot(previousId, name, line.nameHash);
+                uint32_t index = static_cast<uint32_t>(flexEntries.size());
+                if (*slot != 0) {
+                    Entry& head = flexEntries[*slot];
+                    flexEntries.push_back(Entry{previousId, head.nameOffset, head.nameLength, line.package, head.next});
+                    flexEntries[*slot].next = index;
+                } else {
+                    *slot = index;
+                    flexEntries.push_back(Entry{previousId, static_cast<uint32_t>(flexNamePool.size()),
+                                                line.nameLength, line.package, 0});
+                    flexNamePool.append(name);
+                    if (++flexUniquePaths * 2 > flexSlots.size()) {
+                        flexGrow();
+                    }
+                }
+            }
+            std::string().swap(chunk.text);
+            std::vector<FlexListChunk::Line>().swap(chunk.lines);
+        }
+    }
+    
+    return true;
+}
+
+uint32_t FlexFileOwnerIndex::flexInternDirectory(std::string_view directory) {
+    auto result = flexDirectoryIds.emplace(std::string(directory), static_cast<uint32_t>(flexDirectoryIds.size()));
+    return result.first->second;
+}
+
+size_t FlexFileOwnerIndex::flexFindSlot(uint32_t directory, std::string_view name, uint64_t nameHash) const {
+    size_t mask = flexSlots.size() - 1;
+    size_t position = flexHashKey(directory, nameHash) & mask;
+    while (flexSlots[position] != 0) {
+        const Entry& entry = flexEntries[flexSlots[position]];
+        if (entry.directory == directory &&
+            std::string_view(flexNamePool.data() + entry.nameOffset, entry.nameLength) == name) {
+            break;
+        }
+        position = (position + 1) & mask;
+    }
+    return position;
+}
+
+uint32_t* FlexFileOwnerIndex::flexSlot(uint32_t directory, std::string_view name, uint64_t nameHash) {
+    return &flexSlots[flexFindSlot(directory, name, nameHash)];
+}
+
+void FlexFileOwnerIndex::flexGrow() {
+    std::vector<uint32_t> old;
+    old.swap(flexSlots);
+    flexSlots.assign(old.size() * 2, 0);
+    size_t mask = flexSlots.size() - 1;
+    for (uint32_t head : old) {
+        if (head == 0) continue;
+        const Entry& entry = flexEntries[head];
+        uint64_t nameHash = flexHashBytes(std::string_view(flexNamePool.data() + entry.nameOffset, entry.nameLength));
+        size_t position = flexHashKey(entry.directory, nameHash) & mask;
+        while (flexSlots[position] != 0) {
+            position = (position + 1) & mask;
+        }
+        flexSlots[position] = head;
+    }
+}
+
+void FlexFileOwnerIndex::flexLookup(uint32_t directory, std::string_view name, std::vector<std::string>& out) const {
+    uint32_t index = flexSlots[flexFindSlot(directory, name, flexHashBytes(name))];
+    for (; index != 0; index = flexEntries[index].next) {
+        const std::string& package = flexPackages[flexEntries[index].package];
+        if (std::find(out.begin(), out.end(), package) == out.end()) {
+            out.push_back(package);
+        }
+    }
+}
+
+std::vector<std::string> FlexFileOwnerIndex::owners(const std::string& path) const {
+    return resolve({path}).begin()->second;
+}
+
+std::map<std::string, std::vector<std::string>> FlexFileOwnerIndex::resolve(const std::vector<std::string>& paths) const {
+    std::map<std::string, std::vector<std::string>> result;
+    if (flexSlots.empty()) {
+        for (const auto& path : paths) {
+            result[path];
+        }
+        return result;
+    }
+    
+    std::string previousDirectory;
+    auto previousId = flexDirectoryIds.end();
+    
+    auto lookupPath = [&](const std::string& path, std::vector<std::string>& out) {
+        std::string_view directory;
+        std::string_view name;
+        if (!flexSplitPath(path, directory, name)) {
+            return;
+        }
+        if (previousId == flexDirectoryIds.end() || directory != previousDirectory) {
+            previousDirectory.assign(directory);
+            previousId = flexDirectoryIds.find(previousDirectory);
+            if (previousId == flexDirectoryIds.end()) {
+                previousDirectory.clear();
+                return;
+            }
+        }
+        flexLookup(previousId->second, name, out);
+    };
+    
+    for (const auto& path : paths) {
+        std::vector<std::string>& owners = result[path];
+        std::string normalized = flexNormalizePath(path);
+        lookupPath(normalized, owners);
+        if (owners.empty()) {
+            std::string alias = flexUsrMergeAlias(normalized);
+            if (!alias.empty()) {
+                lookupPath(alias, owners);
+            }
+        }
+        std::sort(owners.begin(), owners.end());
+    }
+    return result;
+}
+
+} // namespace FlexTools
@@ -0,0 +1,56 @@
+#ifndef FLEX_FILE_OWNER_INDEX_H
+#define FLEX_FILE_OWNER_INDEX_H
+
+#include "flex_common.h"
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+
+namespace FlexTools {
+
+// 文件 -> 所属包 反向索引, 由 dpkg info/*.list 并行构建.
+// 目录前缀全局去重, 文件名存于单一字符池, 每条记录 20 字节, 百万级文件也能控制内存.
+class FlexFileOwnerIndex {
+public:
+    explicit FlexFileOwnerIndex(const std::string& infoDir = "/var/lib/dpkg/info/");
+    
+    // 读取全部 .list 文件; workers 为 0 时按 CPU 数决定
+    bool build(size_t workers = 0);
+    
+    size_t fileCount() const { return flexEntries.size(); }
+    size_t directoryCount() const { return flexDirectoryIds.size(); }
+    size_t packageCount() const { return flexPackages.size(); }
+    
+    // 单个路径的所属包, 未找到时为空
+    std::vector<std::string> owners(const std::string& path) const;
+    
+    // 批量解析, 相邻路径共享目录查找
+    std::map<std::string, std::vector<std::string>> resolve(const std::vector<std::string>& paths) const;
+    
+private:
+    struct Entry {
+        uint32_t directory;
+        uint32_t nameOffset;
+        uint32_t nameLength;
+        uint32_t package;
+        uint32_t next; // 同一路径的下一个所属包, 0 表示结束
+    };
+    
+    std::string flexInfoDir;
+    std::vector<std::string> flexPackages;
+    std::unordered_map<std::string, uint32_t> flexDirectoryIds;
+    std::string flexNamePool;
+    std::vector<Entry> flexEntries;  // 下标 0 保留为空
+    std::vector<uint32_t> flexSlots; // 开放寻址表, 存放路径首条记录下标
+    size_t flexUniquePaths = 0;
+    
+    uint32_t flexInternDirectory(std::string_view directory);
+    size_t flexFindSlot(uint32_t directory, std::string_view name, uint64_t nameHash) const;
+    uint32_t* flexSlot(uint32_t directory, std::string_view name, uint64_t nameHash);
+    void flexLookup(uint32_t directory, std::string_view name, std::vector<std::string>& out) const;
+    void flexGrow();
+};
+
+} // namespace FlexTools
+
+#endif // FLEX_FILE_OWNER_INDEX_H
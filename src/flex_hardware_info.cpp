@@ -1,17 +1,24 @@
 #include "flex_hardware_info.h"
+#include "flex_disk_collector.h"
+#include "flex_netlink_collector.h"
+#include "flex_cpu_topology.h"
+#include "flex_cpu_sampler.h"
+#include "flex_sensor_index.h"
+#include "flex_device_ids.h"
 #include <fstream>
 #include <sstream>
 #include <iomanip>
 #include <array>
 #include <memory>
 #include <sys/sysinfo.h>
-#include <sys/statvfs.h>
+#include <sys/utsname.h>
 #include <ifaddrs.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <net/if.h>
 #include <dirent.h>
 #include <unistd.h>
+#include <unordered_set>
 
 namespace FlexTools {
 
@@ -39,6 +46,33 @@ std::vector<FlexNetworkInterface> FlexHardwareInfo::getNetworkInfo() const {
     return flexNetworkInfoCache;
 }
 
+std::vector<std::string> FlexHardwareInfo::getUSBDevices() const {
+    return flexEnumerateUSBDevices();
+}
+
+std::vector<std::string> FlexHardwareInfo::getPCIDevices() const {
+    return flexEnumeratePCIDevices();
+}
+
+std::map<std::string, double> FlexHardwareInfo::getTemperatureInfo() const {
+    return flexEnsureSensorIndex().readTemperatures();
+}
+
+std::map<std::string, int> FlexHardwareInfo::getFanInfo() const {
+    return flexEnsureSensorIndex().readFans();
+}
+
+std::map<std::string, std::string> FlexHardwareInfo::getBatteryInfo() const {
+    return flexEnsureSensorIndex().readBattery();
+}
+
+const FlexSensorIndex& FlexHardwareInfo::flexEnsureSensorIndex() const {
+    if (!flexSensorIndex) {
+        flexSensorIndex = std::make_shared<FlexSensorIndex>();
+    }
+    return *flexSensorIndex;
+}
+
 void FlexHardwareInfo::flexEnsureCache() const {
     if (flexCacheValid) {
         return;
@@ -51,139 +85,67 @@ void FlexHardwareInfo::flexEnsureCache() const {
     flexParseMemoryInfo(flexMemoryInfoCache);
     
     // 解析磁盘信息
-    flexDiskInfoCache.clear();
-    std::array<char, 1024> buffer;
-    std::unique_ptr<FILE, decltype(&pclose)> pipe(popen("df -k 2>/dev/null", "r"), pclose);
-    
-    if (pipe) {
-        bool firstLine = true;
-        while (fgets(buffer.data(), buffer.size(), pipe.get()) != nullptr) {
-            std::string line = buffer.data();
-            if (firstLine) {
-                firstLine = false;
-                continue;
-            }
-            
-            FlexDiskInfo disk = flexParseDiskLine(line);
-            if (!disk.device.empty() && disk.device != "tmpfs" && 
-                disk.device != "devtmpfs" && disk.device != "udev") {
-                flexDiskInfoCache.push_back(disk);
-            }
-        }
-    }
+    flexDiskInfoCache = FlexDiskCollector().collect();
     
-    // 解析网络信息
+    // 解析网络信息: 优先 netlink 一次 dump, 不可用时回退到 getifaddrs + sysfs
     flexNetworkInfoCache.clear();
-    struct ifaddrs *ifaddr, *ifa;
-    if (getifaddrs(&ifaddr) == 0) {
-        for (ifa = ifaddr; ifa != NULL; ifa = ifa->ifa_next) {
-            if (ifa->ifa_addr == NULL) continue;
-            
-            std::string ifName = ifa->ifa_name;
-            // 检查是否已存在该接口
-            bool exists = false;
-            for (const auto& ni : flexNetworkInfoCache) {
-                if (ni.name == ifName) {
-                    exists = true;
-                    break;
-                }
-            }
-            
-            if (!exists) {
-                FlexNetworkInterface ni = flexParseNetworkInterface(ifName);
-                if (!ni.name.empty()) {
-                    flexNetworkInfoCache.push_back(ni);
+    if (!FlexNetlinkCollector().collect(flexNetworkInfoCache)) {
+        flexNetworkInfoCache.clear();
+        struct ifaddrs *ifaddr, *ifa;
+        if (getifaddrs(&ifaddr) == 0) {
+            std::unordered_set<std::string> seen;
+            for (ifa = ifaddr; ifa != NULL; ifa = ifa->ifa_next) {
+                if (ifa->ifa_addr == NULL) continue;
+                
+                std::string ifName = ifa->ifa_name;
+                if (seen.insert(ifName).second) {
+                    FlexNetworkInterface ni = flexParseNetworkInterface(ifName);
+                    if (!ni.name.empty()) {
+                        flexNetworkInfoCache.push_back(ni);
+                    }
                 }
             }
+            freeifaddrs(ifaddr);
         }
-        freeifaddrs(ifaddr);
     }
     
     flexCacheValid = true;
 }
 
 void FlexHardwareInfo::flexParseCPUInfo(FlexCPUInfo& cpu) const {
-    std::ifstream cpuinfo("/proc/cpuinfo");
-    if (!cpuinfo.is_open()) {
-        return;
-    }
+    // cpuinfo 与拓扑在进程内只解析一次, 与系统信息模块共享
+    const FlexCPUTopology& topology = flexGetCPUTopology();
+    cpu.model = topology.model;
+    cpu.vendor = topology.vendor;
+    cpu.sockets = topology.sockets;
+    cpu.cores = topology.physicalCores;
+    cpu.threads = topology.logicalCPUs;
+    cpu.flags = topology.flags;
+    cpu.cacheSize = topology.cacheSize;
+    cpu.clockSpeed = topology.cpuMHz / 1000.0;
     
-    std::string line;
-    int processorCount = 0;
-    int physicalCores = 0;
-    bool hyperthreading = false;
+    // 获取架构信息
+    struct utsname unameData;
+    if (uname(&unameData) == 0) {
+        cpu.architecture = unameData.machine;
+    }
     
-    while (std::getline(cpuinfo, line)) {
-        if (line.find("processor") != std::string::npos) {
-            processorCount++;
-        }
-        
-        if (line.find("model name") != std::string::npos) {
-            size_t colonPos = line.find(':');
-            if (colonPos != std::string::npos) {
-                cpu.model = line.substr(colonPos + 2);
-            }
-        } else if (line.find("vendor_id") != std::string::npos) {
-            size_t colonPos = line.find(':');
-            if (colonPos != std::string::npos) {
-                cpu.vendor = line.substr(colonPos + 2);
-            }
-        } else if (line.find("cpu cores") != std::string::npos) {
-            size_t colonPos = line.find(':');
-            if (colonPos != std::string::npos) {
-                physicalCores = std::stoi(line.substr(colonPos + 2));
-                cpu.cores = physicalCores;
-            }
-        } else if (line.find("siblings") != std::string::npos) {
-            size_t colonPos = line.find(':');
-            if (colonPos != std::string::npos) {
-                cpu.threads = std::stoi(line.substr(colonPos + 2));
-                hyperthreading = (cpu.threads > physicalCores);
-            }
-        } else if (line.find("flags") != std::string::npos) {
-            size_t colonPos = line.find(':');
-            if (colonPos != std::string::npos) {
-                std::string flagsStr = line.substr(colonPos + 2);
-                std::istringstream iss(flagsStr);
-                std::string flag;
-                while (iss >> flag) {
-                    cpu.flags.push_back(flag);
-                }
-            }
-        } else if (line.find("cache size") != std::string::npos) {
-            size_t colonPos = line.find(':');
-            if (colonPos != std::string::npos) {
-                std::string cacheStr = line.substr(colonPos + 2);
-                size_t spacePos = cacheStr.find(' ');
-                if (spacePos != std::string::npos) {
-                    cpu.cacheSize = std::stoi(cacheStr.substr(0, spacePos));
-                }
+    // 获取每个核心的当前频率, 整机频率取各核平均值
+    FlexCPUSampler sampler;
+    if (sampler.sample()) {
+        double sum = 0.0;
+        int counted = 0;
+        cpu.coreClockSpeeds.clear();
+        for (double mhz : sampler.frequencies()) {
+            cpu.coreClockSpeeds.push_back(mhz / 1000.0);
+            if (mhz > 0.0) {
+                sum += mhz;
+                counted++;
             }
         }
-    }
-    cpuinfo.close();
-    
-    // 获取架构信息
-    std::array<char, 128> buffer;
-    std::string result;
-    std::unique_ptr<FILE, decltype(&pclose)> pipe(popen("uname -m", "r"), pclose);
-    if (pipe) {
-        while (fgets(buffer.data(), buffer.size(), pipe.get()) != nullptr) {
-            result += buffer.data();
+        if (counted > 0) {
+            cpu.clockSpeed = sum / counted / 1000.0;
         }
-        cpu.architecture = result;
-        cpu.architecture.erase(std::remove(cpu.architecture.begin(), 
-                                         cpu.architecture.end(), '\n'), 
-                             cpu.architecture.end());
-    }
-    
-    // 获取时钟速度
-    std::ifstream cpuMHz("/sys/devices/system/cpu/cpu0/cpufreq/scaling_cur_freq");
-    if (cpuMHz.is_open()) {
-        double mhz;
-        cpuMHz >> mhz;
-        cpuMHz.close();
-        cpu.clockSpeed = mhz / 1000.0; // 转换为GHz
     }
 }
 
@@ -221,82 +183,14 @@ void FlexHardwareInfo::flexParseMemoryInfo(FlexMemoryInfo& mem) const {
     meminfo.close();
 }
 
-FlexDiskInfo FlexHardwareInfo::flexParseDiskLine(const std::string& line) const {
-    FlexDiskInfo disk;
-    std::istringstream iss(line);
-    
-    iss >> disk.device;
-    
-    // 跳过非磁盘设备
-    if (disk.device.empty() || disk.device.find("://") != std::string::npos) {
-        return disk;
-    }
-    
-    long long blocks;
-    iss >> blocks;
-    disk.total = blocks;
-    
-    iss >> blocks;
-    disk.used = blocks;
-    
-    iss >> blocks;
-    disk.free = blocks;
-    
-    std::string percentStr;
-    iss >> percentStr;
-    if (!percentStr.empty() && percentStr.back() == '%') {
-        disk.usagePercent = std::stoi(percentStr.substr(0, percentStr.size() - 1));
-    }
-    
-    // 获取挂载点
-    std::getline(iss, disk.mountPoint);
-    disk.mountPoint.erase(0, disk.mountPoint.find_first_not_of(" \t"));
-    
-    // 获取文件系统类型
-    std::string cmd = "df -T " + disk.device + " 2>/dev/null | tail -1 | awk '{print $2}'";
-    std::array<char, 128> buffer;
-    std::string result;
-    std::unique_ptr<FILE, decltype(&pclose)> pipe(popen(cmd.c_str(), "r"), pclose);
-    if (pipe) {
-        if (fgets(buffer.data(), sizeof(buffer), pipe.get()) != nullptr) {
-            disk.filesystem = buffer.data();
-            disk.filesystem.erase(std::remove(disk.filesystem.begin(), 
-                                            disk.filesystem.end(), '\n'), 
-                                disk.filesystem.end());
-        }
-    }
-    
-    // 获取inode信息
-    if (!disk.mountPoint.empty()) {
-        struct statvfs vfs;
-        if (statvfs(disk.mountPoint.c_str(), &vfs) == 0) {
-            disk.inodesTotal = vfs.f_files;
-            disk.inodesFree = vfs.f_ffree;
-            disk.inodesUsed = disk.inodesTotal - disk.inodesFree;
-            if (disk.inodesTotal > 0) {
-                disk.inodeUsagePercent = static_cast<int>((disk.inodesUsed * 100.0) / disk.inodesTotal);
-            }
-        }
-    }
-    
-    return disk;
-}
-
 FlexNetworkInterface FlexHardwareInfo::flexParseNetworkInterface(const std::string& name) const {
-    FlexNetworkInterface ni;
+    FlexNetworkInterface ni{};
     ni.name = name;
     
     // 获取MAC地址
-    std::string cmd = "cat /sys/class/net/" + name + "/address 2>/dev/null";
-    std::array<char, 128> buffer;
-    std::unique_ptr<FILE, decltype(&pclose)> pipe(popen(cmd.c_str(), "r"), pclose);
-    if (pipe) {
-        if (fgets(buffer.data(), sizeof(buffer), pipe.get()) != nullptr) {
-            ni.macAddress = buffer.data();
-            ni.macAddress.erase(std::remove(ni.macAddress.begin(), 
-                                          ni.macAddress.end(), '\n'), 
-                              ni.macAddress.end());
-        }
+    std::ifstream addressFile("/sys/class/net/" + name + "/address");
+    if (addressFile.is_open()) {
+        std::getline(addressFile, ni.macAddress);
     }
     
     // 获取网络统计信息
@@ -331,8 +225,9 @@ void FlexHardwareInfo::printAllInfo(FlexOutputFormat format) const {
         std::cout << FLEX_COLOR_YELLOW << "  Model: " << FLEX_COLOR_RESET << cpu.model << std::endl;
         std::cout << FLEX_COLOR_YELLOW << "  Vendor: " << FLEX_COLOR_RESET << cpu.vendor << std::endl;
         std::cout << FLEX_COLOR_YELLOW << "  Architecture: " << FLEX_COLOR_RESET << cpu.architecture << std::endl;
-        std::cout << FLEX_COLOR_YELLOW << "  Cores/Threads: " << FLEX_COLOR_RESET 
-                  << cpu.cores << " cores, " << cpu.threads << " threads" << std::endl;
+        std::cout << FLEX_COLOR_YELLOW << "  Sockets/Cores/Threads: " << FLEX_COLOR_RESET 
+                  << cpu.sockets << " sockets, " << cpu.cores << " cores, " 
+                  << cpu.threads << " threads" << std::endl;
         std::cout << FLEX_COLOR_YELLOW << "  Clock Speed: " << FLEX_COLOR_RESET 
                   << std::fixed << std::setprecision(2) << cpu.clockSpeed << " GHz" << std::endl;
         if (cpu.cacheSize > 0) {
@@ -375,6 +270,11 @@ void FlexHardwareInfo::printAllInfo(FlexOutputFormat format) const {
                 std::cout << FLEX_COLOR_YELLOW << "  Device: " << FLEX_COLOR_RESET << disk.device << std::endl;
                 std::cout << FLEX_COLOR_YELLOW << "  Mount Point: " << FLEX_COLOR_RESET << disk.mountPoint << std::endl;
                 std::cout << FLEX_COLOR_YELLOW << "  Filesystem: " << FLEX_COLOR_RESET << disk.filesystem << std::endl;
+                if (disk.stale) {
+                    std::cout << FLEX_COLOR_YELLOW << "  Status: " << FLEX_COLOR_RED << "stale" 
+                              << FLEX_COLOR_RESET << std::endl << std::endl;
+                    continue;
+                }
                 std::cout << FLEX_COLOR_YELLOW << "  Total: " << FLEX_COLOR_RESET 
                           << std::fixed << std::setprecision(2) 
                           << (disk.total / 1024.0 / 1024.0) << " GB" << std::endl;
@@ -398,6 +298,17 @@ void FlexHardwareInfo::printAllInfo(FlexOutputFormat format) const {
             if (!net.macAddress.empty() && net.macAddress != "00:00:00:00:00:00") {
                 std::cout << FLEX_COLOR_YELLOW << "  Interface: " << FLEX_COLOR_RESET << net.name << std::endl;
                 std::cout << FLEX_COLOR_YELLOW << "  MAC Address: " << FLEX_COLOR_RESET << net.macAddress << std::endl;
+                if (!net.ipAddress.empty()) {
+                    std::cout << FLEX_COLOR_YELLOW << "  IPv4 Address: " << FLEX_COLOR_RESET << net.ipAddress
+                              << " / " << net.netmask;
+                    if (!net.broadcast.empty()) {
+                        std::cout << " brd " << net.broadcast;
+                    }
+                    std::cout << std::endl;
+                }
+                if (!net.ipv6Address.empty()) {
+                    std::cout << FLEX_COLOR_YELLOW << "  IPv6 Address: " << FLEX_COLOR_RESET << net.ipv6Address << std::endl;
+                }
                 if (net.rxBytes > 0 || net.txBytes > 0) {
                     std::cout << FLEX_COLOR_YELLOW << "  RX/TX Bytes: " << FLEX_COLOR_RESET 
                               << (net.rxBytes / 1024.0 / 1024.0) << " MB / " 
@@ -406,6 +317,46 @@ void FlexHardwareInfo::printAllInfo(FlexOutputFormat format) const {
                 std::cout << std::endl;
             }
         }
+        
+        // PCI / USB 设备
+        auto pciDevices = getPCIDevices();
+        if (!pciDevices.empty()) {
+            std::cout << FLEX_COLOR_GREEN << "\n[PCI Devices]" << FLEX_COLOR_RESET << std::endl;
+            for (const auto& device : pciDevices) {
+                std::cout << "  " << device << std::endl;
+            }
+        }
+        auto usbDevices = getUSBDevices();
+        if (!usbDevices.empty()) {
+            std::cout << FLEX_COLOR_GREEN << "\n[USB Devices]" << FLEX_COLOR_RESET << std::endl;
+            for (const auto& device : usbDevices) {
+                std::cout << "  " << device << std::endl;
+            }
+        }
+        
+        // 传感器信息
+        auto temperatures = getTemperatureInfo();
+        auto fans = getFanInfo();
+        if (!temperatures.empty() || !fans.empty()) {
+            std::cout << FLEX_COLOR_GREEN << "\n[Sensors]" << FLEX_COLOR_RESET << std::endl;
+            for (const auto& [label, celsius] : temperatures) {
+                std::cout << FLEX_COLOR_YELLOW << "  " << label << ": " << FLEX_COLOR_RESET 
+                          << std::fixed << std::setprecision(1) << celsius << " °C" << std::endl;
+            }
+            for (const auto& [label, rpm] : fans) {
+                std::cout << FLEX_COLOR_YELLOW << "  " << label << ": " << FLEX_COLOR_RESET 
+                          << rpm << " RPM" << std::endl;
+            }
+        }
+        
+        // 电池信息
+        auto battery = getBatteryInfo();
+        if (!battery.empty()) {
+            std::cout << FLEX_COLOR_GREEN << "\n[Battery Information]" << FLEX_COLOR_RESET << std::endl;
+            for (const auto& [key, value] : battery) {
+                std::cout << FLEX_COLOR_YELLOW << "  " << key << ": " << FLEX_COLOR_RESET << value << std::endl;
+            }
+        }
     } else if (format == FlexOutputFormat::JSON) {
         std::cout << toJSON() << std::endl;
     } else if (format == FlexOutputFormat::CSV) {
@@ -429,9 +380,16 @@ std::string FlexHardwareInfo::toJSON() const {
     oss << "      \"model\": \"" << cpu.model << "\",\n";
     oss << "      \"vendor\": \"" << cpu.vendor << "\",\n";
     oss << "      \"architecture\": \"" << cpu.architecture << "\",\n";
+    oss << "      \"sockets\": " << cpu.sockets << ",\n";
     oss << "      \"cores\": " << cpu.cores << ",\n";
     oss << "      \"threads\": " << cpu.threads << ",\n";
     oss << "      \"clock_speed_ghz\": " << std::fixed << std::setprecision(2) << cpu.clockSpeed << ",\n";
+    oss << "      \"core_clock_speeds_ghz\": [";
+    for (size_t i = 0; i < cpu.coreClockSpeeds.size(); ++i) {
+        if (i > 0) oss << ", ";
+        oss << std::fixed << std::setprecision(2) << cpu.coreClockSpeeds[i];
+    }
+    oss << "],\n";
     oss << "      \"cache_size_kb\": " << cpu.cacheSize << "\n";
     oss << "    },\n";
     
@@ -458,7 +416,8 @@ std::string FlexHardwareInfo::toJSON() const {
         oss << "        \"filesystem\": \"" << disk.filesystem << "\",\n";
         oss << "        \"total_gb\": " << std::fixed << std::setprecision(2) << (disk.total / 1024.0 / 1024.0) << ",\n";
         oss << "        \"used_gb\": " << std::fixed << std::setprecision(2) << (disk.used / 1024.0 / 1024.0) << ",\n";
-        oss << "        \"usage_percent\": " << disk.usagePercent << "\n";
+        oss << "        \"usage_percent\": " << disk.usagePercent << ",\n";
+        oss << "        \"stale\": " << (disk.stale ? "true" : "false") << "\n";
         oss << "      }";
     }
     oss << "\n    ],\n";
@@ -473,11 +432,58 @@ std::string FlexHardwareInfo::toJSON() const {
         oss << "      {\n";
         oss << "        \"name\": \"" << net.name << "\",\n";
         oss << "        \"mac_address\": \"" << net.macAddress << "\",\n";
+        oss << "        \"ipv4_address\": \"" << net.ipAddress << "\",\n";
+        oss << "        \"netmask\": \"" << net.netmask << "\",\n";
+        oss << "        \"broadcast\": \"" << net.broadcast << "\",\n";
+        oss << "        \"ipv6_address\": \"" << net.ipv6Address << "\",\n";
         oss << "        \"rx_bytes\": " << net.rxBytes << ",\n";
-        oss << "        \"tx_bytes\": " << net.txBytes << "\n";
+        oss << "        \"tx_bytes\": " << net.txBytes << ",\n";
+        oss << "        \"rx_packets\": " << net.rxPackets << ",\n";
+        oss << "        \"tx_packets\": " << net.txPackets << ",\n";
+        oss << "        \"rx_errors\": " << net.rxErrors << ",\n";
+        oss << "        \"tx_errors\": " << net.txErrors << "\n";
         oss << "      }";
     }
-    oss << "\n    ]\n";
+    oss << "\n    ],\n";
+    
+    // PCI / USB 设备
+    auto writeDeviceList = [&oss](const char* key, const std::vector<std::string>& devices) {
+        oss << "    \"" << key << "\": [";
+        for (size_t i = 0; i < devices.size(); ++i) {
+            oss << (i == 0 ? "\n" : ",\n") << "      \"" << flexEscapeJSON(devices[i]) << "\"";
+        }
+        oss << (devices.empty() ? "],\n" : "\n    ],\n");
+    };
+    writeDeviceList("pci_devices", getPCIDevices());
+    writeDeviceList("usb_devices", getUSBDevices());
+    
+    // 传感器信息
+    oss << "    \"temperatures_celsius\": {";
+    bool firstSensor = true;
+    for (const auto& [label, celsius] : getTemperatureInfo()) {
+        oss << (firstSensor ? "\n" : ",\n");
+        firstSensor = false;
+        oss << "      \"" << label << "\": " << std::fixed << std::setprecision(1) << celsius;
+    }
+    oss << (firstSensor ? "},\n" : "\n    },\n");
+    
+    oss << "    \"fans_rpm\": {";
+    firstSensor = true;
+    for (const auto& [label, rpm] : getFanInfo()) {
+        oss << (firstSensor ? "\n" : ",\n");
+        firstSensor = false;
+        oss << "      \"" << label << "\": " << rpm;
+    }
+    oss << (firstSensor ? "},\n" : "\n    },\n");
+    
+    oss << "    \"battery\": {";
+    firstSensor = true;
+    for (const auto& [key, value] : getBatteryInfo()) {
+        oss << (firstSensor ? "\n" : ",\n");
+        firstSensor = false;
+        oss << "      \"" << key << "\": \"" << value << "\"";
+    }
+    oss << (firstSensor ? "}\n" : "\n    }\n");
     
     oss << "  }\n";
     oss << "}";
@@ -499,6 +505,7 @@ std::string FlexHardwareInfo::toCSV() const {
     oss << "CPU,Model,\"" << cpu.model << "\"\n";
     oss << "CPU,Vendor,\"" << cpu.vendor << "\"\n";
     oss << "CPU,Architecture,\"" << cpu.architecture << "\"\n";
+    oss << "CPU,Sockets," << cpu.sockets << "\n";
     oss << "CPU,Cores," << cpu.cores << "\n";
     oss << "CPU,Threads," << cpu.threads << "\n";
     oss << "CPU,Clock Speed (GHz)," << std::fixed << std::setprecision(2) << cpu.clockSpeed << "\n";
@@ -520,16 +527,47 @@ std::string FlexHardwareInfo::toCSV() const {
         oss << "Disk,Total (GB)," << std::fixed << std::setprecision(2) << (disk.total / 1024.0 / 1024.0) << "\n";
         oss << "Disk,Used (GB)," << std::fixed << std::setprecision(2) << (disk.used / 1024.0 / 1024.0) << "\n";
         oss << "Disk,Usage %," << disk.usagePercent << "\n";
+        oss << "Disk,Stale," << (disk.stale ? "true" : "false") << "\n";
     }
     
     // 网络信息
     for (const auto& net : networks) {
         oss << "Network,Interface,\"" << net.name << "\"\n";
         oss << "Network,MAC Address,\"" << net.macAddress << "\"\n";
+        oss << "Network,IPv4 Address,\"" << net.ipAddress << "\"\n";
+        oss << "Network,Netmask,\"" << net.netmask << "\"\n";
+        oss << "Network,Broadcast,\"" << net.broadcast << "\"\n";
+        oss << "Network,IPv6 Address,\"" << net.ipv6Address << "\"\n";
         oss << "Network,RX Bytes," << net.rxBytes << "\n";
         oss << "Network,TX Bytes," << net.txBytes << "\n";
     }
     
+    // PCI / USB 设备 (CSV 中双引号需要重复转义)
+    auto writeDeviceRows = [&oss](const char* category, const std::vector<std::string>& devices) {
+        for (const auto& device : devices) {
+            std::string escaped = device;
+            size_t pos = 0;
+            while ((pos = escaped.find('"', pos)) != std::string::npos) {
+                escaped.replace(pos, 1, "\"\"");
+                pos += 2;
+            }
+            oss << category << ",Device,\"" << escaped << "\"\n";
+        }
+    };
+    writeDeviceRows("PCI", getPCIDevices());
+    writeDeviceRows("USB", getUSBDevices());
+    
+    // 传感器信息
+    for (const auto& [label, celsius] : getTemperatureInfo()) {
+        oss << "Temperature,\"" << label << "\"," << std::fixed << std::setprecision(1) << celsius << "\n";
+    }
+    for (const auto& [label, rpm] : getFanInfo()) {
+        oss << "Fan,\"" << label << "\"," << rpm << "\n";
+    }
+    for (const auto& [key, value] : getBatteryInfo()) {
+        oss << "Battery,\"" << key << "\",\"" << value << "\"\n";
+    }
+    
     return oss.str();
 }
 
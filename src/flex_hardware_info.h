@@ -7,13 +7,17 @@
 
 namespace FlexTools {
 
+class FlexSensorIndex;
+
 struct FlexCPUInfo {
     std::string model;
     std::string vendor;
-    int cores;
-    int threads;
+    int sockets;
+    int cores;   // 物理核心总数
+    int threads; // 逻辑 CPU 总数
     std::string architecture;
-    double clockSpeed; // GHz
+    double clockSpeed; // GHz, 各核当前频率的平均值
+    std::vector<double> coreClockSpeeds; // GHz, 按逻辑 CPU 顺序
     std::vector<std::string> flags;
     int cacheSize; // KB
 };
@@ -40,12 +44,14 @@ struct FlexDiskInfo {
     long long inodesUsed;
     long long inodesFree;
     int inodeUsagePercent;
+    bool stale;         // statvfs 超时 (如挂死的 NFS)
 };
 
 struct FlexNetworkInterface {
     std::string name;
     std::string macAddress;
     std::string ipAddress;
+    std::string ipv6Address;
     std::string netmask;
     std::string broadcast;
     long long rxBytes;
@@ -116,7 +122,6 @@ private:
     // 特定信息解析
     void flexParseCPUInfo(FlexCPUInfo& cpu) const;
     void flexParseMemoryInfo(FlexMemoryInfo& mem) const;
-    FlexDiskInfo flexParseDiskLine(const std::string& line) const;
     FlexNetworkInterface flexParseNetworkInterface(const std::string& name) const;
     
     // 缓存
@@ -126,7 +131,11 @@ private:
     mutable std::vector<FlexNetworkInterface> flexNetworkInfoCache;
     mutable bool flexCacheValid = false;
     
+    // 传感器文件索引, 首次访问时建立, 之后的读取只做 pread
+    mutable std::shared_ptr<FlexSensorIndex> flexSensorIndex;
+    
     void flexEnsureCache() const;
+    const FlexSensorIndex& flexEnsureSensorIndex() const;
 };
 
 } // namespace FlexTools
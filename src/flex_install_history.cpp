@@ -0,0 +1,560 @@
+#include "flex_install_history.h"
+#include "flex_compressed_file.h"
+#include "flex_proc_file.h"
+#include "flex_package_snapshot.h"
+#include "flex_debian_version.h"
+#include <sys/stat.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstring>
+
+namespace FlexTools {
+
+namespace {
+
+constexpr uint8_t FLEX_SOURCE_DPKG = 0;
+constexpr uint8_t FLEX_SOURCE_APT = 1;
+const char* FLEX_HISTORY_CACHE_MAGIC = "FLEXHIST1";
+
+// 本地时间 "YYYY-MM-DD" + 时分秒 -> epoch; 同一小时只调用一次 mktime.
+// 按小时而非按天缓存: 夏令时切换当天, 切换前后的整点与零点的差不是 hour * 3600
+class FlexLocalTimeParser {
+public:
+    bool parse(std::string_view date, std::string_view time, int64_t& out) {
+        if (date.size() != 10 || time.size() < 8) {
+            return false;
+        }
+        int hour, minute, second;
+        if (!flexNumber(time.substr(0, 2), hour) || !flexNumber(time.substr(3, 2), minute) ||
+            !flexNumber(time.substr(6, 2), second)) {
+            return false;
+        }
+        if (date != std::string_view(flexDate, sizeof(flexDate)) || hour != flexHour) {
+            struct tm tm = {};
+            if (!flexNumber(date.substr(0, 4), tm.tm_year) || !flexNumber(date.substr(5, 2), tm.tm_mon) ||
+                !flexNumber(date.substr(8, 2), tm.tm_mday)) {
+                return false;
+            }
+            tm.tm_year -= 1900;
+            tm.tm_mon -= 1;
+            tm.tm_hour = hour;
+            tm.tm_isdst = -1;
+            flexHourStart = static_cast<int64_t>(mktime(&tm));
+            std::memcpy(flexDate, date.data(), sizeof(flexDate));
+            flexHour = hour;
+        }
+        out = flexHourStart + minute * 60 + second;
+        return true;
+    }
+    
+private:
+    char flexDate[10] = {};
+    int flexHour = -1;
+    int64_t flexHourStart = 0;
+    
+    static bool flexNumber(std::string_view text, int& value) {
+        value = 0;
+        for (char c : text) {
+            if (c < '0' || c > '9') return false;
+            value = value * 10 + (c - '0');
+        }
+        return !text.empty();
+    }
+};
+
+// 按空白切分出下一个字段
+std::string_view flexNextField(std::string_view& line) {
+    size_t start = line.find_first_not_of(' ');
+    if (start == std::string_view::npos) {
+        line = std::string_view();
+        return line;
+    }
+    line.remove_prefix(start);
+    size_t end = line.find(' ');
+    std::string_view field = line.substr(0, end);
+    line.remove_prefix(end == std::string_view::npos ? line.size() : end);
+    return field;
+}
+
+// "pkg:arch" -> 拆分包名与架构
+void flexSplitArch(std::string_view qualified, std::string_view& name, std::string_view& arch) {
+    size_t colon = qualified.find(':');
+    name = qualified.substr(0, colon);
+    arch = colon == std::string_view::npos ? std::string_view() : qualified.substr(colon + 1);
+}
+
+bool flexStatFile(const std::string& path, struct stat& st) {
+    return stat(path.c_str(), &st) == 0 && S_ISREG(st.st_mode);
+}
+
+// 从 offset 读到文件末尾
+bool flexReadTail(const std::string& path, uint64_t offset, std::string& out) {
+    out.clear();
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    char buffer[64 * 1024];
+    off_t position = static_cast<off_t>(offset);
+    ssize_t n;
+    while ((n = pread(fd, buffer, sizeof(buffer), position)) > 0) {
+        out.append(buffer, static_cast<size_t>(n));
+        position += n;
+    }
+    close(fd);
+    return n == 0;
+}
+
+// 日志目录下以 prefix 开头的全部代次 (dpkg.log, dpkg.log.1, dpkg.log.2.gz ...)
+std::vector<std::string> flexLogGenerations(const std::string& dir, const std::string& prefix) {
+    std::vector<std::string> paths;
+    DIR* handle = opendir(dir.c_str());
+    if (handle == nullptr) {
+        return paths;
+    }
+    while (struct dirent* entry = readdir(handle)) {
+        std::string name = entry->d_name;
+        if (name == prefix) {
+            paths.push_back(dir + "/" + name);
+            continue;
+        }
+        if (name.compare(0, prefix.size() + 1, prefix + ".") != 0) {
+            continue;
+        }
+        // 只接受纯数字代次, 可带 .gz
+        std::string suffix = name.substr(prefix.size() + 1);
+        if (flexIsGzipPath(suffix)) {
+            suffix.resize(suffix.size() - 3);
+        }
+        if (!suffix.empty() && suffix.find_first_not_of("0123456789") == std::string::npos) {
+            paths.push_back(dir + "/" + name);
+        }
+    }
+    closedir(handle);
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
+
+} // namespace
+
+const char* flexPackageActionName(FlexPackageAction action) {
+    switch (action) {
+        case FlexPackageAction::INSTALL: return "install";
+        case FlexPackageAction::UPGRADE: return "upgrade";
+        case FlexPackageAction::DOWNGRADE: return "downgrade";
+        case FlexPackageAction::REINSTALL: return "reinstall";
+        case FlexPackageAction::REMOVE: return "remove";
+        case FlexPackageAction::PURGE: return "purge";
+    }
+    return "unknown";
+}
+
+FlexInstallHistory::FlexInstallHistory(const std::string& logDir, const std::string& cachePath)
+    : flexLogDir(logDir),
+      flexCachePath(cachePath.empty() ? FlexPackageSnapshot::flexDefaultPath("install-history.tsv") : cachePath) {
+    flexDpkgLog.path = flexLogDir + "/dpkg.log";
+    flexAptLog.path = flexLogDir + "/apt/history.log";
+    flexClear();
+}
+
+void FlexInstallHistory::flexClear() {
+    flexStrings.assign(1, std::string());
+    flexStringIds.clear();
+    flexStringIds.emplace(std::string(), 0);
+    flexRecords.clear();
+    flexTimestamps.clear();
+    flexPackageIndex.clear();
+    flexDpkgLog.inode = flexDpkgLog.offset = 0;
+    flexAptLog.inode = flexAptLog.offset = 0;
+    flexDpkgStart = 0;
+}
+
+uint32_t FlexInstallHistory::flexIntern(std::string_view value) {
+    auto it = flexStringIds.find(std::string(value));
+    if (it != flexStringIds.end()) {
+        return it->second;
+    }
+    uint32_t id = static_cast<uint32_t>(flexStrings.size());
+    flexStrings.emplace_back(value);
+    flexStringIds.emplace(flexStrings.back(), id);
+    return id;
+}
+
+void FlexInstallHistory::flexAddRecord(int64_t timestamp, FlexPackageAction action, std::string_view package,
+                                       std::string_view oldVersion, std::string_view newVersion, uint8_t source) {
+    std::string_view name, arch;
+    flexSplitArch(package, name, arch);
+    if (oldVersion == "<none>") oldVersion = std::string_view();
+    if (newVersion == "<none>") newVersion = std::string_view();
+    
+    // dpkg 对降级和重装同样记为 upgrade, 按版本比较区分
+    if (action == FlexPackageAction::UPGRADE && !oldVersion.empty() && !newVersion.empty()) {
+        int order = flexCompareDebianVersions(newVersion, oldVersion);
+        if (order < 0) action = FlexPackageAction::DOWNGRADE;
+        else if (order == 0) action = FlexPackageAction::REINSTALL;
+    }
+    
+    flexRecords.push_back(Record{timestamp, flexIntern(name), flexIntern(arch), flexIntern(oldVersion),
+                                 flexIntern(newVersion), static_cast<uint8_t>(action), source});
+}
+
+uint64_t FlexInstallHistory::flexParseDpkgLog(std::string_view content) {
+    // "2025-10-02 21:06:51 upgrade libssl3:amd64 3.0.11-1 3.0.17-1", 只处理以换行结尾的完整行
+    FlexLocalTimeParser clock;
+    uint64_t consumed = 0;
+    while (true) {
+        size_t end = content.find('\n', consumed);
+        if (end == std::string_view::npos) {
+            break;
+        }
+        std::string_view line = content.substr(consumed, end - consumed);
+        consumed = end + 1;
+        
+        if (line.size() < 28 || line[4] != '-' || line[19] != ' ') {
+            continue;
+        }
+        std::string_view rest = line.substr(20);
+        std::string_view verb = flexNextField(rest);
+        FlexPackageAction action;
+        if (verb == "install") action = FlexPackageAction::INSTALL;
+        else if (verb == "upgrade") action = FlexPackageAction::UPGRADE;
+        else if (verb == "remove") action = FlexPackageAction::REMOVE;
+        else if (verb == "purge") action = FlexPackageAction::PURGE;
+        else continue;
+        
+        int64_t timestamp;
+        if (!clock.parse(line.substr(0, 10), line.substr(11, 8), timestamp)) {
+            continue;
+        }
+        std::string_view package = flexNextField(rest);
+        std::string_view oldVersion = flexNextField(rest);
+        std::string_view newVersion = flexNextField(rest);
+        flexAddRecord(timestamp, action, package, oldVersion, newVersion, FLEX_SOURCE_DPKG);
+    }
+    return consumed;
+}
+
+uint64_t FlexInstallHistory::flexParseAptHistory(std::string_view content) {
+    // 事务以 Start-Date 开始、End-Date 结束; 只有写完 End-Date 的事务才算完整
+    FlexLocalTimeParser clock;
+    uint64_t consumed = 0;
+    uint64_t position = 0;
+    int64_t start = 0;
+    bool inTransaction = false;
+    
+    struct Pending {
+        FlexPackageAction action;
+        std::string_view items;
+    };
+    std::vector<Pending> pending;
+    
+    while (position < content.size()) {
+        size_t end = content.find('\n', position);
+        if (end == std::string_view::npos) {
+            break;
+        }
+        std::string_view line = content.substr(position, end - position);
+        position = end + 1;
+        
+        size_t colon = line.find(": ");
+        if (colon == std::string_view::npos) {
+            continue;
+        }
+        std::string_view key = line.substr(0, colon);
+        std::string_view value = line.substr(colon + 2);
+        
+        if (key == "Start-Date") {
+            // "2025-10-02  21:06:51"
+            std::string_view date = flexNextField(value);
+            std::string_view time = flexNextField(value);
+            inTransaction = clock.parse(date, time, start);
+            pending.clear();
+        } else if (key == "End-Date") {
+            if (inTransaction) {
+                for (const auto& item : pending) {
+                    // "libssl3:amd64 (3.0.11-1, 3.0.17-1), zlib1g:amd64 (1:1.2.13, automatic)"
+                    std::string_view list = item.items;
+                    while (!list.empty()) {
+                        size_t open = list.find(" (");
+                        size_t close = list.find(')', open);
+                        if (open == std::string_view::npos || close == std::string_view::npos) break;
+                        std::string_view package = list.substr(0, open);
+                        std::string_view versions = list.substr(open + 2, close - open - 2);
+                        list.remove_prefix(close + 1);
+                        while (!list.empty() && (list.front() == ',' || list.front() == ' ')) list.remove_prefix(1);
+                        
+                        size_t comma = versions.find(", ");
+                        std::string_view first = versions.substr(0, comma);
+                        std::string_view second = comma == std::string_view::npos ? std::string_view()
+                                                                                   : versions.substr(comma + 2);
+                        if (second == "automatic") second = std::string_view();
+                        
+                        switch (item.action) {
+                            case FlexPackageAction::UPGRADE:
+                            case FlexPackageAction::DOWNGRADE:
+                                flexAddRecord(start, item.action, package, first, second, FLEX_SOURCE_APT);
+                                break;
+                            case FlexPackageAction::REMOVE:
+                            case FlexPackageAction::PURGE:
+                                flexAddRecord(start, item.action, package, first, "", FLEX_SOURCE_APT);
+                                break;
+                            default:
+                                flexAddRecord(start, item.action, package, "", first, FLEX_SOURCE_APT);
+                                break;
+                        }
+                    }
+                }
+            }
+            inTransaction = false;
+            pending.clear();
+            consumed = position;
+        } else if (inTransaction) {
+            if (key == "Install") pending.push_back(Pending{FlexPackageAction::INSTALL, value});
+            else if (key == "Upgrade") pending.push_back(Pending{FlexPackageAction::UPGRADE, value});
+            else if (key == "Downgrade") pending.push_back(Pending{FlexPackageAction::DOWNGRADE, value});
+            else if (key == "Reinstall") pending.push_back(Pending{FlexPackageAction::REINSTALL, value});
+            else if (key == "Remove") pending.push_back(Pending{FlexPackageAction::REMOVE, value});
+            else if (key == "Purge") pending.push_back(Pending{FlexPackageAction::PURGE, value});
+        }
+    }
+    return consumed;
+}
+
+bool FlexInstallHistory::flexRebuild() {
+    flexClear();
+    std::string content;
+    bool any = false;
+    
+    for (const auto& path : flexLogGenerations(flexLogDir, "dpkg.log")) {
+        if (path == flexDpkgLog.path) continue;
+        if (flexReadMaybeCompressed(path, content)) {
+            flexParseDpkgLog(content);
+            any = true;
+        }
+    }
+    for (const auto& path : flexLogGenerations(flexLogDir + "/apt", "history.log")) {
+        if (path == flexAptLog.path) continue;
+        if (flexReadMaybeCompressed(path, content)) {
+            flexParseAptHistory(content);
+            any = true;
+        }
+    }
+    
+    // 活动日志从头读起并记录续读位置
+    any = flexResume(flexDpkgLog, false) || any;
+    any = flexResume(flexAptLog, true) || any;
+    flexFinalize();
+    return any;
+}
+
+bool FlexInstallHistory::flexResume(ActiveLog& log, bool apt) {
+    struct stat st;
+    if (!flexStatFile(log.path, st)) {
+        return false;
+    }
+    if (static_cast<uint64_t>(st.st_ino) != log.inode || static_cast<uint64_t>(st.st_size) < log.offset) {
+        log.inode = st.st_ino;
+        log.offset = 0;
+    }
+    if (static_cast<uint64_t>(st.st_size) == log.offset) {
+        return true;
+    }
+    
+    std::string content;
+    if (!flexReadTail(log.path, log.offset, content)) {
+        return false;
+    }
+    log.offset += apt ? flexParseAptHistory(content) : flexParseDpkgLog(content);
+    return true;
+}
+
+bool FlexInstallHistory::load() {
+    if (!flexReadCache()) {
+        bool ok = flexRebuild();
+        save();
+        return ok;
+    }
+    
+    // 活动日志被轮转 (inode 变化或变短) 时旧内容已进入 .1/.gz 代次, 只能整体重建
+    for (const ActiveLog* log : {&flexDpkgLog, &flexAptLog}) {
+        struct stat st;
+        bool exists = flexStatFile(log->path, st);
+        if ((exists && (static_cast<uint64_t>(st.st_ino) != log->inode ||
+                        static_cast<uint64_t>(st.st_size) < log->offset)) ||
+            (!exists && log->inode != 0)) {
+            bool ok = flexRebuild();
+            save();
+            return ok;
+        }
+    }
+    
+    size_t before = flexRecords.size();
+    uint64_t dpkgOffset = flexDpkgLog.offset;
+    uint64_t aptOffset = flexAptLog.offset;
+    refresh();
+    if (flexRecords.size() != before || dpkgOffset != flexDpkgLog.offset || aptOffset != flexAptLog.offset) {
+        save();
+    }
+    return true;
+}
+
+bool FlexInstallHistory::refresh() {
+    bool ok = flexResume(flexDpkgLog, false);
+    ok = flexResume(flexAptLog, true) || ok;
+    flexFinalize();
+    return ok;
+}
+
+void FlexInstallHistory::flexFinalize() {
+    // dpkg.log 覆盖的时间段内, apt 历史与之重复, 只保留 dpkg 的逐包记录
+    int64_t dpkgStart = 0;
+    for (const auto& record : flexRecords) {
+        if (record.source == FLEX_SOURCE_DPKG && (dpkgStart == 0 || record.timestamp < dpkgStart)) {
+            dpkgStart = record.timestamp;
+        }
+    }
+    flexDpkgStart = dpkgStart;
+    if (dpkgStart != 0) {
+        flexRecords.erase(std::remove_if(flexRecords.begin(), flexRecords.end(),
+                                         [dpkgStart](const Record& record) {
+                                             return record.source == FLEX_SOURCE_APT && record.timestamp >= dpkgStart;
+                                         }),
+                          flexRecords.end());
+    }
+    
+    std::stable_sort(flexRecords.begin(), flexRecords.end(),
+                     [](const Record& a, const Record& b) { return a.timestamp < b.timestamp; });
+    
+    flexTimestamps.resize(flexRecords.size());
+    flexPackageIndex.assign(flexStrings.size(), {});
+    for (uint32_t i = 0; i < flexRecords.size(); ++i) {
+        flexTimestamps[i] = flexRecords[i].timestamp;
+        flexPackageIndex[flexRecords[i].package].push_back(i);
+    }
+}
+
+FlexPackageEvent FlexInstallHistory::flexMakeEvent(const Record& record) const {
+    FlexPackageEvent event;
+    event.timestamp = static_cast<time_t>(record.timestamp);
+    event.action = static_cast<FlexPackageAction>(record.action);
+    event.package = flexStrings[record.package];
+    event.architecture = flexStrings[record.architecture];
+    event.oldVersion = flexStrings[record.oldVersion];
+    event.newVersion = flexStrings[record.newVersion];
+    event.source = record.source == FLEX_SOURCE_APT ? "apt" : "dpkg";
+    return event;
+}
+
+std::vector<FlexPackageEvent> FlexInstallHistory::events(time_t since, time_t until) const {
+    auto first = std::lower_bound(flexTimestamps.begin(), flexTimestamps.end(), static_cast<int64_t>(since));
+    auto last = std::lower_bound(first, flexTimestamps.end(), static_cast<int64_t>(until));
+    
+    std::vector<FlexPackageEvent> result;
+    result.reserve(static_cast<size_t>(last - first));
+    for (auto it = first; it != last; ++it) {
+        result.push_back(flexMakeEvent(flexRecords[static_cast<size_t>(it - flexTimestamps.begin())]));
+    }
+    return result;
+}
+
+std::vector<FlexPackageEvent> FlexInstallHistory::packageEvents(const std::string& package) const {
+    std::vector<FlexPackageEvent> result;
+    auto it = flexStringIds.find(package);
+    if (it == flexStringIds.end() || it->second >= flexPackageIndex.size()) {
+        return result;
+    }
+    for (uint32_t index : flexPackageIndex[it->second]) {
+        result.push_back(flexMakeEvent(flexRecords[index]));
+    }
+    return result;
+}
+
+bool FlexInstallHistory::lastInstallTime(const std::string& package, time_t& when) const {
+    auto it = flexStringIds.find(package);
+    if (it == flexStringIds.end() || it->second >= flexPackageIndex.size()) {
+        return false;
+    }
+    const auto& indices = flexPackageIndex[it->second];
+    for (auto rit = indices.rbegin(); rit != indices.rend(); ++rit) {
+        auto action = static_cast<FlexPackageAction>(flexRecords[*rit].action);
+        if (action != FlexPackageAction::REMOVE && action != FlexPackageAction::PURGE) {
+            when = static_cast<time_t>(flexRecords[*rit].timestamp);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool FlexInstallHistory::save() const {
+    std::ostringstream out;
+    out << FLEX_HISTORY_CACHE_MAGIC << "\t" << flexLogDir << "\n";
+    out << "log\t" << flexDpkgLog.inode << "\t" << flexDpkgLog.offset << "\n";
+    out << "log\t" << flexAptLog.inode << "\t" << flexAptLog.offset << "\n";
+    for (const auto& record : flexRecords) {
+        out << record.timestamp << "\t" << static_cast<int>(record.action) << "\t"
+            << static_cast<int>(record.source) << "\t" << flexStrings[record.package] << "\t"
+            << flexStrings[record.architecture] << "\t" << flexStrings[record.oldVersion] << "\t"
+            << flexStrings[record.newVersion] << "\n";
+    }
+    return flexAtomicWriteFile(flexCachePath, out.str());
+}
+
+bool FlexInstallHistory::flexReadCache() {
+    flexClear();
+    std::string content;
+    if (flexCachePath.empty() || !flexReadWholeFile(flexCachePath, content)) {
+        return false;
+    }
+    
+    std::string_view view = content;
+    auto nextLine = [&view](std::string_view& line) {
+        size_t end = view.find('\n');
+        if (end == std::string_view::npos) return false;
+        line = view.substr(0, end);
+        view.remove_prefix(end + 1);
+        return true;
+    };
+    auto split = [](std::string_view line, std::string_view* fields, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            size_t tab = line.find('\t');
+            if (tab == std::string_view::npos && i + 1 < count) return false;
+            fields[i] = line.substr(0, tab);
+            line.remove_prefix(tab == std::string_view::npos ? line.size() : tab + 1);
+        }
+        return true;
+    };
+    auto number = [](std::string_view text, uint64_t& value) {
+        return flexParseUnsigned(text, value) && text.empty();
+    };
+    
+    std::string_view line;
+    std::string_view fields[7];
+    if (!nextLine(line) || !split(line, fields, 2) || fields[0] != FLEX_HISTORY_CACHE_MAGIC ||
+        fields[1] != flexLogDir) {
+        return false;
+    }
+    for (ActiveLog* log : {&flexDpkgLog, &flexAptLog}) {
+        if (!nextLine(line) || !split(line, fields, 3) || fields[0] != "log" ||
+            !number(fields[1], log->inode) || !number(fields[2], log->offset)) {
+            flexClear();
+            return false;
+        }
+    }
+    
+    while (nextLine(line)) {
+        uint64_t timestamp, action, source;
+        if (!split(line, fields, 7) || !number(fields[0], timestamp) || !number(fields[1], action) ||
+            !number(fields[2], source) || action > static_cast<uint64_t>(FlexPackageAction::PURGE)) {
+            flexClear();
+            return false;
+        }
+        flexRecords.push_back(Record{static_cast<int64_t>(timestamp), flexIntern(fields[3]), flexIntern(fields[4]),
+                                     flexIntern(fields[5]), flexIntern(fields[6]), static_cast<uint8_t>(action),
+                                     static_cast<uint8_t>(source)});
+    }
+    flexFinalize();
+    return true;
+}
+
+} // namespace FlexTools
@@ -0,0 +1,104 @@
+#ifndef FLEX_INSTALL_HISTORY_H
+#define FLEX_INSTALL_HISTORY_H
+
+#include "flex_common.h"
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+
+namespace FlexTools {
+
+enum class FlexPackageAction {
+    INSTALL,
+    UPGRADE,
+    DOWNGRADE,
+    REINSTALL,
+    REMOVE,
+    PURGE
+};
+
+const char* flexPackageActionName(FlexPackageAction action);
+
+struct FlexPackageEvent {
+    time_t timestamp;
+    FlexPackageAction action;
+    std::string package;
+    std::string architecture;
+    std::string oldVersion; // 安装时为空
+    std::string newVersion; // 移除时为空
+    std::string source;     // "dpkg" 或 "apt"
+};
+
+// 包安装历史索引: 来自 dpkg.log* 与 apt/history.log* (含 .gz 代次).
+// 事件按时间排序存放, 支持时间区间查询与按包查询; 索引持久化到用户缓存目录,
+// 再次加载时只从活动日志上次的字节偏移处继续解析
+class FlexInstallHistory {
+public:
+    explicit FlexInstallHistory(const std::string& logDir = "/var/log", const std::string& cachePath = "");
+    
+    // 读取缓存并增量解析; 日志已轮转或缓存不可用时完整重建
+    bool load();
+    
+    // 只解析活动日志新追加的部分 (进程内增量)
+    bool refresh();
+    
+    // 写回缓存文件
+    bool save() const;
+    
+    size_t size() const { return flexRecords.size(); }
+    
+    // 时间区间 [since, until) 内的事件, 按时间升序
+    std::vector<FlexPackageEvent> events(time_t since, time_t until) const;
+    
+    // 某个包的全部事件, 按时间升序
+    std::vector<FlexPackageEvent> packageEvents(const std::string& package) const;
+    
+    // 当前版本的安装时间: 最近一次 install/upgrade/downgrade/reinstall
+    bool lastInstallTime(const std::string& package, time_t& when) const;
+    
+private:
+    // 紧凑事件记录, 字符串均为字符串表下标
+    struct Record {
+        int64_t timestamp;
+        uint32_t package;
+        uint32_t architecture;
+        uint32_t oldVersion;
+        uint32_t newVersion;
+        uint8_t action;
+        uint8_t source;
+    };
+    
+    // 活动日志的续读位置
+    struct ActiveLog {
+        std::string path;
+        uint64_t inode = 0;
+        uint64_t offset = 0;
+    };
+    
+    std::string flexLogDir;
+    std::string flexCachePath;
+    std::vector<std::string> flexStrings;
+    std::unordered_map<std::string, uint32_t> flexStringIds;
+    std::vector<Record> flexRecords;
+    std::vector<int64_t> flexTimestamps;                 // 与 flexRecords 对齐, 供二分查找
+    std::vector<std::vector<uint32_t>> flexPackageIndex; // 包名字符串下标 -> 事件下标
+    ActiveLog flexDpkgLog;
+    ActiveLog flexAptLog;
+    int64_t flexDpkgStart = 0; // dpkg 日志覆盖的最早时间, 更早的事件才取自 apt 历史
+    
+    uint32_t flexIntern(std::string_view value);
+    void flexClear();
+    bool flexRebuild();
+    bool flexReadCache();
+    bool flexResume(ActiveLog& log, bool apt);
+    uint64_t flexParseDpkgLog(std::string_view content);
+    uint64_t flexParseAptHistory(std::string_view content);
+    void flexAddRecord(int64_t timestamp, FlexPackageAction action, std::string_view package,
+                       std::string_view oldVersion, std::string_view newVersion, uint8_t source);
+    void flexFinalize();
+    FlexPackageEvent flexMakeEvent(const Record& record) const;
+};
+
+} // namespace FlexTools
+
+#endif // FLEX_INSTALL_HISTORY_H
@@ -0,0 +1,766 @@
+#include "flex_journal_reader.h"
+#include "flex_log_collector.h"
+#include <sys/stat.h>
+#include <dirent.h>
+#include <endian.h>
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <queue>
+#ifdef FLEX_HAVE_LZMA
+#include <lzma.h>
+#endif
+#ifdef FLEX_HAVE_LZ4
+#include <lz4.h>
+#endif
+#ifdef FLEX_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace FlexTools {
+
+namespace {
+
+// 文件格式见 systemd 的 journal-def.h, 所有整数均为小端
+constexpr char FLEX_JOURNAL_SIGNATURE[8] = {'L', 'P', 'K', 'S', 'H', 'H', 'R', 'H'};
+
+// 头部字段偏移
+constexpr size_t FLEX_JH_INCOMPATIBLE = 12;
+constexpr size_t FLEX_JH_FILE_ID = 24;
+constexpr size_t FLEX_JH_HEADER_SIZE = 88;
+constexpr size_t FLEX_JH_FIELD_HASH_OFFSET = 120;
+constexpr size_t FLEX_JH_FIELD_HASH_SIZE = 128;
+constexpr size_t FLEX_JH_N_ENTRIES = 152;
+constexpr size_t FLEX_JH_ENTRY_ARRAY = 176;
+constexpr size_t FLEX_JH_HEAD_REALTIME = 184;
+constexpr size_t FLEX_JH_MIN_SIZE = 208;
+
+// 不兼容标志: 我们能理解的全部
+constexpr uint32_t FLEX_JOURNAL_COMPRESSED_XZ = 1;
+constexpr uint32_t FLEX_JOURNAL_COMPRESSED_LZ4 = 2;
+constexpr uint32_t FLEX_JOURNAL_KEYED_HASH = 4;
+constexpr uint32_t FLEX_JOURNAL_COMPRESSED_ZSTD = 8;
+constexpr uint32_t FLEX_JOURNAL_COMPACT = 16;
+constexpr uint32_t FLEX_JOURNAL_SUPPORTED = 31;
+
+// 对象类型与对象压缩标志
+constexpr uint8_t FLEX_JOBJ_DATA = 1;
+constexpr uint8_t FLEX_JOBJ_FIELD = 2;
+constexpr uint8_t FLEX_JOBJ_ENTRY = 3;
+constexpr uint8_t FLEX_JOBJ_ENTRY_ARRAY = 6;
+constexpr uint8_t FLEX_JOBJ_XZ = 1;
+constexpr uint8_t FLEX_JOBJ_LZ4 = 2;
+constexpr uint8_t FLEX_JOBJ_ZSTD = 4;
+
+// 对象内字段偏移 (对象头 16 字节之后)
+constexpr size_t FLEX_JOBJ_HEADER = 16;
+constexpr size_t FLEX_JDATA_NEXT_FIELD = 32;
+constexpr size_t FLEX_JDATA_ENTRY = 40;
+constexpr size_t FLEX_JDATA_ENTRY_ARRAY = 48;
+constexpr size_t FLEX_JDATA_N_ENTRIES = 56;
+constexpr size_t FLEX_JDATA_PAYLOAD = 64;
+constexpr size_t FLEX_JDATA_PAYLOAD_COMPACT = 72;
+constexpr size_t FLEX_JFIELD_HASH = 16;
+constexpr size_t FLEX_JFIELD_NEXT_HASH = 24;
+constexpr size_t FLEX_JFIELD_HEAD_DATA = 32;
+constexpr size_t FLEX_JFIELD_PAYLOAD = 40;
+constexpr size_t FLEX_JENTRY_SEQNUM = 16;
+constexpr size_t FLEX_JENTRY_REALTIME = 24;
+constexpr size_t FLEX_JENTRY_ITEMS = 64;
+constexpr size_t FLEX_JARRAY_NEXT = 16;
+constexpr size_t FLEX_JARRAY_ITEMS = 24;
+
+// 解压后的数据对象上限, 与 journald 的 DATA_SIZE_MAX 相同
+constexpr size_t FLEX_JOURNAL_DATA_MAX = 64 * 1024 * 1024;
+
+inline uint64_t flexLE64(const char* p) {
+    uint64_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return le64toh(value);
+}
+
+inline uint32_t flexLE32(const char* p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return le32toh(value);
+}
+
+inline uint64_t flexRotl64(uint64_t x, int bits) {
+    return (x << bits) | (x >> (64 - bits));
+}
+
+// KEYED_HASH 文件: 以 file_id 为密钥的 SipHash-2-4
+uint64_t flexSipHash24(const char* data, size_t size, const char* key) {
+    uint64_t k0 = flexLE64(key);
+    uint64_t k1 = flexLE64(key + 8);
+    uint64_t v0 = 0x736f6d6570736575ULL ^ k0;
+    uint64_t v1 = 0x646f72616e646f6dULL ^ k1;
+    uint64_t v2 = 0x6c7967656e657261ULL ^ k0;
+    uint64_t v3 = 0x7465646279746573ULL ^ k1;
+    auto round = [&]() {
+        v0 += v1; v1 = flexRotl64(v1, 13); v1 ^= v0; v0 = flexRotl64(v0, 32);
+        v2 += v3; v3 = flexRotl64(v3, 16); v3 ^= v2;
+        v0 += v3; v3 = flexRotl64(v3, 21); v3 ^= v0;
+        v2 += v1; v1 = flexRotl64(v1, 17); v1 ^= v2; v2 = flexRotl64(v2, 32);
+    };
+    
+    size_t blocks = size / 8;
+    for (size_t i = 0; i < blocks; ++i) {
+        uint64_t m = flexLE64(data + i * 8);
+        v3 ^= m;
+        round();
+        round();
+        v0 ^= m;
+    }
+    uint64_t last = static_cast<uint64_t>(size) << 56;
+    for (size_t i = blocks * 8; i < size; ++i) {
+        last |= static_cast<uint64_t>(static_cast<unsigned char>(data[i])) << (8 * (i - blocks * 8));
+    }
+    v3 ^= last;
+    round();
+    round();
+    v0 ^= last;
+    v2 ^= 0xff;
+    round();
+    round();
+    round();
+    round();
+    return v0 ^ v1 ^ v2 ^ v3;
+}
+
+inline uint32_t flexRotl32(uint32_t x, int bits) {
+    return (x << bits) | (x >> (32 - bits));
+}
+
+// 旧格式文件: Bob Jenkins 的 lookup3 hashlittle2, 两个 32 位结果拼成 64 位
+uint64_t flexJenkinsHash64(const char* data, size_t size) {
+    const unsigned char* k = reinterpret_cast<const unsigned char*>(data);
+    uint32_t a = 0xdeadbeef + static_cast<uint32_t>(size);
+    uint32_t b = a;
+    uint32_t c = a;
+    if (size == 0) {
+        return (static_cast<uint64_t>(c) << 32) | b;
+    }
+    
+    while (size > 12) {
+        a += k[0] | (static_cast<uint32_t>(k[1]) << 8) | (static_cast<uint32_t>(k[2]) << 16) |
+             (static_cast<uint32_t>(k[3]) << 24);
+        b += k[4] | (static_cast<uint32_t>(k[5]) << 8) | (static_cast<uint32_t>(k[6]) << 16) |
+             (static_cast<uint32_t>(k[7]) << 24);
+        c += k[8] | (static_cast<uint32_t>(k[9]) << 8) | (static_cast<uint32_t>(k[10]) << 16) |
+             (static_cast<uint32_t>(k[11]) << 24);
+        a -= c; a ^= flexRotl32(c, 4);  c += b;
+        b -= a; b ^= flexRotl32(a, 6);  a += c;
+        c -= b; c ^= flexRotl32(b, 8);  b += a;
+        a -= c; a ^= flexRotl32(c, 16); c += b;
+        b -= a; b ^= flexRotl32(a, 19); a += c;
+        c -= b; c ^= flexRotl32(b, 4);  b += a;
+        size -= 12;
+        k += 12;
+    }
+    
+    // 剩余 1-12 字节按小端累加到 a/b/c
+    uint32_t words[3] = {0, 0, 0};
+    for (size_t i = 0; i < size; ++i) {
+        words[i / 4] |= static_cast<uint32_t>(k[i]) << (8 * (i % 4));
+    }
+    a += words[0];
+    b += words[1];
+    c += words[2];
+    c ^= b; c -= flexRotl32(b, 14);
+    a ^= c; a -= flexRotl32(c, 11);
+    b ^= a; b -= flexRotl32(a, 25);
+    c ^= b; c -= flexRotl32(b, 16);
+    a ^= c; a -= flexRotl32(c, 4);
+    b ^= a; b -= flexRotl32(a, 14);
+    c ^= b; c -= flexRotl32(b, 24);
+    return (static_cast<uint64_t>(c) << 32) | b;
+}
+
+// 各压缩格式的解压; 未编译对应库时返回 false
+bool flexDecompressXZ(const char* data, size_t size, std::string& out) {
+#ifdef FLEX_HAVE_LZMA
+    lzma_stream stream = LZMA_STREAM_INIT;
+    if (lzma_stream_decoder(&stream, UINT64_MAX, 0) != LZMA_OK) {
+        return false;
+    }
+    out.resize(std::max<size_t>(size * 4, 4096));
+    stream.next_in = reinterpret_cast<const uint8_t*>(data);
+    stream.avail_in = size;
+    size_t produced = 0;
+    lzma_ret ret = LZMA_OK;
+    while (ret == LZMA_OK) {
+        if (produced == out.size()) {
+            if (out.size() >= FLEX_JOURNAL_DATA_MAX) break;
+            out.resize(std::min(out.size() * 2, FLEX_JOURNAL_DATA_MAX));
+        }
+        stream.next_out = reinterpret_cast<uint8_t*>(&out[produced]);
+        stream.avail_out = out.size() - produced;
+        ret = lzma_code(&stream, LZMA_FINISH);
+        produced = out.size() - stream.avail_out;
+    }
+    lzma_end(&stream);
+    out.resize(produced);
+    return ret == LZMA_STREAM_END;
+#else
+    (void)data; (void)size; (void)out;
+    return false;
+#endif
+}
+
+bool flexDecompressLZ4(const char* data, size_t size, std::string& out) {
+#ifdef FLEX_HAVE_LZ4
+    // journald 在 LZ4 块前写入 8 字节的原始长度
+    if (size <= 8) {
+        return false;
+    }
+    uint64_t length = flexLE64(data);
+    if (length == 0 || length > FLEX_JOURNAL_DATA_MAX) {
+        return false;
+    }
+    out.resize(length);
+    int produced = LZ4_decompress_safe(data + 8, &out[0], static_cast<int>(size - 8), static_cast<int>(length));
+    return produced >= 0 && static_cast<uint64_t>(produced) == length;
+#else
+    (void)data; (void)size; (void)out;
+    return false;
+#endif
+}
+
+bool flexDecompressZSTD(const char* data, size_t size, std::string& out) {
+#ifdef FLEX_HAVE_ZSTD
+    unsigned long long length = ZSTD_getFrameContentSize(data, size);
+    if (length == ZSTD_CONTENTSIZE_ERROR || length == ZSTD_CONTENTSIZE_UNKNOWN || length > FLEX_JOURNAL_DATA_MAX) {
+        return false;
+    }
+    out.resize(length);
+    size_t produced = ZSTD_decompress(&out[0], out.size(), data, size);
+    return !ZSTD_isError(produced) && produced == length;
+#else
+    (void)data; (void)size; (void)out;
+    return false;
+#endif
+}
+
+bool flexHasPrefix(std::string_view text, std::string_view prefix) {
+    return text.size() >= prefix.size() && text.compare(0, prefix.size(), prefix) == 0;
+}
+
+std::string flexFormatRealtime(uint64_t realtime) {
+    return flexFormatTime(static_cast<int64_t>(realtime / 1000000));
+}
+
+// 单条记录的三种输出格式, 列表输出与流式输出共用
+void flexWriteEntryText(std::ostream& out, const FlexJournalEntry& entry) {
+    const char* color = entry.level >= FlexLogLevel::ERROR ? FLEX_COLOR_RED :
+                        entry.level == FlexLogLevel::WARNING ? FLEX_COLOR_YELLOW : "";
+    const std::string& name = entry.identifier.empty() ? entry.unit : entry.identifier;
+    out << flexFormatRealtime(entry.realtime) << " " << color << name
+        << (entry.pid.empty() ? "" : "[" + entry.pid + "]") << ": " << entry.message
+        << (*color ? FLEX_COLOR_RESET : "") << "\n";
+}
+
+void flexWriteEntryJSON(std::ostream& out, const FlexJournalEntry& entry, bool first) {
+    out << (first ? "\n" : ",\n") << "      {\"time\": \"" << flexFormatRealtime(entry.realtime)
+        << "\", \"realtime\": " << entry.realtime << ", \"priority\": " << entry.priority
+        << ", \"level\": \"" << flexLogLevelName(entry.level)
+        << "\", \"unit\": \"" << flexEscapeJSON(entry.unit)
+        << "\", \"identifier\": \"" << flexEscapeJSON(entry.identifier)
+        << "\", \"pid\": \"" << flexEscapeJSON(entry.pid)
+        << "\", \"message\": \"" << flexEscapeJSON(entry.message) << "\"}";
+}
+
+void flexWriteEntryCSV(std::ostream& out, const FlexJournalEntry& entry) {
+    out << flexFormatRealtime(entry.realtime) << "," << entry.priority << "," << flexLogLevelName(entry.level)
+        << "," << flexEscapeCSV(entry.unit) << "," << flexEscapeCSV(entry.identifier) << "," << entry.pid
+        << "," << flexEscapeCSV(entry.message) << "\n";
+}
+
+constexpr const char* FLEX_JOURNAL_CSV_HEADER = "Time,Priority,Level,Unit,Identifier,PID,Message\n";
+
+} // namespace
+
+FlexLogLevel flexJournalPriorityLevel(int priority) {
+    // 与 "<N>" 前缀的映射一致: emerg/alert/crit 均视为 CRITICAL, notice 视为 INFO
+    static const FlexLogLevel levels[] = {
+        FlexLogLevel::CRITICAL, FlexLogLevel::CRITICAL, FlexLogLevel::CRITICAL, FlexLogLevel::ERROR,
+        FlexLogLevel::WARNING, FlexLogLevel::INFO, FlexLogLevel::INFO, FlexLogLevel::DEBUG
+    };
+    return priority >= 0 && priority <= 7 ? levels[priority] : FlexLogLevel::INFO;
+}
+
+int flexParseJournalPriority(const std::string& text) {
+    static const char* names[] = {"emerg", "alert", "crit", "err", "warning", "notice", "info", "debug"};
+    if (text.size() == 1 && text[0] >= '0' && text[0] <= '7') {
+        return text[0] - '0';
+    }
+    for (int i = 0; i < 8; ++i) {
+        if (text == names[i]) return i;
+    }
+    return -1;
+}
+
+FlexJournalFile::FlexJournalFile(const std::string& path) : flexPath(path), flexFile(path) {
+    if (!flexFile.isOpen() || flexFile.size() < FLEX_JH_MIN_SIZE) {
+        return;
+    }
+    const char* header = flexFile.data();
+    if (std::memcmp(header, FLEX_JOURNAL_SIGNATURE, sizeof(FLEX_JOURNAL_SIGNATURE)) != 0) {
+        return;
+    }
+    flexIncompatible = flexLE32(header + FLEX_JH_INCOMPATIBLE);
+    uint64_t headerSize = flexLE64(header + FLEX_JH_HEADER_SIZE);
+    // 未知的不兼容特性无法安全解析
+    if ((flexIncompatible & ~FLEX_JOURNAL_SUPPORTED) != 0 || headerSize < FLEX_JH_MIN_SIZE ||
+        headerSize > flexFile.size()) {
+        return;
+    }
+    flexValid = true;
+}
+
+uint64_t FlexJournalFile::entryCount() const {
+    return flexValid ? flexLE64(flexFile.data() + FLEX_JH_N_ENTRIES) : 0;
+}
+
+uint64_t FlexJournalFile::headRealtime() const {
+    return flexValid ? flexLE64(flexFile.data() + FLEX_JH_HEAD_REALTIME) : 0;
+}
+
+const char* FlexJournalFile::flexObject(uint64_t offset, uint8_t type, uint64_t minSize, uint64_t& size) const {
+    uint64_t fileSize = flexFile.size();
+    if (offset == 0 || offset % 8 != 0 || offset > fileSize || fileSize - offset < FLEX_JOBJ_HEADER) {
+        return nullptr;
+    }
+    const char* object = flexFile.data() + offset;
+    size = flexLE64(object + 8);
+    if (static_cast<uint8_t>(object[0]) != type || size < minSize || size > fileSize - offset) {
+        return nullptr;
+    }
+    return object;
+}
+
+bool FlexJournalFile::flexPayload(uint64_t offset, std::string_view& payload, std::string& scratch) const {
+    uint64_t size = 0;
+    size_t payloadStart = (flexIncompatible & FLEX_JOURNAL_COMPACT) ? FLEX_JDATA_PAYLOAD_COMPACT : FLEX_JDATA_PAYLOAD;
+    const char* object = flexObject(offset, FLEX_JOBJ_DATA, payloadStart, size);
+    if (object == nullptr) {
+        return false;
+    }
+    const char* data = object + payloadStart;
+    size_t length = static_cast<size_t>(size - payloadStart);
+    uint8_t flags = static_cast<uint8_t>(object[1]);
+    
+    bool decoded = true;
+    if (flags & FLEX_JOBJ_XZ) {
+        decoded = flexDecompressXZ(data, length, scratch);
+    } else if (flags & FLEX_JOBJ_LZ4) {
+        decoded = flexDecompressLZ4(data, length, scratch);
+    } else if (flags & FLEX_JOBJ_ZSTD) {
+        decoded = flexDecompressZSTD(data, length, scratch);
+    } else {
+        payload = std::string_view(data, length);
+        return true;
+    }
+    if (!decoded) {
+        flexUndecodable++;
+        return false;
+    }
+    payload = scratch;
+    return true;
+}
+
+uint64_t FlexJournalFile::flexHash(std::string_view data) const {
+    if (flexIncompatible & FLEX_JOURNAL_KEYED_HASH) {
+        return flexSipHash24(data.data(), data.size(), flexFile.data() + FLEX_JH_FILE_ID);
+    }
+    return flexJenkinsHash64(data.data(), data.size());
+}
+
+uint64_t FlexJournalFile::flexFindField(std::string_view field) const {
+    const char* header = flexFile.data();
+    uint64_t tableOffset = flexLE64(header + FLEX_JH_FIELD_HASH_OFFSET);
+    uint64_t tableSize = flexLE64(header + FLEX_JH_FIELD_HASH_SIZE);
+    uint64_t buckets = tableSize / 16;
+    if (buckets == 0 || tableOffset > flexFile.size() || tableSize > flexFile.size() - tableOffset) {
+        return 0;
+    }
+    
+    uint64_t hash = flexHash(field);
+    uint64_t offset = flexLE64(header + tableOffset + (hash % buckets) * 16);
+    // 链长以对象数为上限, 防止损坏文件中的环
+    for (uint64_t steps = 0; offset != 0 && steps < flexFile.size() / FLEX_JOBJ_HEADER; ++steps) {
+        uint64_t size = 0;
+        const char* object = flexObject(offset, FLEX_JOBJ_FIELD, FLEX_JFIELD_PAYLOAD, size);
+        if (object == nullptr) {
+            return 0;
+        }
+        std::string_view name(object + FLEX_JFIELD_PAYLOAD, static_cast<size_t>(size - FLEX_JFIELD_PAYLOAD));
+        if (flexLE64(object + FLEX_JFIELD_HASH) == hash && name == field) {
+            return offset;
+        }
+        offset = flexLE64(object + FLEX_JFIELD_NEXT_HASH);
+    }
+    return 0;
+}
+
+void FlexJournalFile::flexWalkEntryArray(uint64_t arrayOffset, uint64_t limit, std::vector<uint64_t>& out) const {
+    bool compact = (flexIncompatible & FLEX_JOURNAL_COMPACT) != 0;
+    size_t itemSize = compact ? 4 : 8;
+    uint64_t taken = 0;
+    for (uint64_t steps = 0; arrayOffset != 0 && taken < limit && steps < flexFile.size() / FLEX_JARRAY_ITEMS; ++steps) {
+        uint64_t size = 0;
+        const char* object = flexObject(arrayOffset, FLEX_JOBJ_ENTRY_ARRAY, FLEX_JARRAY_ITEMS, size);
+        if (object == nullptr) {
+            return;
+        }
+        uint64_t items = (size - FLEX_JARRAY_ITEMS) / itemSize;
+        for (uint64_t i = 0; i < items && taken < limit; ++i) {
+            const char* item = object + FLEX_JARRAY_ITEMS + i * itemSize;
+            uint64_t entry = compact ? flexLE32(item) : flexLE64(item);
+            // 数组尾部预留的空位
+            if (entry == 0) {
+                return;
+            }
+            out.push_back(entry);
+            taken++;
+        }
+        arrayOffset = flexLE64(object + FLEX_JARRAY_NEXT);
+    }
+}
+
+void FlexJournalFile::flexDataEntries(uint64_t dataOffset, std::vector<uint64_t>& out) const {
+    uint64_t size = 0;
+    const char* object = flexObject(dataOffset, FLEX_JOBJ_DATA, FLEX_JDATA_PAYLOAD, size);
+    if (object == nullptr) {
+        return;
+    }
+    // 第一个条目直接记在数据对象里, 其余在条目数组链中
+    uint64_t count = flexLE64(object + FLEX_JDATA_N_ENTRIES);
+    uint64_t first = flexLE64(object + FLEX_JDATA_ENTRY);
+    if (count == 0 || first == 0) {
+        return;
+    }
+    out.push_back(first);
+    flexWalkEntryArray(flexLE64(object + FLEX_JDATA_ENTRY_ARRAY), count - 1, out);
+}
+
+std::vector<uint64_t> FlexJournalFile::flexFieldEntries(std::string_view field,
+                                                        const std::function<bool(std::string_view)>& accept) const {
+    std::vector<uint64_t> entries;
+    uint64_t fieldOffset = flexFindField(field);
+    uint64_t size = 0;
+    const char* object = flexObject(fieldOffset, FLEX_JOBJ_FIELD, FLEX_JFIELD_PAYLOAD, size);
+    if (object == nullptr) {
+        return entries;
+    }
+    
+    // 同一字段的数据对象由 next_field_offset 串成链
+    size_t matched = 0;
+    uint64_t dataOffset = flexLE64(object + FLEX_JFIELD_HEAD_DATA);
+    std::string scratch;
+    for (uint64_t steps = 0; dataOffset != 0 && steps < flexFile.size() / FLEX_JOBJ_HEADER; ++steps) {
+        uint64_t dataSize = 0;
+        const char* data = flexObject(dataOffset, FLEX_JOBJ_DATA, FLEX_JDATA_PAYLOAD, dataSize);
+        if (data == nullptr) {
+            break;
+        }
+        std::string_view payload;
+        if (flexPayload(dataOffset, payload, scratch) && payload.size() > field.size() &&
+            payload.compare(0, field.size(), field) == 0 && payload[field.size()] == '=' &&
+            accept(payload.substr(field.size() + 1))) {
+            flexDataEntries(dataOffset, entries);
+            matched++;
+        }
+        dataOffset = flexLE64(data + FLEX_JDATA_NEXT_FIELD);
+    }
+    // 多个取值的条目列表各自有序, 合并后去重
+    if (matched > 1) {
+        std::sort(entries.begin(), entries.end());
+        entries.erase(std::unique(entries.begin(), entries.end()), entries.end());
+    }
+    return entries;
+}
+
+std::vector<uint64_t> FlexJournalFile::matchEntries(const FlexJournalFilter& filter) const {
+    std::vector<uint64_t> entries;
+    if (!flexValid) {
+        return entries;
+    }
+    
+    bool filtered = false;
+    if (!filter.units.empty()) {
+        std::vector<std::string> units;
+        for (const auto& unit : filter.units) {
+            units.push_back(unit.find('.') == std::string::npos ? unit + ".service" : unit);
+        }
+        entries = flexFieldEntries("_SYSTEMD_UNIT", [&units](std::string_view value) {
+            return std::find(units.begin(), units.end(), value) != units.end();
+        });
+        filtered = true;
+    }
+    if (filter.maxPriority < 7) {
+        std::vector<uint64_t> byPriority = flexFieldEntries("PRIORITY", [&filter](std::string_view value) {
+            return value.size() == 1 && value[0] >= '0' && value[0] - '0' <= filter.maxPriority;
+        });
+        if (filtered) {
+            std::vector<uint64_t> both;
+            std::set_intersection(entries.begin(), entries.end(), byPriority.begin(), byPriority.end(),
+                                  std::back_inserter(both));
+            entries.swap(both);
+        } else {
+            entries.swap(byPriority);
+        }
+        filtered = true;
+    }
+    if (!filtered) {
+        // 全局条目数组链按写入顺序列出全部条目
+        const char* header = flexFile.data();
+        entries.reserve(static_cast<size_t>(std::min<uint64_t>(entryCount(), flexFile.size() / FLEX_JENTRY_ITEMS)));
+        flexWalkEntryArray(flexLE64(header + FLEX_JH_ENTRY_ARRAY), entryCount(), entries);
+    }
+    return entries;
+}
+
+bool FlexJournalFile::entryRealtime(uint64_t offset, uint64_t& realtime) const {
+    uint64_t size = 0;
+    const char* object = flexObject(offset, FLEX_JOBJ_ENTRY, FLEX_JENTRY_ITEMS, size);
+    if (object == nullptr) {
+        return false;
+    }
+    realtime = flexLE64(object + FLEX_JENTRY_REALTIME);
+    return true;
+}
+
+bool FlexJournalFile::readEntry(uint64_t offset, FlexJournalEntry& entry) const {
+    uint64_t size = 0;
+    const char* object = flexObject(offset, FLEX_JOBJ_ENTRY, FLEX_JENTRY_ITEMS, size);
+    if (object == nullptr) {
+        return false;
+    }
+    entry = FlexJournalEntry();
+    entry.offset = offset;
+    entry.seqnum = flexLE64(object + FLEX_JENTRY_SEQNUM);
+    entry.realtime = flexLE64(object + FLEX_JENTRY_REALTIME);
+    
+    bool compact = (flexIncompatible & FLEX_JOURNAL_COMPACT) != 0;
+    size_t itemSize = compact ? 4 : 16;
+    uint64_t items = (size - FLEX_JENTRY_ITEMS) / itemSize;
+    std::string scratch;
+    for (uint64_t i = 0; i < items; ++i) {
+        const char* item = object + FLEX_JENTRY_ITEMS + i * itemSize;
+        uint64_t dataOffset = compact ? flexLE32(item) : flexLE64(item);
+        std::string_view payload;
+        if (!flexPayload(dataOffset, payload, scratch)) {
+            continue;
+        }
+        if (flexHasPrefix(payload, "MESSAGE=")) {
+            entry.message.assign(payload.substr(8));
+        } else if (flexHasPrefix(payload, "PRIORITY=")) {
+            if (payload.size() == 10 && payload[9] >= '0' && payload[9] <= '7') {
+                entry.priority = payload[9] - '0';
+            }
+        } else if (flexHasPrefix(payload, "_SYSTEMD_UNIT=")) {
+            entry.unit.assign(payload.substr(14));
+        } else if (flexHasPrefix(payload, "SYSLOG_IDENTIFIER=")) {
+            entry.identifier.assign(payload.substr(18));
+        } else if (flexHasPrefix(payload, "_PID=")) {
+            entry.pid.assign(payload.substr(5));
+        }
+    }
+    entry.level = entry.priority >= 0 ? flexJournalPriorityLevel(entry.priority) : flexClassifyLogLine(entry.message);
+    return true;
+}
+
+std::vector<std::string> FlexJournalFile::fieldValues(std::string_view field) const {
+    std::vector<std::string> values;
+    if (!flexValid) {
+        return values;
+    }
+    flexFieldEntries(field, [&values](std::string_view value) {
+        values.emplace_back(value);
+        return false;
+    });
+    std::sort(values.begin(), values.end());
+    return values;
+}
+
+FlexJournalReader::FlexJournalReader(std::vector<std::string> dirs) : flexDirs(std::move(dirs)) {
+}
+
+std::vector<std::string> FlexJournalReader::discoverFiles() const {
+    std::vector<std::string> files;
+    // 目录结构: <dir>/<machine-id>/*.journal, 也兼容直接放在 <dir> 下的文件
+    std::function<void(const std::string&, int)> scan = [&](const std::string& dir, int depth) {
+        DIR* handle = opendir(dir.c_str());
+        if (handle == nullptr) {
+            return;
+        }
+        while (struct dirent* entry = readdir(handle)) {
+            std::string name = entry->d_name;
+            if (name == "." || name == "..") {
+                continue;
+            }
+            std::string path = dir + "/" + name;
+            struct stat st;
+            if (stat(path.c_str(), &st) != 0) {
+                continue;
+            }
+            if (S_ISDIR(st.st_mode)) {
+                if (depth == 0) scan(path, depth + 1);
+            } else if (S_ISREG(st.st_mode) &&
+                       ((name.size() > 8 && name.compare(name.size() - 8, 8, ".journal") == 0) ||
+                        (name.size() > 9 && name.compare(name.size() - 9, 9, ".journal~") == 0))) {
+                files.push_back(path);
+            }
+        }
+        closedir(handle);
+    };
+    for (const auto& dir : flexDirs) {
+        scan(dir, 0);
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+size_t FlexJournalReader::read(const FlexJournalFilter& filter,
+                               const std::function<void(const FlexJournalEntry&, size_t)>& onEntry) {
+    flexFiles.clear();
+    flexUndecodable = 0;
+    std::vector<std::unique_ptr<FlexJournalFile>> journals;
+    std::vector<std::vector<uint64_t>> matches;
+    for (const auto& path : discoverFiles()) {
+        auto journal = std::make_unique<FlexJournalFile>(path);
+        if (!journal->isOpen()) {
+            continue;
+        }
+        matches.push_back(journal->matchEntries(filter));
+        journals.push_back(std::move(journal));
+        flexFiles.push_back(path);
+    }
+    
+    // 各文件内部已按时间排序, 用最小堆按 realtime 归并, 每个文件只保留一个游标
+    struct Cursor {
+        uint64_t realtime;
+        size_t file;
+        size_t index;
+        bool operator>(const Cursor& other) const {
+            return realtime != other.realtime ? realtime > other.realtime : file > other.file;
+        }
+    };
+    std::priority_queue<Cursor, std::vector<Cursor>, std::greater<Cursor>> heap;
+    auto advance = [&](size_t file, size_t index) {
+        for (; index < matches[file].size(); ++index) {
+            uint64_t realtime = 0;
+            if (journals[file]->entryRealtime(matches[file][index], realtime)) {
+                heap.push(Cursor{realtime, file, index});
+                return;
+            }
+        }
+    };
+    for (size_t file = 0; file < journals.size(); ++file) {
+        advance(file, 0);
+    }
+    
+    size_t count = 0;
+    FlexJournalEntry entry;
+    while (!heap.empty()) {
+        Cursor cursor = heap.top();
+        heap.pop();
+        if (journals[cursor.file]->readEntry(matches[cursor.file][cursor.index], entry)) {
+            onEntry(entry, cursor.file);
+            count++;
+        }
+        advance(cursor.file, cursor.index + 1);
+    }
+    for (const auto& journal : journals) {
+        flexUndecodable += journal->undecodable();
+    }
+    return count;
+}
+
+std::vector<FlexJournalEntry> FlexJournalReader::entries(const FlexJournalFilter& filter) {
+    std::vector<FlexJournalEntry> result;
+    read(filter, [&result](const FlexJournalEntry& entry, size_t) {
+        result.push_back(entry);
+    });
+    return result;
+}
+
+void FlexJournalReader::printEntries(const std::vector<FlexJournalEntry>& entries, FlexOutputFormat format) const {
+    if (format == FlexOutputFormat::JSON) {
+        std::cout << toJSON(entries) << std::endl;
+        return;
+    }
+    if (format == FlexOutputFormat::CSV) {
+        std::cout << toCSV(entries) << std::endl;
+        return;
+    }
+    
+    std::cout << FLEX_COLOR_CYAN << "\n=== FlexTools Journal ===" << FLEX_COLOR_RESET << std::endl;
+    for (const auto& entry : entries) {
+        flexWriteEntryText(std::cout, entry);
+    }
+    flexPrintTotals(entries.size());
+}
+
+void FlexJournalReader::flexPrintTotals(size_t count) const {
+    std::cout << FLEX_COLOR_GREEN << "\nTotal: " << count << " entries from " << flexFiles.size()
+              << " journal files" << FLEX_COLOR_RESET << std::endl;
+    if (flexUndecodable > 0) {
+        std::cout << FLEX_COLOR_YELLOW << "Skipped " << flexUndecodable
+                  << " compressed fields (decompressor not built in)" << FLEX_COLOR_RESET << std::endl;
+    }
+}
+
+size_t FlexJournalReader::printStream(const FlexJournalFilter& filter, FlexOutputFormat format) {
+    // 文件数与跳过的字段数要读完才知道, JSON 中放在条目数组之后
+    size_t count = 0;
+    if (format == FlexOutputFormat::JSON) {
+        std::cout << "{\n  \"flex_journal\": {\n    \"entries\": [";
+        bool first = true;
+        count = read(filter, [&first](const FlexJournalEntry& entry, size_t) {
+            flexWriteEntryJSON(std::cout, entry, first);
+            first = false;
+        });
+        std::cout << "\n    ],\n    \"files\": " << flexFiles.size() << ",\n    \"total\": " << count
+                  << ",\n    \"undecodable\": " << flexUndecodable << "\n  }\n}" << std::endl;
+    } else if (format == FlexOutputFormat::CSV) {
+        std::cout << FLEX_JOURNAL_CSV_HEADER;
+        count = read(filter, [](const FlexJournalEntry& entry, size_t) {
+            flexWriteEntryCSV(std::cout, entry);
+        });
+        std::cout << std::flush;
+    } else {
+        std::cout << FLEX_COLOR_CYAN << "\n=== FlexTools Journal ===" << FLEX_COLOR_RESET << std::endl;
+        count = read(filter, [](const FlexJournalEntry& entry, size_t) {
+            flexWriteEntryText(std::cout, entry);
+        });
+        flexPrintTotals(count);
+    }
+    return count;
+}
+
+std::string FlexJournalReader::toJSON(const std::vector<FlexJournalEntry>& entries) const {
+    std::ostringstream json;
+    json << "{\n  \"flex_journal\": {\n";
+    json << "    \"files\": " << flexFiles.size() << ",\n";
+    json << "    \"total\": " << entries.size() << ",\n";
+    json << "    \"undecodable\": " << flexUndecodable << ",\n";
+    json << "    \"entries\": [";
+    for (size_t i = 0; i < entries.size(); ++i) {
+        flexWriteEntryJSON(json, entries[i], i == 0);
+    }
+    json << "\n    ]\n  }\n}";
+    return json.str();
+}
+
+std::string FlexJournalReader::toCSV(const std::vector<FlexJournalEntry>& entries) const {
+    std::ostringstream csv;
+    csv << FLEX_JOURNAL_CSV_HEADER;
+    for (const auto& entry : entries) {
+        flexWriteEntryCSV(csv, entry);
+    }
+    return csv.str();
+}
+
+} // namespace FlexTools
@@ -0,0 +1,116 @@
+#ifndef FLEX_JOURNAL_READER_H
+#define FLEX_JOURNAL_READER_H
+
+#include "flex_common.h"
+#include "flex_mapped_file.h"
+#include <cstdint>
+#include <functional>
+#include <string_view>
+
+namespace FlexTools {
+
+// 一条 journald 记录
+struct FlexJournalEntry {
+    uint64_t realtime = 0;   // 微秒, CLOCK_REALTIME
+    uint64_t seqnum = 0;
+    uint64_t offset = 0;     // ENTRY 对象在文件中的偏移
+    int priority = -1;       // PRIORITY 字段, 缺失时为 -1
+    FlexLogLevel level = FlexLogLevel::INFO;
+    std::string unit;        // _SYSTEMD_UNIT
+    std::string identifier;  // SYSLOG_IDENTIFIER
+    std::string pid;         // _PID
+    std::string message;     // MESSAGE
+};
+
+// 过滤条件, 默认读取全部记录
+struct FlexJournalFilter {
+    std::vector<std::string> units; // _SYSTEMD_UNIT, 不含 '.' 时按 "<name>.service" 匹配
+    int maxPriority = 7;            // 小于 7 时只保留 PRIORITY <= maxPriority 的记录
+};
+
+// syslog 优先级 (0-7) 对应的级别; 无优先级时按 MESSAGE 关键字判断
+FlexLogLevel flexJournalPriorityLevel(int priority);
+
+// 解析 "0"-"7" 或 emerg/alert/crit/err/warning/notice/info/debug, 失败返回 -1
+int flexParseJournalPriority(const std::string& text);
+
+// 单个 .journal 文件 (systemd 的二进制日志格式), 整个只读映射.
+// 所有对象偏移都做边界与类型检查, 正在写入或损坏的文件只会少读条目
+class FlexJournalFile {
+public:
+    explicit FlexJournalFile(const std::string& path);
+    
+    bool isOpen() const { return flexValid; }
+    const std::string& path() const { return flexPath; }
+    uint64_t entryCount() const;
+    uint64_t headRealtime() const;
+    
+    // 满足过滤条件的条目偏移, 按文件顺序 (即写入顺序).
+    // 有条件时经字段哈希表找到字段的全部取值, 只展开匹配取值的条目数组
+    std::vector<uint64_t> matchEntries(const FlexJournalFilter& filter) const;
+    
+    // 条目的时间戳 (用于多文件归并), 偏移无效时返回 false
+    bool entryRealtime(uint64_t offset, uint64_t& realtime) const;
+    
+    // 解析条目的常用字段
+    bool readEntry(uint64_t offset, FlexJournalEntry& entry) const;
+    
+    // 经字段哈希表列出某字段的全部取值
+    std::vector<std::string> fieldValues(std::string_view field) const;
+    
+    // 因缺少对应解压库而跳过的数据对象数
+    uint64_t undecodable() const { return flexUndecodable; }
+
+private:
+    std::string flexPath;
+    FlexMappedFile flexFile;
+    bool flexValid = false;
+    uint32_t flexIncompatible = 0;
+    mutable uint64_t flexUndecodable = 0;
+    
+    const char* flexObject(uint64_t offset, uint8_t type, uint64_t minSize, uint64_t& size) const;
+    bool flexPayload(uint64_t offset, std::string_view& payload, std::string& scratch) const;
+    uint64_t flexHash(std::string_view data) const;
+    uint64_t flexFindField(std::string_view field) const;
+    void flexWalkEntryArray(uint64_t arrayOffset, uint64_t limit, std::vector<uint64_t>& out) const;
+    void flexDataEntries(uint64_t dataOffset, std::vector<uint64_t>& out) const;
+    std::vector<uint64_t> flexFieldEntries(std::string_view field,
+                                           const std::function<bool(std::string_view)>& accept) const;
+};
+
+// journal 目录 (含 machine-id 子目录) 下的全部文件, 按 realtime 多路归并输出
+class FlexJournalReader {
+public:
+    explicit FlexJournalReader(std::vector<std::string> dirs = {"/var/log/journal", "/run/log/journal"});
+    
+    // *.journal 与 *.journal~ (异常关闭的文件)
+    std::vector<std::string> discoverFiles() const;
+    
+    // onEntry(entry, file) 中 file 为 files() 下标; 返回输出的条目数
+    size_t read(const FlexJournalFilter& filter,
+                const std::function<void(const FlexJournalEntry&, size_t)>& onEntry);
+    
+    const std::vector<std::string>& files() const { return flexFiles; }
+    uint64_t undecodable() const { return flexUndecodable; }
+    
+    // 便捷接口: 读取全部匹配记录 (全部留在内存中, 大量记录时用 printStream)
+    std::vector<FlexJournalEntry> entries(const FlexJournalFilter& filter);
+    
+    // 边读边输出到 stdout, 内存与记录数无关; 返回输出的条目数
+    size_t printStream(const FlexJournalFilter& filter, FlexOutputFormat format = FlexOutputFormat::TEXT);
+    
+    void printEntries(const std::vector<FlexJournalEntry>& entries, FlexOutputFormat format = FlexOutputFormat::TEXT) const;
+    std::string toJSON(const std::vector<FlexJournalEntry>& entries) const;
+    std::string toCSV(const std::vector<FlexJournalEntry>& entries) const;
+
+private:
+    std::vector<std::string> flexDirs;
+    std::vector<std::string> flexFiles;
+    uint64_t flexUndecodable = 0;
+    
+    void flexPrintTotals(size_t count) const;
+};
+
+} // namespace FlexTools
+
+#endif // FLEX_JOURNAL_READER_H
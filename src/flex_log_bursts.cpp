@@ -0,0 +1,375 @@
+#include "flex_log_bursts.h"
+#include <algorithm>
+#include <climits>
+#include <ctime>
+#include <sys/stat.h>
+
+namespace FlexTools {
+
+namespace {
+
+// 槽位: 全程累计, 当前窗, 基线; 其后为历史窗
+constexpr size_t FLEX_SLOT_TOTAL = 0;
+constexpr size_t FLEX_SLOT_WINDOW = 1;
+constexpr size_t FLEX_SLOT_BASELINE = 2;
+constexpr size_t FLEX_SLOT_HISTORY = 3;
+// 至少积累这么多个历史窗才判断突增, 避免文件开头所有键都被当作新出现
+constexpr size_t FLEX_MIN_HISTORY = 5;
+// 保留的突增记录数
+constexpr size_t FLEX_BURST_LIMIT = 200;
+// 键中标识与级别之间的分隔符
+constexpr char FLEX_KEY_SEPARATOR = '\x1f';
+
+// 跳过 count 个以空白分隔的词
+size_t flexSkipTokens(std::string_view line, size_t pos, size_t count) {
+    for (size_t i = 0; i < count && pos < line.size(); ++i) {
+        while (pos < line.size() && flexIsSpace(line[pos])) ++pos;
+        while (pos < line.size() && !flexIsSpace(line[pos])) ++pos;
+    }
+    while (pos < line.size() && flexIsSpace(line[pos])) ++pos;
+    return pos;
+}
+
+// syslog 标识: "ident[pid]:" 或 "ident:" 中的 ident, 不是这种形式时返回空
+std::string_view flexSyslogIdentifier(std::string_view line, size_t pos) {
+    size_t end = pos;
+    while (end < line.size() && !flexIsSpace(line[end])) ++end;
+    std::string_view token = line.substr(pos, end - pos);
+    if (token.size() < 2 || token.back() != ':') {
+        return {};
+    }
+    token.remove_suffix(1);
+    size_t bracket = token.find('[');
+    if (bracket != std::string_view::npos && token.back() == ']') {
+        token = token.substr(0, bracket);
+    }
+    return token;
+}
+
+// 64 位哈希, 两半分别作为双重哈希的 h1 与 h2
+inline uint64_t flexHashKey(const std::string& key) {
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : key) {
+        hash = (hash ^ c) * 1099511628211ull;
+    }
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+inline size_t flexCell(uint64_t hash, size_t row, size_t width) {
+    uint32_t h1 = static_cast<uint32_t>(hash);
+    uint32_t h2 = static_cast<uint32_t>(hash >> 32) | 1;
+    return row * width + (h1 + row * h2) % width;
+}
+
+// 键 "标识\x1f级别" 拆回两部分
+void flexSplitKey(const std::string& key, std::string& identifier, FlexLogLevel& level) {
+    identifier = key.substr(0, key.size() - 2);
+    level = static_cast<FlexLogLevel>(key.back() - '0');
+}
+
+} // namespace
+
+void FlexLogBurstDetector::TopK::offer(const std::string& key, uint64_t count, uint32_t source) {
+    auto found = flexIndex.find(key);
+    if (found != flexIndex.end()) {
+        // 估计值只增不减, 在最小堆中只需下沉
+        flexHeap[found->second].count = count;
+        flexHeap[found->second].source = source;
+        flexSiftDown(found->second);
+        return;
+    }
+    if (flexHeap.size() < flexLimit) {
+        flexIndex.emplace(key, flexHeap.size());
+        flexHeap.push_back(Entry{key, count, source});
+        flexSiftUp(flexHeap.size() - 1);
+    } else if (!flexHeap.empty() && count > flexHeap[0].count) {
+        flexIndex.erase(flexHeap[0].key);
+        flexHeap[0].key = key;
+        flexHeap[0].count = count;
+        flexHeap[0].source = source;
+        flexIndex.emplace(key, 0);
+        flexSiftDown(0);
+    }
+}
+
+void FlexLogBurstDetector::TopK::clear() {
+    flexHeap.clear();
+    flexIndex.clear();
+}
+
+void FlexLogBurstDetector::TopK::flexSiftUp(size_t i) {
+    while (i > 0) {
+        size_t parent = (i - 1) / 2;
+        if (flexHeap[parent].count <= flexHeap[i].count) break;
+        flexSwap(i, parent);
+        i = parent;
+    }
+}
+
+void FlexLogBurstDetector::TopK::flexSiftDown(size_t i) {
+    for (;;) {
+        size_t smallest = i;
+        size_t left = 2 * i + 1;
+        size_t right = left + 1;
+        if (left < flexHeap.size() && flexHeap[left].count < flexHeap[smallest].count) smallest = left;
+        if (right < flexHeap.size() && flexHeap[right].count < flexHeap[smallest].count) smallest = right;
+        if (smallest == i) break;
+        flexSwap(i, smallest);
+        i = smallest;
+    }
+}
+
+void FlexLogBurstDetector::TopK::flexSwap(size_t a, size_t b) {
+    std::swap(flexHeap[a], flexHeap[b]);
+    flexIndex[flexHeap[a].key] = a;
+    flexIndex[flexHeap[b].key] = b;
+}
+
+FlexLogBurstDetector::FlexLogBurstDetector(unsigned windowSeconds, size_t history, size_t topK, double factor,
+                                           uint64_t minCount)
+    : flexWindowSeconds(std::max(windowSeconds, 1u)),
+      flexHistory(std::max<size_t>(history, 1)),
+      flexFactor(factor),
+      flexMinCount(minCount),
+      flexSketches((FLEX_SLOT_HISTORY + flexHistory) * FLEX_SKETCH_CELLS, 0),
+      flexTotalTop(topK),
+      flexWindowTop(topK) {
+}
+
+void FlexLogBurstDetector::beginSource(uint32_t source, const std::string& name) {
+    if (flexSources.size() <= source) {
+        flexSources.resize(source + 1);
+    }
+    flexSources[source] = name;
+    size_t slash = name.find_last_of('/');
+    flexSourceBase = slash == std::string::npos ? name : name.substr(slash + 1);
+    // syslog 时间戳没有年份, 以文件修改时间为参照
+    struct stat st;
+    time_t reference = stat(name.c_str(), &st) == 0 ? st.st_mtime : time(nullptr);
+    flexParser.reset(new FlexLogTimeParser(reference));
+    // journal 归并时多个源交错打开, 它们共用一条时间线, 只在没有打开的源时重新计时
+    if (flexOpenSources++ == 0) {
+        flexResetWindows();
+    }
+}
+
+void FlexLogBurstDetector::endSource(uint32_t source) {
+    (void)source;
+    if (flexOpenSources > 0 && --flexOpenSources > 0) {
+        return;
+    }
+    if (flexWindow != INT64_MIN) {
+        flexCloseWindow();
+    }
+    flexResetWindows();
+}
+
+void FlexLogBurstDetector::flexResetWindows() {
+    std::fill(flexSketches.begin() + FLEX_SLOT_WINDOW * FLEX_SKETCH_CELLS, flexSketches.end(), 0);
+    flexHistoryNext = 0;
+    flexHistoryFilled = 0;
+    flexWindow = INT64_MIN;
+    flexWindowTop.clear();
+}
+
+void FlexLogBurstDetector::consume(const FlexLogLine& line) {
+    std::string_view text = line.text;
+    size_t pos = 0;
+    time_t stamp = static_cast<time_t>(line.time);
+    bool parsed = line.time == 0 && flexParser && flexParser->parse(text, stamp);
+    if (parsed || line.time != 0) {
+        int64_t window = static_cast<int64_t>(stamp) - static_cast<int64_t>(stamp) % flexWindowSeconds;
+        if (flexWindow == INT64_MIN) {
+            flexWindow = window;
+        }
+        // 时间前进时依次关闭经过的窗口 (空窗也计入历史), 跨度超过历史长度时只需关闭这么多次;
+        // 稍早的乱序行计入当前窗
+        size_t closes = 0;
+        while (window > flexWindow && closes <= flexHistory) {
+            flexCloseWindow();
+            flexWindow += flexWindowSeconds;
+            closes++;
+        }
+        if (window > flexWindow) {
+            flexWindow = window;
+        }
+    }
+    if (parsed) {
+        // 时间戳之后是主机名, 再后面是 "ident[pid]:"
+        pos = flexSkipTokens(text, 0, FlexLogTimeParser::timestampTokens(text) + 1);
+    }
+    std::string_view identifier = flexSyslogIdentifier(text, pos);
+    if (identifier.empty()) {
+        // journal 行 "ident[pid]: 消息" 没有时间戳与主机名
+        identifier = flexSyslogIdentifier(text, 0);
+    }
+    if (identifier.empty()) {
+        identifier = flexSourceBase;
+    }
+    
+    flexKey.assign(identifier.data(), identifier.size());
+    flexKey.push_back(FLEX_KEY_SEPARATOR);
+    flexKey.push_back(static_cast<char>('0' + static_cast<int>(line.level)));
+    uint64_t hash = flexHashKey(flexKey);
+    
+    // 每行 depth 次自增 (累计与当前窗), 估计值取各行最小
+    uint32_t* total = flexSketch(FLEX_SLOT_TOTAL);
+    uint32_t* current = flexSketch(FLEX_SLOT_WINDOW);
+    uint32_t totalEstimate = UINT32_MAX;
+    uint32_t windowEstimate = UINT32_MAX;
+    for (size_t row = 0; row < FLEX_SKETCH_DEPTH; ++row) {
+        size_t cell = flexCell(hash, row, FLEX_SKETCH_WIDTH);
+        totalEstimate = std::min(totalEstimate, ++total[cell]);
+        windowEstimate = std::min(windowEstimate, ++current[cell]);
+    }
+    flexTotalTop.offer(flexKey, totalEstimate, line.source);
+    flexWindowTop.offer(flexKey, windowEstimate, line.source);
+}
+
+uint64_t FlexLogBurstDetector::flexEstimate(const uint32_t* sketch, uint64_t hash) const {
+    uint32_t estimate = UINT32_MAX;
+    for (size_t row = 0; row < FLEX_SKETCH_DEPTH; ++row) {
+        estimate = std::min(estimate, sketch[flexCell(hash, row, FLEX_SKETCH_WIDTH)]);
+    }
+    return estimate;
+}
+
+void FlexLogBurstDetector::flexCloseWindow() {
+    uint32_t* current = flexSketch(FLEX_SLOT_WINDOW);
+    uint32_t* baseline = flexSketch(FLEX_SLOT_BASELINE);
+    
+    // 当前窗的高频键与之前各窗的平均值比较
+    if (flexHistoryFilled >= std::min(flexHistory, FLEX_MIN_HISTORY)) {
+        for (const auto& entry : flexWindowTop.entries()) {
+            if (entry.count < flexMinCount) continue;
+            double average = static_cast<double>(flexEstimate(baseline, flexHashKey(entry.key))) / flexHistoryFilled;
+            if (entry.count < flexFactor * std::max(average, 1.0)) continue;
+            std::string identifier;
+            FlexLogLevel level;
+            flexSplitKey(entry.key, identifier, level);
+            // 紧接上一窗的同一突增合并为一条; 最近的记录都在末尾
+            Burst* previous = nullptr;
+            for (auto it = flexBursts.rbegin(); it != flexBursts.rend() && it->last + flexWindowSeconds >= flexWindow;
+                 ++it) {
+                if (it->last + flexWindowSeconds == flexWindow && it->source == entry.source && it->level == level &&
+                    it->identifier == identifier) {
+                    previous = &*it;
+                    break;
+                }
+            }
+            if (previous != nullptr) {
+                previous->last = flexWindow;
+                previous->count += entry.count;
+                previous->peak = std::max(previous->peak, entry.count);
+                continue;
+            }
+            Burst burst;
+            burst.identifier = std::move(identifier);
+            burst.level = level;
+            burst.window = flexWindow;
+            burst.last = flexWindow;
+            burst.count = entry.count;
+            burst.peak = entry.count;
+            burst.baseline = average;
+            burst.source = entry.source;
+            flexBursts.push_back(std::move(burst));
+            if (flexBursts.size() > FLEX_BURST_LIMIT) {
+                flexBursts.pop_front();
+            }
+        }
+    }
+    
+    // 当前窗移入历史: 基线减去被替换的最旧窗, 加上当前窗
+    uint32_t* slot = flexSketch(FLEX_SLOT_HISTORY + flexHistoryNext);
+    for (size_t i = 0; i < FLEX_SKETCH_CELLS; ++i) {
+        baseline[i] += current[i] - slot[i];
+    }
+    std::copy(current, current + FLEX_SKETCH_CELLS, slot);
+    std::fill(current, current + FLEX_SKETCH_CELLS, 0);
+    flexHistoryNext = (flexHistoryNext + 1) % flexHistory;
+    flexHistoryFilled = std::min(flexHistoryFilled + 1, flexHistory);
+    flexWindowTop.clear();
+}
+
+std::vector<FlexLogBurstDetector::Counter> FlexLogBurstDetector::heavyHitters() const {
+    std::vector<Counter> result;
+    for (const auto& entry : flexTotalTop.entries()) {
+        Counter counter;
+        flexSplitKey(entry.key, counter.identifier, counter.level);
+        counter.count = entry.count;
+        result.push_back(std::move(counter));
+    }
+    std::sort(result.begin(), result.end(), [](const Counter& a, const Counter& b) { return a.count > b.count; });
+    return result;
+}
+
+void FlexLogBurstDetector::printBursts(FlexOutputFormat format) const {
+    if (format == FlexOutputFormat::JSON) {
+        std::cout << toJSON() << std::endl;
+        return;
+    }
+    if (format == FlexOutputFormat::CSV) {
+        std::cout << toCSV() << std::endl;
+        return;
+    }
+    
+    std::cout << FLEX_COLOR_CYAN << "\n=== FlexTools Top Log Sources ===" << FLEX_COLOR_RESET << std::endl;
+    std::cout << std::left << std::setw(32) << "Identifier" << std::setw(10) << "Level" << std::right
+              << std::setw(12) << "Lines" << std::endl;
+    for (const auto& counter : heavyHitters()) {
+        std::cout << std::left << std::setw(32) << counter.identifier << std::setw(10)
+                  << flexLogLevelName(counter.level) << std::right << std::setw(12) << counter.count << std::endl;
+    }
+    
+    std::cout << FLEX_COLOR_CYAN << "\n=== Bursts (" << flexWindowSeconds << "s windows, >= " << flexFactor
+              << "x trailing average) ===" << FLEX_COLOR_RESET << std::endl;
+    for (const auto& burst : flexBursts) {
+        std::ostringstream average;
+        average << std::fixed << std::setprecision(1) << burst.baseline;
+        std::cout << FLEX_COLOR_RED << flexFormatTime(burst.window) << FLEX_COLOR_RESET << "  " << std::left
+                  << std::setw(32) << burst.identifier << std::setw(10) << flexLogLevelName(burst.level)
+                  << std::right << std::setw(10) << burst.count << " lines in "
+                  << (burst.last - burst.window) / flexWindowSeconds + 1 << " windows, peak " << burst.peak
+                  << " (avg " << average.str() << ")  " << flexSources[burst.source] << std::endl;
+    }
+    std::cout << FLEX_COLOR_GREEN << "\nTotal: " << flexBursts.size() << " bursts" << FLEX_COLOR_RESET << std::endl;
+}
+
+std::string FlexLogBurstDetector::toJSON() const {
+    std::ostringstream oss;
+    oss << "{\n  \"flex_log_bursts\": {\n";
+    oss << "    \"window_seconds\": " << flexWindowSeconds << ",\n";
+    oss << "    \"top\": [";
+    auto top = heavyHitters();
+    for (size_t i = 0; i < top.size(); ++i) {
+        oss << (i ? ",\n" : "\n") << "      {\"identifier\": \"" << flexEscapeJSON(top[i].identifier)
+            << "\", \"level\": \"" << flexLogLevelName(top[i].level) << "\", \"count\": " << top[i].count << "}";
+    }
+    oss << "\n    ],\n    \"bursts\": [";
+    for (size_t i = 0; i < flexBursts.size(); ++i) {
+        const auto& burst = flexBursts[i];
+        oss << (i ? ",\n" : "\n") << "      {\"start\": \"" << flexFormatTime(burst.window)
+            << "\", \"end\": \"" << flexFormatTime(burst.last + flexWindowSeconds) << "\", \"identifier\": \"" << flexEscapeJSON(burst.identifier) << "\", \"level\": \""
+            << flexLogLevelName(burst.level) << "\", \"count\": " << burst.count
+            << ", \"peak\": " << burst.peak << ", \"baseline\": " << burst.baseline << ", \"file\": \"" << flexEscapeJSON(flexSources[burst.source])
+            << "\"}";
+    }
+    oss << "\n    ]\n  }\n}";
+    return oss.str();
+}
+
+std::string FlexLogBurstDetector::toCSV() const {
+    std::ostringstream oss;
+    oss << "Start,End,Identifier,Level,Count,Peak,Baseline,File\n";
+    for (const auto& burst : flexBursts) {
+        oss << flexFormatTime(burst.window) << "," << flexFormatTime(burst.last + flexWindowSeconds) << "," << flexEscapeCSV(burst.identifier) << ","
+            << flexLogLevelName(burst.level) << "," << burst.count << "," << burst.peak << ","
+            << burst.baseline << "," << flexEscapeCSV(flexSources[burst.source]) << "\n";
+    }
+    return oss.str();
+}
+
+} // namespace FlexTools
@@ -0,0 +1,115 @@
+#ifndef FLEX_LOG_BURSTS_H
+#define FLEX_LOG_BURSTS_H
+
+#include "flex_common.h"
+#include "flex_log_collector.h"
+#include "flex_log_time_index.h"
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+
+namespace FlexTools {
+
+// 日志量突增检测: 以 (syslog 标识, 级别) 为键, 按行首时间戳划分固定长度的时间窗,
+// 当前窗与前 history 个窗各一个 count-min sketch, 另有它们之和作为基线; 全程再有一个累计 sketch.
+// 每行只做 depth 次计数与一次容量固定的 top-K 更新, 内存与行数无关.
+// 窗口结束时, 当前窗 top-K 中计数不少于 minCount 且超过基线均值 factor 倍的键记为一次突增.
+// 各源分别计时 (源切换时清空窗口历史), 因为收集器按文件顺序而非时间顺序推送;
+// 同时打开的源 (归并的 journal 文件) 按行自带的时间共用一条时间线
+class FlexLogBurstDetector : public FlexLogStage {
+public:
+    struct Counter {
+        std::string identifier;
+        FlexLogLevel level;
+        uint64_t count;          // sketch 估计值 (只会高估)
+    };
+    
+    struct Burst {
+        std::string identifier;
+        FlexLogLevel level;
+        int64_t window;          // 第一个与最后一个突增窗口的起始时间
+        int64_t last;
+        uint64_t count;          // 突增期间的总行数
+        uint64_t peak;           // 单窗最大行数
+        double baseline;         // 突增开始前各窗的平均计数
+        uint32_t source;
+    };
+    
+    explicit FlexLogBurstDetector(unsigned windowSeconds = 60, size_t history = 60, size_t topK = 20,
+                                  double factor = 10.0, uint64_t minCount = 50);
+    
+    void beginSource(uint32_t source, const std::string& name) override;
+    void consume(const FlexLogLine& line) override;
+    void endSource(uint32_t source) override;
+    
+    // 全程计数最多的键, 从多到少
+    std::vector<Counter> heavyHitters() const;
+    // 最近的突增, 按发生顺序; 连续多个窗口的突增合并为一条
+    const std::deque<Burst>& bursts() const { return flexBursts; }
+    
+    void printBursts(FlexOutputFormat format = FlexOutputFormat::TEXT) const;
+    std::string toJSON() const;
+    std::string toCSV() const;
+
+private:
+    static constexpr size_t FLEX_SKETCH_DEPTH = 4;
+    static constexpr size_t FLEX_SKETCH_WIDTH = 2048;
+    static constexpr size_t FLEX_SKETCH_CELLS = FLEX_SKETCH_DEPTH * FLEX_SKETCH_WIDTH;
+    
+    // 固定容量的最小堆, 附键到堆下标的索引
+    class TopK {
+    public:
+        struct Entry {
+            std::string key;
+            uint64_t count;
+            uint32_t source;     // 该键最近一行所在的源; 归并的 journal 中各键可能来自不同文件
+        };
+        
+        explicit TopK(size_t limit) : flexLimit(limit) {}
+        
+        void offer(const std::string& key, uint64_t count, uint32_t source);
+        void clear();
+        const std::vector<Entry>& entries() const { return flexHeap; }
+    
+    private:
+        size_t flexLimit;
+        std::vector<Entry> flexHeap;
+        std::unordered_map<std::string, size_t> flexIndex;
+        
+        void flexSiftUp(size_t i);
+        void flexSiftDown(size_t i);
+        void flexSwap(size_t a, size_t b);
+    };
+    
+    unsigned flexWindowSeconds;
+    size_t flexHistory;
+    double flexFactor;
+    uint64_t flexMinCount;
+    
+    // sketch 依次为: 全程累计, 当前窗, 基线 (历史窗之和), 历史窗环形缓冲
+    std::vector<uint32_t> flexSketches;
+    size_t flexHistoryNext = 0;
+    size_t flexHistoryFilled = 0;
+    int64_t flexWindow = INT64_MIN;  // 当前窗起始时间, 尚无时间戳时为 INT64_MIN
+    
+    TopK flexTotalTop;
+    TopK flexWindowTop;
+    std::deque<Burst> flexBursts;
+    
+    std::vector<std::string> flexSources;
+    std::string flexSourceBase;      // 无 syslog 标识的行以文件名作标识
+    size_t flexOpenSources = 0;      // 已开始尚未结束的源
+    std::unique_ptr<FlexLogTimeParser> flexParser;
+    std::string flexKey;             // 逐行复用
+    
+    uint32_t* flexSketch(size_t slot) { return flexSketches.data() + slot * FLEX_SKETCH_CELLS; }
+    const uint32_t* flexSketch(size_t slot) const { return flexSketches.data() + slot * FLEX_SKETCH_CELLS; }
+    uint64_t flexEstimate(const uint32_t* sketch, uint64_t hash) const;
+    void flexCloseWindow();
+    void flexResetWindows();
+};
+
+} // namespace FlexTools
+
+#endif // FLEX_LOG_BURSTS_H
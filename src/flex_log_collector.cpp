@@ -0,0 +1,821 @@
+#include "flex_log_collector.h"
+#include "flex_compressed_file.h"
+#include "flex_decompress_pipeline.h"
+#include "flex_log_time_index.h"
+#include <sys/stat.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define FLEX_LOG_X86 1
+#endif
+
+namespace FlexTools {
+
+namespace {
+
+// 每次 pread 的块大小, 缓冲在多次收集间复用, 常驻内存不随文件增长
+constexpr size_t FLEX_LOG_READ_BUFFER = 4 * 1024 * 1024;
+// 文本输出中单行最多显示的字符数
+constexpr size_t FLEX_LOG_DISPLAY_WIDTH = 200;
+
+// 关键字前一个字符为这些时不算词首 (如 "libgpg-error-dev", "/var/crit.log")
+inline bool flexIsWordChar(char c) {
+    return static_cast<unsigned char>((c | 0x20) - 'a') < 26 || static_cast<unsigned char>(c - '0') < 10 ||
+           c == '-' || c == '_' || c == '.' || c == '/';
+}
+
+// 关键字按小端序打包成 64 位整数, 与行中读出的 8 字节做掩码比较
+struct FlexLogKeyword {
+    uint64_t text;
+    uint64_t mask;
+    FlexLogLevel level;
+};
+
+constexpr FlexLogKeyword flexMakeKeyword(const char* text, FlexLogLevel level) {
+    uint64_t value = 0;
+    uint64_t mask = 0;
+    for (size_t i = 0; text[i] != '\0'; ++i) {
+        value |= static_cast<uint64_t>(static_cast<unsigned char>(text[i])) << (8 * i);
+        mask |= uint64_t{0xff} << (8 * i);
+    }
+    return {value, mask, level};
+}
+
+constexpr FlexLogKeyword FLEX_LOG_KEYWORDS[] = {
+    flexMakeKeyword("err", FlexLogLevel::ERROR),
+    flexMakeKeyword("fail", FlexLogLevel::ERROR),
+    flexMakeKeyword("emerg", FlexLogLevel::CRITICAL),
+    flexMakeKeyword("crit", FlexLogLevel::CRITICAL),
+    flexMakeKeyword("alert", FlexLogLevel::CRITICAL),
+    flexMakeKeyword("panic", FlexLogLevel::CRITICAL),
+    flexMakeKeyword("fatal", FlexLogLevel::CRITICAL),
+    flexMakeKeyword("warn", FlexLogLevel::WARNING),
+    flexMakeKeyword("debug", FlexLogLevel::DEBUG),
+};
+
+// 校验 pos 处的候选关键字, 返回级别下标, 不是关键字时返回 -1
+int flexKeywordAt(std::string_view line, size_t pos) {
+    if (pos > 0 && flexIsWordChar(line[pos - 1])) {
+        return -1;
+    }
+    // 行尾不足 8 字节时补零 (零字节转小写后是空格, 不会匹配)
+    uint64_t word = 0;
+    std::memcpy(&word, line.data() + pos, std::min<size_t>(8, line.size() - pos));
+    word |= 0x2020202020202020ULL;
+    int best = -1;
+    for (const FlexLogKeyword& keyword : FLEX_LOG_KEYWORDS) {
+        if ((word & keyword.mask) == keyword.text) {
+            best = std::max(best, static_cast<int>(keyword.level));
+        }
+    }
+    return best;
+}
+
+// 关键字的前两个字母: er em cr al pa fa wa de
+inline bool flexIsCandidatePair(char first, char second) {
+    char a = first | 0x20;
+    char b = second | 0x20;
+    switch (a) {
+        case 'e': return b == 'r' || b == 'm';
+        case 'c': return b == 'r';
+        case 'a': return b == 'l';
+        case 'p': case 'f': case 'w': return b == 'a';
+        case 'd': return b == 'e';
+    }
+    return false;
+}
+
+void flexScanLogBlockScalar(const char* data, size_t size, uint32_t* newlines, size_t& newlineCount,
+                            uint32_t* keywords, size_t& keywordCount) {
+    newlineCount = 0;
+    keywordCount = 0;
+    bool wordStart = true;
+    for (size_t i = 0; i < size; ++i) {
+        char c = data[i];
+        if (c == '\n') {
+            newlines[newlineCount++] = static_cast<uint32_t>(i);
+        } else if (wordStart && i + 1 < size && flexIsCandidatePair(c, data[i + 1])) {
+            keywords[keywordCount++] = static_cast<uint32_t>(i);
+        }
+        wordStart = !flexIsWordChar(c);
+    }
+}
+
+#ifdef FLEX_LOG_X86
+
+// 每 16/32 字节得到三个掩码: 换行, 关键字前两字母匹配, 词内字符;
+// 候选 = 字母匹配且前一字节不是词内字符, 前一字节的状态跨迭代传递
+struct FlexScanMasks {
+    uint32_t newline;
+    uint32_t pair;
+    uint32_t word;
+};
+
+inline FlexScanMasks flexScanChunkSSE2(const char* p) {
+    const __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    const __m128i a = _mm_or_si128(raw, _mm_set1_epi8(0x20));
+    const __m128i b = _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 1)), _mm_set1_epi8(0x20));
+    __m128i secondR = _mm_cmpeq_epi8(b, _mm_set1_epi8('r'));
+    __m128i secondA = _mm_cmpeq_epi8(b, _mm_set1_epi8('a'));
+    __m128i hits = _mm_and_si128(_mm_cmpeq_epi8(a, _mm_set1_epi8('e')),
+                                 _mm_or_si128(secondR, _mm_cmpeq_epi8(b, _mm_set1_epi8('m'))));
+    hits = _mm_or_si128(hits, _mm_and_si128(_mm_cmpeq_epi8(a, _mm_set1_epi8('c')), secondR));
+    hits = _mm_or_si128(hits, _mm_and_si128(_mm_cmpeq_epi8(a, _mm_set1_epi8('a')),
+                                            _mm_cmpeq_epi8(b, _mm_set1_epi8('l'))));
+    hits = _mm_or_si128(hits, _mm_and_si128(secondA,
+                                            _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(a, _mm_set1_epi8('p')),
+                                                                      _mm_cmpeq_epi8(a, _mm_set1_epi8('f'))),
+                                                         _mm_cmpeq_epi8(a, _mm_set1_epi8('w')))));
+    hits = _mm_or_si128(hits, _mm_and_si128(_mm_cmpeq_epi8(a, _mm_set1_epi8('d')),
+                                            _mm_cmpeq_epi8(b, _mm_set1_epi8('e'))));
+    // 区间判断: 平移到 -128 起点后做有符号比较
+    __m128i alpha = _mm_cmpgt_epi8(_mm_set1_epi8(-128 + 26), _mm_add_epi8(a, _mm_set1_epi8(static_cast<char>(128 - 'a'))));
+    __m128i digit = _mm_cmpgt_epi8(_mm_set1_epi8(-128 + 10), _mm_add_epi8(raw, _mm_set1_epi8(static_cast<char>(128 - '0'))));
+    __m128i punct = _mm_cmpgt_epi8(_mm_set1_epi8(-128 + 3), _mm_add_epi8(raw, _mm_set1_epi8(static_cast<char>(128 - '-'))));
+    __m128i word = _mm_or_si128(_mm_or_si128(alpha, digit), _mm_or_si128(punct, _mm_cmpeq_epi8(raw, _mm_set1_epi8('_'))));
+    return {static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(raw, _mm_set1_epi8('\n')))),
+            static_cast<uint32_t>(_mm_movemask_epi8(hits)), static_cast<uint32_t>(_mm_movemask_epi8(word))};
+}
+
+// AVX2 版用 pshufb 按低半字节查表: 关键字首字母与次字母的低半字节各不相同,
+// 表中给出允许的次字母集合 (r=1 m=2 l=4 a=8 e=16) 及应有的高半字节, 两者相与即为候选;
+// 词内字符同样按高低半字节两张表判断
+__attribute__((target("avx2")))
+inline FlexScanMasks flexScanChunkAVX2(const char* p) {
+    const __m256i firstBits = _mm256_broadcastsi128_si256(
+        _mm_setr_epi8(8, 4, 0, 1, 16, 3, 8, 8, 0, 0, 0, 0, 0, 0, 0, 0));             // p a - c d e f w
+    const __m256i firstHigh = _mm256_broadcastsi128_si256(
+        _mm_setr_epi8(0x70, 0x60, 0, 0x60, 0x60, 0x60, 0x60, 0x70, 0, 0, 0, 0, 0, 0, 0, 0));
+    const __m256i secondBits = _mm256_broadcastsi128_si256(
+        _mm_setr_epi8(0, 8, 1, 0, 0, 16, 0, 0, 0, 0, 0, 0, 4, 2, 0, 0));             // a r e l m
+    const __m256i secondHigh = _mm256_broadcastsi128_si256(
+        _mm_setr_epi8(0, 0x60, 0x70, 0, 0, 0x60, 0, 0, 0, 0, 0, 0, 0x60, 0x60, 0, 0));
+    // 高半字节 2:-./ 3:数字 4,6:字母 5:大写 P-Z 与 '_' 7:小写 p-z
+    const __m256i wordLow = _mm256_broadcastsi128_si256(
+        _mm_setr_epi8(0x1a, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1c, 0x04, 0x04, 0x05, 0x05, 0x0d));
+    const __m256i wordHigh = _mm256_broadcastsi128_si256(
+        _mm_setr_epi8(0, 0, 0x01, 0x02, 0x04, 0x08, 0x04, 0x10, 0, 0, 0, 0, 0, 0, 0, 0));
+    const __m256i highNibble = _mm256_set1_epi8(static_cast<char>(0xf0));
+    const __m256i lowNibble = _mm256_set1_epi8(0x0f);
+    const __m256i zero = _mm256_setzero_si256();
+    
+    const __m256i raw = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    const __m256i a = _mm256_or_si256(raw, _mm256_set1_epi8(0x20));
+    const __m256i b = _mm256_or_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 1)),
+                                      _mm256_set1_epi8(0x20));
+    __m256i first = _mm256_and_si256(_mm256_shuffle_epi8(firstBits, a),
+                                     _mm256_cmpeq_epi8(_mm256_and_si256(a, highNibble),
+                                                       _mm256_shuffle_epi8(firstHigh, a)));
+    __m256i second = _mm256_and_si256(_mm256_shuffle_epi8(secondBits, b),
+                                      _mm256_cmpeq_epi8(_mm256_and_si256(b, highNibble),
+                                                        _mm256_shuffle_epi8(secondHigh, b)));
+    __m256i pairMiss = _mm256_cmpeq_epi8(_mm256_and_si256(first, second), zero);
+    __m256i word = _mm256_and_si256(_mm256_shuffle_epi8(wordLow, _mm256_and_si256(raw, lowNibble)),
+                                    _mm256_shuffle_epi8(wordHigh, _mm256_and_si256(_mm256_srli_epi16(raw, 4), lowNibble)));
+    __m256i wordMiss = _mm256_cmpeq_epi8(word, zero);
+    return {static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(raw, _mm256_set1_epi8('\n')))),
+            ~static_cast<uint32_t>(_mm256_movemask_epi8(pairMiss)), ~static_cast<uint32_t>(_mm256_movemask_epi8(wordMiss))};
+}
+
+inline void flexExtractPositions(size_t base, uint32_t mask, uint32_t* positions, size_t& count) {
+    while (mask != 0) {
+        positions[count++] = static_cast<uint32_t>(base + __builtin_ctz(mask));
+        mask &= mask - 1;
+    }
+}
+
+// 先无条件写 4 个下标 (多写的在计数之外, 见 FLEX_LOG_SCAN_SLACK), 超出时再循环, 减少按位数的分支预测失败;
+// 依赖 popcnt, 只在 AVX2 路径使用
+inline void flexExtractPositionsBatched(size_t base, uint32_t mask, uint32_t* positions, size_t& count) {
+    uint32_t* out = positions + count;
+    count += static_cast<size_t>(__builtin_popcount(mask));
+    for (int k = 0; k < 4; ++k) {
+        out[k] = static_cast<uint32_t>(base + __builtin_ctz(mask | 0x80000000u));
+        mask &= mask - 1;
+    }
+    out += 4;
+    while (mask != 0) {
+        *out++ = static_cast<uint32_t>(base + __builtin_ctz(mask));
+        mask &= mask - 1;
+    }
+}
+
+// prevWord 为上一组最后一个字节是否为词内字符
+template <size_t Width, void (*Extract)(size_t, uint32_t, uint32_t*, size_t&)>
+inline void flexExtractMasks(size_t base, FlexScanMasks masks, uint32_t valid, uint32_t& prevWord,
+                             uint32_t* newlines, size_t& newlineCount, uint32_t* keywords, size_t& keywordCount) {
+    uint32_t keywordMask = masks.pair & ~((masks.word << 1) | prevWord) & valid;
+    prevWord = (masks.word >> (Width - 1)) & 1;
+    Extract(base, masks.newline & valid, newlines, newlineCount);
+    Extract(base, keywordMask, keywords, keywordCount);
+}
+
+// 末尾不足一组 (含向后多读的 1 字节) 时拷到补零的缓冲里再扫
+void flexScanLogBlockSSE2(const char* data, size_t size, uint32_t* newlines, size_t& newlineCount,
+                          uint32_t* keywords, size_t& keywordCount) {
+    // 计数放在局部变量里, 避免每次经引用读写内存
+    size_t nl = 0;
+    size_t kw = 0;
+    uint32_t prevWord = 0;
+    size_t i = 0;
+    for (; i + 17 <= size; i += 16) {
+        flexExtractMasks<16, flexExtractPositions>(i, flexScanChunkSSE2(data + i), 0xffff, prevWord,
+                                                   newlines, nl, keywords, kw);
+    }
+    alignas(16) char tail[48] = {};
+    std::memcpy(tail, data + i, size - i);
+    for (size_t j = 0; i + j < size; j += 16) {
+        size_t rest = std::min<size_t>(size - i - j, 16);
+        flexExtractMasks<16, flexExtractPositions>(i + j, flexScanChunkSSE2(tail + j), (1u << rest) - 1, prevWord,
+                                                   newlines, nl, keywords, kw);
+    }
+    newlineCount = nl;
+    keywordCount = kw;
+}
+
+__attribute__((target("avx2,bmi,popcnt")))
+void flexScanLogBlockAVX2(const char* data, size_t size, uint32_t* newlines, size_t& newlineCount,
+                          uint32_t* keywords, size_t& keywordCount) {
+    size_t nl = 0;
+    size_t kw = 0;
+    uint32_t prevWord = 0;
+    size_t i = 0;
+    for (; i + 33 <= size; i += 32) {
+        flexExtractMasks<32, flexExtractPositionsBatched>(i, flexScanChunkAVX2(data + i), 0xffffffffu, prevWord,
+                                                          newlines, nl, keywords, kw);
+    }
+    alignas(32) char tail[96] = {};
+    std::memcpy(tail, data + i, size - i);
+    for (size_t j = 0; i + j < size; j += 32) {
+        size_t rest = std::min<size_t>(size - i - j, 32);
+        uint32_t valid = rest == 32 ? 0xffffffffu : (1u << rest) - 1;
+        flexExtractMasks<32, flexExtractPositionsBatched>(i + j, flexScanChunkAVX2(tail + j), valid, prevWord,
+                                                          newlines, nl, keywords, kw);
+    }
+    newlineCount = nl;
+    keywordCount = kw;
+}
+
+#endif // FLEX_LOG_X86
+
+using FlexLogBlockScanner = void (*)(const char*, size_t, uint32_t*, size_t&, uint32_t*, size_t&);
+
+// 运行时按 CPU 能力选择实现, 只判断一次
+struct FlexLogKernels {
+    FlexLogBlockScanner scan = flexScanLogBlockScalar;
+    
+    FlexLogKernels() {
+#ifdef FLEX_LOG_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            scan = flexScanLogBlockAVX2;
+        } else if (__builtin_cpu_supports("sse2")) {
+            scan = flexScanLogBlockSSE2;
+        }
+#endif
+    }
+};
+
+const FlexLogKernels& flexLogKernels() {
+    static const FlexLogKernels kernels;
+    return kernels;
+}
+
+// 内核/syslog 原始格式的 "<N>" 前缀直接给出优先级
+bool flexSyslogPriority(std::string_view line, FlexLogLevel& level) {
+    if (line.size() < 3 || line[0] != '<' || line[1] < '0' || line[1] > '7' || line[2] != '>') {
+        return false;
+    }
+    static const FlexLogLevel priorities[] = {
+        FlexLogLevel::CRITICAL, FlexLogLevel::CRITICAL, FlexLogLevel::CRITICAL, FlexLogLevel::ERROR,
+        FlexLogLevel::WARNING, FlexLogLevel::INFO, FlexLogLevel::INFO, FlexLogLevel::DEBUG
+    };
+    level = priorities[line[1] - '0'];
+    return true;
+}
+
+
+bool flexHasSuffix(const std::string& name, const char* suffix) {
+    size_t length = std::strlen(suffix);
+    return name.size() >= length && name.compare(name.size() - length, length, suffix) == 0;
+}
+
+// 除 .gz 外的压缩日志与已知的二进制日志不在此处理
+bool flexSkipLogName(const std::string& name) {
+    static const char* suffixes[] = {".xz", ".bz2", ".zst", ".lz4", ".Z", ".zip", ".journal", ".journal~"};
+    static const char* binaries[] = {"wtmp", "btmp", "lastlog", "faillog", "utmp"};
+    for (const char* suffix : suffixes) {
+        if (flexHasSuffix(name, suffix)) return true;
+    }
+    for (const char* binary : binaries) {
+        if (name.compare(0, std::strlen(binary), binary) == 0) return true;
+    }
+    return false;
+}
+
+// 前 4KB 中出现 NUL 视为二进制文件
+bool flexLooksBinary(int fd) {
+    char buffer[4096];
+    ssize_t count = pread(fd, buffer, sizeof(buffer), 0);
+    return count > 0 && std::memchr(buffer, '\0', static_cast<size_t>(count)) != nullptr;
+}
+
+void flexDiscover(const std::string& dir, int depth, std::vector<std::string>& files) {
+    DIR* handle = opendir(dir.c_str());
+    if (handle == nullptr) {
+        return;
+    }
+    while (struct dirent* entry = readdir(handle)) {
+        std::string name = entry->d_name;
+        if (name == "." || name == ".." || flexSkipLogName(name)) {
+            continue;
+        }
+        std::string path = dir + "/" + name;
+        struct stat st;
+        if (lstat(path.c_str(), &st) != 0) {
+            continue;
+        }
+        if (S_ISDIR(st.st_mode)) {
+            // journald 的二进制日志由专门的读取器处理
+            if (depth == 0 && name != "journal") {
+                flexDiscover(path, depth + 1, files);
+            }
+            continue;
+        }
+        if (!S_ISREG(st.st_mode) || st.st_size == 0) {
+            continue;
+        }
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            continue;
+        }
+        if (flexIsGzipPath(name) || !flexLooksBinary(fd)) {
+            files.push_back(path);
+        }
+        close(fd);
+    }
+    closedir(handle);
+}
+
+// 轮转代次: "<base>.<N>[.gz]" 中 N 越大越旧, "<base>-YYYYMMDD[.gz]" 按日期排序
+struct FlexRotation {
+    std::string base;     // 含目录
+    int kind = -1;        // -1 当前文件, 0 数字序号, 1 日期后缀
+    uint64_t value = 0;
+};
+
+FlexRotation flexParseRotation(const std::string& path) {
+    FlexRotation rotation;
+    std::string name = flexIsGzipPath(path) ? path.substr(0, path.size() - 3) : path;
+    size_t slash = name.rfind('/');
+    size_t digits = name.size();
+    while (digits > 0 && std::isdigit(static_cast<unsigned char>(name[digits - 1]))) {
+        --digits;
+    }
+    size_t count = name.size() - digits;
+    bool separated = digits > 0 && (slash == std::string::npos || digits - 1 > slash + 1);
+    if (count > 0 && count <= 9 && separated && name[digits - 1] == '.') {
+        rotation.kind = 0;
+    } else if (count == 8 && separated && name[digits - 1] == '-') {
+        rotation.kind = 1;
+    }
+    if (rotation.kind < 0) {
+        rotation.base = name;
+        return rotation;
+    }
+    rotation.base = name.substr(0, digits - 1);
+    rotation.value = std::stoull(name.substr(digits));
+    return rotation;
+}
+
+} // namespace
+
+bool flexIsRotatedLog(const std::string& path) {
+    return flexParseRotation(path).kind >= 0;
+}
+
+const char* flexLogLevelName(FlexLogLevel level) {
+    switch (level) {
+        case FlexLogLevel::DEBUG: return "debug";
+        case FlexLogLevel::INFO: return "info";
+        case FlexLogLevel::WARNING: return "warning";
+        case FlexLogLevel::ERROR: return "error";
+        case FlexLogLevel::CRITICAL: return "critical";
+    }
+    return "unknown";
+}
+
+FlexLogLevel flexClassifyLogLine(std::string_view line) {
+    FlexLogLevel level;
+    if (flexSyslogPriority(line, level)) {
+        return level;
+    }
+    // 分段复用块扫描, 相邻段重叠一个字节以免漏掉跨段的字母对
+    constexpr size_t FLEX_CLASSIFY_PIECE = 256;
+    uint32_t newlines[FLEX_CLASSIFY_PIECE + FLEX_LOG_SCAN_SLACK];
+    uint32_t keywords[FLEX_CLASSIFY_PIECE + FLEX_LOG_SCAN_SLACK];
+    int best = -1;
+    for (size_t base = 0; base < line.size(); base += FLEX_CLASSIFY_PIECE - 1) {
+        size_t piece = std::min(line.size() - base, FLEX_CLASSIFY_PIECE);
+        size_t newlineCount = 0;
+        size_t keywordCount = 0;
+        flexLogKernels().scan(line.data() + base, piece, newlines, newlineCount, keywords, keywordCount);
+        for (size_t i = 0; i < keywordCount; ++i) {
+            best = std::max(best, flexKeywordAt(line, base + keywords[i]));
+        }
+        if (base + piece == line.size()) break;
+    }
+    return best < 0 ? FlexLogLevel::INFO : static_cast<FlexLogLevel>(best);
+}
+
+FlexLogLevel flexResolveLogLevel(std::string_view line, const uint32_t* keywords, size_t count, size_t lineStart) {
+    FlexLogLevel level;
+    if (flexSyslogPriority(line, level)) {
+        return level;
+    }
+    int best = -1;
+    for (size_t i = 0; i < count; ++i) {
+        size_t pos = keywords[i] - lineStart;
+        if (pos < line.size()) {
+            best = std::max(best, flexKeywordAt(line, pos));
+        }
+    }
+    return best < 0 ? FlexLogLevel::INFO : static_cast<FlexLogLevel>(best);
+}
+
+void flexScanLogBlock(const char* data, size_t size, uint32_t* newlines, size_t& newlineCount,
+                      uint32_t* keywords, size_t& keywordCount) {
+    flexLogKernels().scan(data, size, newlines, newlineCount, keywords, keywordCount);
+}
+
+FlexLineSplitter::FlexLineSplitter(size_t maxLine) : flexMaxLine(maxLine) {
+}
+
+void FlexLineSplitter::reset(uint64_t offset) {
+    flexCarry.clear();
+    flexCarryOffset = offset;
+    flexOffset = offset;
+}
+
+FlexLogSummary::FlexLogSummary(size_t recentLimit) : flexRecentLimit(recentLimit) {
+}
+
+void FlexLogSummary::beginSource(uint32_t source, const std::string& name) {
+    if (source >= flexSources.size()) {
+        flexSources.resize(source + 1);
+    }
+    flexSources[source].name = name;
+}
+
+void FlexLogSummary::consume(const FlexLogLine& line) {
+    FlexLogSourceStats& stats = flexSources[line.source];
+    stats.bytes += line.text.size() + 1;
+    stats.lines++;
+    stats.levels[static_cast<size_t>(line.level)]++;
+    
+    if (line.level < FlexLogLevel::WARNING || flexRecentLimit == 0) {
+        return;
+    }
+    Entry entry{line.source, line.level, std::string(line.text)};
+    if (flexRecent.size() < flexRecentLimit) {
+        flexRecent.push_back(std::move(entry));
+    } else {
+        flexRecent[flexRecentNext] = std::move(entry);
+    }
+    flexRecentNext = (flexRecentNext + 1) % flexRecentLimit;
+}
+
+std::vector<FlexLogSummary::Entry> FlexLogSummary::recent() const {
+    if (flexRecent.size() < flexRecentLimit) {
+        return flexRecent;
+    }
+    std::vector<Entry> ordered;
+    ordered.reserve(flexRecent.size());
+    for (size_t i = 0; i < flexRecent.size(); ++i) {
+        ordered.push_back(flexRecent[(flexRecentNext + i) % flexRecent.size()]);
+    }
+    return ordered;
+}
+
+FlexLogCollector::FlexLogCollector(const std::string& logDir) : flexLogDir(logDir) {
+    while (flexLogDir.size() > 1 && flexLogDir.back() == '/') {
+        flexLogDir.pop_back();
+    }
+    flexStages.push_back(&flexSummary);
+}
+
+void FlexLogCollector::addStage(FlexLogStage* stage) {
+    if (stage != nullptr) {
+        flexStages.push_back(stage);
+    }
+}
+
+std::vector<std::string> FlexLogCollector::discoverFiles() const {
+    std::vector<std::string> files;
+    flexDiscover(flexLogDir, 0, files);
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+uint32_t FlexLogCollector::flexBeginSource(const std::string& name) {
+    uint32_t source = static_cast<uint32_t>(flexSources.size());
+    flexSources.push_back(name);
+    for (FlexLogStage* stage : flexStages) {
+        stage->beginSource(source, name);
+    }
+    return source;
+}
+
+void FlexLogCollector::flexEndSource(uint32_t source) {
+    for (FlexLogStage* stage : flexStages) {
+        stage->endSource(source);
+    }
+}
+
+void FlexLogCollector::flexEmit(uint32_t source, std::string_view text, uint64_t offset, FlexLogLevel level,
+                                int64_t time) {
+    if (!text.empty() && text.back() == '\r') {
+        text.remove_suffix(1);
+    }
+    FlexLogLine line{text, level, offset, source, time};
+    flexTotalLines++;
+    for (FlexLogStage* stage : flexStages) {
+        stage->consume(line);
+    }
+}
+
+uint64_t FlexLogCollector::collectFile(const std::string& path, uint64_t offset) {
+    return flexCollectRange(path, offset, UINT64_MAX, nullptr);
+}
+
+size_t FlexLogCollector::collectTimeRange(time_t from, time_t to) {
+    size_t collected = 0;
+    for (const auto& file : discoverFiles()) {
+        // .gz 无法随机访问, 不在按时间查询的范围内
+        if (flexIsGzipPath(file)) {
+            continue;
+        }
+        FlexLogTimeIndex index(file);
+        uint64_t begin, end;
+        if (!index.update() || !index.locate(from, to, begin, end)) {
+            continue;
+        }
+        FlexLogTimeRange range{&index.parser(), from, to};
+        flexCollectRange(file, begin, end, &range);
+        collected++;
+    }
+    return collected;
+}
+
+uint64_t FlexLogCollector::flexCollectRange(const std::string& path, uint64_t offset, uint64_t limit,
+                                            const FlexLogTimeRange* range) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        flexErrors.push_back(path + ": " + std::strerror(errno));
+        return offset;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        flexErrors.push_back(path + ": " + std::strerror(errno));
+        close(fd);
+        return offset;
+    }
+    
+    uint64_t size = S_ISREG(st.st_mode) ? std::min<uint64_t>(static_cast<uint64_t>(st.st_size), limit) : 0;
+    // 文件比记录的偏移短说明已被截断, 从头开始
+    if (offset > size) {
+        offset = 0;
+    }
+    
+    uint32_t source = flexBeginSource(path);
+    FlexLineSplitter splitter;
+    splitter.reset(offset);
+    // 按时间过滤时, 没有时间戳的行 (如多行消息的后续行) 沿用上一行的时间
+    bool inRange = false;
+    auto onLine = [this, source, range, &inRange](std::string_view text, uint64_t lineOffset, FlexLogLevel level) {
+        if (range != nullptr) {
+            time_t time;
+            if (range->parser->parse(text, time)) {
+                inRange = time >= range->from && time <= range->to;
+            }
+            if (!inRange) return;
+        }
+        flexEmit(source, text, lineOffset, level);
+    };
+    
+    // 活动日志随时可能被 copytruncate 截短, 映射后访问截掉的页会触发 SIGBUS, 因此用 pread 读取;
+    // 截短时 pread 只是提前返回 0
+    posix_fadvise(fd, static_cast<off_t>(offset), 0, POSIX_FADV_SEQUENTIAL);
+    if (flexReadBuffer.size() < FLEX_LOG_READ_BUFFER) {
+        flexReadBuffer.resize(FLEX_LOG_READ_BUFFER);
+    }
+    uint64_t end = S_ISREG(st.st_mode) ? size : limit;
+    uint64_t position = offset;
+    while (position < end) {
+        size_t want = static_cast<size_t>(std::min<uint64_t>(flexReadBuffer.size(), end - position));
+        ssize_t count = pread(fd, flexReadBuffer.data(), want, static_cast<off_t>(position));
+        if (count < 0 && errno == EINTR) continue;
+        if (count < 0) {
+            flexErrors.push_back(path + ": " + std::strerror(errno));
+        }
+        if (count <= 0) break;
+        splitter.feed(flexReadBuffer.data(), static_cast<size_t>(count), onLine);
+        position += static_cast<uint64_t>(count);
+    }
+    close(fd);
+    
+    splitter.finish(onLine);
+    flexTotalBytes += position - offset;
+    flexEndSource(source);
+    return position;
+}
+
+size_t FlexLogCollector::collectJournal(const FlexJournalFilter& filter) {
+    FlexJournalReader reader({flexLogDir + "/journal", "/run/log/journal"});
+    // 归并输出时各文件的记录交错到达, 源在首条记录时登记, 全部读完后统一结束
+    std::vector<int64_t> sources;
+    std::string text;
+    size_t count = reader.read(filter, [&](const FlexJournalEntry& entry, size_t file) {
+        if (file >= sources.size()) {
+            sources.resize(file + 1, -1);
+        }
+        if (sources[file] < 0) {
+            sources[file] = flexBeginSource(reader.files()[file]);
+        }
+        text = entry.identifier.empty() ? entry.unit : entry.identifier;
+        if (!entry.pid.empty()) {
+            text += "[" + entry.pid + "]";
+        }
+        text += ": ";
+        text += entry.message;
+        flexTotalBytes += text.size() + 1;
+        flexEmit(static_cast<uint32_t>(sources[file]), text, entry.offset, entry.level,
+                 static_cast<int64_t>(entry.realtime / 1000000));
+    });
+    for (int64_t source : sources) {
+        if (source >= 0) {
+            flexEndSource(static_cast<uint32_t>(source));
+        }
+    }
+    return count;
+}
+
+size_t FlexLogCollector::collectRotated(const std::vector<std::string>& files, size_t workers) {
+    FlexDecompressPipeline pipeline(files, workers);
+    FlexLineSplitter splitter;
+    uint32_t source = 0;
+    bool open = false;
+    auto onLine = [this, &source](std::string_view text, uint64_t lineOffset, FlexLogLevel level) {
+        flexEmit(source, text, lineOffset, level);
+    };
+    // 每个文件是独立的源, 偏移为解压后的字节偏移
+    auto begin = [&](size_t file) {
+        if (!open) {
+            source = flexBeginSource(files[file]);
+            splitter.reset();
+            open = true;
+        }
+    };
+    
+    pipeline.run(
+        [&](size_t file, const char* data, size_t size) {
+            begin(file);
+            splitter.feed(data, size, onLine);
+            flexTotalBytes += size;
+        },
+        [&](size_t file, bool ok) {
+            if (!ok) {
+                flexErrors.push_back(files[file] + ": cannot read or decompress");
+            }
+            begin(file);
+            splitter.finish(onLine);
+            flexEndSource(source);
+            open = false;
+        });
+    return files.size();
+}
+
+size_t FlexLogCollector::collect() {
+    auto files = discoverFiles();
+    
+    // 轮转代次按时间从旧到新排在一起并行解压; 当前文件随后顺序读取,
+    // 因此同一日志的行总是按时间顺序到达各阶段
+    std::vector<std::pair<FlexRotation, std::string>> rotated;
+    std::vector<std::string> live;
+    for (auto& file : files) {
+        FlexRotation rotation = flexParseRotation(file);
+        if (rotation.kind < 0) {
+            live.push_back(std::move(file));
+        } else {
+            rotated.emplace_back(std::move(rotation), std::move(file));
+        }
+    }
+    std::sort(rotated.begin(), rotated.end(), [](const auto& a, const auto& b) {
+        if (a.first.base != b.first.base) return a.first.base < b.first.base;
+        if (a.first.kind != b.first.kind) return a.first.kind < b.first.kind;
+        return a.first.kind == 0 ? a.first.value > b.first.value : a.first.value < b.first.value;
+    });
+    std::vector<std::string> ordered;
+    ordered.reserve(rotated.size());
+    for (auto& entry : rotated) {
+        ordered.push_back(std::move(entry.second));
+    }
+    
+    collectRotated(ordered);
+    for (const auto& file : live) {
+        collectFile(file);
+    }
+    size_t before = flexSources.size();
+    collectJournal();
+    return files.size() + (flexSources.size() - before);
+}
+
+void FlexLogCollector::printLogs(FlexOutputFormat format) const {
+    if (format == FlexOutputFormat::JSON) {
+        std::cout << toJSON() << std::endl;
+        return;
+    }
+    if (format == FlexOutputFormat::CSV) {
+        std::cout << toCSV() << std::endl;
+        return;
+    }
+    
+    std::cout << FLEX_COLOR_CYAN << "\n=== FlexTools Log Summary ===" << FLEX_COLOR_RESET << std::endl;
+    std::cout << std::left << std::setw(40) << "File" << std::right << std::setw(10) << "Lines"
+              << std::setw(8) << "Warn" << std::setw(8) << "Error" << std::setw(8) << "Crit" << std::endl;
+    for (const auto& stats : flexSummary.sources()) {
+        std::cout << std::left << std::setw(40) << stats.name << std::right << std::setw(10) << stats.lines
+                  << std::setw(8) << stats.levels[static_cast<size_t>(FlexLogLevel::WARNING)]
+                  << std::setw(8) << stats.levels[static_cast<size_t>(FlexLogLevel::ERROR)]
+                  << std::setw(8) << stats.levels[static_cast<size_t>(FlexLogLevel::CRITICAL)] << std::endl;
+    }
+    
+    auto recent = flexSummary.recent();
+    if (!recent.empty()) {
+        std::cout << FLEX_COLOR_CYAN << "\n=== Recent Warnings and Errors ===" << FLEX_COLOR_RESET << std::endl;
+        for (const auto& entry : recent) {
+            const char* color = entry.level == FlexLogLevel::WARNING ? FLEX_COLOR_YELLOW : FLEX_COLOR_RED;
+            std::cout << color << "[" << flexLogLevelName(entry.level) << "] " << FLEX_COLOR_RESET
+                      << flexSources[entry.source] << ": " << entry.text.substr(0, FLEX_LOG_DISPLAY_WIDTH)
+                      << (entry.text.size() > FLEX_LOG_DISPLAY_WIDTH ? " ..." : "") << std::endl;
+        }
+    }
+    for (const auto& error : flexErrors) {
+        std::cout << FLEX_COLOR_YELLOW << "Warning: " << error << FLEX_COLOR_RESET << std::endl;
+    }
+    std::cout << FLEX_COLOR_GREEN << "\nTotal: " << flexTotalLines << " lines, " << flexTotalBytes
+              << " bytes in " << flexSources.size() << " files" << FLEX_COLOR_RESET << std::endl;
+}
+
+std::string FlexLogCollector::toJSON() const {
+    std::ostringstream oss;
+    oss << "{\n  \"flex_logs\": {\n";
+    oss << "    \"total_files\": " << flexSources.size() << ",\n";
+    oss << "    \"total_lines\": " << flexTotalLines << ",\n";
+    oss << "    \"total_bytes\": " << flexTotalBytes << ",\n";
+    oss << "    \"files\": [";
+    const auto& sources = flexSummary.sources();
+    for (size_t i = 0; i < sources.size(); ++i) {
+        const auto& stats = sources[i];
+        oss << (i ? ",\n" : "\n") << "      {\"path\": \"" << flexEscapeJSON(stats.name)
+            << "\", \"lines\": " << stats.lines << ", \"bytes\": " << stats.bytes;
+        for (int level = 0; level < 5; ++level) {
+            oss << ", \"" << flexLogLevelName(static_cast<FlexLogLevel>(level)) << "\": " << stats.levels[level];
+        }
+        oss << "}";
+    }
+    oss << "\n    ],\n    \"recent\": [";
+    auto recent = flexSummary.recent();
+    for (size_t i = 0; i < recent.size(); ++i) {
+        oss << (i ? ",\n" : "\n") << "      {\"file\": \"" << flexEscapeJSON(flexSources[recent[i].source])
+            << "\", \"level\": \"" << flexLogLevelName(recent[i].level)
+            << "\", \"line\": \"" << flexEscapeJSON(recent[i].text) << "\"}";
+    }
+    oss << "\n    ],\n    \"errors\": [";
+    for (size_t i = 0; i < flexErrors.size(); ++i) {
+        oss << (i ? ", " : "") << "\"" << flexEscapeJSON(flexErrors[i]) << "\"";
+    }
+    oss << "]\n  }\n}";
+    return oss.str();
+}
+
+std::string FlexLogCollector::toCSV() const {
+    std::ostringstream oss;
+    oss << "File,Lines,Bytes,Debug,Info,Warning,Error,Critical\n";
+    for (const auto& stats : flexSummary.sources()) {
+        oss << flexEscapeCSV(stats.name) << "," << stats.lines << "," << stats.bytes;
+        for (uint64_t count : stats.levels) {
+            oss << "," << count;
+        }
+        oss << "\n";
+    }
+    return oss.str();
+}
+
+} // namespace FlexTools
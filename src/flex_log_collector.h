@@ -0,0 +1,242 @@
+#ifndef FLEX_LOG_COLLECTOR_H
+#define FLEX_LOG_COLLECTOR_H
+
+#include "flex_common.h"
+#include "flex_journal_reader.h"
+#include <cstdint>
+#include <string_view>
+
+namespace FlexTools {
+
+const char* flexLogLevelName(FlexLogLevel level);
+
+// 按关键字 (error/fail/warn/crit/panic/debug 等, 不区分大小写, 需在词首) 与
+// 行首的 "<N>" syslog 优先级判断日志级别, 无匹配时为 INFO
+FlexLogLevel flexClassifyLogLine(std::string_view line);
+
+// 是否为轮转后的旧代次 ("<base>.<N>[.gz]" 或 "<base>-YYYYMMDD[.gz]")
+bool flexIsRotatedLog(const std::string& path);
+
+// 流水线中的一行; text 只在 consume 调用期间有效
+struct FlexLogLine {
+    std::string_view text; // 不含换行符
+    FlexLogLevel level;
+    uint64_t offset;       // 行首在源文件中的字节偏移
+    uint32_t source;       // FlexLogCollector::sources() 下标
+    int64_t time = 0;      // 记录自带的时间 (秒, 如 journal 的 realtime); 为 0 时需从 text 行首解析
+};
+
+// 日志处理阶段: 收集器逐行推送, 各阶段自行维护有界状态.
+// 文本日志一个源读完才开始下一个; journal 的各文件按时间归并, 其源先后开始、行相互交错,
+// 全部读完后才依次结束, 因此 beginSource 可能在另一个源尚未结束时到来
+class FlexLogStage {
+public:
+    virtual ~FlexLogStage() = default;
+    
+    virtual void beginSource(uint32_t source, const std::string& name) { (void)source; (void)name; }
+    virtual void consume(const FlexLogLine& line) = 0;
+    virtual void endSource(uint32_t source) { (void)source; }
+};
+
+// 把任意分块的字节流切成行; 跨块的行先拼到内部缓冲, 超长行截断到 maxLine 字节
+class FlexLineSplitter {
+public:
+    explicit FlexLineSplitter(size_t maxLine = 64 * 1024);
+    
+    // onLine(std::string_view text, uint64_t offset, FlexLogLevel level) 对每个完整行调用一次,
+    // 级别与换行在同一趟扫描中得出
+    template <typename Callback>
+    void feed(const char* data, size_t size, Callback&& onLine);
+    
+    // 输出末尾没有换行的残行
+    template <typename Callback>
+    void finish(Callback&& onLine);
+    
+    // 从 offset 处重新开始 (丢弃残行)
+    void reset(uint64_t offset = 0);
+    
+    uint64_t offset() const { return flexOffset; }
+
+private:
+    std::string flexCarry;
+    uint64_t flexCarryOffset = 0;
+    uint64_t flexOffset = 0;
+    size_t flexMaxLine;
+    std::vector<uint32_t> flexNewlines;
+    std::vector<uint32_t> flexKeywords;
+};
+
+class FlexLogTimeParser;
+
+// 按时间过滤收集的行 (闭区间)
+struct FlexLogTimeRange {
+    const FlexLogTimeParser* parser;
+    time_t from;
+    time_t to;
+};
+
+// 每个源文件的统计
+struct FlexLogSourceStats {
+    std::string name;
+    uint64_t bytes = 0;
+    uint64_t lines = 0;
+    uint64_t levels[5] = {}; // 按 FlexLogLevel 下标
+};
+
+// 默认阶段: 各文件按级别计数, 并保留最近的若干条 WARNING 及以上的行
+class FlexLogSummary : public FlexLogStage {
+public:
+    struct Entry {
+        uint32_t source;
+        FlexLogLevel level;
+        std::string text;
+    };
+    
+    explicit FlexLogSummary(size_t recentLimit = 20);
+    
+    void beginSource(uint32_t source, const std::string& name) override;
+    void consume(const FlexLogLine& line) override;
+    
+    const std::vector<FlexLogSourceStats>& sources() const { return flexSources; }
+    
+    // 最近的重要行, 按出现顺序
+    std::vector<Entry> recent() const;
+
+private:
+    std::vector<FlexLogSourceStats> flexSources;
+    std::vector<Entry> flexRecent; // 环形缓冲
+    size_t flexRecentNext = 0;
+    size_t flexRecentLimit;
+};
+
+// 流式日志收集: 按固定大小的块 pread 日志文件, SIMD 查找换行并分级,
+// 每行依次交给已注册的阶段; 内存占用与文件大小无关
+class FlexLogCollector {
+public:
+    explicit FlexLogCollector(const std::string& logDir = "/var/log");
+    
+    // 阶段由调用者持有, 需在收集期间保持有效
+    void addStage(FlexLogStage* stage);
+    
+    // logDir 下的文本日志与 .gz 轮转代次 (递归一层子目录, 跳过二进制与其他压缩格式)
+    std::vector<std::string> discoverFiles() const;
+    
+    // 收集单个文件, 从 offset 处开始; 返回扫描结束时的文件偏移
+    uint64_t collectFile(const std::string& path, uint64_t offset = 0);
+    
+    // 只收集时间戳落在 [from, to] 内的行: 每个文本日志维护稀疏时间索引 (见 FlexLogTimeIndex),
+    // 二分查找定位字节范围后只扫描该窗口; 返回扫描的文件数
+    size_t collectTimeRange(time_t from, time_t to);
+    
+    // 按给定顺序收集一组文件 (可含 .gz), 由 workers 个线程并发解压, 缓冲有上限;
+    // 各文件的行仍按顺序交给各阶段. workers 为 0 时取 CPU 数
+    size_t collectRotated(const std::vector<std::string>& files, size_t workers = 0);
+    
+    // 读取 journald 的二进制日志 (logDir/journal 与 /run/log/journal), 按时间归并后
+    // 以 "标识[pid]: 消息" 的形式交给各阶段, 级别取自 PRIORITY; 返回记录数
+    size_t collectJournal(const FlexJournalFilter& filter = FlexJournalFilter());
+    
+    // 收集全部发现的文本日志、轮转代次与 journal 文件, 返回处理的文件数.
+    // 同一日志的轮转代次从旧到新先于当前文件处理
+    size_t collect();
+    
+    const std::vector<std::string>& sources() const { return flexSources; }
+    const FlexLogSummary& summary() const { return flexSummary; }
+    uint64_t totalBytes() const { return flexTotalBytes; }
+    uint64_t totalLines() const { return flexTotalLines; }
+    // 无法打开、读取或解压的文件 ("路径: 原因"), 已读出的部分仍交给了各阶段
+    const std::vector<std::string>& errors() const { return flexErrors; }
+    
+    void printLogs(FlexOutputFormat format = FlexOutputFormat::TEXT) const;
+    std::string toJSON() const;
+    std::string toCSV() const;
+
+private:
+    friend class FlexLogFollower;
+    
+    std::string flexLogDir;
+    std::vector<FlexLogStage*> flexStages;
+    std::vector<std::string> flexSources;
+    FlexLogSummary flexSummary;
+    uint64_t flexTotalBytes = 0;
+    uint64_t flexTotalLines = 0;
+    std::vector<char> flexReadBuffer; // flexCollectRange 复用的读缓冲
+    std::vector<std::string> flexErrors;
+    
+    uint64_t flexCollectRange(const std::string& path, uint64_t offset, uint64_t limit,
+                              const FlexLogTimeRange* range);
+    uint32_t flexBeginSource(const std::string& name);
+    void flexEndSource(uint32_t source);
+    void flexEmit(uint32_t source, std::string_view text, uint64_t offset, FlexLogLevel level, int64_t time = 0);
+};
+
+// 单趟扫描 [data, data + size) (SSE2/AVX2, 运行时选择): 全部 '\n' 的下标写入 newlines,
+// 词首关键字候选 (er/em/cr/al/pa/fa/wa/de) 的下标写入 keywords;
+// 两个数组都至少要有 size + FLEX_LOG_SCAN_SLACK 个元素 (计数之后的几个元素可能被改写)
+constexpr size_t FLEX_LOG_SCAN_SLACK = 4;
+void flexScanLogBlock(const char* data, size_t size, uint32_t* newlines, size_t& newlineCount,
+                      uint32_t* keywords, size_t& keywordCount);
+
+// 由块扫描得到的候选确定一行的级别; keywords 为块内下标, lineStart 为该行在块内的起点
+FlexLogLevel flexResolveLogLevel(std::string_view line, const uint32_t* keywords, size_t count, size_t lineStart);
+
+template <typename Callback>
+void FlexLineSplitter::feed(const char* data, size_t size, Callback&& onLine) {
+    // 分段扫描, 下标数组大小固定
+    constexpr size_t FLEX_SPLIT_BLOCK = 64 * 1024;
+    if (flexNewlines.size() < FLEX_SPLIT_BLOCK) {
+        flexNewlines.resize(FLEX_SPLIT_BLOCK + FLEX_LOG_SCAN_SLACK);
+        flexKeywords.resize(FLEX_SPLIT_BLOCK + FLEX_LOG_SCAN_SLACK);
+    }
+    
+    while (size > 0) {
+        size_t block = std::min(size, FLEX_SPLIT_BLOCK);
+        size_t newlineCount = 0;
+        size_t keywordCount = 0;
+        flexScanLogBlock(data, block, flexNewlines.data(), newlineCount, flexKeywords.data(), keywordCount);
+        size_t start = 0;
+        size_t keyword = 0;
+        for (size_t i = 0; i < newlineCount; ++i) {
+            size_t end = flexNewlines[i];
+            size_t firstKeyword = keyword;
+            while (keyword < keywordCount && flexKeywords[keyword] < end) {
+                ++keyword;
+            }
+            if (flexCarryOffset < flexOffset) {
+                // 跨块的行单独分级
+                if (flexCarry.size() < flexMaxLine) {
+                    flexCarry.append(data + start, std::min(end - start, flexMaxLine - flexCarry.size()));
+                }
+                onLine(std::string_view(flexCarry), flexCarryOffset, flexClassifyLogLine(flexCarry));
+                flexCarry.clear();
+            } else {
+                std::string_view text(data + start, std::min(end - start, flexMaxLine));
+                onLine(text, flexOffset + start,
+                       flexResolveLogLevel(text, flexKeywords.data() + firstKeyword, keyword - firstKeyword, start));
+            }
+            start = end + 1;
+            flexCarryOffset = flexOffset + start;
+        }
+        
+        // 块尾的残行先暂存
+        if (start < block && flexCarry.size() < flexMaxLine) {
+            flexCarry.append(data + start, std::min(block - start, flexMaxLine - flexCarry.size()));
+        }
+        data += block;
+        size -= block;
+        flexOffset += block;
+    }
+}
+
+template <typename Callback>
+void FlexLineSplitter::finish(Callback&& onLine) {
+    if (flexCarryOffset < flexOffset) {
+        onLine(std::string_view(flexCarry), flexCarryOffset, flexClassifyLogLine(flexCarry));
+    }
+    flexCarry.clear();
+    flexCarryOffset = flexOffset;
+}
+
+} // namespace FlexTools
+
+#endif // FLEX_LOG_COLLECTOR_H
@@ -0,0 +1,321 @@
+#include "flex_log_follower.h"
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+namespace FlexTools {
+
+namespace {
+
+constexpr size_t FLEX_FOLLOW_READ_BUFFER = 256 * 1024;
+// 记录已读内容末尾的字节数; copytruncate 后同一位置的内容几乎不可能恰好相同
+constexpr size_t FLEX_FOLLOW_TAIL = 32;
+
+constexpr uint32_t FLEX_FOLLOW_FILE_EVENTS = IN_MODIFY | IN_ATTRIB | IN_MOVE_SELF | IN_DELETE_SELF;
+constexpr uint32_t FLEX_FOLLOW_DIR_EVENTS = IN_CREATE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE;
+
+volatile std::sig_atomic_t flexFollowStopRequested = 0;
+
+void flexFollowSignalHandler(int) {
+    flexFollowStopRequested = 1;
+}
+
+} // namespace
+
+FlexLogPrinter::FlexLogPrinter(const FlexLogCollector& collector, std::ostream& out, FlexOutputFormat format)
+    : flexCollector(collector), flexOut(out), flexFormat(format) {}
+
+void FlexLogPrinter::consume(const FlexLogLine& line) {
+    const std::string& name = flexCollector.sources()[line.source];
+    std::string text(line.text);
+    if (flexFormat == FlexOutputFormat::JSON) {
+        flexOut << "{\"file\": \"" << flexEscapeJSON(name) << "\", \"offset\": " << line.offset
+                << ", \"level\": \"" << flexLogLevelName(line.level) << "\", \"text\": \""
+                << flexEscapeJSON(text) << "\"}" << std::endl;
+    } else if (flexFormat == FlexOutputFormat::CSV) {
+        flexOut << flexEscapeCSV(name) << "," << line.offset << "," << flexLogLevelName(line.level) << ","
+                << flexEscapeCSV(text) << std::endl;
+    } else if (line.level >= FlexLogLevel::WARNING) {
+        const char* color = line.level == FlexLogLevel::WARNING ? FLEX_COLOR_YELLOW : FLEX_COLOR_RED;
+        flexOut << color << name << ": " << text << FLEX_COLOR_RESET << std::endl;
+    } else {
+        flexOut << name << ": " << text << std::endl;
+    }
+}
+
+FlexLogFollower::FlexLogFollower(FlexLogCollector& collector)
+    : flexCollector(collector), flexBuffer(FLEX_FOLLOW_READ_BUFFER) {
+    flexInotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+}
+
+FlexLogFollower::~FlexLogFollower() {
+    for (auto& followed : flexFollowed) {
+        if (followed.current.fd >= 0) close(followed.current.fd);
+        if (followed.retired.fd >= 0) close(followed.retired.fd);
+    }
+    if (flexInotify >= 0) {
+        close(flexInotify);
+    }
+}
+
+bool FlexLogFollower::addFile(const std::string& path, bool fromEnd) {
+    if (flexInotify < 0) {
+        return false;
+    }
+    // 目录的 watch 用于发现文件被改名、删除或重新创建; 同一目录重复添加返回同一个 watch
+    size_t slash = path.rfind('/');
+    std::string dir = slash == std::string::npos ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+    int dirWatch = inotify_add_watch(flexInotify, dir.c_str(), FLEX_FOLLOW_DIR_EVENTS | IN_ONLYDIR);
+    if (dirWatch < 0) {
+        return false;
+    }
+    flexDirWatches[dirWatch] = dir;
+    
+    Followed followed;
+    followed.path = path;
+    followed.source = flexCollector.flexBeginSource(path);
+    flexFollowed.push_back(std::move(followed));
+    flexOpen(flexFollowed.size() - 1, flexFollowed.back().current, fromEnd);
+    return true;
+}
+
+bool FlexLogFollower::flexOpen(size_t index, Stream& stream, bool fromEnd) {
+    Followed& followed = flexFollowed[index];
+    int fd = open(followed.path.c_str(), O_RDONLY | O_CLOEXEC | O_NONBLOCK);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        close(fd);
+        return false;
+    }
+    
+    stream.fd = fd;
+    stream.device = st.st_dev;
+    stream.inode = st.st_ino;
+    stream.offset = fromEnd ? static_cast<uint64_t>(st.st_size) : 0;
+    stream.splitter.reset(stream.offset);
+    stream.tail.clear();
+    if (stream.offset > 0) {
+        size_t length = static_cast<size_t>(std::min<uint64_t>(FLEX_FOLLOW_TAIL, stream.offset));
+        stream.tail.resize(length);
+        ssize_t count = pread(fd, &stream.tail[0], length, static_cast<off_t>(stream.offset - length));
+        stream.tail.resize(count > 0 ? static_cast<size_t>(count) : 0);
+    }
+    
+    // 经 /proc/self/fd 监视已打开的 inode 本身, 改名后事件仍能对应到这个流
+    std::string link = "/proc/self/fd/" + std::to_string(fd);
+    stream.watch = inotify_add_watch(flexInotify, link.c_str(), FLEX_FOLLOW_FILE_EVENTS);
+    if (stream.watch < 0) {
+        stream.watch = inotify_add_watch(flexInotify, followed.path.c_str(), FLEX_FOLLOW_FILE_EVENTS);
+    }
+    if (stream.watch >= 0) {
+        flexFileWatches[stream.watch] = index;
+    }
+    return true;
+}
+
+void FlexLogFollower::flexDrain(Stream& stream, uint32_t source) {
+    if (stream.fd < 0) {
+        return;
+    }
+    auto onLine = [this, source](std::string_view text, uint64_t offset, FlexLogLevel level) {
+        flexCollector.flexEmit(source, text, offset, level);
+    };
+    
+    struct stat st;
+    if (fstat(stream.fd, &st) != 0) {
+        return;
+    }
+    bool truncated = static_cast<uint64_t>(st.st_size) < stream.offset;
+    if (!truncated && !stream.tail.empty()) {
+        char check[FLEX_FOLLOW_TAIL];
+        ssize_t count = pread(stream.fd, check, stream.tail.size(),
+                              static_cast<off_t>(stream.offset - stream.tail.size()));
+        truncated = count != static_cast<ssize_t>(stream.tail.size()) ||
+                    std::memcmp(check, stream.tail.data(), stream.tail.size()) != 0;
+    }
+    if (truncated) {
+        // 截断前的残行仍是有效内容
+        stream.splitter.finish(onLine);
+        stream.offset = 0;
+        stream.splitter.reset(0);
+        stream.tail.clear();
+    }
+    
+    while (true) {
+        ssize_t count = pread(stream.fd, flexBuffer.data(), flexBuffer.size(), static_cast<off_t>(stream.offset));
+        if (count < 0 && errno == EINTR) continue;
+        if (count <= 0) break;
+        size_t size = static_cast<size_t>(count);
+        stream.splitter.feed(flexBuffer.data(), size, onLine);
+        stream.offset += size;
+        flexCollector.flexTotalBytes += size;
+        
+        if (size >= FLEX_FOLLOW_TAIL) {
+            stream.tail.assign(flexBuffer.data() + size - FLEX_FOLLOW_TAIL, FLEX_FOLLOW_TAIL);
+        } else {
+            stream.tail.append(flexBuffer.data(), size);
+            if (stream.tail.size() > FLEX_FOLLOW_TAIL) {
+                stream.tail.erase(0, stream.tail.size() - FLEX_FOLLOW_TAIL);
+            }
+        }
+        if (size < flexBuffer.size()) break;
+    }
+}
+
+void FlexLogFollower::flexClose(Stream& stream, uint32_t source) {
+    if (stream.fd < 0) {
+        return;
+    }
+    flexDrain(stream, source);
+    stream.splitter.finish([this, source](std::string_view text, uint64_t offset, FlexLogLevel level) {
+        flexCollector.flexEmit(source, text, offset, level);
+    });
+    if (stream.watch >= 0) {
+        inotify_rm_watch(flexInotify, stream.watch);
+        flexFileWatches.erase(stream.watch);
+    }
+    close(stream.fd);
+    stream = Stream();
+}
+
+void FlexLogFollower::flexCheck(size_t index) {
+    Followed& followed = flexFollowed[index];
+    flexDrain(followed.retired, followed.source);
+    
+    // 路径指向了新的 inode (改名后重建, 或另一个文件被改名到此处)
+    struct stat st;
+    if (stat(followed.path.c_str(), &st) == 0 &&
+        (followed.current.fd < 0 || st.st_ino != followed.current.inode || st.st_dev != followed.current.device)) {
+        if (followed.current.fd >= 0) {
+            flexDrain(followed.current, followed.source);
+            flexClose(followed.retired, followed.source);
+            followed.retired = std::move(followed.current);
+            followed.current = Stream();
+        }
+        flexOpen(index, followed.current, false);
+    }
+    
+    // 新文件有了内容说明写入方已经切换, 旧 inode 不会再增长: 读完旧文件后再读新文件
+    if (followed.retired.fd >= 0 && followed.current.fd >= 0) {
+        struct stat current;
+        if (fstat(followed.current.fd, &current) == 0 && current.st_size > 0) {
+            flexClose(followed.retired, followed.source);
+        }
+    }
+    flexDrain(followed.current, followed.source);
+}
+
+bool FlexLogFollower::flexWait(const struct timespec* timeout, const sigset_t* mask) {
+    struct pollfd descriptor = {flexInotify, POLLIN, 0};
+    int rc = ppoll(&descriptor, 1, timeout, mask);
+    if (rc < 0) {
+        return errno == EINTR;
+    }
+    if (rc == 0) {
+        return true;
+    }
+    
+    // 同一批事件中一个文件只检查一次
+    std::vector<bool> dirty(flexFollowed.size(), false);
+    alignas(struct inotify_event) char events[64 * 1024];
+    while (true) {
+        ssize_t length = read(flexInotify, events, sizeof(events));
+        if (length < 0 && errno == EINTR) continue;
+        if (length <= 0) break;
+        
+        for (char* p = events; p < events + length;) {
+            const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(p);
+            p += sizeof(struct inotify_event) + event->len;
+            
+            if (event->mask & IN_Q_OVERFLOW) {
+                // 事件队列溢出, 全部重新检查
+                dirty.assign(dirty.size(), true);
+                continue;
+            }
+            if (event->mask & IN_IGNORED) {
+                flexFileWatches.erase(event->wd);
+                flexDirWatches.erase(event->wd);
+                continue;
+            }
+            auto file = flexFileWatches.find(event->wd);
+            if (file != flexFileWatches.end()) {
+                dirty[file->second] = true;
+                continue;
+            }
+            auto dir = flexDirWatches.find(event->wd);
+            if (dir != flexDirWatches.end() && event->len > 0) {
+                std::string path = (dir->second == "/" ? "" : dir->second) + "/" + event->name;
+                for (size_t i = 0; i < flexFollowed.size(); ++i) {
+                    if (flexFollowed[i].path == path) dirty[i] = true;
+                }
+            }
+        }
+    }
+    
+    for (size_t i = 0; i < dirty.size(); ++i) {
+        if (dirty[i]) {
+            flexCheck(i);
+        }
+    }
+    return true;
+}
+
+bool FlexLogFollower::processEvents(int timeoutMs) {
+    if (flexInotify < 0) {
+        return false;
+    }
+    struct timespec timeout = {timeoutMs / 1000, static_cast<long>(timeoutMs % 1000) * 1000000L};
+    return flexWait(timeoutMs < 0 ? nullptr : &timeout, nullptr);
+}
+
+void FlexLogFollower::run() {
+    if (flexInotify < 0) {
+        return;
+    }
+    flexFollowStopRequested = 0;
+    struct sigaction action = {};
+    action.sa_handler = flexFollowSignalHandler;
+    sigemptyset(&action.sa_mask);
+    struct sigaction oldInt, oldTerm;
+    sigaction(SIGINT, &action, &oldInt);
+    sigaction(SIGTERM, &action, &oldTerm);
+    
+    // 信号平时屏蔽, 只在 ppoll 等待期间放开, 检查标志与进入等待之间不会漏掉信号
+    sigset_t blocked, oldMask;
+    sigemptyset(&blocked);
+    sigaddset(&blocked, SIGINT);
+    sigaddset(&blocked, SIGTERM);
+    sigprocmask(SIG_BLOCK, &blocked, &oldMask);
+    sigset_t waitMask = oldMask;
+    sigdelset(&waitMask, SIGINT);
+    sigdelset(&waitMask, SIGTERM);
+    
+    // 启动与建立 watch 之间追加的内容
+    for (size_t i = 0; i < flexFollowed.size(); ++i) {
+        flexCheck(i);
+    }
+    while (!flexFollowStopRequested) {
+        if (!flexWait(nullptr, &waitMask)) {
+            break;
+        }
+    }
+    
+    for (auto& followed : flexFollowed) {
+        flexClose(followed.retired, followed.source);
+        flexClose(followed.current, followed.source);
+        flexCollector.flexEndSource(followed.source);
+    }
+    
+    sigprocmask(SIG_SETMASK, &oldMask, nullptr);
+    sigaction(SIGINT, &oldInt, nullptr);
+    sigaction(SIGTERM, &oldTerm, nullptr);
+}
+
+} // namespace FlexTools
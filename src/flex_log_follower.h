@@ -0,0 +1,83 @@
+#ifndef FLEX_LOG_FOLLOWER_H
+#define FLEX_LOG_FOLLOWER_H
+
+#include "flex_common.h"
+#include "flex_log_collector.h"
+#include <sys/types.h>
+#include <csignal>
+#include <unordered_map>
+
+namespace FlexTools {
+
+// 跟随模式的输出阶段: 每行立即输出. TEXT 为 "文件: 行",
+// JSON 为每行一个对象 (JSON Lines), CSV 为 file,offset,level,text
+class FlexLogPrinter : public FlexLogStage {
+public:
+    FlexLogPrinter(const FlexLogCollector& collector, std::ostream& out, FlexOutputFormat format);
+    
+    void consume(const FlexLogLine& line) override;
+
+private:
+    const FlexLogCollector& flexCollector;
+    std::ostream& flexOut;
+    FlexOutputFormat flexFormat;
+};
+
+// 多文件的 tail -F: 一个 inotify 实例监视各文件的 inode 及其所在目录, 事件到达时只读取新增的字节,
+// 无事件时阻塞在 ppoll 上, 不轮询.
+// 改名后重建的轮转: 旧 inode 保持打开, 新文件开始写入时读完旧文件再切换, 不丢行也不重复;
+// copytruncate: 文件变短或已读部分末尾的内容改变时视为截断, 从头读取
+class FlexLogFollower {
+public:
+    explicit FlexLogFollower(FlexLogCollector& collector);
+    ~FlexLogFollower();
+    
+    FlexLogFollower(const FlexLogFollower&) = delete;
+    FlexLogFollower& operator=(const FlexLogFollower&) = delete;
+    
+    bool isOpen() const { return flexInotify >= 0; }
+    
+    // fromEnd 为 true 时只输出之后追加的内容; 文件尚不存在时等它创建后从头读取
+    bool addFile(const std::string& path, bool fromEnd = true);
+    
+    // 等待并处理一批事件, timeoutMs < 0 表示一直等待; 超时或被信号中断时返回 true, 出错返回 false
+    bool processEvents(int timeoutMs = -1);
+    
+    // 处理事件直到收到 SIGINT/SIGTERM, 退出前输出各文件末尾未换行的残行
+    void run();
+
+private:
+    struct Stream {
+        int fd = -1;
+        int watch = -1;
+        dev_t device = 0;
+        ino_t inode = 0;
+        uint64_t offset = 0;
+        std::string tail; // 已读内容末尾的若干字节, 用于发现 copytruncate
+        FlexLineSplitter splitter;
+    };
+    
+    struct Followed {
+        std::string path;
+        uint32_t source = 0;
+        Stream current;
+        Stream retired;   // 轮转改名后的旧 inode, 写入方可能还没有重新打开文件
+    };
+    
+    FlexLogCollector& flexCollector;
+    int flexInotify = -1;
+    std::vector<Followed> flexFollowed;
+    std::unordered_map<int, size_t> flexFileWatches;     // inode 的 watch -> flexFollowed 下标
+    std::unordered_map<int, std::string> flexDirWatches; // 目录的 watch -> 目录路径
+    std::vector<char> flexBuffer;
+    
+    bool flexWait(const struct timespec* timeout, const sigset_t* mask);
+    bool flexOpen(size_t index, Stream& stream, bool fromEnd);
+    void flexDrain(Stream& stream, uint32_t source);
+    void flexClose(Stream& stream, uint32_t source);
+    void flexCheck(size_t index);
+};
+
+} // namespace FlexTools
+
+#endif // FLEX_LOG_FOLLOWER_H
@@ -0,0 +1,758 @@
+#include "flex_log_search.h"
+#include <cctype>
+#include <climits>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define FLEX_SEARCH_X86 1
+#endif
+
+namespace FlexTools {
+
+namespace {
+
+// 短于此长度的字面量作为预过滤意义不大, 该模式改为逐行正则匹配
+constexpr size_t FLEX_SEARCH_MIN_LITERAL = 3;
+constexpr uint32_t FLEX_SEARCH_OUTPUT_BIT = 0x80000000u;
+// 三字节片段哈希位图 2^18 位 (32KB), 可常驻 L1; 复核指纹命中, 无 AVX2 时直接预过滤
+constexpr uint32_t FLEX_SEARCH_FILTER_BITS = 18;
+// 8 个桶的指纹表在字面量较多时几乎每个位置都会命中, 超过此数改走哈希位图
+constexpr size_t FLEX_SEARCH_FINGERPRINT_LITERALS = 64;
+// 每批最多缓存的行数与字节数
+constexpr size_t FLEX_SEARCH_BATCH_LINES = 256;
+constexpr size_t FLEX_SEARCH_BATCH_BYTES = 256 * 1024;
+// 文本输出中单行最多显示的字符数
+constexpr size_t FLEX_SEARCH_DISPLAY_WIDTH = 200;
+
+struct FlexDefaultPattern {
+    const char* name;
+    const char* expression;
+};
+
+const FlexDefaultPattern FLEX_DEFAULT_PATTERNS[] = {
+    {"oom-kill", "Out of memory: Killed process \\d+"},
+    {"oom-invoked", "invoked oom-killer"},
+    {"cgroup-oom", "Memory cgroup out of memory"},
+    {"nic-tx-timeout", "NETDEV WATCHDOG: \\S+.*transmit queue \\d+ timed out"},
+    {"nic-reset", "(?i)(adapter|nic|controller) reset"},
+    {"nic-link-down", "NIC Link is Down"},
+    {"ecc-corrected", "EDAC \\S+: \\d+ CE "},
+    {"ecc-uncorrected", "EDAC \\S+: \\d+ UE "},
+    {"mce", "Machine check events logged"},
+    {"hardware-error", "\\[Hardware Error\\]"},
+    {"disk-io-error", "I/O error, dev \\w+, sector \\d+"},
+    {"ata-error", "ata\\d+(\\.\\d+)?: (failed command|exception Emask)"},
+    {"fs-error", "(EXT4|XFS|BTRFS)(-fs)? (error|\\(\\S+\\): (Corruption|metadata I/O error))"},
+    {"readonly-remount", "Remounting filesystem read-only"},
+    {"soft-lockup", "BUG: soft lockup - CPU#\\d+ stuck"},
+    {"hung-task", "task \\S+:\\d+ blocked for more than \\d+ seconds"},
+    {"rcu-stall", "rcu_\\w+ detected stalls"},
+    {"kernel-oops", "Oops: \\d+"},
+    {"kernel-panic", "Kernel panic - not syncing"},
+    {"segfault", "segfault at [0-9a-f]+ ip [0-9a-f]+"},
+    {"nfs-timeout", "nfs: server \\S+ not responding"},
+    {"thermal-throttle", "temperature above threshold"},
+    {"service-failed", "Failed to start .+\\.service"},
+    {"auth-failure", "authentication failure"},
+};
+
+// 跳过以 open 开始的括号结构 ([...] 或 (...)), 返回结束符之后的位置
+size_t flexSkipBracket(const std::string& expr, size_t pos) {
+    char open = expr[pos];
+    int depth = 0;
+    for (size_t i = pos; i < expr.size(); ++i) {
+        char c = expr[i];
+        if (c == '\\') {
+            ++i;
+            continue;
+        }
+        if (open == '[') {
+            // "[]...]" 与 "[^]...]" 中紧跟的 ']' 是普通字符
+            if (c == ']' && i > pos + 1 && !(i == pos + 2 && expr[pos + 1] == '^')) return i + 1;
+            continue;
+        }
+        if (c == '[') {
+            i = flexSkipBracket(expr, i) - 1;
+        } else if (c == '(') {
+            ++depth;
+        } else if (c == ')' && --depth == 0) {
+            return i + 1;
+        }
+    }
+    return expr.size();
+}
+
+// 一个分支中必须出现的最长字面量. 分组与字符类整体视为非字面量, 可选的字符 (?, *, {) 不计入
+std::string flexLongestLiteral(const std::string& branch) {
+    std::string best;
+    std::string current;
+    auto flush = [&]() {
+        if (current.size() > best.size()) best = current;
+        current.clear();
+    };
+    
+    size_t i = 0;
+    while (i < branch.size()) {
+        char c = branch[i];
+        bool literal = false;
+        char value = c;
+        if (c == '\\' && i + 1 < branch.size()) {
+            char next = branch[i + 1];
+            if (std::isalnum(static_cast<unsigned char>(next))) {
+                // \d \w \s \b 等类别与转义码
+                flush();
+                i += next == 'x' ? 4 : next == 'u' ? 6 : next == 'c' ? 3 : 2;
+                continue;
+            }
+            literal = true;
+            value = next;
+            i += 2;
+        } else if (c == '[' || c == '(') {
+            flush();
+            i = flexSkipBracket(branch, i);
+            continue;
+        } else if (c == '.' || c == '^' || c == '$') {
+            flush();
+            ++i;
+            continue;
+        } else if (c == '*' || c == '+' || c == '?') {
+            // 紧跟在分组、字符类或其他量词之后的量词
+            ++i;
+            continue;
+        } else if (c == '{') {
+            size_t close = branch.find('}', i);
+            i = close == std::string::npos ? branch.size() : close + 1;
+            continue;
+        } else {
+            literal = true;
+            ++i;
+        }
+        
+        if (!literal) continue;
+        char quantifier = i < branch.size() ? branch[i] : '\0';
+        if (quantifier == '?' || quantifier == '*' || quantifier == '{') {
+            flush();
+        } else if (quantifier == '+') {
+            current.push_back(value);
+            flush();
+        } else {
+            current.push_back(value);
+        }
+    }
+    flush();
+    return best;
+}
+
+bool flexRequiredLiterals(const std::string& expr, std::vector<std::string>& literals);
+
+// 分支必须包含的字面量集合 (命中其一即可): 取分支本身的最长字面量, 或某个必选分组内各选项的字面量,
+// 以其中最短者最长为准
+bool flexBranchLiterals(const std::string& branch, std::vector<std::string>& literals) {
+    std::vector<std::string> best{flexLongestLiteral(branch)};
+    size_t bestLength = best[0].size();
+    
+    for (size_t i = 0; i < branch.size(); ++i) {
+        char c = branch[i];
+        if (c == '\\') {
+            ++i;
+        } else if (c == '[') {
+            i = flexSkipBracket(branch, i) - 1;
+        } else if (c == '(') {
+            size_t end = flexSkipBracket(branch, i);
+            char quantifier = end < branch.size() ? branch[end] : '\0';
+            // 断言 (?= (?! 等不消耗字符, 与 [...] 一样整体跳过; 只有 (?: 是普通分组
+            bool special = branch.compare(i + 1, 1, "?") == 0 && branch.compare(i + 1, 2, "?:") != 0;
+            if (!special && end <= branch.size() && branch[end - 1] == ')' && quantifier != '?' && quantifier != '*' &&
+                quantifier != '{') {
+                size_t start = branch.compare(i + 1, 2, "?:") == 0 ? i + 3 : i + 1;
+                std::vector<std::string> inner;
+                if (flexRequiredLiterals(branch.substr(start, end - 1 - start), inner)) {
+                    size_t shortest = SIZE_MAX;
+                    for (const auto& literal : inner) shortest = std::min(shortest, literal.size());
+                    if (shortest > bestLength) {
+                        best = std::move(inner);
+                        bestLength = shortest;
+                    }
+                }
+            }
+            i = end - 1;
+        }
+    }
+    if (bestLength < FLEX_SEARCH_MIN_LITERAL) {
+        return false;
+    }
+    literals.insert(literals.end(), best.begin(), best.end());
+    return true;
+}
+
+// 顶层按 '|' 切分, 每个分支都要有足够长的字面量, 否则返回 false
+bool flexRequiredLiterals(const std::string& expr, std::vector<std::string>& literals) {
+    std::vector<std::string> branches;
+    size_t start = 0;
+    for (size_t i = 0; i < expr.size(); ++i) {
+        char c = expr[i];
+        if (c == '\\') {
+            ++i;
+        } else if (c == '[' || c == '(') {
+            i = flexSkipBracket(expr, i) - 1;
+        } else if (c == '|') {
+            branches.push_back(expr.substr(start, i - start));
+            start = i + 1;
+        }
+    }
+    branches.push_back(expr.substr(start));
+    
+    for (const auto& branch : branches) {
+        if (!flexBranchLiterals(branch, literals)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+inline unsigned char flexFold(unsigned char c) {
+    return static_cast<unsigned char>(c - 'A') < 26 ? static_cast<unsigned char>(c | 0x20) : c;
+}
+
+inline char flexFoldAscii(unsigned char c) {
+    return static_cast<char>(c == 0 ? 1 : flexFold(c));
+}
+
+// 三字节片段的哈希; 各字节或上 0x20, 大小写字母 (及少数标点) 落在同一个值上
+inline uint32_t flexTrigramHash(uint32_t word) {
+    return ((word & 0xffffff) | 0x202020) * 0x9e3779b1u >> (32 - FLEX_SEARCH_FILTER_BITS);
+}
+
+// 字节在日志文本中的大致常见程度, 用于挑选字面量中最少见的片段
+int flexByteCommonness(unsigned char c) {
+    if (c == ' ') return 10;
+    if (std::strchr("etaoinsrh", flexFoldAscii(c)) != nullptr) return 6;
+    if (std::isalpha(c)) return 3;
+    if (std::isdigit(c)) return 4;
+    return 1;
+}
+
+} // namespace
+
+FlexLogSearch::FlexLogSearch(size_t matchLimit) : flexMatchLimit(matchLimit) {
+}
+
+bool FlexLogSearch::addPattern(const std::string& name, const std::string& expression, std::string* error) {
+    Pattern pattern;
+    std::string body = expression;
+    if (body.compare(0, 4, "(?i)") == 0) {
+        pattern.icase = true;
+        body.erase(0, 4);
+    }
+    if (body.empty()) {
+        if (error != nullptr) *error = "empty pattern";
+        return false;
+    }
+    try {
+        auto flags = std::regex::ECMAScript | std::regex::optimize;
+        pattern.regex = std::regex(body, pattern.icase ? flags | std::regex::icase : flags);
+    } catch (const std::regex_error& e) {
+        if (error != nullptr) *error = name + ": " + e.what();
+        return false;
+    }
+    pattern.pure = body.find_first_of("\\^$.|?*+()[]{}") == std::string::npos;
+    if (pattern.pure) {
+        pattern.literal = body;
+    }
+    
+    uint32_t index = static_cast<uint32_t>(flexPatterns.size());
+    std::vector<std::string> literals;
+    if (pattern.pure) {
+        literals.push_back(body);
+    }
+    if ((pattern.pure && body.size() >= FLEX_SEARCH_MIN_LITERAL) || (!pattern.pure && flexRequiredLiterals(body, literals))) {
+        for (auto& literal : literals) {
+            for (auto& c : literal) c = static_cast<char>(flexFold(static_cast<unsigned char>(c)));
+            auto found = std::find(flexLiterals.begin(), flexLiterals.end(), literal);
+            if (found == flexLiterals.end()) {
+                flexLiterals.push_back(literal);
+                flexLiteralPatterns.emplace_back();
+                found = flexLiterals.end() - 1;
+            }
+            auto& owners = flexLiteralPatterns[static_cast<size_t>(found - flexLiterals.begin())];
+            if (owners.empty() || owners.back() != index) owners.push_back(index);
+        }
+    } else {
+        flexAlwaysPatterns.push_back(index);
+    }
+    
+    flexPatterns.push_back(std::move(pattern));
+    Result result;
+    result.name = name.empty() ? expression : name;
+    result.expression = expression;
+    flexResults.push_back(std::move(result));
+    flexBuilt = false;
+    return true;
+}
+
+bool FlexLogSearch::loadPatterns(const std::string& path, std::string* error) {
+    std::ifstream in(path);
+    if (!in.is_open()) {
+        if (error != nullptr) *error = "cannot open " + path;
+        return false;
+    }
+    std::string line;
+    size_t lineNumber = 0;
+    while (std::getline(in, line)) {
+        ++lineNumber;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line[0] == '#') continue;
+        // 没有名字的行以表达式本身作名字
+        size_t tab = line.find('\t');
+        std::string expression = tab == std::string::npos ? line : line.substr(tab + 1);
+        std::string name = tab == std::string::npos ? expression : line.substr(0, tab);
+        std::string reason;
+        if (!addPattern(name, expression, &reason)) {
+            if (error != nullptr) *error = path + ":" + std::to_string(lineNumber) + ": " + reason;
+            return false;
+        }
+    }
+    return true;
+}
+
+void FlexLogSearch::addDefaultPatterns() {
+    for (const auto& pattern : FLEX_DEFAULT_PATTERNS) {
+        addPattern(pattern.name, pattern.expression);
+    }
+}
+
+void FlexLogSearch::flexBuild() {
+    // 字节类: 字面量中出现的每个 (折叠后的) 字节一类, 其余字节共用类 0
+    std::fill(std::begin(flexByteClass), std::end(flexByteClass), 0);
+    flexClassCount = 1;
+    uint8_t folded[256] = {};
+    for (const auto& literal : flexLiterals) {
+        for (unsigned char c : literal) {
+            if (folded[c] == 0) folded[c] = static_cast<uint8_t>(flexClassCount++);
+        }
+    }
+    for (int b = 0; b < 256; ++b) {
+        flexByteClass[b] = folded[flexFold(static_cast<unsigned char>(b))];
+    }
+    const uint32_t classes = flexClassCount;
+    
+    // 字典树; 转移先记为状态号, -1 表示缺失
+    std::vector<int32_t> trie(classes, -1);
+    std::vector<std::vector<uint32_t>> outputs(1);
+    for (uint32_t id = 0; id < flexLiterals.size(); ++id) {
+        int32_t state = 0;
+        for (unsigned char c : flexLiterals[id]) {
+            int32_t& next = trie[static_cast<size_t>(state) * classes + flexByteClass[c]];
+            if (next < 0) {
+                next = static_cast<int32_t>(outputs.size());
+                outputs.emplace_back();
+                trie.resize(trie.size() + classes, -1);
+            }
+            state = trie[static_cast<size_t>(state) * classes + flexByteClass[c]];
+        }
+        outputs[state].push_back(id);
+    }
+    
+    // 按层 BFS 求失败链接, 同时补全为 DFA, 输出集合并入失败状态的输出
+    size_t stateCount = outputs.size();
+    std::vector<uint32_t> fail(stateCount, 0);
+    std::vector<uint32_t> queue;
+    queue.reserve(stateCount);
+    for (uint32_t c = 0; c < classes; ++c) {
+        int32_t& next = trie[c];
+        if (next < 0) {
+            next = 0;
+        } else {
+            fail[next] = 0;
+            queue.push_back(static_cast<uint32_t>(next));
+        }
+    }
+    for (size_t head = 0; head < queue.size(); ++head) {
+        uint32_t state = queue[head];
+        const auto& inherited = outputs[fail[state]];
+        outputs[state].insert(outputs[state].end(), inherited.begin(), inherited.end());
+        for (uint32_t c = 0; c < classes; ++c) {
+            int32_t& next = trie[static_cast<size_t>(state) * classes + c];
+            int32_t viaFail = trie[static_cast<size_t>(fail[state]) * classes + c];
+            if (next < 0) {
+                next = viaFail;
+            } else {
+                fail[next] = static_cast<uint32_t>(viaFail);
+                queue.push_back(static_cast<uint32_t>(next));
+            }
+        }
+    }
+    
+    // 转移目标预乘类数, 最高位标记目标状态有输出, 扫描时每字节只查一次表
+    flexDelta.resize(trie.size());
+    for (size_t i = 0; i < trie.size(); ++i) {
+        uint32_t next = static_cast<uint32_t>(trie[i]);
+        flexDelta[i] = next * classes | (outputs[next].empty() ? 0 : FLEX_SEARCH_OUTPUT_BIT);
+    }
+    flexOutputStart.assign(stateCount + 1, 0);
+    flexOutputs.clear();
+    for (size_t state = 0; state < stateCount; ++state) {
+        flexOutputStart[state] = static_cast<uint32_t>(flexOutputs.size());
+        flexOutputs.insert(flexOutputs.end(), outputs[state].begin(), outputs[state].end());
+    }
+    flexOutputStart[stateCount] = static_cast<uint32_t>(flexOutputs.size());
+    
+    // 字面量出现时它的每个三字节片段都出现, 取最少见的一个作为指纹; 字面量依次分到 8 个桶,
+    // 字母的高半字节同时登记大小写两种
+    std::memset(flexFingerprint, 0, sizeof(flexFingerprint));
+    flexFilter.assign((size_t{1} << FLEX_SEARCH_FILTER_BITS) / 64, 0);
+    for (size_t id = 0; id < flexLiterals.size(); ++id) {
+        const std::string& literal = flexLiterals[id];
+        size_t best = 0;
+        int bestScore = INT32_MAX;
+        for (size_t i = 0; i + 3 <= literal.size(); ++i) {
+            int score = 0;
+            for (size_t j = i; j < i + 3; ++j) score += flexByteCommonness(static_cast<unsigned char>(literal[j]));
+            if (score < bestScore) {
+                bestScore = score;
+                best = i;
+            }
+        }
+        uint8_t bucket = static_cast<uint8_t>(1u << (id % 8));
+        uint32_t word = 0;
+        for (size_t k = 0; k < 3; ++k) {
+            unsigned char c = static_cast<unsigned char>(literal[best + k]);
+            flexFingerprint[2 * k][c & 0x0f] |= bucket;
+            flexFingerprint[2 * k + 1][c >> 4] |= bucket;
+            if (c >= 'a' && c <= 'z') {
+                flexFingerprint[2 * k + 1][(c ^ 0x20) >> 4] |= bucket;
+            }
+            word |= static_cast<uint32_t>(c) << (8 * k);
+        }
+        uint32_t hash = flexTrigramHash(word);
+        flexFilter[hash >> 6] |= uint64_t{1} << (hash & 63);
+    }
+    
+    flexCandidateStamp.assign(flexPatterns.size() * FLEX_SEARCH_LANES, 0);
+    flexLineStamp = 1;
+    flexBuilt = true;
+}
+
+void FlexLogSearch::beginSource(uint32_t source, const std::string& name) {
+    if (source >= flexSources.size()) {
+        flexSources.resize(source + 1);
+    }
+    flexSources[source] = name;
+}
+
+void FlexLogSearch::flexRecord(uint32_t pattern, const Pending& pending) {
+    Result& result = flexResults[pattern];
+    result.hits++;
+    if (flexMatchLimit == 0) {
+        return;
+    }
+    if (result.matches.size() >= flexMatchLimit) {
+        result.matches.pop_front();
+    }
+    result.matches.push_back({pending.source, pending.offset, flexPendingText.substr(pending.start, pending.length)});
+}
+
+void FlexLogSearch::consume(const FlexLogLine& line) {
+    if (flexPatterns.empty()) {
+        return;
+    }
+    flexPending.push_back({line.source, line.offset, flexPendingText.size(), line.text.size(), 0, 0});
+    flexPendingText.append(line.text.data(), line.text.size());
+    if (flexPending.size() >= FLEX_SEARCH_BATCH_LINES || flexPendingText.size() >= FLEX_SEARCH_BATCH_BYTES) {
+        flexScanPending();
+    }
+}
+
+void FlexLogSearch::endSource(uint32_t source) {
+    (void)source;
+    flexScanPending();
+}
+
+inline void FlexLogSearch::flexMark(uint32_t state, size_t lane) {
+    uint64_t* stamps = flexCandidateStamp.data() + lane * flexPatterns.size();
+    uint64_t stamp = flexLineStamp + lane;
+    uint32_t index = state / flexClassCount;
+    for (uint32_t k = flexOutputStart[index]; k < flexOutputStart[index + 1]; ++k) {
+        for (uint32_t pattern : flexLiteralPatterns[flexOutputs[k]]) {
+            if (stamps[pattern] != stamp) {
+                stamps[pattern] = stamp;
+                flexCandidates[lane].push_back(pattern);
+            }
+        }
+    }
+}
+
+void FlexLogSearch::flexConfirm(const Pending& pending) {
+    std::string_view text(flexPendingText.data() + pending.start, pending.length);
+    if (pending.candidateCount > 0) {
+        flexCandidateLines++;
+    }
+    for (uint32_t k = pending.candidateStart; k < pending.candidateStart + pending.candidateCount; ++k) {
+        uint32_t pattern = flexBatchCandidates[k];
+        const Pattern& p = flexPatterns[pattern];
+        bool matched;
+        if (p.pure) {
+            // 自动机不区分大小写, 区分大小写的字面量需再比较一次
+            matched = p.icase || text.find(p.literal) != std::string_view::npos;
+        } else {
+            matched = std::regex_search(text.begin(), text.end(), p.regex);
+        }
+        if (matched) {
+            flexRecord(pattern, pending);
+        }
+    }
+    for (uint32_t pattern : flexAlwaysPatterns) {
+        if (std::regex_search(text.begin(), text.end(), flexPatterns[pattern].regex)) {
+            flexRecord(pattern, pending);
+        }
+    }
+}
+
+namespace {
+
+#ifdef FLEX_SEARCH_X86
+// 32 个起点一组: 三个错位加载各按高低半字节查表, 结果相与后非零的字节即可能的指纹起点
+__attribute__((target("avx2")))
+inline uint32_t flexFingerprintChunkAVX2(const uint8_t (*tables)[16], const unsigned char* p) {
+    const __m256i lowNibble = _mm256_set1_epi8(0x0f);
+    __m256i result = _mm256_set1_epi8(static_cast<char>(0xff));
+    for (int k = 0; k < 3; ++k) {
+        const __m256i low = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(tables[2 * k])));
+        const __m256i high = _mm256_broadcastsi128_si256(
+            _mm_load_si128(reinterpret_cast<const __m128i*>(tables[2 * k + 1])));
+        const __m256i raw = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + k));
+        __m256i bits = _mm256_and_si256(_mm256_shuffle_epi8(low, _mm256_and_si256(raw, lowNibble)),
+                                        _mm256_shuffle_epi8(high, _mm256_and_si256(_mm256_srli_epi16(raw, 4), lowNibble)));
+        result = _mm256_and_si256(result, bits);
+    }
+    return ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(result, _mm256_setzero_si256())));
+}
+
+// 末尾不足一组 (含向后多读的 2 字节) 时拷到补零的缓冲里再扫
+__attribute__((target("avx2")))
+void flexFingerprintScanAVX2(const uint8_t (*tables)[16], const unsigned char* data, size_t size, uint32_t* bits) {
+    size_t i = 0;
+    for (; i + 34 <= size; i += 32) {
+        bits[i / 32] = flexFingerprintChunkAVX2(tables, data + i);
+    }
+    alignas(32) unsigned char tail[96] = {};
+    std::memcpy(tail, data + i, size - i);
+    for (size_t j = 0; i + j < size; j += 32) {
+        size_t rest = std::min<size_t>(size - i - j, 32);
+        uint32_t valid = rest == 32 ? 0xffffffffu : (1u << rest) - 1;
+        bits[(i + j) / 32] = flexFingerprintChunkAVX2(tables, tail + j) & valid;
+    }
+}
+
+bool flexHaveAVX2() {
+    static const bool supported = [] {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+    }();
+    return supported;
+}
+#endif // FLEX_SEARCH_X86
+
+// [from, to) 内是否有置位
+inline bool flexAnyBit(const uint32_t* bits, size_t from, size_t to) {
+    if (from >= to) {
+        return false;
+    }
+    size_t first = from / 32;
+    size_t last = (to - 1) / 32;
+    uint32_t head = ~0u << (from % 32);
+    uint32_t tail = ~0u >> (31 - (to - 1) % 32);
+    if (first == last) {
+        return (bits[first] & head & tail) != 0;
+    }
+    if (bits[first] & head) return true;
+    for (size_t w = first + 1; w < last; ++w) {
+        if (bits[w] != 0) return true;
+    }
+    return (bits[last] & tail) != 0;
+}
+
+} // namespace
+
+void FlexLogSearch::flexPrefilter(const unsigned char* data, size_t size) {
+    flexHitBits.assign((size + 31) / 32, 0);
+    uint32_t* bits = flexHitBits.data();
+#ifdef FLEX_SEARCH_X86
+    const uint64_t* filter = flexFilter.data();
+    if (flexLiterals.size() <= FLEX_SEARCH_FINGERPRINT_LITERALS && flexHaveAVX2()) {
+        // 半字节查表在桶间会串位, 剩下的起点再用哈希位图复核
+        flexFingerprintScanAVX2(flexFingerprint, data, size, bits);
+        for (size_t w = 0; w < flexHitBits.size(); ++w) {
+            for (uint32_t mask = bits[w]; mask != 0; mask &= mask - 1) {
+                size_t i = w * 32 + __builtin_ctz(mask);
+                if (i + 3 > size) {
+                    bits[w] &= ~(1u << (i % 32));
+                    continue;
+                }
+                uint32_t word = data[i] | data[i + 1] << 8 | static_cast<uint32_t>(data[i + 2]) << 16;
+                uint32_t hash = flexTrigramHash(word);
+                if (!(filter[hash >> 6] >> (hash & 63) & 1)) {
+                    bits[w] &= ~(1u << (i % 32));
+                }
+            }
+        }
+        return;
+    }
+#else
+    const uint64_t* filter = flexFilter.data();
+#endif
+    // 标量版: 各位置互不依赖, 每字节一次 L1 查表
+    for (size_t i = 0; i + 3 <= size; ++i) {
+        uint32_t word = data[i] | data[i + 1] << 8 | static_cast<uint32_t>(data[i + 2]) << 16;
+        uint32_t hash = flexTrigramHash(word);
+        if (filter[hash >> 6] >> (hash & 63) & 1) {
+            bits[i / 32] |= 1u << (i % 32);
+        }
+    }
+}
+
+void FlexLogSearch::flexScanPending() {
+    if (flexPending.empty()) {
+        return;
+    }
+    if (!flexBuilt) {
+        flexBuild();
+    }
+    const uint32_t* delta = flexDelta.data();
+    const uint8_t* byteClass = flexByteClass;
+    const unsigned char* base = reinterpret_cast<const unsigned char*>(flexPendingText.data());
+    
+    // 不含任何指纹的行不进自动机
+    flexPrefilter(base, flexPendingText.size());
+    std::vector<uint32_t>& passed = flexPassed;
+    passed.clear();
+    flexBatchCandidates.clear();
+    for (uint32_t i = 0; i < flexPending.size(); ++i) {
+        const Pending& pending = flexPending[i];
+        if (flexAnyBit(flexHitBits.data(), pending.start, pending.start + pending.length)) {
+            passed.push_back(i);
+        }
+    }
+    
+    for (size_t first = 0; first < passed.size(); first += FLEX_SEARCH_LANES) {
+        // 每条通道扫描一行, 各自的状态链互不依赖, 可同时发出访存
+        const unsigned char* data[FLEX_SEARCH_LANES];
+        size_t length[FLEX_SEARCH_LANES];
+        uint32_t state[FLEX_SEARCH_LANES];
+        size_t common = SIZE_MAX;
+        for (size_t lane = 0; lane < FLEX_SEARCH_LANES; ++lane) {
+            bool present = first + lane < passed.size();
+            data[lane] = present ? base + flexPending[passed[first + lane]].start : base;
+            length[lane] = present ? flexPending[passed[first + lane]].length : 0;
+            state[lane] = 0;
+            common = std::min(common, length[lane]);
+        }
+        
+        for (size_t i = 0; i < common; ++i) {
+            for (size_t lane = 0; lane < FLEX_SEARCH_LANES; ++lane) {
+                uint32_t next = delta[state[lane] + byteClass[data[lane][i]]];
+                state[lane] = next & ~FLEX_SEARCH_OUTPUT_BIT;
+                if (next & FLEX_SEARCH_OUTPUT_BIT) {
+                    flexMark(state[lane], lane);
+                }
+            }
+        }
+        for (size_t lane = 0; lane < FLEX_SEARCH_LANES; ++lane) {
+            uint32_t current = state[lane];
+            for (size_t i = common; i < length[lane]; ++i) {
+                uint32_t next = delta[current + byteClass[data[lane][i]]];
+                current = next & ~FLEX_SEARCH_OUTPUT_BIT;
+                if (next & FLEX_SEARCH_OUTPUT_BIT) {
+                    flexMark(current, lane);
+                }
+            }
+        }
+        
+        for (size_t lane = 0; lane < FLEX_SEARCH_LANES && first + lane < passed.size(); ++lane) {
+            Pending& pending = flexPending[passed[first + lane]];
+            pending.candidateStart = static_cast<uint32_t>(flexBatchCandidates.size());
+            pending.candidateCount = static_cast<uint32_t>(flexCandidates[lane].size());
+            flexBatchCandidates.insert(flexBatchCandidates.end(), flexCandidates[lane].begin(), flexCandidates[lane].end());
+            flexCandidates[lane].clear();
+        }
+        flexLineStamp += FLEX_SEARCH_LANES;
+    }
+    
+    // 按行序确认, 保留的命中行保持时间顺序
+    for (const Pending& pending : flexPending) {
+        if (pending.candidateCount > 0 || !flexAlwaysPatterns.empty()) {
+            flexConfirm(pending);
+        }
+    }
+    flexPending.clear();
+    flexPendingText.clear();
+}
+
+void FlexLogSearch::printResults(FlexOutputFormat format) const {
+    if (format == FlexOutputFormat::JSON) {
+        std::cout << toJSON() << std::endl;
+        return;
+    }
+    if (format == FlexOutputFormat::CSV) {
+        std::cout << toCSV() << std::endl;
+        return;
+    }
+    
+    std::cout << FLEX_COLOR_CYAN << "\n=== FlexTools Log Search ===" << FLEX_COLOR_RESET << std::endl;
+    std::cout << std::left << std::setw(24) << "Pattern" << std::right << std::setw(10) << "Hits" << std::endl;
+    size_t matchedPatterns = 0;
+    for (const auto& result : flexResults) {
+        if (result.hits == 0) continue;
+        matchedPatterns++;
+        std::cout << FLEX_COLOR_RED << std::left << std::setw(24) << result.name << std::right << std::setw(10)
+                  << result.hits << FLEX_COLOR_RESET << std::endl;
+        for (const auto& match : result.matches) {
+            std::cout << "    " << flexSources[match.source] << ": "
+                      << match.text.substr(0, FLEX_SEARCH_DISPLAY_WIDTH)
+                      << (match.text.size() > FLEX_SEARCH_DISPLAY_WIDTH ? " ..." : "") << std::endl;
+        }
+    }
+    std::cout << FLEX_COLOR_GREEN << "\nTotal: " << matchedPatterns << " of " << flexResults.size()
+              << " patterns matched" << FLEX_COLOR_RESET << std::endl;
+}
+
+std::string FlexLogSearch::toJSON() const {
+    std::ostringstream oss;
+    oss << "{\n  \"flex_log_search\": {\n";
+    oss << "    \"patterns\": " << flexResults.size() << ",\n";
+    oss << "    \"results\": [";
+    for (size_t i = 0; i < flexResults.size(); ++i) {
+        const auto& result = flexResults[i];
+        oss << (i ? ",\n" : "\n") << "      {\"name\": \"" << flexEscapeJSON(result.name)
+            << "\", \"expression\": \"" << flexEscapeJSON(result.expression) << "\", \"hits\": " << result.hits
+            << ", \"matches\": [";
+        for (size_t j = 0; j < result.matches.size(); ++j) {
+            const auto& match = result.matches[j];
+            oss << (j ? ", " : "") << "{\"file\": \"" << flexEscapeJSON(flexSources[match.source])
+                << "\", \"offset\": " << match.offset << ", \"text\": \"" << flexEscapeJSON(match.text) << "\"}";
+        }
+        oss << "]}";
+    }
+    oss << "\n    ]\n  }\n}";
+    return oss.str();
+}
+
+std::string FlexLogSearch::toCSV() const {
+    std::ostringstream oss;
+    oss << "Pattern,Hits,File,Offset,Text\n";
+    for (const auto& result : flexResults) {
+        if (result.matches.empty()) {
+            oss << flexEscapeCSV(result.name) << "," << result.hits << ",,,\n";
+            continue;
+        }
+        for (const auto& match : result.matches) {
+            oss << flexEscapeCSV(result.name) << "," << result.hits << ","
+                << flexEscapeCSV(flexSources[match.source]) << "," << match.offset << ","
+                << flexEscapeCSV(match.text) << "\n";
+        }
+    }
+    return oss.str();
+}
+
+} // namespace FlexTools
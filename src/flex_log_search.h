@@ -0,0 +1,115 @@
+#ifndef FLEX_LOG_SEARCH_H
+#define FLEX_LOG_SEARCH_H
+
+#include "flex_common.h"
+#include "flex_log_collector.h"
+#include <cstdint>
+#include <deque>
+#include <regex>
+
+namespace FlexTools {
+
+// 多模式日志检索阶段: 从每个正则中提取必须出现的字面量, 全部编入一个 Aho-Corasick 自动机
+// (按字节类压缩的 DFA, 不区分大小写). 一批行先整体做 SIMD 预过滤 (每个字面量取一个三字节指纹,
+// 按半字节查表, 类似 Teddy), 只有含指纹的行才走自动机, 且多行交错扫描; 命中字面量的模式再用 std::regex 确认,
+// 纯字面量的模式直接比较. 提取不出足够长字面量的模式对每行都做正则匹配.
+// 模式以 "(?i)" 开头时不区分大小写
+class FlexLogSearch : public FlexLogStage {
+public:
+    struct Match {
+        uint32_t source;
+        uint64_t offset;
+        std::string text;
+    };
+    
+    struct Result {
+        std::string name;
+        std::string expression;
+        uint64_t hits = 0;            // 命中的行数
+        std::deque<Match> matches;    // 最近的若干条命中行
+    };
+    
+    explicit FlexLogSearch(size_t matchLimit = 20);
+    
+    // 表达式不合法时返回 false 并写入 error
+    bool addPattern(const std::string& name, const std::string& expression, std::string* error = nullptr);
+    
+    // 每行 "名称<TAB>正则" 或只有正则; 空行与 # 开头的行忽略
+    bool loadPatterns(const std::string& path, std::string* error = nullptr);
+    
+    // 内置的常见故障特征 (OOM、网卡复位、ECC、磁盘 I/O 错误、内核锁死等)
+    void addDefaultPatterns();
+    
+    // 行先缓存成批再扫描, 每个源结束时 (endSource) 处理剩余的行
+    void beginSource(uint32_t source, const std::string& name) override;
+    void consume(const FlexLogLine& line) override;
+    void endSource(uint32_t source) override;
+    
+    const std::vector<Result>& results() const { return flexResults; }
+    uint64_t candidateLines() const { return flexCandidateLines; }
+    
+    void printResults(FlexOutputFormat format = FlexOutputFormat::TEXT) const;
+    std::string toJSON() const;
+    std::string toCSV() const;
+
+private:
+    struct Pattern {
+        std::regex regex;
+        std::string literal;  // 纯字面量模式的原文
+        bool icase = false;
+        bool pure = false;
+    };
+    
+    size_t flexMatchLimit;
+    std::vector<Pattern> flexPatterns;
+    std::vector<Result> flexResults;
+    std::vector<std::string> flexSources;
+    uint64_t flexCandidateLines = 0;
+    
+    // 自动机: 字面量 (已折叠为小写) 及其所属模式
+    std::vector<std::string> flexLiterals;
+    std::vector<std::vector<uint32_t>> flexLiteralPatterns;
+    std::vector<uint32_t> flexAlwaysPatterns; // 没有可用字面量的模式
+    bool flexBuilt = false;
+    uint32_t flexClassCount = 1;
+    uint8_t flexByteClass[256] = {};
+    std::vector<uint32_t> flexDelta;          // 状态 * flexClassCount + 字节类 -> 下一状态 * flexClassCount
+    std::vector<uint32_t> flexOutputStart;    // 状态 -> flexOutputs 中的区间
+    std::vector<uint32_t> flexOutputs;        // 字面量下标
+    // 预过滤: 指纹第 k 个字节按低/高半字节查表 (flexFingerprint[2k], [2k+1]), 每位对应一个桶;
+    // 无 AVX2 时改用指纹哈希位图 flexFilter
+    alignas(16) uint8_t flexFingerprint[6][16] = {};
+    std::vector<uint64_t> flexFilter;
+    std::vector<uint32_t> flexHitBits;        // 批内每个字节位置是否可能为指纹起点
+    
+    // 待扫描的行: 文本复制到 flexPendingText, 凑满一批后多行交错扫描, 掩盖逐字节查表的延迟
+    static constexpr size_t FLEX_SEARCH_LANES = 4;
+    struct Pending {
+        uint32_t source;
+        uint64_t offset;
+        size_t start;
+        size_t length;
+        uint32_t candidateStart; // flexBatchCandidates 中的区间
+        uint32_t candidateCount;
+    };
+    std::vector<Pending> flexPending;
+    std::string flexPendingText;
+    std::vector<uint32_t> flexPassed; // 通过预过滤的 flexPending 下标
+    std::vector<uint32_t> flexBatchCandidates;
+    
+    // 每条通道各自的候选标记, 以行序号区分避免逐行清零
+    std::vector<uint64_t> flexCandidateStamp;
+    std::vector<uint32_t> flexCandidates[FLEX_SEARCH_LANES];
+    uint64_t flexLineStamp = 0;
+    
+    void flexBuild();
+    void flexPrefilter(const unsigned char* data, size_t size);
+    void flexScanPending();
+    void flexMark(uint32_t state, size_t lane);
+    void flexConfirm(const Pending& pending);
+    void flexRecord(uint32_t pattern, const Pending& pending);
+};
+
+} // namespace FlexTools
+
+#endif // FLEX_LOG_SEARCH_H
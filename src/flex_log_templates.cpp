@@ -0,0 +1,274 @@
+#include "flex_log_templates.h"
+#include <algorithm>
+#include <ctime>
+#include <sys/stat.h>
+
+namespace FlexTools {
+
+namespace {
+
+const char FLEX_TEMPLATE_WILDCARD[] = "<*>";
+// 文本输出中模板最多显示的字符数
+constexpr size_t FLEX_TEMPLATE_DISPLAY_WIDTH = 160;
+
+inline bool flexIsDigit(char c) {
+    return static_cast<unsigned char>(c - '0') < 10;
+}
+
+// 含数字的词替换为 <*>, 保留 "name[" / "key=" 之类的前缀与末尾的标点,
+// 如 "sshd[1234]:" -> "sshd[<*>]:", "pid=42," -> "pid=<*>,"
+void flexMaskToken(std::string_view token, std::string& out) {
+    out.assign(token.data(), token.size());
+    if (std::none_of(token.begin(), token.end(), flexIsDigit)) {
+        return;
+    }
+    size_t begin = 0;
+    size_t separator = token.find_first_of("[=(");
+    if (separator != std::string_view::npos &&
+        std::none_of(token.begin(), token.begin() + separator, flexIsDigit)) {
+        begin = separator + 1;
+    }
+    size_t end = token.size();
+    while (end > begin && std::string_view("]):,;").find(token[end - 1]) != std::string_view::npos) {
+        --end;
+    }
+    out.replace(begin, end - begin, FLEX_TEMPLATE_WILDCARD);
+}
+
+inline bool flexIsWildcard(const std::string& token) {
+    return token.find(FLEX_TEMPLATE_WILDCARD) != std::string::npos;
+}
+
+} // namespace
+
+FlexLogTemplateMiner::FlexLogTemplateMiner(size_t depth, double similarity, size_t maxChildren, size_t maxTemplates)
+    : flexDepth(std::max<size_t>(depth, 1)),
+      flexSimilarity(similarity),
+      flexMaxChildren(std::max<size_t>(maxChildren, 2)),
+      flexMaxTemplates(maxTemplates) {
+}
+
+void FlexLogTemplateMiner::beginSource(uint32_t source, const std::string& name) {
+    if (flexSources.size() <= source) {
+        flexSources.resize(source + 1);
+    }
+    flexSources[source] = name;
+    // syslog 时间戳没有年份, 以文件修改时间为参照
+    struct stat st;
+    time_t reference = stat(name.c_str(), &st) == 0 ? st.st_mtime : time(nullptr);
+    flexParser.reset(new FlexLogTimeParser(reference));
+    flexLastTime = 0;
+}
+
+void FlexLogTemplateMiner::flexTokenize(std::string_view text) {
+    flexTokenCount = 0;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        while (pos < text.size() && flexIsSpace(text[pos])) ++pos;
+        size_t start = pos;
+        while (pos < text.size() && !flexIsSpace(text[pos])) ++pos;
+        if (pos == start) break;
+        if (flexTokenCount == flexTokens.size()) {
+            flexTokens.emplace_back();
+        }
+        flexMaskToken(text.substr(start, pos - start), flexTokens[flexTokenCount++]);
+    }
+}
+
+void FlexLogTemplateMiner::consume(const FlexLogLine& line) {
+    flexLines++;
+    std::string_view text = line.text;
+    time_t stamp;
+    if (line.time != 0) {
+        // journal 记录自带时间, 文本中没有时间戳
+        flexLastTime = line.time;
+    } else if (flexParser && flexParser->parse(text, stamp)) {
+        flexLastTime = stamp;
+        // 去掉时间戳, 不让它占用解析树的层
+        size_t skip = FlexLogTimeParser::timestampTokens(text);
+        size_t pos = 0;
+        for (size_t i = 0; i < skip && pos < text.size(); ++i) {
+            while (pos < text.size() && flexIsSpace(text[pos])) ++pos;
+            while (pos < text.size() && !flexIsSpace(text[pos])) ++pos;
+        }
+        text.remove_prefix(pos);
+    }
+    flexTokenize(text);
+    
+    uint32_t index = UINT32_MAX;
+    Node* leaf = flexDescend(false);
+    if (leaf != nullptr) {
+        index = flexBestCluster(*leaf);
+    }
+    if (index != UINT32_MAX) {
+        flexMerge(flexTemplates[index]);
+    } else {
+        if (flexTemplates.size() >= flexMaxTemplates) {
+            flexUnmatched++;
+            return;
+        }
+        index = static_cast<uint32_t>(flexTemplates.size());
+        Cluster cluster;
+        cluster.tokens.assign(flexTokens.begin(), flexTokens.begin() + flexTokenCount);
+        cluster.info.source = line.source;
+        cluster.info.level = line.level;
+        flexTemplates.push_back(std::move(cluster));
+        flexDescend(true)->clusters.push_back(index);
+    }
+    
+    Template& info = flexTemplates[index].info;
+    info.count++;
+    // 各源按文件顺序而非时间顺序到达, 取最早/最晚而不是首个/末个
+    if (flexLastTime != 0) {
+        if (info.first == 0 || flexLastTime < info.first) info.first = flexLastTime;
+        if (flexLastTime > info.last) info.last = flexLastTime;
+    }
+    if (line.level > info.level) info.level = line.level;
+}
+
+FlexLogTemplateMiner::Node* FlexLogTemplateMiner::flexDescend(bool create) {
+    // 第一层按词数, 其后按前 depth 个词; 参数词与超出子节点上限的词走 <*> 分支
+    auto length = flexRoot.find(flexTokenCount);
+    if (length == flexRoot.end()) {
+        if (!create) return nullptr;
+        length = flexRoot.emplace(flexTokenCount, Node()).first;
+    }
+    Node* node = &length->second;
+    size_t layers = std::min(flexDepth, flexTokenCount);
+    for (size_t i = 0; i < layers; ++i) {
+        const std::string& token = flexTokens[i];
+        std::string_view key = flexIsWildcard(token) ? std::string_view(FLEX_TEMPLATE_WILDCARD) : token;
+        auto child = node->children.find(key);
+        if (child == node->children.end()) {
+            child = node->children.find(std::string_view(FLEX_TEMPLATE_WILDCARD));
+            if (create && (child == node->children.end() || node->children.size() < flexMaxChildren)) {
+                if (node->children.size() >= flexMaxChildren) {
+                    key = FLEX_TEMPLATE_WILDCARD;
+                }
+                child = node->children.emplace(std::string(key), std::unique_ptr<Node>(new Node())).first;
+            } else if (child == node->children.end()) {
+                return nullptr;
+            }
+        }
+        node = child->second.get();
+    }
+    return node;
+}
+
+uint32_t FlexLogTemplateMiner::flexBestCluster(const Node& leaf) const {
+    // 相同位置上相等的词 (模板中的 <*> 与任意词相等) 所占比例最高者; 同分时取参数较多的
+    uint32_t best = UINT32_MAX;
+    double bestScore = -1.0;
+    size_t bestParams = 0;
+    for (uint32_t index : leaf.clusters) {
+        const std::vector<std::string>& tokens = flexTemplates[index].tokens;
+        if (tokens.size() != flexTokenCount) continue;
+        size_t same = 0;
+        size_t params = 0;
+        for (size_t i = 0; i < flexTokenCount; ++i) {
+            if (tokens[i] == FLEX_TEMPLATE_WILDCARD) {
+                params++;
+                same++;
+            } else if (tokens[i] == flexTokens[i]) {
+                same++;
+            }
+        }
+        double score = flexTokenCount == 0 ? 1.0 : static_cast<double>(same) / flexTokenCount;
+        if (score > bestScore || (score == bestScore && params > bestParams)) {
+            best = index;
+            bestScore = score;
+            bestParams = params;
+        }
+    }
+    return bestScore >= flexSimilarity ? best : UINT32_MAX;
+}
+
+void FlexLogTemplateMiner::flexMerge(Cluster& cluster) const {
+    for (size_t i = 0; i < flexTokenCount; ++i) {
+        if (cluster.tokens[i] != flexTokens[i] && cluster.tokens[i] != FLEX_TEMPLATE_WILDCARD) {
+            cluster.tokens[i] = FLEX_TEMPLATE_WILDCARD;
+        }
+    }
+}
+
+std::vector<FlexLogTemplateMiner::Template> FlexLogTemplateMiner::templates() const {
+    std::vector<Template> result;
+    result.reserve(flexTemplates.size());
+    for (const auto& cluster : flexTemplates) {
+        Template info = cluster.info;
+        for (size_t i = 0; i < cluster.tokens.size(); ++i) {
+            if (i) info.text.push_back(' ');
+            info.text += cluster.tokens[i];
+        }
+        result.push_back(std::move(info));
+    }
+    std::stable_sort(result.begin(), result.end(),
+                     [](const Template& a, const Template& b) { return a.count > b.count; });
+    return result;
+}
+
+void FlexLogTemplateMiner::printTemplates(FlexOutputFormat format, size_t limit) const {
+    if (format == FlexOutputFormat::JSON) {
+        std::cout << toJSON() << std::endl;
+        return;
+    }
+    if (format == FlexOutputFormat::CSV) {
+        std::cout << toCSV() << std::endl;
+        return;
+    }
+    
+    auto list = templates();
+    std::cout << FLEX_COLOR_CYAN << "\n=== FlexTools Log Templates ===" << FLEX_COLOR_RESET << std::endl;
+    std::cout << std::right << std::setw(10) << "Count" << "  " << std::left << std::setw(21) << "First"
+              << std::setw(21) << "Last" << "Template" << std::endl;
+    for (size_t i = 0; i < list.size() && i < limit; ++i) {
+        const auto& entry = list[i];
+        const char* color = entry.level >= FlexLogLevel::ERROR     ? FLEX_COLOR_RED
+                            : entry.level == FlexLogLevel::WARNING ? FLEX_COLOR_YELLOW
+                                                                   : "";
+        std::cout << color << std::right << std::setw(10) << entry.count << "  " << std::left << std::setw(21)
+                  << flexFormatTime(entry.first) << std::setw(21) << flexFormatTime(entry.last)
+                  << entry.text.substr(0, FLEX_TEMPLATE_DISPLAY_WIDTH)
+                  << (entry.text.size() > FLEX_TEMPLATE_DISPLAY_WIDTH ? " ..." : "") << FLEX_COLOR_RESET << std::endl;
+    }
+    if (list.size() > limit) {
+        std::cout << "  ... " << (list.size() - limit) << " more templates" << std::endl;
+    }
+    std::cout << FLEX_COLOR_GREEN << "\nTotal: " << flexLines << " lines in " << list.size() << " templates";
+    if (flexUnmatched > 0) {
+        std::cout << ", " << flexUnmatched << " lines over the template limit";
+    }
+    std::cout << FLEX_COLOR_RESET << std::endl;
+}
+
+std::string FlexLogTemplateMiner::toJSON() const {
+    auto list = templates();
+    std::ostringstream oss;
+    oss << "{\n  \"flex_log_templates\": {\n";
+    oss << "    \"total_lines\": " << flexLines << ",\n";
+    oss << "    \"unmatched_lines\": " << flexUnmatched << ",\n";
+    oss << "    \"templates\": [";
+    for (size_t i = 0; i < list.size(); ++i) {
+        const auto& entry = list[i];
+        oss << (i ? ",\n" : "\n") << "      {\"template\": \"" << flexEscapeJSON(entry.text)
+            << "\", \"count\": " << entry.count << ", \"first\": \"" << flexFormatTime(entry.first)
+            << "\", \"last\": \"" << flexFormatTime(entry.last) << "\", \"level\": \""
+            << flexLogLevelName(entry.level) << "\", \"file\": \"" << flexEscapeJSON(flexSources[entry.source])
+            << "\"}";
+    }
+    oss << "\n    ]\n  }\n}";
+    return oss.str();
+}
+
+std::string FlexLogTemplateMiner::toCSV() const {
+    std::ostringstream oss;
+    oss << "Count,First,Last,Level,File,Template\n";
+    for (const auto& entry : templates()) {
+        oss << entry.count << "," << flexFormatTime(entry.first) << "," << flexFormatTime(entry.last) << ","
+            << flexLogLevelName(entry.level) << "," << flexEscapeCSV(flexSources[entry.source]) << ","
+            << flexEscapeCSV(entry.text) << "\n";
+    }
+    return oss.str();
+}
+
+} // namespace FlexTools
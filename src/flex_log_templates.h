@@ -0,0 +1,83 @@
+#ifndef FLEX_LOG_TEMPLATES_H
+#define FLEX_LOG_TEMPLATES_H
+
+#include "flex_common.h"
+#include "flex_log_collector.h"
+#include "flex_log_time_index.h"
+#include <cstdint>
+#include <map>
+#include <memory>
+
+namespace FlexTools {
+
+// 在线日志模板提取 (Drain 式固定深度解析树): 去掉行首时间戳后按空白切词, 含数字的词先替换为 <*>;
+// 树的第一层按词数分支, 其后 depth 层按前几个词分支 (子节点超过 maxChildren 时归入 <*>),
+// 叶子上保存候选模板. 与最相似模板的相同词比例达到 similarity 时合并 (不同的位置变为 <*>),
+// 否则新建模板. 状态只随模板数增长, 模板数达到 maxTemplates 后新出现的行只计入 unmatched()
+class FlexLogTemplateMiner : public FlexLogStage {
+public:
+    struct Template {
+        std::string text;       // 以空格连接的词, 参数位置为 <*>
+        uint64_t count = 0;
+        int64_t first = 0;      // 最早/最晚出现的时间戳, 无时间戳时为 0
+        int64_t last = 0;
+        FlexLogLevel level = FlexLogLevel::DEBUG; // 出现过的最高级别
+        uint32_t source = 0;    // 首次出现的源
+    };
+    
+    explicit FlexLogTemplateMiner(size_t depth = 3, double similarity = 0.5, size_t maxChildren = 100,
+                                  size_t maxTemplates = 10000);
+    
+    // 每个源按其修改时间推断 syslog 时间戳的年份
+    void beginSource(uint32_t source, const std::string& name) override;
+    void consume(const FlexLogLine& line) override;
+    
+    // 按出现次数从多到少
+    std::vector<Template> templates() const;
+    size_t templateCount() const { return flexTemplates.size(); }
+    uint64_t lines() const { return flexLines; }
+    uint64_t unmatched() const { return flexUnmatched; }
+    
+    void printTemplates(FlexOutputFormat format = FlexOutputFormat::TEXT, size_t limit = 50) const;
+    std::string toJSON() const;
+    std::string toCSV() const;
+
+private:
+    struct Cluster {
+        std::vector<std::string> tokens;
+        Template info;
+    };
+    
+    struct Node {
+        std::map<std::string, std::unique_ptr<Node>, std::less<>> children;
+        std::vector<uint32_t> clusters; // 叶子上的模板下标
+    };
+    
+    size_t flexDepth;
+    double flexSimilarity;
+    size_t flexMaxChildren;
+    size_t flexMaxTemplates;
+    
+    std::map<size_t, Node> flexRoot; // 按词数分支
+    std::vector<Cluster> flexTemplates;
+    std::vector<std::string> flexSources;
+    uint64_t flexLines = 0;
+    uint64_t flexUnmatched = 0;
+    
+    // 当前源的时间戳解析; 没有时间戳的行沿用上一行的时间
+    std::unique_ptr<FlexLogTimeParser> flexParser;
+    int64_t flexLastTime = 0;
+    
+    // 逐行复用的切词缓冲, 只有前 flexTokenCount 个有效
+    std::vector<std::string> flexTokens;
+    size_t flexTokenCount = 0;
+    
+    void flexTokenize(std::string_view text);
+    Node* flexDescend(bool create);
+    uint32_t flexBestCluster(const Node& leaf) const;
+    void flexMerge(Cluster& cluster) const;
+};
+
+} // namespace FlexTools
+
+#endif // FLEX_LOG_TEMPLATES_H
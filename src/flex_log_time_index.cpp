@@ -0,0 +1,337 @@
+#include "flex_log_time_index.h"
+#include "flex_package_snapshot.h"
+#include "flex_proc_file.h"
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+namespace FlexTools {
+
+namespace {
+
+constexpr char FLEX_TIME_INDEX_MAGIC[8] = {'F', 'L', 'X', 'T', 'I', 'D', 'X', '1'};
+// 取样时在边界之后读取的字节数, 其中没有带时间戳的完整行则跳过该样本
+constexpr size_t FLEX_TIME_SAMPLE_WINDOW = 16 * 1024;
+constexpr uint64_t FLEX_TIME_SIGNATURE_MAX = 4096;
+// 允许的时间戳乱序幅度 (秒), 查找范围两端各放宽这么多, 行级过滤仍按精确范围
+constexpr int64_t FLEX_TIME_SKEW = 300;
+
+struct FlexTimeIndexHeader {
+    char magic[8];
+    uint64_t device;
+    uint64_t inode;
+    uint64_t indexedSize;
+    uint64_t nextBoundary;
+    uint64_t stride;
+    uint64_t signature;
+    uint64_t signatureLength;
+    uint64_t sampleCount;
+};
+
+inline bool flexDigits(std::string_view text, size_t pos, size_t count, int& value) {
+    value = 0;
+    for (size_t i = pos; i < pos + count; ++i) {
+        unsigned digit = static_cast<unsigned char>(text[i]) - '0';
+        if (digit > 9) return false;
+        value = value * 10 + static_cast<int>(digit);
+    }
+    return true;
+}
+
+// 公历日期到 1970-01-01 起的天数
+int64_t flexDaysFromCivil(int year, int month, int day) {
+    year -= month <= 2;
+    int64_t era = (year >= 0 ? year : year - 399) / 400;
+    int64_t yoe = year - era * 400;
+    int64_t doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+int flexMonthIndex(std::string_view name) {
+    static const char months[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+    for (int i = 0; i < 12; ++i) {
+        if (name.compare(0, 3, months + i * 3, 3) == 0) return i;
+    }
+    return -1;
+}
+
+uint64_t flexFnv1a(const char* data, size_t size) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ static_cast<unsigned char>(data[i])) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+bool flexSignatureOf(int fd, uint64_t length, uint64_t& signature) {
+    char buffer[FLEX_TIME_SIGNATURE_MAX];
+    ssize_t count = pread(fd, buffer, static_cast<size_t>(length), 0);
+    if (count != static_cast<ssize_t>(length)) {
+        return false;
+    }
+    signature = flexFnv1a(buffer, static_cast<size_t>(length));
+    return true;
+}
+
+} // namespace
+
+FlexLogTimeParser::FlexLogTimeParser(time_t reference) {
+    struct tm local;
+    localtime_r(&reference, &local);
+    flexYear = local.tm_year + 1900;
+    flexMonth = local.tm_mon;
+}
+
+int64_t FlexLogTimeParser::flexLocalOffset(int year, int month, int day, int hour) const {
+    int64_t wall = flexDaysFromCivil(year, month, day) * 86400 + hour * 3600;
+    if (wall / 3600 == flexCachedHour) {
+        return flexCachedOffset;
+    }
+    
+    // tm_isdst = -1 让 mktime 自行判断该时刻是否处于夏令时
+    struct tm local{};
+    local.tm_year = year - 1900;
+    local.tm_mon = month - 1;
+    local.tm_mday = day;
+    local.tm_hour = hour;
+    local.tm_isdst = -1;
+    time_t utc = mktime(&local);
+    flexCachedHour = wall / 3600;
+    flexCachedOffset = utc == static_cast<time_t>(-1) ? 0 : wall - static_cast<int64_t>(utc);
+    return flexCachedOffset;
+}
+
+bool FlexLogTimeParser::parse(std::string_view line, time_t& out) const {
+    int year, month, day, hour, minute, second;
+    bool zoned = false;
+    long offset = 0;
+    
+    if (line.size() >= 19 && line[4] == '-' && line[7] == '-' && (line[10] == 'T' || line[10] == ' ') &&
+        line[13] == ':' && line[16] == ':' && flexDigits(line, 0, 4, year) && flexDigits(line, 5, 2, month) &&
+        flexDigits(line, 8, 2, day) && flexDigits(line, 11, 2, hour) && flexDigits(line, 14, 2, minute) &&
+        flexDigits(line, 17, 2, second)) {
+        // RFC3339: 小数秒忽略, 时区为 Z 或 ±HH[:]MM
+        size_t pos = 19;
+        if (pos < line.size() && (line[pos] == '.' || line[pos] == ',')) {
+            ++pos;
+            while (pos < line.size() && static_cast<unsigned char>(line[pos] - '0') < 10) ++pos;
+        }
+        if (pos < line.size() && line[pos] == 'Z') {
+            zoned = true;
+        } else if (pos + 5 <= line.size() && (line[pos] == '+' || line[pos] == '-')) {
+            int tzHour, tzMinute;
+            size_t minutePos = line[pos + 3] == ':' ? pos + 4 : pos + 3;
+            if (minutePos + 2 <= line.size() && flexDigits(line, pos + 1, 2, tzHour) &&
+                flexDigits(line, minutePos, 2, tzMinute)) {
+                offset = (tzHour * 3600L + tzMinute * 60L) * (line[pos] == '-' ? -1 : 1);
+                zoned = true;
+            }
+        }
+    } else if (line.size() >= 15 && line[3] == ' ' && line[6] == ' ' && line[9] == ':' && line[12] == ':' &&
+               flexDigits(line, 7, 2, hour) && flexDigits(line, 10, 2, minute) && flexDigits(line, 13, 2, second)) {
+        // syslog: "Mmm dd HH:MM:SS", 日期可能以空格补齐
+        int monthIndex = flexMonthIndex(line);
+        if (monthIndex < 0) {
+            return false;
+        }
+        int tens = line[4] == ' ' ? 0 : line[4] - '0';
+        int ones = line[5] - '0';
+        if (tens < 0 || tens > 3 || ones < 0 || ones > 9) {
+            return false;
+        }
+        day = tens * 10 + ones;
+        month = monthIndex + 1;
+        year = monthIndex > flexMonth ? flexYear - 1 : flexYear;
+    } else {
+        return false;
+    }
+    
+    if (month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 60) {
+        return false;
+    }
+    if (!zoned) {
+        offset = static_cast<long>(flexLocalOffset(year, month, day, hour));
+    }
+    out = static_cast<time_t>(flexDaysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second -
+                              offset);
+    return true;
+}
+
+size_t FlexLogTimeParser::timestampTokens(std::string_view line) {
+    if (line.size() >= 19 && line[4] == '-' && line[7] == '-') {
+        return line[10] == ' ' ? 2 : 1;
+    }
+    return 3;
+}
+
+FlexLogTimeIndex::FlexLogTimeIndex(const std::string& logPath, const std::string& indexPath, uint64_t stride)
+    : flexLogPath(logPath), flexIndexPath(indexPath), flexStride(std::max<uint64_t>(stride, 4096)) {
+    if (flexIndexPath.empty()) {
+        std::string name = logPath;
+        std::replace(name.begin(), name.end(), '/', '%');
+        flexIndexPath = FlexPackageSnapshot::flexDefaultPath("logindex/" + name + ".idx");
+    }
+}
+
+bool FlexLogTimeIndex::flexSample(int fd, uint64_t boundary, uint64_t size, FlexLogTimeSample& sample) const {
+    // 从边界前一个字节读起, 以便判断边界本身是否为行首
+    uint64_t start = boundary > 0 ? boundary - 1 : 0;
+    size_t length = static_cast<size_t>(std::min<uint64_t>(FLEX_TIME_SAMPLE_WINDOW, size - start));
+    std::string buffer(length, '\0');
+    ssize_t count = pread(fd, &buffer[0], length, static_cast<off_t>(start));
+    if (count <= 0) {
+        return false;
+    }
+    std::string_view view(buffer.data(), static_cast<size_t>(count));
+    
+    size_t pos = 0;
+    if (boundary > 0) {
+        size_t newline = view.find('\n');
+        if (newline == std::string_view::npos) return false;
+        pos = newline + 1;
+    }
+    while (pos < view.size()) {
+        size_t end = view.find('\n', pos);
+        if (end == std::string_view::npos) {
+            // 只取完整的行, 文件末尾的行除外
+            if (start + view.size() < size) break;
+            end = view.size();
+        }
+        time_t time;
+        if (flexParser.parse(view.substr(pos, end - pos), time)) {
+            sample.offset = start + pos;
+            sample.time = static_cast<int64_t>(time);
+            return true;
+        }
+        pos = end + 1;
+    }
+    return false;
+}
+
+bool FlexLogTimeIndex::update() {
+    int fd = open(flexLogPath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        close(fd);
+        return false;
+    }
+    uint64_t size = static_cast<uint64_t>(st.st_size);
+    flexParser = FlexLogTimeParser(st.st_mtime);
+    
+    // 同一 inode、没有变短且开头内容未变时沿用已有样本
+    uint64_t signature = 0;
+    bool valid = flexLoad() && flexDevice == static_cast<uint64_t>(st.st_dev) &&
+                 flexInode == static_cast<uint64_t>(st.st_ino) && size >= flexIndexedSize &&
+                 flexSignatureOf(fd, flexSignatureLength, signature) && signature == flexSignature;
+    bool changed = !valid;
+    if (!valid) {
+        flexSamples.clear();
+        flexDevice = static_cast<uint64_t>(st.st_dev);
+        flexInode = static_cast<uint64_t>(st.st_ino);
+        flexIndexedSize = 0;
+        flexNextBoundary = 0;
+        flexSignatureLength = 0;
+    }
+    if (flexSignatureLength < FLEX_TIME_SIGNATURE_MAX && flexSignatureLength < size) {
+        flexSignatureLength = std::min(size, FLEX_TIME_SIGNATURE_MAX);
+        flexSignatureOf(fd, flexSignatureLength, flexSignature);
+        changed = true;
+    }
+    
+    while (flexNextBoundary < size) {
+        FlexLogTimeSample sample;
+        if (flexSample(fd, flexNextBoundary, size, sample)) {
+            if (flexSamples.empty() || sample.offset > flexSamples.back().offset) {
+                flexSamples.push_back(sample);
+            }
+        } else if (flexNextBoundary + FLEX_TIME_SAMPLE_WINDOW >= size) {
+            // 末尾的边界之后还没有完整的行, 留到下次扩展
+            break;
+        }
+        flexNextBoundary += flexStride;
+    }
+    close(fd);
+    
+    changed = changed || flexIndexedSize != size;
+    flexIndexedSize = size;
+    if (changed) {
+        flexSave();
+    }
+    return true;
+}
+
+bool FlexLogTimeIndex::locate(time_t from, time_t to, uint64_t& begin, uint64_t& end) const {
+    if (flexSamples.empty() || from > to) {
+        return false;
+    }
+    // 只给出一端时另一端是 time_t 的极值, 放宽时饱和而不溢出
+    int64_t low = static_cast<int64_t>(from);
+    int64_t high = static_cast<int64_t>(to);
+    low = low < INT64_MIN + FLEX_TIME_SKEW ? INT64_MIN : low - FLEX_TIME_SKEW;
+    high = high > INT64_MAX - FLEX_TIME_SKEW ? INT64_MAX : high + FLEX_TIME_SKEW;
+    
+    // 起点: 第一个不早于 low 的样本的前一个样本; 终点: 第一个晚于 high 的样本
+    auto first = std::partition_point(flexSamples.begin(), flexSamples.end(),
+                                      [low](const FlexLogTimeSample& sample) { return sample.time < low; });
+    auto last = std::partition_point(first, flexSamples.end(),
+                                     [high](const FlexLogTimeSample& sample) { return sample.time <= high; });
+    begin = first == flexSamples.begin() ? 0 : std::prev(first)->offset;
+    end = last == flexSamples.end() ? flexIndexedSize : last->offset;
+    return begin < end;
+}
+
+bool FlexLogTimeIndex::flexLoad() {
+    std::string content;
+    if (flexIndexPath.empty() || !flexReadWholeFile(flexIndexPath, content) ||
+        content.size() < sizeof(FlexTimeIndexHeader)) {
+        return false;
+    }
+    FlexTimeIndexHeader header;
+    std::memcpy(&header, content.data(), sizeof(header));
+    if (std::memcmp(header.magic, FLEX_TIME_INDEX_MAGIC, sizeof(header.magic)) != 0 || header.stride != flexStride ||
+        header.signatureLength > FLEX_TIME_SIGNATURE_MAX ||
+        content.size() != sizeof(header) + header.sampleCount * sizeof(FlexLogTimeSample)) {
+        return false;
+    }
+    
+    flexDevice = header.device;
+    flexInode = header.inode;
+    flexIndexedSize = header.indexedSize;
+    flexNextBoundary = header.nextBoundary;
+    flexSignature = header.signature;
+    flexSignatureLength = header.signatureLength;
+    flexSamples.resize(header.sampleCount);
+    if (header.sampleCount > 0) {
+        std::memcpy(flexSamples.data(), content.data() + sizeof(header), header.sampleCount * sizeof(FlexLogTimeSample));
+    }
+    return true;
+}
+
+bool FlexLogTimeIndex::flexSave() const {
+    FlexTimeIndexHeader header{};
+    std::memcpy(header.magic, FLEX_TIME_INDEX_MAGIC, sizeof(header.magic));
+    header.device = flexDevice;
+    header.inode = flexInode;
+    header.indexedSize = flexIndexedSize;
+    header.nextBoundary = flexNextBoundary;
+    header.stride = flexStride;
+    header.signature = flexSignature;
+    header.signatureLength = flexSignatureLength;
+    header.sampleCount = flexSamples.size();
+    
+    std::string buffer(sizeof(header) + flexSamples.size() * sizeof(FlexLogTimeSample), '\0');
+    std::memcpy(&buffer[0], &header, sizeof(header));
+    if (!flexSamples.empty()) {
+        std::memcpy(&buffer[sizeof(header)], flexSamples.data(), flexSamples.size() * sizeof(FlexLogTimeSample));
+    }
+    // 并发的读者不会看到写了一半的索引
+    return flexAtomicWriteFile(flexIndexPath, buffer);
+}
+
+} // namespace FlexTools
@@ -0,0 +1,79 @@
+#ifndef FLEX_LOG_TIME_INDEX_H
+#define FLEX_LOG_TIME_INDEX_H
+
+#include "flex_common.h"
+#include <cstdint>
+#include <string_view>
+
+namespace FlexTools {
+
+// 行首时间戳解析, 支持 RFC3339 ("2026-10-17T14:02:03.5+02:00", 也接受空格分隔与无时区)
+// 与传统 syslog ("Oct 17 14:02:03"). 无时区时按本地时区 (含夏令时切换), syslog 格式的年份取 reference
+// 所在年份, 月份晚于 reference 时视为上一年. 内部缓存不是线程安全的, 每个线程各用一个实例
+class FlexLogTimeParser {
+public:
+    explicit FlexLogTimeParser(time_t reference = time(nullptr));
+    
+    bool parse(std::string_view line, time_t& out) const;
+    
+    // parse 成功的行首时间戳占用的以空白分隔的词数:
+    // RFC3339 为 1 个 (日期与时间以空格分隔时 2 个), syslog "Mmm dd hh:mm:ss" 为 3 个
+    static size_t timestampTokens(std::string_view line);
+
+private:
+    int flexYear;
+    int flexMonth;     // 0-11
+    
+    // 本地时间按小时缓存的 UTC 偏移 (mktime 较慢, 而日志行的时间大多落在同一小时)
+    mutable int64_t flexCachedHour = INT64_MIN;
+    mutable int64_t flexCachedOffset = 0;
+    
+    int64_t flexLocalOffset(int year, int month, int day, int hour) const;
+};
+
+struct FlexLogTimeSample {
+    uint64_t offset; // 行首字节偏移
+    int64_t time;
+};
+
+// 日志文件的稀疏时间索引: 每隔 stride 字节取其后第一个带时间戳的行, 记录 (偏移, 时间).
+// 索引作为旁路文件保存在缓存目录, 文件增长时只对新增部分取样;
+// 文件被替换或截断 (inode 或开头内容变化) 时重建
+class FlexLogTimeIndex {
+public:
+    // indexPath 为空时取 $XDG_CACHE_HOME/flextools/logindex/ 下按日志路径命名的文件
+    explicit FlexLogTimeIndex(const std::string& logPath, const std::string& indexPath = "",
+                              uint64_t stride = 1024 * 1024);
+    
+    // 载入旁路索引并扩展到文件当前末尾, 有新增样本时写回; 日志不可读时返回 false
+    bool update();
+    
+    // 二分查找 [from, to] 对应的字节范围 [begin, end); 容许时间戳小幅乱序.
+    // 范围外或没有样本时返回 false
+    bool locate(time_t from, time_t to, uint64_t& begin, uint64_t& end) const;
+    
+    const std::vector<FlexLogTimeSample>& samples() const { return flexSamples; }
+    const FlexLogTimeParser& parser() const { return flexParser; }
+    uint64_t indexedSize() const { return flexIndexedSize; }
+
+private:
+    std::string flexLogPath;
+    std::string flexIndexPath;
+    uint64_t flexStride;
+    FlexLogTimeParser flexParser;
+    std::vector<FlexLogTimeSample> flexSamples;
+    uint64_t flexDevice = 0;
+    uint64_t flexInode = 0;
+    uint64_t flexIndexedSize = 0;
+    uint64_t flexNextBoundary = 0;
+    uint64_t flexSignature = 0;   // 文件开头 flexSignatureLength 字节的 FNV-1a 摘要
+    uint64_t flexSignatureLength = 0;
+    
+    bool flexLoad();
+    bool flexSave() const;
+    bool flexSample(int fd, uint64_t boundary, uint64_t size, FlexLogTimeSample& sample) const;
+};
+
+} // namespace FlexTools
+
+#endif // FLEX_LOG_TIME_INDEX_H
@@ -0,0 +1,68 @@
+#include "flex_mapped_file.h"
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace FlexTools {
+
+FlexMappedFile::FlexMappedFile(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return;
+    }
+    
+    if (fstat(fd, &flexStat) != 0 || !S_ISREG(flexStat.st_mode)) {
+        close(fd);
+        return;
+    }
+    
+    flexSize = static_cast<size_t>(flexStat.st_size);
+    if (flexSize > 0) {
+        void* mapped = mmap(nullptr, flexSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+            close(fd);
+            flexSize = 0;
+            return;
+        }
+        madvise(mapped, flexSize, MADV_SEQUENTIAL);
+        flexData = static_cast<const char*>(mapped);
+    }
+    close(fd);
+    flexOpen = true;
+}
+
+FlexMappedFile::~FlexMappedFile() {
+    flexRelease();
+}
+
+FlexMappedFile::FlexMappedFile(FlexMappedFile&& other) noexcept
+    : flexData(other.flexData), flexSize(other.flexSize), flexOpen(other.flexOpen), flexStat(other.flexStat) {
+    other.flexData = nullptr;
+    other.flexSize = 0;
+    other.flexOpen = false;
+}
+
+FlexMappedFile& FlexMappedFile::operator=(FlexMappedFile&& other) noexcept {
+    if (this != &other) {
+        flexRelease();
+        flexData = other.flexData;
+        flexSize = other.flexSize;
+        flexOpen = other.flexOpen;
+        flexStat = other.flexStat;
+        other.flexData = nullptr;
+        other.flexSize = 0;
+        other.flexOpen = false;
+    }
+    return *this;
+}
+
+void FlexMappedFile::flexRelease() {
+    if (flexData != nullptr) {
+        munmap(const_cast<char*>(flexData), flexSize);
+    }
+    flexData = nullptr;
+    flexSize = 0;
+    flexOpen = false;
+}
+
+} // namespace FlexTools
@@ -0,0 +1,41 @@
+#ifndef FLEX_MAPPED_FILE_H
+#define FLEX_MAPPED_FILE_H
+
+#include "flex_common.h"
+#include <string_view>
+#include <sys/stat.h>
+
+namespace FlexTools {
+
+// 只读内存映射文件 (RAII), 用于一次性解析较大的数据文件
+class FlexMappedFile {
+public:
+    FlexMappedFile() = default;
+    explicit FlexMappedFile(const std::string& path);
+    ~FlexMappedFile();
+    
+    FlexMappedFile(FlexMappedFile&& other) noexcept;
+    FlexMappedFile& operator=(FlexMappedFile&& other) noexcept;
+    FlexMappedFile(const FlexMappedFile&) = delete;
+    FlexMappedFile& operator=(const FlexMappedFile&) = delete;
+    
+    bool isOpen() const { return flexOpen; }
+    const char* data() const { return flexData; }
+    size_t size() const { return flexSize; }
+    std::string_view view() const { return std::string_view(flexData, flexSize); }
+    
+    // 映射时的文件元数据 (inode、mtime、大小), 供缓存校验使用
+    const struct stat& fileStat() const { return flexStat; }
+    
+private:
+    const char* flexData = nullptr;
+    size_t flexSize = 0;
+    bool flexOpen = false;
+    struct stat flexStat = {};
+    
+    void flexRelease();
+};
+
+} // namespace FlexTools
+
+#endif // FLEX_MAPPED_FILE_H
@@ -0,0 +1,151 @@
+#include "flex_md5.h"
+#include <cstring>
+
+namespace FlexTools {
+
+namespace {
+
+constexpr uint32_t FLEX_MD5_K[64] = {
+    0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+    0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+    0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+    0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+    0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+    0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+    0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+    0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391
+};
+
+constexpr int FLEX_MD5_SHIFT[64] = {
+    7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+    5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20,
+    4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+    6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21
+};
+
+inline uint32_t flexRotateLeft(uint32_t value, int shift) {
+    return (value << shift) | (value >> (32 - shift));
+}
+
+int flexHexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+} // namespace
+
+FlexMD5::FlexMD5()
+    : flexState{0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476} {
+}
+
+void FlexMD5::flexTransform(const uint8_t block[64]) {
+    uint32_t m[16];
+    for (int i = 0; i < 16; ++i) {
+        m[i] = static_cast<uint32_t>(block[i * 4]) | (static_cast<uint32_t>(block[i * 4 + 1]) << 8) |
+               (static_cast<uint32_t>(block[i * 4 + 2]) << 16) | (static_cast<uint32_t>(block[i * 4 + 3]) << 24);
+    }
+    
+    uint32_t a = flexState[0];
+    uint32_t b = flexState[1];
+    uint32_t c = flexState[2];
+    uint32_t d = flexState[3];
+    
+    for (int i = 0; i < 64; ++i) {
+        uint32_t f;
+        int g;
+        if (i < 16) {
+            f = (b & c) | (~b & d);
+            g = i;
+        } else if (i < 32) {
+            f = (d & b) | (~d & c);
+            g = (5 * i + 1) & 15;
+        } else if (i < 48) {
+            f = b ^ c ^ d;
+            g = (3 * i + 5) & 15;
+        } else {
+            f = c ^ (b | ~d);
+            g = (7 * i) & 15;
+        }
+        uint32_t next = d;
+        d = c;
+        c = b;
+        b = b + flexRotateLeft(a + f + FLEX_MD5_K[i] + m[g], FLEX_MD5_SHIFT[i]);
+        a = next;
+    }
+    
+    flexState[0] += a;
+    flexState[1] += b;
+    flexState[2] += c;
+    flexState[3] += d;
+}
+
+void FlexMD5::update(const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    flexLength += size;
+    
+    if (flexBuffered > 0) {
+        size_t take = std::min(size, sizeof(flexBuffer) - flexBuffered);
+        std::memcpy(flexBuffer + flexBuffered, bytes, take);
+        flexBuffered += take;
+        bytes += take;
+        size -= take;
+        if (flexBuffered < sizeof(flexBuffer)) {
+            return;
+        }
+        flexTransform(flexBuffer);
+        flexBuffered = 0;
+    }
+    
+    // 整块直接在输入上处理, 不经过缓冲区
+    for (; size >= 64; bytes += 64, size -= 64) {
+        flexTransform(bytes);
+    }
+    
+    std::memcpy(flexBuffer, bytes, size);
+    flexBuffered = size;
+}
+
+void FlexMD5::finalize(uint8_t digest[16]) {
+    uint64_t bits = flexLength * 8;
+    uint8_t padding[72] = {0x80};
+    size_t padLength = (flexBuffered < 56) ? 56 - flexBuffered : 120 - flexBuffered;
+    update(padding, padLength);
+    
+    uint8_t lengthBytes[8];
+    for (int i = 0; i < 8; ++i) {
+        lengthBytes[i] = static_cast<uint8_t>(bits >> (8 * i));
+    }
+    update(lengthBytes, sizeof(lengthBytes));
+    
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            digest[i * 4 + j] = static_cast<uint8_t>(flexState[i] >> (8 * j));
+        }
+    }
+}
+
+std::string FlexMD5::toHex(const uint8_t digest[16]) {
+    static const char* digits = "0123456789abcdef";
+    std::string hex(32, '0');
+    for (int i = 0; i < 16; ++i) {
+        hex[i * 2] = digits[digest[i] >> 4];
+        hex[i * 2 + 1] = digits[digest[i] & 0x0f];
+    }
+    return hex;
+}
+
+bool FlexMD5::fromHex(const char* hex, uint8_t digest[16]) {
+    for (int i = 0; i < 16; ++i) {
+        int high = flexHexValue(hex[i * 2]);
+        int low = high < 0 ? -1 : flexHexValue(hex[i * 2 + 1]);
+        if (low < 0) {
+            return false;
+        }
+        digest[i] = static_cast<uint8_t>((high << 4) | low);
+    }
+    return true;
+}
+
+} // namespace FlexTools
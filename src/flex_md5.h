@@ -0,0 +1,32 @@
+#ifndef FLEX_MD5_H
+#define FLEX_MD5_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+namespace FlexTools {
+
+// MD5 (RFC 1321), 用于与 dpkg md5sums 比对, 不依赖外部加密库
+class FlexMD5 {
+public:
+    FlexMD5();
+    
+    void update(const void* data, size_t size);
+    void finalize(uint8_t digest[16]);
+    
+    static std::string toHex(const uint8_t digest[16]);
+    static bool fromHex(const char* hex, uint8_t digest[16]);
+    
+private:
+    uint32_t flexState[4];
+    uint64_t flexLength = 0;
+    uint8_t flexBuffer[64];
+    size_t flexBuffered = 0;
+    
+    void flexTransform(const uint8_t block[64]);
+};
+
+} // namespace FlexTools
+
+#endif // FLEX_MD5_H
@@ -0,0 +1,217 @@
+#include "flex_netlink_collector.h"
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <linux/if_link.h>
+#include <linux/if_addr.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <unordered_map>
+
+namespace FlexTools {
+
+namespace {
+
+// 打开的 netlink 套接字, 析构时自动关闭
+struct FlexNetlinkSocket {
+    int fd = -1;
+    ~FlexNetlinkSocket() {
+        if (fd >= 0) close(fd);
+    }
+};
+
+bool flexSendDumpRequest(int fd, uint16_t type, uint32_t seq) {
+    struct {
+        struct nlmsghdr header;
+        struct rtgenmsg message;
+    } request;
+    std::memset(&request, 0, sizeof(request));
+    request.header.nlmsg_len = NLMSG_LENGTH(sizeof(struct rtgenmsg));
+    request.header.nlmsg_type = type;
+    request.header.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+    request.header.nlmsg_seq = seq;
+    request.message.rtgen_family = AF_UNSPEC;
+    
+    struct sockaddr_nl kernel;
+    std::memset(&kernel, 0, sizeof(kernel));
+    kernel.nl_family = AF_NETLINK;
+    
+    return sendto(fd, &request, request.header.nlmsg_len, 0,
+                  reinterpret_cast<struct sockaddr*>(&kernel), sizeof(kernel)) >= 0;
+}
+
+// 接收一次 dump 的全部消息, 对每条消息调用 handler
+template <typename Handler>
+bool flexReceiveDump(int fd, uint32_t seq, std::vector<char>& buffer, Handler&& handler) {
+    while (true) {
+        ssize_t len = recv(fd, buffer.data(), buffer.size(), 0);
+        if (len < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        
+        int remaining = static_cast<int>(len);
+        for (struct nlmsghdr* msg = reinterpret_cast<struct nlmsghdr*>(buffer.data());
+             NLMSG_OK(msg, remaining); msg = NLMSG_NEXT(msg, remaining)) {
+            if (msg->nlmsg_seq != seq) {
+                continue;
+            }
+            if (msg->nlmsg_type == NLMSG_DONE) {
+                return true;
+            }
+            if (msg->nlmsg_type == NLMSG_ERROR) {
+                return false;
+            }
+            handler(msg);
+        }
+    }
+}
+
+std::string flexFormatMAC(const unsigned char* data, size_t len) {
+    static const char hex[] = "0123456789abcdef";
+    std::string mac;
+    mac.reserve(len * 3);
+    for (size_t i = 0; i < len; ++i) {
+        if (i > 0) mac.push_back(':');
+        mac.push_back(hex[data[i] >> 4]);
+        mac.push_back(hex[data[i] & 0x0f]);
+    }
+    return mac;
+}
+
+std::string flexFormatAddress(int family, const void* data) {
+    char text[INET6_ADDRSTRLEN];
+    if (inet_ntop(family, data, text, sizeof(text)) == nullptr) {
+        return "";
+    }
+    return text;
+}
+
+std::string flexPrefixToNetmask(unsigned prefixLength) {
+    uint32_t mask = prefixLength == 0 ? 0 : htonl(~0u << (32 - std::min(prefixLength, 32u)));
+    return flexFormatAddress(AF_INET, &mask);
+}
+
+} // namespace
+
+bool FlexNetlinkCollector::collect(std::vector<FlexNetworkInterface>& interfaces) const {
+    FlexNetlinkSocket sock;
+    sock.fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+    if (sock.fd < 0) {
+        return false;
+    }
+    
+    std::vector<char> buffer(1 << 16);
+    std::unordered_map<int, size_t> byIndex;
+    std::vector<bool> hasIPv6Global;
+    interfaces.clear();
+    
+    // 链路信息: 名称、MAC、64 位统计
+    uint32_t seq = 1;
+    if (!flexSendDumpRequest(sock.fd, RTM_GETLINK, seq)) {
+        return false;
+    }
+    bool ok = flexReceiveDump(sock.fd, seq, buffer, [&](struct nlmsghdr* msg) {
+        if (msg->nlmsg_type != RTM_NEWLINK) return;
+        auto* info = static_cast<struct ifinfomsg*>(NLMSG_DATA(msg));
+        
+        FlexNetworkInterface ni{};
+        int attrLen = static_cast<int>(IFLA_PAYLOAD(msg));
+        for (struct rtattr* attr = IFLA_RTA(info); RTA_OK(attr, attrLen);
+             attr = RTA_NEXT(attr, attrLen)) {
+            switch (attr->rta_type) {
+                case IFLA_IFNAME:
+                    ni.name = static_cast<const char*>(RTA_DATA(attr));
+                    break;
+                case IFLA_ADDRESS:
+                    ni.macAddress = flexFormatMAC(static_cast<const unsigned char*>(RTA_DATA(attr)),
+                                                  RTA_PAYLOAD(attr));
+                    break;
+                case IFLA_STATS64: {
+                    struct rtnl_link_stats64 stats;
+                    std::memset(&stats, 0, sizeof(stats));
+                    std::memcpy(&stats, RTA_DATA(attr), std::min<size_t>(RTA_PAYLOAD(attr), sizeof(stats)));
+                    ni.rxBytes = static_cast<long long>(stats.rx_bytes);
+                    ni.txBytes = static_cast<long long>(stats.tx_bytes);
+                    ni.rxPackets = static_cast<long long>(stats.rx_packets);
+                    ni.txPackets = static_cast<long long>(stats.tx_packets);
+                    ni.rxErrors = static_cast<long long>(stats.rx_errors);
+                    ni.txErrors = static_cast<long long>(stats.tx_errors);
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+        
+        if (!ni.name.empty()) {
+            byIndex.emplace(info->ifi_index, interfaces.size());
+            interfaces.push_back(std::move(ni));
+            hasIPv6Global.push_back(false);
+        }
+    });
+    if (!ok) {
+        return false;
+    }
+    
+    // 地址信息: IPv4 主地址/掩码/广播, IPv6 优先全局地址
+    seq = 2;
+    if (!flexSendDumpRequest(sock.fd, RTM_GETADDR, seq)) {
+        return false;
+    }
+    ok = flexReceiveDump(sock.fd, seq, buffer, [&](struct nlmsghdr* msg) {
+        if (msg->nlmsg_type != RTM_NEWADDR) return;
+        auto* info = static_cast<struct ifaddrmsg*>(NLMSG_DATA(msg));
+        auto it = byIndex.find(static_cast<int>(info->ifa_index));
+        if (it == byIndex.end()) return;
+        FlexNetworkInterface& ni = interfaces[it->second];
+        
+        const void* local = nullptr;
+        const void* address = nullptr;
+        const void* broadcast = nullptr;
+        uint32_t flags = info->ifa_flags;
+        int attrLen = static_cast<int>(IFA_PAYLOAD(msg));
+        for (struct rtattr* attr = IFA_RTA(info); RTA_OK(attr, attrLen);
+             attr = RTA_NEXT(attr, attrLen)) {
+            switch (attr->rta_type) {
+                case IFA_LOCAL:
+                    local = RTA_DATA(attr);
+                    break;
+                case IFA_ADDRESS:
+                    address = RTA_DATA(attr);
+                    break;
+                case IFA_BROADCAST:
+                    broadcast = RTA_DATA(attr);
+                    break;
+                case IFA_FLAGS:
+                    flags = *static_cast<const uint32_t*>(RTA_DATA(attr));
+                    break;
+                default:
+                    break;
+            }
+        }
+        
+        if (info->ifa_family == AF_INET) {
+            // 点对点链路上 IFA_ADDRESS 是对端地址, 本端地址在 IFA_LOCAL 中
+            const void* own = local ? local : address;
+            if (own == nullptr || !ni.ipAddress.empty() || (flags & IFA_F_SECONDARY)) return;
+            ni.ipAddress = flexFormatAddress(AF_INET, own);
+            ni.netmask = flexPrefixToNetmask(info->ifa_prefixlen);
+            if (broadcast) {
+                ni.broadcast = flexFormatAddress(AF_INET, broadcast);
+            }
+        } else if (info->ifa_family == AF_INET6 && address != nullptr) {
+            bool global = info->ifa_scope == RT_SCOPE_UNIVERSE;
+            if (ni.ipv6Address.empty() || (global && !hasIPv6Global[it->second])) {
+                ni.ipv6Address = flexFormatAddress(AF_INET6, address);
+                hasIPv6Global[it->second] = global;
+            }
+        }
+    });
+    
+    return ok;
+}
+
+} // namespace FlexTools
@@ -0,0 +1,21 @@
+#ifndef FLEX_NETLINK_COLLECTOR_H
+#define FLEX_NETLINK_COLLECTOR_H
+
+#include "flex_common.h"
+#include "flex_hardware_info.h"
+
+namespace FlexTools {
+
+// 基于 RTNETLINK 的网络接口收集器: 在同一个套接字上依次完成
+// RTM_GETLINK / RTM_GETADDR 两次 dump, 一次性填充 MAC、地址与 64 位统计
+class FlexNetlinkCollector {
+public:
+    FlexNetlinkCollector() = default;
+    
+    // 套接字不可用 (如被 seccomp 拦截) 时返回 false, 调用者可回退到 sysfs
+    bool collect(std::vector<FlexNetworkInterface>& interfaces) const;
+};
+
+} // namespace FlexTools
+
+#endif // FLEX_NETLINK_COLLECTOR_H
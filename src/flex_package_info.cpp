@@ -0,0 +1,979 @@
+#include "flex_package_info.h"
+#include "flex_mapped_file.h"
+#include "flex_rpm_database.h"
+#include "flex_package_snapshot.h"
+#include "flex_package_store.h"
+#include "flex_trigram_index.h"
+#include "flex_file_owner_index.h"
+#include "flex_dependency_graph.h"
+#include "flex_debian_version.h"
+#include "flex_install_history.h"
+#include "flex_package_verifier.h"
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <spawn.h>
+#include <unistd.h>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <climits>
+#include <memory>
+#include <set>
+#include <thread>
+#include <unordered_map>
+
+namespace FlexTools {
+
+namespace {
+
+const char* FLEX_DPKG_STATUS_PATH = "/var/lib/dpkg/status";
+const char* FLEX_DPKG_INFO_DIR = "/var/lib/dpkg/info/";
+const char* FLEX_APT_LISTS_DIR = "/var/lib/apt/lists/";
+// 一次 rpm 调用最多携带的参数个数, 远低于 ARG_MAX
+constexpr size_t FLEX_RPM_BATCH = 512;
+
+// rpm 只解析目录部分的符号链接, 文件本身是链接时查的是链接的所属包
+std::string flexRPMLookupPath(const std::string& path) {
+    size_t slash = path.find_last_of('/');
+    if (slash == std::string::npos) {
+        return path;
+    }
+    std::string directory = slash == 0 ? "/" : path.substr(0, slash);
+    char resolved[PATH_MAX];
+    if (realpath(directory.c_str(), resolved) == nullptr) {
+        return path;
+    }
+    std::string result = resolved;
+    if (result != "/") result.push_back('/');
+    return result + path.substr(slash + 1);
+}
+
+bool flexPathExists(const char* path) {
+    struct stat st;
+    return stat(path, &st) == 0;
+}
+
+std::string_view flexTrimView(std::string_view view) {
+    while (!view.empty() && (view.front() == ' ' || view.front() == '\t')) view.remove_prefix(1);
+    while (!view.empty() && (view.back() == ' ' || view.back() == '\t' || view.back() == '\r')) view.remove_suffix(1);
+    return view;
+}
+
+// 拆分以逗号分隔的关系字段 (Depends/Provides/Conflicts), 保留版本约束与 "a | b" 备选
+void flexSplitRelations(std::string_view value, std::vector<std::string>& out) {
+    while (!value.empty()) {
+        size_t comma = value.find(',');
+        std::string_view item = flexTrimView(value.substr(0, comma));
+        value.remove_prefix(comma == std::string_view::npos ? value.size() : comma + 1);
+        if (!item.empty()) {
+            out.emplace_back(item);
+        }
+    }
+}
+
+int flexDebianPriority(std::string_view priority) {
+    if (priority == "required") return 1;
+    if (priority == "important") return 2;
+    if (priority == "standard") return 3;
+    if (priority == "optional") return 4;
+    if (priority == "extra") return 5;
+    return 0;
+}
+
+// 已安装包按名称索引; 缓存按名称排序, 同名多架构包相邻
+using FlexInstalledIndex = std::unordered_map<std::string_view, uint32_t>;
+
+// 扫描一个 apt Packages 列表, 为每个已安装包记录比当前版本更新的最高候选版本.
+// best 中的 string_view 指向映射区, 调用者需保持 file 存活
+void flexScanAptList(const FlexMappedFile& file, const FlexPackageStore& packages,
+                     const FlexInstalledIndex& installed, std::vector<std::string_view>& best) {
+    std::string_view content = file.view();
+    std::string_view name, version, arch;
+    
+    auto finishStanza = [&]() {
+        if (!name.empty() && !version.empty()) {
+            auto it = installed.find(name);
+            if (it != installed.end()) {
+                for (uint32_t i = it->second; i < packages.size() && packages.name(i) == name; ++i) {
+                    std::string_view architecture = packages.architecture(i);
+                    if (!arch.empty() && arch != "all" && architecture != "all" && arch != architecture) {
+                        continue;
+                    }
+                    std::string_view current = best[i].empty() ? packages.version(i) : best[i];
+                    if (flexCompareDebianVersions(version, current) > 0) {
+                        best[i] = version;
+                    }
+                }
+            }
+        }
+        name = version = arch = std::string_view();
+    };
+    
+    while (!content.empty()) {
+        size_t end = content.find('\n');
+        std::string_view line = content.substr(0, end);
+        content.remove_prefix(end == std::string_view::npos ? content.size() : end + 1);
+        
+        if (line.empty()) {
+            finishStanza();
+        } else if (line[0] == 'P' && line.compare(0, 9, "Package: ") == 0) {
+            name = flexTrimView(line.substr(9));
+        } else if (line[0] == 'V' && line.compare(0, 9, "Version: ") == 0) {
+            version = flexTrimView(line.substr(9));
+        } else if (line[0] == 'A' && line.compare(0, 14, "Architecture: ") == 0) {
+            arch = flexTrimView(line.substr(14));
+        }
+    }
+    finishStanza();
+}
+
+// 快照文件路径及其校验所依据的源数据库元数据
+bool flexSnapshotSource(FlexSystemType type, std::string& cachePath, struct stat& source) {
+    std::string sourcePath;
+    if (type == FlexSystemType::DEBIAN_BASED) {
+        sourcePath = FLEX_DPKG_STATUS_PATH;
+        cachePath = FlexPackageSnapshot::flexDefaultPath("packages-dpkg.bin");
+    } else if (type == FlexSystemType::RPM_BASED) {
+        sourcePath = FlexRPMDatabase::flexFindDatabase();
+        cachePath = FlexPackageSnapshot::flexDefaultPath("packages-rpm.bin");
+    }
+    return !sourcePath.empty() && !cachePath.empty() && stat(sourcePath.c_str(), &source) == 0;
+}
+
+} // namespace
+
+FlexPackageInfo::FlexPackageInfo() {
+    flexSystemType = flexDetectSystemType();
+    flexCacheValid = false;
+}
+
+FlexSystemType FlexPackageInfo::flexDetectSystemType() const {
+    if (flexPathExists(FLEX_DPKG_STATUS_PATH)) {
+        return FlexSystemType::DEBIAN_BASED;
+    }
+    if (flexPathExists("/var/lib/rpm") || flexPathExists("/usr/lib/sysimage/rpm")) {
+        return FlexSystemType::RPM_BASED;
+    }
+    return FlexSystemType::UNKNOWN;
+}
+
+void FlexPackageInfo::flexEnsureCache() const {
+    if (flexCacheValid) {
+        return;
+    }
+    
+    flexPackageStore = std::make_shared<FlexPackageStore>();
+    if (const FlexPackageSnapshot* snapshot = flexLoadSnapshot()) {
+        snapshot->load(*flexPackageStore);
+        flexCacheValid = true;
+        return;
+    }
+    
+    // 冷启动: 解析结果按名称排序后转入列式仓库, 临时的 FlexPackage 随即释放
+    std::vector<FlexPackage> packages;
+    if (flexSystemType == FlexSystemType::DEBIAN_BASED) {
+        packages = flexGetDebianPackages();
+        flexFillInstallDates(packages);
+    } else if (flexSystemType == FlexSystemType::RPM_BASED) {
+        packages = flexGetRPMPackages();
+    }
+    
+    std::sort(packages.begin(), packages.end(),
+              [](const FlexPackage& a, const FlexPackage& b) { return a.name < b.name; });
+    flexPackageStore->reserve(packages.size());
+    for (const auto& package : packages) {
+        flexPackageStore->append(package);
+    }
+    flexCacheValid = true;
+    flexStoreSnapshot();
+}
+
+const FlexPackageSnapshot* FlexPackageInfo::flexLoadSnapshot() const {
+    if (!flexSnapshotChecked) {
+        flexSnapshotChecked = true;
+        std::string cachePath;
+        struct stat source;
+        if (flexSnapshotSource(flexSystemType, cachePath, source)) {
+            auto snapshot = std::make_shared<FlexPackageSnapshot>();
+            if (snapshot->open(cachePath, source)) {
+                flexSnapshot = std::move(snapshot);
+            }
+        }
+    }
+    return flexSnapshot.get();
+}
+
+void FlexPackageInfo::flexStoreSnapshot() const {
+    std::string cachePath;
+    struct stat source;
+    if (flexPackageStore->empty() || !flexSnapshotSource(flexSystemType, cachePath, source)) {
+        return;
+    }
+    // 缓存目录不可写时静默跳过, 下次仍走完整解析
+    FlexPackageSnapshot::write(cachePath, source, *flexPackageStore);
+}
+
+std::vector<FlexPackage> FlexPackageInfo::getAllPackages() const {
+    flexEnsureCache();
+    return flexPackageStore->packages();
+}
+
+std::vector<FlexPackage> FlexPackageInfo::searchPackages(const std::string& keyword) const {
+    flexEnsureCache();
+    if (!flexSearchIndex) {
+        flexSearchIndex = std::make_shared<FlexTrigramIndex>(*flexPackageStore);
+    }
+    
+    std::vector<FlexPackage> results;
+    for (uint32_t index : flexSearchIndex->search(keyword)) {
+        results.push_back(flexPackageStore->package(index));
+    }
+    return results;
+}
+
+FlexPackage FlexPackageInfo::getPackageInfo(const std::string& packageName) const {
+    // 热启动时直接在映射的快照上二分查找, 不展开整个包列表
+    if (!flexCacheValid) {
+        if (const FlexPackageSnapshot* snapshot = flexLoadSnapshot()) {
+            FlexPackage package{};
+            snapshot->find(packageName, package);
+            return package;
+        }
+    }
+    return flexLookupPackage(packageName);
+}
+
+std::vector<std::string> FlexPackageInfo::getPackageDependencies(const std::string& packageName) const {
+    return getPackageInfo(packageName).dependencies;
+}
+
+const FlexDependencyGraph& FlexPackageInfo::getDependencyGraph() const {
+    flexEnsureCache();
+    if (!flexDependencyGraph) {
+        flexDependencyGraph = std::make_shared<FlexDependencyGraph>(*flexPackageStore, flexSystemType);
+    }
+    return *flexDependencyGraph;
+}
+
+std::vector<std::string> FlexPackageInfo::getDependencyClosure(const std::string& packageName) const {
+    const FlexDependencyGraph& graph = getDependencyGraph();
+    std::vector<std::string> names;
+    for (uint32_t node : graph.closure(graph.nodeId(packageName))) {
+        names.push_back(graph.nodeName(node));
+    }
+    return names;
+}
+
+std::vector<std::string> FlexPackageInfo::getReverseDependencies(const std::string& packageName, bool transitive) const {
+    const FlexDependencyGraph& graph = getDependencyGraph();
+    uint32_t node = graph.nodeId(packageName);
+    std::vector<std::string> names;
+    if (node == FlexDependencyGraph::FLEX_NO_NODE) {
+        return names;
+    }
+    for (uint32_t dependent : transitive ? graph.reverseClosure(node) : graph.dependents(node)) {
+        names.push_back(graph.nodeName(dependent));
+    }
+    return names;
+}
+
+std::vector<std::string> FlexPackageInfo::getRemovalImpact(const std::vector<std::string>& packageNames) const {
+    const FlexDependencyGraph& graph = getDependencyGraph();
+    std::vector<uint32_t> removed;
+    for (const auto& name : packageNames) {
+        uint32_t node = graph.nodeId(name);
+        if (node != FlexDependencyGraph::FLEX_NO_NODE) {
+            removed.push_back(node);
+        }
+    }
+    std::vector<std::string> names;
+    for (uint32_t node : graph.removalImpact(removed)) {
+        names.push_back(graph.nodeName(node));
+    }
+    return names;
+}
+
+std::vector<std::string> FlexPackageInfo::getPackageFiles(const std::string& packageName) const {
+    std::vector<std::string> files;
+    
+    if (flexSystemType == FlexSystemType::RPM_BASED) {
+        // 优先直接解码 rpmdb.sqlite 中的文件表
+        FlexRPMDatabase database;
+        if (database.readFiles(packageName, files)) {
+            return files;
+        }
+        files.clear();
+        
+        // 未安装时 rpm 在标准输出打印提示, 只保留路径行
+        for (auto& line : flexExecuteArgv({"rpm", "-ql", "--", packageName})) {
+            if (!line.empty() && line[0] == '/') {
+                files.push_back(std::move(line));
+            }
+        }
+        return files;
+    }
+    
+    // 多架构包的列表文件名带 ":arch" 后缀
+    FlexPackage package = getPackageInfo(packageName);
+    std::vector<std::string> candidates = {std::string(FLEX_DPKG_INFO_DIR) + packageName + ".list"};
+    if (!package.architecture.empty()) {
+        candidates.push_back(std::string(FLEX_DPKG_INFO_DIR) + packageName + ":" + package.architecture + ".list");
+    }
+    
+    for (const auto& path : candidates) {
+        std::ifstream list(path);
+        if (!list.is_open()) {
+            continue;
+        }
+        std::string line;
+        while (std::getline(list, line)) {
+            if (!line.empty()) {
+                files.push_back(line);
+            }
+        }
+        break;
+    }
+    return files;
+}
+
+std::map<std::string, std::vector<std::string>> FlexPackageInfo::getFileOwners(const std::vector<std::string>& paths) const {
+    if (flexSystemType == FlexSystemType::RPM_BASED) {
+        // 多个参数时 rpm -qf 的输出分不清属于哪个参数, 于是让每个所属包列出自己的全部文件,
+        // 再按文件名对回查询路径; 整批只启动一个 rpm (参数过多时分块)
+        std::map<std::string, std::vector<std::string>> owners;
+        std::unordered_map<std::string, std::vector<std::string>> wanted;
+        for (const auto& path : paths) {
+            owners[path];
+            wanted[flexRPMLookupPath(path)].push_back(path);
+        }
+        for (size_t first = 0; first < paths.size(); first += FLEX_RPM_BATCH) {
+            std::vector<std::string> argv = {"rpm", "-qf", "--queryformat", "[%{FILENAMES}\\t%{NAME}\\n]", "--"};
+            size_t last = std::min(paths.size(), first + FLEX_RPM_BATCH);
+            argv.insert(argv.end(), paths.begin() + first, paths.begin() + last);
+            for (const auto& line : flexExecuteArgv(argv)) {
+                size_t tab = line.find('\t');
+                if (tab == std::string::npos) {
+                    continue;
+                }
+                auto match = wanted.find(line.substr(0, tab));
+                if (match == wanted.end()) {
+                    continue;
+                }
+                std::string name = line.substr(tab + 1);
+                for (const auto& path : match->second) {
+                    auto& packages = owners[path];
+                    if (std::find(packages.begin(), packages.end(), name) == packages.end()) {
+                        packages.push_back(name);
+                    }
+                }
+            }
+        }
+        return owners;
+    }
+    
+    if (!flexOwnerIndex) {
+        flexOwnerIndex = std::make_shared<FlexFileOwnerIndex>(FLEX_DPKG_INFO_DIR);
+        flexOwnerIndex->build();
+    }
+    return flexOwnerIndex->resolve(paths);
+}
+
+FlexVerifyReport FlexPackageInfo::verifyPackages(const std::vector<std::string>& packageNames) const {
+    if (flexSystemType != FlexSystemType::RPM_BASED) {
+        FlexPackageVerifier verifier(FLEX_DPKG_INFO_DIR);
+        return verifier.verify(packageNames);
+    }
+    
+    // 一个 rpm -V 进程校验整批包 (不指定时 -Va 校验全部); 输出不带包名, 出问题的路径
+    // 最后再用一次 getFileOwners 归属到包. 第 3 列标志位 '5' 表示摘要不符
+    FlexVerifyReport report;
+    std::vector<std::string> names = packageNames;
+    if (names.empty()) {
+        flexEnsureCache();
+        for (uint32_t i = 0; i < flexPackageStore->size(); ++i) {
+            names.emplace_back(flexPackageStore->name(i));
+        }
+    }
+    report.packages = names.size();
+    
+    std::vector<std::pair<std::string, FlexVerifyStatus>> problems;
+    auto parse = [&problems](const std::vector<std::string>& lines) {
+        for (const auto& line : lines) {
+            size_t slash = line.find('/');
+            if (slash == std::string::npos) {
+                continue;
+            }
+            std::string path = line.substr(slash);
+            if (line.compare(0, 7, "missing") == 0) {
+                problems.emplace_back(path, FlexVerifyStatus::MISSING);
+            } else if (line.size() > 2 && line[2] == '5') {
+                problems.emplace_back(path, FlexVerifyStatus::MODIFIED);
+            } else if (line.size() > 2 && line[2] == '?') {
+                problems.emplace_back(path, FlexVerifyStatus::UNREADABLE);
+            }
+        }
+    };
+    if (packageNames.empty()) {
+        parse(flexExecuteArgv({"rpm", "-Va"}));
+    } else {
+        for (size_t first = 0; first < names.size(); first += FLEX_RPM_BATCH) {
+            std::vector<std::string> argv = {"rpm", "-V", "--"};
+            size_t last = std::min(names.size(), first + FLEX_RPM_BATCH);
+            argv.insert(argv.end(), names.begin() + first, names.begin() + last);
+            parse(flexExecuteArgv(argv));
+        }
+    }
+    if (problems.empty()) {
+        return report;
+    }
+    
+    // 同一文件有多个所属包时优先取本次校验的包
+    std::set<std::string> checked(names.begin(), names.end());
+    std::vector<std::string> paths;
+    for (const auto& problem : problems) {
+        paths.push_back(problem.first);
+    }
+    auto owners = getFileOwners(paths);
+    for (const auto& problem : problems) {
+        const auto& candidates = owners[problem.first];
+        std::string owner;
+        for (const auto& candidate : candidates) {
+            if (checked.count(candidate) != 0) {
+                owner = candidate;
+                break;
+            }
+        }
+        if (owner.empty() && !candidates.empty()) {
+            owner = candidates.front();
+        }
+        report.issues.push_back({owner, problem.first, problem.second});
+    }
+    return report;
+}
+
+std::map<std::string, int> FlexPackageInfo::getPackageStatistics() const {
+    flexEnsureCache();
+    const FlexPackageStore& store = *flexPackageStore;
+    std::map<std::string, int> stats;
+    
+    // 直接在列上计数: 驻留 ID 作下标, 最后才转成字符串键
+    uint64_t totalSize = 0;
+    for (uint64_t size : store.sizeColumn()) {
+        totalSize += size;
+    }
+    std::vector<int> architectureCounts(store.symbolCount());
+    for (uint32_t id : store.architectureColumn()) {
+        ++architectureCounts[id];
+    }
+    std::vector<int> sectionCounts(store.symbolCount());
+    for (uint32_t id : store.sectionColumn()) {
+        ++sectionCounts[id];
+    }
+    
+    // ID 0 为空串, 不计入
+    for (uint32_t id = 1; id < store.symbolCount(); ++id) {
+        if (architectureCounts[id] > 0) {
+            stats["Architecture: " + std::string(store.symbol(id))] = architectureCounts[id];
+        }
+        if (sectionCounts[id] > 0) {
+            stats["Section: " + std::string(store.symbol(id))] = sectionCounts[id];
+        }
+    }
+    stats["Total Packages"] = static_cast<int>(store.size());
+    stats["Total Installed Size (MB)"] = static_cast<int>(totalSize / (1024 * 1024));
+    return stats;
+}
+
+bool FlexPackageInfo::flexParseDPKGStanza(std::string_view stanza, FlexPackage& package) const {
+    package = FlexPackage{};
+    bool installed = false;
+    
+    while (!stanza.empty()) {
+        size_t eol = stanza.find('\n');
+        std::string_view line = stanza.substr(0, eol);
+        stanza.remove_prefix(eol == std::string_view::npos ? stanza.size() : eol + 1);
+        
+        // 续行 (Description 长描述、Conffiles 等) 不需要
+        if (line.empty() || line[0] == ' ' || line[0] == '\t') {
+            continue;
+        }
+        size_t colon = line.find(':');
+        if (colon == std::string_view::npos) {
+            continue;
+        }
+        std::string_view key = line.substr(0, colon);
+        std::string_view value = flexTrimView(line.substr(colon + 1));
+        
+        switch (key[0]) {
+            case 'P':
+                if (key == "Package") {
+                    package.name = std::string(value);
+                } else if (key == "Priority") {
+                    package.priority = flexDebianPriority(value);
+                } else if (key == "Pre-Depends") {
+                    flexSplitRelations(value, package.dependencies);
+                } else if (key == "Provides") {
+                    flexSplitRelations(value, package.provides);
+                }
+                break;
+            case 'S':
+                if (key == "Status") {
+                    // "want flag state", 只保留实际安装状态
+                    size_t lastSpace = value.rfind(' ');
+                    std::string_view state = lastSpace == std::string_view::npos ? value : value.substr(lastSpace + 1);
+                    installed = state != "not-installed" && state != "config-files";
+                    package.status = std::string(state);
+                } else if (key == "Section") {
+                    package.section = std::string(value);
+                }
+                break;
+            case 'I':
+                if (key == "Installed-Size") {
+                    size_t kib = 0;
+                    for (char c : value) {
+                        if (c < '0' || c > '9') break;
+                        kib = kib * 10 + static_cast<size_t>(c - '0');
+                    }
+                    package.size = kib * 1024;
+                }
+                break;
+            case 'M':
+                if (key == "Maintainer") {
+                    package.maintainer = std::string(value);
+                }
+                break;
+            case 'A':
+                if (key == "Architecture") {
+                    package.architecture = std::string(value);
+                }
+                break;
+            case 'V':
+                if (key == "Version") {
+                    package.version = std::string(value);
+                }
+                break;
+            case 'D':
+                if (key == "Depends") {
+                    flexSplitRelations(value, package.dependencies);
+                } else if (key == "Description") {
+                    package.description = std::string(value);
+                }
+                break;
+            case 'C':
+                if (key == "Conflicts") {
+                    flexSplitRelations(value, package.conflicts);
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    
+    return installed && !package.name.empty();
+}
+
+std::vector<FlexPackage> FlexPackageInfo::flexGetDebianPackages() const {
+    std::vector<FlexPackage> packages;
+    FlexMappedFile status(FLEX_DPKG_STATUS_PATH);
+    if (!status.isOpen()) {
+        return packages;
+    }
+    
+    // RFC822 风格的段落以空行分隔, 单次遍历映射区, 不 fork dpkg-query
+    std::string_view content = status.view();
+    FlexPackage package;
+    while (!content.empty()) {
+        size_t end = content.find("\n\n");
+        std::string_view stanza = content.substr(0, end == std::string_view::npos ? content.size() : end + 1);
+        content.remove_prefix(end == std::string_view::npos ? content.size() : end + 2);
+        
+        if (flexParseDPKGStanza(stanza, package)) {
+            packages.push_back(std::move(package));
+        }
+    }
+    return packages;
+}
+
+void FlexPackageInfo::flexFillInstallDates(std::vector<FlexPackage>& packages) const {
+    // dpkg 状态文件不记录安装时间: 优先取安装历史中当前版本的安装时刻,
+    // 日志已被轮转清理时退回 info/<包>.list 的修改时间
+    FlexInstallHistory history;
+    history.load();
+    
+    for (auto& package : packages) {
+        time_t when = 0;
+        if (!history.lastInstallTime(package.name, when)) {
+            struct stat st;
+            std::string base = std::string(FLEX_DPKG_INFO_DIR) + package.name;
+            if (stat((base + ".list").c_str(), &st) == 0 ||
+                stat((base + ":" + package.architecture + ".list").c_str(), &st) == 0) {
+                when = st.st_mtime;
+            }
+        }
+        if (when > 0) {
+            package.installDate = flexFormatTime(when);
+        }
+    }
+}
+
+FlexPackage FlexPackageInfo::flexLookupPackage(const std::string& packageName) const {
+    flexEnsureCache();
+    uint32_t index = flexPackageStore->find(packageName);
+    if (index != FlexPackageStore::FLEX_NO_PACKAGE) {
+        return flexPackageStore->package(index);
+    }
+    return FlexPackage{};
+}
+
+std::vector<FlexPackage> FlexPackageInfo::flexGetRPMPackages() const {
+    std::vector<FlexPackage> packages;
+    
+    // 优先直接解码 rpmdb.sqlite, 读不到时再退回 rpm 子进程
+    FlexRPMDatabase database;
+    if (database.readPackages(packages) && !packages.empty()) {
+        return packages;
+    }
+    packages.clear();
+    
+    auto lines = flexExecuteCommand(
+        "rpm -qa --queryformat '%{NAME}\\t%{EPOCH}:%{VERSION}-%{RELEASE}\\t%{ARCH}\\t%{SIZE}\\t"
+        "%{INSTALLTIME}\\t%{GROUP}\\t%{PACKAGER}\\t%{SUMMARY}\\n' 2>/dev/null");
+    for (const auto& line : lines) {
+        FlexPackage package = flexParseRPMLine(line);
+        if (!package.name.empty()) {
+            packages.push_back(std::move(package));
+        }
+    }
+    return packages;
+}
+
+FlexPackage FlexPackageInfo::flexParseRPMLine(const std::string& line) const {
+    FlexPackage package{};
+    auto fields = flexSplit(line, '\t');
+    if (fields.size() < 8) {
+        return package;
+    }
+    
+    package.name = fields[0];
+    // 无 epoch 时 rpm 输出 "(none):"
+    package.version = fields[1].compare(0, 7, "(none):") == 0 ? fields[1].substr(7) : fields[1];
+    package.architecture = fields[2];
+    package.size = static_cast<size_t>(std::strtoull(fields[3].c_str(), nullptr, 10));
+    time_t installTime = static_cast<time_t>(std::strtoll(fields[4].c_str(), nullptr, 10));
+    if (installTime > 0) {
+        package.installDate = flexFormatTime(installTime);
+    }
+    package.section = fields[5];
+    package.maintainer = fields[6];
+    package.description = fields[7];
+    package.status = "installed";
+    return package;
+}
+
+std::vector<FlexPackage> FlexPackageInfo::checkForUpdates() const {
+    flexEnsureCache();
+    if (flexSystemType == FlexSystemType::RPM_BASED) {
+        return flexCheckRPMUpdates();
+    }
+    
+    std::vector<FlexPackage> updates;
+    if (flexSystemType != FlexSystemType::DEBIAN_BASED) {
+        return updates;
+    }
+    
+    const FlexPackageStore& store = *flexPackageStore;
+    uint32_t installedStatus = store.symbolId("installed");
+    FlexInstalledIndex installed;
+    installed.reserve(store.size());
+    for (uint32_t i = 0; i < store.size(); ++i) {
+        if (store.statusColumn()[i] == installedStatus) {
+            installed.emplace(store.name(i), i);
+        }
+    }
+    
+    std::vector<std::string> lists;
+    if (DIR* dir = opendir(FLEX_APT_LISTS_DIR)) {
+        while (struct dirent* entry = readdir(dir)) {
+            std::string name = entry->d_name;
+            if (name.size() > 9 && name.compare(name.size() - 9, 9, "_Packages") == 0) {
+                lists.push_back(std::string(FLEX_APT_LISTS_DIR) + name);
+            }
+        }
+        closedir(dir);
+    }
+    if (lists.empty()) {
+        return updates;
+    }
+    
+    // 每个工作线程一次取一个列表文件, 候选版本先记在线程本地, 最后合并
+    size_t workers = std::min<size_t>(lists.size(), std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<std::vector<FlexMappedFile>> mapped(workers);
+    std::vector<std::vector<std::string_view>> best(workers, std::vector<std::string_view>(store.size()));
+    std::atomic<size_t> next{0};
+    
+    auto work = [&](size_t worker) {
+        for (size_t i = next++; i < lists.size(); i = next++) {
+            FlexMappedFile file(lists[i]);
+            if (!file.isOpen()) continue;
+            flexScanAptList(file, store, installed, best[worker]);
+            mapped[worker].push_back(std::move(file));
+        }
+    };
+    
+    std::vector<std::thread> threads;
+    for (size_t w = 1; w < workers; ++w) {
+        threads.emplace_back(work, w);
+    }
+    work(0);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    
+    for (uint32_t i = 0; i < store.size(); ++i) {
+        std::string_view candidate;
+        for (size_t w = 0; w < workers; ++w) {
+            if (!best[w][i].empty() && (candidate.empty() || flexCompareDebianVersions(best[w][i], candidate) > 0)) {
+                candidate = best[w][i];
+            }
+        }
+        if (!candidate.empty()) {
+            FlexPackage package = store.package(i);
+            package.availableVersion = std::string(candidate);
+            package.status = "upgradable";
+            updates.push_back(std::move(package));
+        }
+    }
+    return updates;
+}
+
+std::vector<FlexPackage> FlexPackageInfo::flexCheckRPMUpdates() const {
+    // -C 只使用本地元数据缓存, 不访问网络; check-update 有可用更新时退出码为 100.
+    // 只有 dnf 无法启动时才退回 yum, 否则两者都在的主机上每个更新会列出两次
+    std::vector<FlexPackage> updates;
+    int status = -1;
+    auto lines = flexExecuteArgv({"dnf", "-C", "-q", "check-update"}, &status);
+    if (status < 0) {
+        lines = flexExecuteArgv({"yum", "-C", "-q", "check-update"}, &status);
+    }
+    if (status != 0 && status != 100) {
+        return updates;
+    }
+    for (const auto& line : lines) {
+        // "name.arch    version-release    repo"
+        std::istringstream iss(line);
+        std::string nameArch, version, repo;
+        if (!(iss >> nameArch >> version >> repo)) {
+            continue;
+        }
+        size_t dot = nameArch.rfind('.');
+        if (dot == std::string::npos) {
+            continue;
+        }
+        FlexPackage package = getPackageInfo(nameArch.substr(0, dot));
+        if (package.name.empty()) {
+            continue;
+        }
+        package.availableVersion = version;
+        package.status = "upgradable";
+        updates.push_back(std::move(package));
+    }
+    return updates;
+}
+
+std::vector<std::string> FlexPackageInfo::flexExecuteCommand(const std::string& cmd) const {
+    std::vector<std::string> lines;
+    std::array<char, 4096> buffer;
+    std::unique_ptr<FILE, decltype(&pclose)> pipe(popen(cmd.c_str(), "r"), pclose);
+    if (!pipe) {
+        return lines;
+    }
+    
+    std::string current;
+    while (fgets(buffer.data(), buffer.size(), pipe.get()) != nullptr) {
+        current += buffer.data();
+        if (!current.empty() && current.back() == '\n') {
+            current.pop_back();
+            lines.push_back(std::move(current));
+            current.clear();
+        }
+    }
+    if (!current.empty()) {
+        lines.push_back(std::move(current));
+    }
+    return lines;
+}
+
+std::vector<std::string> FlexPackageInfo::flexExecuteArgv(const std::vector<std::string>& argv, int* status) const {
+    std::vector<std::string> lines;
+    if (status != nullptr) *status = -1;
+    int fds[2];
+    if (argv.empty() || pipe2(fds, O_CLOEXEC) != 0) {
+        return lines;
+    }
+    
+    std::vector<char*> args;
+    for (const auto& arg : argv) {
+        args.push_back(const_cast<char*>(arg.c_str()));
+    }
+    args.push_back(nullptr);
+    
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, fds[1], STDOUT_FILENO);
+    posix_spawn_file_actions_addopen(&actions, STDERR_FILENO, "/dev/null", O_WRONLY, 0);
+    pid_t pid;
+    int spawned = posix_spawnp(&pid, args[0], &actions, nullptr, args.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    close(fds[1]);
+    if (spawned != 0) {
+        close(fds[0]);
+        return lines;
+    }
+    
+    std::string pending;
+    std::array<char, 65536> buffer;
+    for (;;) {
+        ssize_t n = read(fds[0], buffer.data(), buffer.size());
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        pending.append(buffer.data(), static_cast<size_t>(n));
+        size_t start = 0;
+        for (size_t newline; (newline = pending.find('\n', start)) != std::string::npos; start = newline + 1) {
+            lines.emplace_back(pending, start, newline - start);
+        }
+        pending.erase(0, start);
+    }
+    if (!pending.empty()) {
+        lines.push_back(std::move(pending));
+    }
+    close(fds[0]);
+    
+    int wstatus = 0;
+    pid_t waited;
+    while ((waited = waitpid(pid, &wstatus, 0)) < 0 && errno == EINTR) {
+    }
+    if (status != nullptr && waited == pid && WIFEXITED(wstatus)) {
+        *status = WEXITSTATUS(wstatus);
+    }
+    return lines;
+}
+
+std::vector<std::string> FlexPackageInfo::flexSplit(const std::string& str, char delimiter) const {
+    std::vector<std::string> parts;
+    size_t start = 0;
+    while (true) {
+        size_t pos = str.find(delimiter, start);
+        parts.push_back(str.substr(start, pos == std::string::npos ? std::string::npos : pos - start));
+        if (pos == std::string::npos) break;
+        start = pos + 1;
+    }
+    return parts;
+}
+
+void FlexPackageInfo::printPackages(const std::vector<FlexPackage>& packages, FlexOutputFormat format) const {
+    if (format == FlexOutputFormat::JSON) {
+        std::cout << toJSON(packages) << std::endl;
+        return;
+    }
+    if (format == FlexOutputFormat::CSV) {
+        std::cout << toCSV(packages) << std::endl;
+        return;
+    }
+    
+    std::cout << FLEX_COLOR_CYAN << "\n=== FlexTools Package Information ===" << FLEX_COLOR_RESET << std::endl;
+    std::cout << FLEX_COLOR_YELLOW << std::left << std::setw(36) << "Name" << std::setw(28) << "Version"
+              << std::setw(10) << "Arch" << std::right << std::setw(10) << "Size" << "  Description"
+              << FLEX_COLOR_RESET << std::endl;
+    
+    for (const auto& package : packages) {
+        std::string description = package.description;
+        if (description.size() > 60) {
+            description = description.substr(0, 57) + "...";
+        }
+        std::string version = package.version;
+        if (!package.availableVersion.empty()) {
+            version += " -> " + package.availableVersion;
+        }
+        std::cout << std::left << std::setw(36) << package.name << std::setw(28) << version
+                  << std::setw(10) << package.architecture << std::right << std::setw(8)
+                  << (package.size / 1024) << "KB" << "  " << description << std::endl;
+    }
+    
+    std::cout << FLEX_COLOR_GREEN << "\nTotal: " << packages.size() << " packages" 
+              << FLEX_COLOR_RESET << std::endl;
+}
+
+std::string FlexPackageInfo::toJSON(const std::vector<FlexPackage>& packages) const {
+    std::ostringstream oss;
+    auto writeList = [&oss](const std::vector<std::string>& items) {
+        oss << "[";
+        for (size_t i = 0; i < items.size(); ++i) {
+            if (i > 0) oss << ", ";
+            oss << "\"" << flexEscapeJSON(items[i]) << "\"";
+        }
+        oss << "]";
+    };
+    
+    oss << "{\n";
+    oss << "  \"flex_package_info\": {\n";
+    oss << "    \"total\": " << packages.size() << ",\n";
+    oss << "    \"packages\": [\n";
+    
+    bool first = true;
+    for (const auto& package : packages) {
+        if (!first) oss << ",\n";
+        first = false;
+        
+        oss << "      {\n";
+        oss << "        \"name\": \"" << flexEscapeJSON(package.name) << "\",\n";
+        oss << "        \"version\": \"" << flexEscapeJSON(package.version) << "\",\n";
+        if (!package.availableVersion.empty()) {
+            oss << "        \"available_version\": \"" << flexEscapeJSON(package.availableVersion) << "\",\n";
+        }
+        oss << "        \"architecture\": \"" << flexEscapeJSON(package.architecture) << "\",\n";
+        oss << "        \"status\": \"" << flexEscapeJSON(package.status) << "\",\n";
+        oss << "        \"section\": \"" << flexEscapeJSON(package.section) << "\",\n";
+        oss << "        \"priority\": " << package.priority << ",\n";
+        oss << "        \"size_bytes\": " << package.size << ",\n";
+        oss << "        \"install_date\": \"" << flexEscapeJSON(package.installDate) << "\",\n";
+        oss << "        \"maintainer\": \"" << flexEscapeJSON(package.maintainer) << "\",\n";
+        oss << "        \"description\": \"" << flexEscapeJSON(package.description) << "\",\n";
+        oss << "        \"dependencies\": ";
+        writeList(package.dependencies);
+        oss << ",\n";
+        oss << "        \"provides\": ";
+        writeList(package.provides);
+        oss << ",\n";
+        oss << "        \"conflicts\": ";
+        writeList(package.conflicts);
+        oss << "\n";
+        oss << "      }";
+    }
+    
+    oss << "\n    ]\n";
+    oss << "  }\n";
+    oss << "}";
+    return oss.str();
+}
+
+std::string FlexPackageInfo::toCSV(const std::vector<FlexPackage>& packages) const {
+    std::ostringstream oss;
+    oss << "Name,Version,Architecture,Status,Section,Size,Install Date,Maintainer,Description\n";
+    for (const auto& package : packages) {
+        oss << flexEscapeCSV(package.name) << ","
+            << flexEscapeCSV(package.version) << ","
+            << flexEscapeCSV(package.architecture) << ","
+            << flexEscapeCSV(package.status) << ","
+            << flexEscapeCSV(package.section) << ","
+            << package.size << ","
+            << flexEscapeCSV(package.installDate) << ","
+            << flexEscapeCSV(package.maintainer) << ","
+            << flexEscapeCSV(package.description) << "\n";
+    }
+    return oss.str();
+}
+
+} // namespace FlexTools
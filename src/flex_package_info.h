@@ -4,9 +4,17 @@
 #include "flex_common.h"
 #include <vector>
 #include <map>
+#include <string_view>
 
 namespace FlexTools {
 
+class FlexPackageSnapshot;
+class FlexPackageStore;
+class FlexTrigramIndex;
+class FlexFileOwnerIndex;
+class FlexDependencyGraph;
+struct FlexVerifyReport;
+
 struct FlexPackage {
     std::string name;
     std::string version;
@@ -21,6 +29,7 @@ struct FlexPackage {
     std::vector<std::string> dependencies;
     std::vector<std::string> provides;
     std::vector<std::string> conflicts;
+    std::string availableVersion; // checkForUpdates 找到的候选版本
 };
 
 class FlexPackageInfo {
@@ -33,7 +42,7 @@ public:
     // 获取所有已安装的包
     std::vector<FlexPackage> getAllPackages() const;
     
-    // 搜索包
+    // 搜索包 (trigram 索引, 按 完全匹配 > 前缀 > 子串 > 模糊 排序)
     std::vector<FlexPackage> searchPackages(const std::string& keyword) const;
     
     // 获取特定包的信息
@@ -42,13 +51,25 @@ public:
     // 获取包依赖
     std::vector<std::string> getPackageDependencies(const std::string& packageName) const;
     
+    // 依赖图: 传递依赖、(传递) 反向依赖、移除后会损坏的包
+    const FlexDependencyGraph& getDependencyGraph() const;
+    std::vector<std::string> getDependencyClosure(const std::string& packageName) const;
+    std::vector<std::string> getReverseDependencies(const std::string& packageName, bool transitive = false) const;
+    std::vector<std::string> getRemovalImpact(const std::vector<std::string>& packageNames) const;
+    
     // 获取包文件列表
     std::vector<std::string> getPackageFiles(const std::string& packageName) const;
     
+    // 批量反查文件所属的包 (dpkg -S / rpm -qf)
+    std::map<std::string, std::vector<std::string>> getFileOwners(const std::vector<std::string>& paths) const;
+    
+    // 校验已安装文件的摘要 (dpkg md5sums / rpm -V), packageNames 为空时校验全部包
+    FlexVerifyReport verifyPackages(const std::vector<std::string>& packageNames = {}) const;
+    
     // 统计包信息
     std::map<std::string, int> getPackageStatistics() const;
     
-    // 检查包更新
+    // 检查包更新 (离线: 只读本地 apt 列表或 dnf 缓存), 结果中 availableVersion 为候选版本
     std::vector<FlexPackage> checkForUpdates() const;
     
     // 打印包信息
@@ -66,25 +87,44 @@ private:
     
     // Debian 系统方法
     std::vector<FlexPackage> flexGetDebianPackages() const;
-    FlexPackage flexGetDebianPackageInfo(const std::string& packageName) const;
-    FlexPackage flexParseDPKGLine(const std::string& line) const;
+    bool flexParseDPKGStanza(std::string_view stanza, FlexPackage& package) const;
+    void flexFillInstallDates(std::vector<FlexPackage>& packages) const;
     
     // RPM 系统方法
     std::vector<FlexPackage> flexGetRPMPackages() const;
-    FlexPackage flexGetRPMPackageInfo(const std::string& packageName) const;
     FlexPackage flexParseRPMLine(const std::string& line) const;
+    std::vector<FlexPackage> flexCheckRPMUpdates() const;
     
     // 辅助方法
     std::vector<std::string> flexExecuteCommand(const std::string& cmd) const;
-    std::string flexExecuteCommandSingle(const std::string& cmd) const;
-    std::string flexTrim(const std::string& str) const;
+    // 不经 shell 直接执行 argv (PATH 查找), 按行返回标准输出, 标准错误丢弃;
+    // status 非空时写入退出码 (无法启动或被信号终止时为 -1)
+    std::vector<std::string> flexExecuteArgv(const std::vector<std::string>& argv, int* status = nullptr) const;
     std::vector<std::string> flexSplit(const std::string& str, char delimiter) const;
     
-    // 缓存
-    mutable std::vector<FlexPackage> flexPackageCache;
+    // 缓存: 列式存放, FlexPackage 只在返回给调用者时展开
+    mutable std::shared_ptr<FlexPackageStore> flexPackageStore;
     mutable bool flexCacheValid = false;
     
     void flexEnsureCache() const;
+    // 在包仓库中按名查找 (dpkg 与 rpm 共用), 找不到时返回空包
+    FlexPackage flexLookupPackage(const std::string& packageName) const;
+    
+    // 磁盘快照 (跨进程复用解析结果)
+    mutable std::shared_ptr<FlexPackageSnapshot> flexSnapshot;
+    mutable bool flexSnapshotChecked = false;
+    
+    const FlexPackageSnapshot* flexLoadSnapshot() const;
+    void flexStoreSnapshot() const;
+    
+    // 搜索索引, 首次搜索时基于 flexPackageStore 构建
+    mutable std::shared_ptr<FlexTrigramIndex> flexSearchIndex;
+    
+    // 文件归属索引, 首次反查时构建
+    mutable std::shared_ptr<FlexFileOwnerIndex> flexOwnerIndex;
+    
+    // 依赖图, 首次查询时基于 flexPackageStore 构建
+    mutable std::shared_ptr<FlexDependencyGraph> flexDependencyGraph;
 };
 
 } // namespace FlexTools
@@ -0,0 +1,325 @@
+#include "flex_package_snapshot.h"
+#include "flex_package_store.h"
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_map>
+
+namespace FlexTools {
+
+namespace {
+
+const char FLEX_SNAPSHOT_MAGIC[8] = {'F', 'L', 'E', 'X', 'P', 'K', 'G', '1'};
+constexpr uint32_t FLEX_SNAPSHOT_VERSION = 2; // 2: 填充 installDate
+
+// 文件头, 全部字段为本机字节序 (快照只在本机使用)
+struct FlexSnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+    uint64_t sourceDevice;
+    uint64_t sourceInode;
+    int64_t sourceMtimeSec;
+    int64_t sourceMtimeNsec;
+    uint64_t sourceSize;
+    uint64_t recordCount;
+    uint64_t recordsOffset;
+    uint64_t listCount;
+    uint64_t listsOffset;
+    uint64_t poolSize;
+    uint64_t poolOffset;
+};
+
+// 字符串引用: 字符串池内的 {偏移, 长度}
+struct FlexStringRef {
+    uint32_t offset;
+    uint32_t length;
+};
+
+// 关系列表: 偏移表中的 {起始下标, 数量}
+struct FlexListRange {
+    uint32_t first;
+    uint32_t count;
+};
+
+// 定长包记录
+struct FlexSnapshotRecord {
+    FlexStringRef name;
+    FlexStringRef version;
+    FlexStringRef architecture;
+    FlexStringRef description;
+    FlexStringRef status;
+    FlexStringRef installDate;
+    FlexStringRef maintainer;
+    FlexStringRef section;
+    FlexListRange dependencies;
+    FlexListRange provides;
+    FlexListRange conflicts;
+    uint64_t size;
+    int32_t priority;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(FlexSnapshotRecord) % 8 == 0, "snapshot records must stay 8-byte aligned");
+
+size_t flexAlign8(size_t value) {
+    return (value + 7) & ~static_cast<size_t>(7);
+}
+
+bool flexSourceMatches(const FlexSnapshotHeader& header, const struct stat& source) {
+    return header.sourceDevice == static_cast<uint64_t>(source.st_dev) &&
+           header.sourceInode == static_cast<uint64_t>(source.st_ino) &&
+           header.sourceMtimeSec == static_cast<int64_t>(source.st_mtim.tv_sec) &&
+           header.sourceMtimeNsec == static_cast<int64_t>(source.st_mtim.tv_nsec) &&
+           header.sourceSize == static_cast<uint64_t>(source.st_size);
+}
+
+// 构建快照时的字符串池, 相同字符串只存一份; 键引用调用方的字符串, 写入期间须保持有效
+class FlexPoolBuilder {
+public:
+    FlexStringRef add(std::string_view value) {
+        auto it = flexOffsets.find(value);
+        if (it != flexOffsets.end()) {
+            return FlexStringRef{it->second, static_cast<uint32_t>(value.size())};
+        }
+        uint32_t offset = static_cast<uint32_t>(flexPool.size());
+        flexPool += value;
+        flexOffsets.emplace(value, offset);
+        return FlexStringRef{offset, static_cast<uint32_t>(value.size())};
+    }
+    
+    const std::string& data() const { return flexPool; }
+    
+private:
+    std::string flexPool;
+    std::unordered_map<std::string_view, uint32_t> flexOffsets;
+};
+
+} // namespace
+
+std::string FlexPackageSnapshot::flexDefaultPath(const std::string& fileName) {
+    std::string base;
+    const char* xdg = std::getenv("XDG_CACHE_HOME");
+    if (xdg != nullptr && xdg[0] == '/') {
+        base = xdg;
+    } else {
+        const char* home = std::getenv("HOME");
+        if (home == nullptr || home[0] == '\0') {
+            return "";
+        }
+        base = std::string(home) + "/.cache";
+    }
+    return base + "/flextools/" + fileName;
+}
+
+bool FlexPackageSnapshot::open(const std::string& cachePath, const struct stat& source) {
+    *this = FlexPackageSnapshot();
+    
+    FlexMappedFile file(cachePath);
+    if (!file.isOpen() || file.size() < sizeof(FlexSnapshotHeader)) {
+        return false;
+    }
+    
+    FlexSnapshotHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, FLEX_SNAPSHOT_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != FLEX_SNAPSHOT_VERSION || header.recordSize != sizeof(FlexSnapshotRecord) ||
+        !flexSourceMatches(header, source)) {
+        return false;
+    }
+    
+    // 各区段必须完整落在文件内
+    uint64_t fileSize = file.size();
+    if (header.recordsOffset > fileSize ||
+        header.recordCount > (fileSize - header.recordsOffset) / sizeof(FlexSnapshotRecord) ||
+        header.listsOffset > fileSize ||
+        header.listCount > (fileSize - header.listsOffset) / sizeof(FlexStringRef) ||
+        header.poolOffset > fileSize || header.poolSize > fileSize - header.poolOffset) {
+        return false;
+    }
+    
+    flexRecords = file.data() + header.recordsOffset;
+    flexLists = file.data() + header.listsOffset;
+    flexPool = file.data() + header.poolOffset;
+    flexRecordCount = header.recordCount;
+    flexListCount = header.listCount;
+    flexPoolSize = header.poolSize;
+    flexFile = std::move(file);
+    return true;
+}
+
+std::string_view FlexPackageSnapshot::flexString(const char* ref) const {
+    FlexStringRef value;
+    std::memcpy(&value, ref, sizeof(value));
+    if (static_cast<size_t>(value.offset) + value.length > flexPoolSize) {
+        return std::string_view();
+    }
+    return std::string_view(flexPool + value.offset, value.length);
+}
+
+std::string_view FlexPackageSnapshot::flexName(size_t index) const {
+    return flexString(flexRecords + index * sizeof(FlexSnapshotRecord) + offsetof(FlexSnapshotRecord, name));
+}
+
+template <typename Visitor>
+void FlexPackageSnapshot::flexVisitList(const char* range, Visitor&& visit) const {
+    FlexListRange list;
+    std::memcpy(&list, range, sizeof(list));
+    if (static_cast<size_t>(list.first) + list.count > flexListCount) {
+        return;
+    }
+    for (uint32_t i = 0; i < list.count; ++i) {
+        visit(flexString(flexLists + (static_cast<size_t>(list.first) + i) * sizeof(FlexStringRef)));
+    }
+}
+
+void FlexPackageSnapshot::flexReadList(const char* range, std::vector<std::string>& out) const {
+    flexVisitList(range, [&out](std::string_view value) { out.emplace_back(value); });
+}
+
+FlexPackage FlexPackageSnapshot::package(size_t index) const {
+    FlexPackage package{};
+    if (index >= flexRecordCount) {
+        return package;
+    }
+    
+    const char* record = flexRecords + index * sizeof(FlexSnapshotRecord);
+    package.name = flexString(record + offsetof(FlexSnapshotRecord, name));
+    package.version = flexString(record + offsetof(FlexSnapshotRecord, version));
+    package.architecture = flexString(record + offsetof(FlexSnapshotRecord, architecture));
+    package.description = flexString(record + offsetof(FlexSnapshotRecord, description));
+    package.status = flexString(record + offsetof(FlexSnapshotRecord, status));
+    package.installDate = flexString(record + offsetof(FlexSnapshotRecord, installDate));
+    package.maintainer = flexString(record + offsetof(FlexSnapshotRecord, maintainer));
+    package.section = flexString(record + offsetof(FlexSnapshotRecord, section));
+    flexReadList(record + offsetof(FlexSnapshotRecord, dependencies), package.dependencies);
+    flexReadList(record + offsetof(FlexSnapshotRecord, provides), package.provides);
+    flexReadList(record + offsetof(FlexSnapshotRecord, conflicts), package.conflicts);
+    
+    uint64_t size;
+    int32_t priority;
+    std::memcpy(&size, record + offsetof(FlexSnapshotRecord, size), sizeof(size));
+    std::memcpy(&priority, record + offsetof(FlexSnapshotRecord, priority), sizeof(priority));
+    package.size = static_cast<size_t>(size);
+    package.priority = priority;
+    return package;
+}
+
+void FlexPackageSnapshot::load(FlexPackageStore& store) const {
+    store.reserve(store.size() + flexRecordCount);
+    for (size_t i = 0; i < flexRecordCount; ++i) {
+        const char* record = flexRecords + i * sizeof(FlexSnapshotRecord);
+        FlexPackageFields fields;
+        fields.name = flexString(record + offsetof(FlexSnapshotRecord, name));
+        fields.version = flexString(record + offsetof(FlexSnapshotRecord, version));
+        fields.architecture = flexString(record + offsetof(FlexSnapshotRecord, architecture));
+        fields.description = flexString(record + offsetof(FlexSnapshotRecord, description));
+        fields.status = flexString(record + offsetof(FlexSnapshotRecord, status));
+        fields.installDate = flexString(record + offsetof(FlexSnapshotRecord, installDate));
+        fields.maintainer = flexString(record + offsetof(FlexSnapshotRecord, maintainer));
+        fields.section = flexString(record + offsetof(FlexSnapshotRecord, section));
+        
+        int32_t priority;
+        std::memcpy(&fields.size, record + offsetof(FlexSnapshotRecord, size), sizeof(fields.size));
+        std::memcpy(&priority, record + offsetof(FlexSnapshotRecord, priority), sizeof(priority));
+        fields.priority = priority;
+        
+        store.append(fields);
+        flexVisitList(record + offsetof(FlexSnapshotRecord, dependencies),
+                      [&store](std::string_view value) { store.addRelation(FlexRelationKind::DEPENDS, value); });
+        flexVisitList(record + offsetof(FlexSnapshotRecord, provides),
+                      [&store](std::string_view value) { store.addRelation(FlexRelationKind::PROVIDES, value); });
+        flexVisitList(record + offsetof(FlexSnapshotRecord, conflicts),
+                      [&store](std::string_view value) { store.addRelation(FlexRelationKind::CONFLICTS, value); });
+    }
+}
+
+bool FlexPackageSnapshot::find(std::string_view name, FlexPackage& result) const {
+    size_t low = 0;
+    size_t high = flexRecordCount;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (flexName(mid) < name) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    if (low < flexRecordCount && flexName(low) == name) {
+        result = package(low);
+        return true;
+    }
+    return false;
+}
+
+bool FlexPackageSnapshot::write(const std::string& cachePath, const struct stat& source,
+                                const FlexPackageStore& store) {
+    FlexPoolBuilder pool;
+    std::vector<FlexSnapshotRecord> records;
+    std::vector<FlexStringRef> lists;
+    records.reserve(store.size());
+    
+    auto addList = [&](FlexRelationKind kind, uint32_t index) {
+        FlexPackageStore::RelationSpan values = store.relations(kind, index);
+        FlexListRange range{static_cast<uint32_t>(lists.size()), static_cast<uint32_t>(values.size())};
+        for (std::string_view value : values) {
+            lists.push_back(pool.add(value));
+        }
+        return range;
+    };
+    
+    for (uint32_t i = 0; i < store.size(); ++i) {
+        FlexSnapshotRecord record{};
+        record.name = pool.add(store.name(i));
+        record.version = pool.add(store.version(i));
+        record.architecture = pool.add(store.architecture(i));
+        record.description = pool.add(store.description(i));
+        record.status = pool.add(store.status(i));
+        record.installDate = pool.add(store.installDate(i));
+        record.maintainer = pool.add(store.maintainer(i));
+        record.section = pool.add(store.section(i));
+        record.dependencies = addList(FlexRelationKind::DEPENDS, i);
+        record.provides = addList(FlexRelationKind::PROVIDES, i);
+        record.conflicts = addList(FlexRelationKind::CONFLICTS, i);
+        record.size = store.installedSize(i);
+        record.priority = store.priority(i);
+        records.push_back(record);
+    }
+    
+    FlexSnapshotHeader header{};
+    std::memcpy(header.magic, FLEX_SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = FLEX_SNAPSHOT_VERSION;
+    header.recordSize = sizeof(FlexSnapshotRecord);
+    header.sourceDevice = source.st_dev;
+    header.sourceInode = source.st_ino;
+    header.sourceMtimeSec = source.st_mtim.tv_sec;
+    header.sourceMtimeNsec = source.st_mtim.tv_nsec;
+    header.sourceSize = source.st_size;
+    header.recordCount = records.size();
+    header.recordsOffset = flexAlign8(sizeof(header));
+    header.listCount = lists.size();
+    header.listsOffset = flexAlign8(header.recordsOffset + records.size() * sizeof(FlexSnapshotRecord));
+    header.poolSize = pool.data().size();
+    header.poolOffset = flexAlign8(header.listsOffset + lists.size() * sizeof(FlexStringRef));
+    
+    std::string buffer(header.poolOffset + header.poolSize, '\0');
+    std::memcpy(&buffer[0], &header, sizeof(header));
+    if (!records.empty()) {
+        std::memcpy(&buffer[header.recordsOffset], records.data(), records.size() * sizeof(FlexSnapshotRecord));
+    }
+    if (!lists.empty()) {
+        std::memcpy(&buffer[header.listsOffset], lists.data(), lists.size() * sizeof(FlexStringRef));
+    }
+    if (!pool.data().empty()) {
+        std::memcpy(&buffer[header.poolOffset], pool.data().data(), pool.data().size());
+    }
+    
+    // 原子替换, 并发读者要么看到旧快照要么看到新快照
+    return flexAtomicWriteFile(cachePath, buffer);
+}
+
+} // namespace FlexTools
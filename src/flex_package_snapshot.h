@@ -0,0 +1,57 @@
+#ifndef FLEX_PACKAGE_SNAPSHOT_H
+#define FLEX_PACKAGE_SNAPSHOT_H
+
+#include "flex_common.h"
+#include "flex_package_info.h"
+#include "flex_mapped_file.h"
+#include <cstdint>
+
+namespace FlexTools {
+
+class FlexPackageStore;
+
+// 包数据库的持久化快照: 定长记录 + 字符串池 + 关系偏移表, 整体 mmap 后直接读取.
+// 头部记录源文件 (dpkg status 或 rpmdb) 的 inode/mtime/size, 源文件变化即失效.
+class FlexPackageSnapshot {
+public:
+    FlexPackageSnapshot() = default;
+    
+    // $XDG_CACHE_HOME/flextools 或 ~/.cache/flextools 下的快照文件路径
+    static std::string flexDefaultPath(const std::string& fileName);
+    
+    // 映射快照并与源文件元数据比对; 格式错误或已过期时返回 false
+    bool open(const std::string& cachePath, const struct stat& source);
+    bool isOpen() const { return flexFile.isOpen(); }
+    
+    size_t size() const { return flexRecordCount; }
+    FlexPackage package(size_t index) const;
+    
+    // 把全部记录追加到列式仓库 (字符串直接从映射区复制, 不经过 FlexPackage)
+    void load(FlexPackageStore& store) const;
+    
+    // 记录按包名排序, 二分查找, 不展开其他记录
+    bool find(std::string_view name, FlexPackage& package) const;
+    
+    // 写入快照 (先写临时文件再 rename); 仓库须已按名称排序
+    static bool write(const std::string& cachePath, const struct stat& source,
+                      const FlexPackageStore& store);
+    
+private:
+    FlexMappedFile flexFile;
+    const char* flexRecords = nullptr;
+    const char* flexLists = nullptr;
+    const char* flexPool = nullptr;
+    size_t flexRecordCount = 0;
+    size_t flexListCount = 0;
+    size_t flexPoolSize = 0;
+    
+    std::string_view flexString(const char* ref) const;
+    std::string_view flexName(size_t index) const;
+    void flexReadList(const char* range, std::vector<std::string>& out) const;
+    template <typename Visitor>
+    void flexVisitList(const char* range, Visitor&& visit) const;
+};
+
+} // namespace FlexTools
+
+#endif // FLEX_PACKAGE_SNAPSHOT_H
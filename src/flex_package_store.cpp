@@ -0,0 +1,189 @@
+#include "flex_package_store.h"
+#include <cstring>
+
+namespace FlexTools {
+
+namespace {
+
+constexpr size_t FLEX_STORE_BLOCK_SIZE = 256 * 1024;
+
+} // namespace
+
+FlexPackageStore::FlexPackageStore() {
+    flexIntern("");
+}
+
+void FlexPackageStore::clear() {
+    *this = FlexPackageStore();
+}
+
+void FlexPackageStore::reserve(size_t packages) {
+    flexNames.reserve(packages);
+    flexVersions.reserve(packages);
+    flexDescriptions.reserve(packages);
+    flexInstallDates.reserve(packages);
+    flexAvailableVersions.reserve(packages);
+    flexArchitectures.reserve(packages);
+    flexSections.reserve(packages);
+    flexMaintainers.reserve(packages);
+    flexStatuses.reserve(packages);
+    flexSizes.reserve(packages);
+    flexPriorities.reserve(packages);
+    for (auto& offsets : flexRelationOffsets) {
+        offsets.reserve(packages);
+    }
+}
+
+std::string_view FlexPackageStore::flexCopy(std::string_view value) {
+    if (value.empty()) {
+        return std::string_view();
+    }
+    if (flexBlocks.empty() || flexBlockUsed + value.size() > flexBlockSize) {
+        // 超长字符串单独占一块, 不浪费当前块的剩余空间
+        size_t size = std::max(FLEX_STORE_BLOCK_SIZE, value.size());
+        if (size > FLEX_STORE_BLOCK_SIZE && !flexBlocks.empty()) {
+            auto block = std::make_unique<char[]>(size);
+            std::memcpy(block.get(), value.data(), value.size());
+            std::string_view copy(block.get(), value.size());
+            flexBlocks.insert(flexBlocks.end() - 1, std::move(block));
+            return copy;
+        }
+        flexBlocks.push_back(std::make_unique<char[]>(size));
+        flexBlockSize = size;
+        flexBlockUsed = 0;
+    }
+    char* target = flexBlocks.back().get() + flexBlockUsed;
+    std::memcpy(target, value.data(), value.size());
+    flexBlockUsed += value.size();
+    return std::string_view(target, value.size());
+}
+
+uint32_t FlexPackageStore::flexIntern(std::string_view value) {
+    auto it = flexSymbolIds.find(value);
+    if (it != flexSymbolIds.end()) {
+        return it->second;
+    }
+    uint32_t id = static_cast<uint32_t>(flexSymbols.size());
+    std::string_view copy = flexCopy(value);
+    flexSymbols.push_back(copy);
+    flexSymbolIds.emplace(copy, id);
+    return id;
+}
+
+uint32_t FlexPackageStore::symbolId(std::string_view value) const {
+    auto it = flexSymbolIds.find(value);
+    return it == flexSymbolIds.end() ? FLEX_NO_PACKAGE : it->second;
+}
+
+uint32_t FlexPackageStore::append(const FlexPackageFields& fields) {
+    uint32_t index = static_cast<uint32_t>(flexNames.size());
+    if (!flexNames.empty() && fields.name < flexNames.back()) {
+        flexSorted = false;
+    }
+    
+    flexNames.push_back(flexCopy(fields.name));
+    flexVersions.push_back(flexCopy(fields.version));
+    flexDescriptions.push_back(flexCopy(fields.description));
+    flexInstallDates.push_back(flexCopy(fields.installDate));
+    flexAvailableVersions.push_back(flexCopy(fields.availableVersion));
+    flexArchitectures.push_back(flexIntern(fields.architecture));
+    flexSections.push_back(flexIntern(fields.section));
+    flexMaintainers.push_back(flexIntern(fields.maintainer));
+    flexStatuses.push_back(flexIntern(fields.status));
+    flexSizes.push_back(fields.size);
+    flexPriorities.push_back(fields.priority);
+    for (size_t kind = 0; kind < 3; ++kind) {
+        flexRelationOffsets[kind].push_back(static_cast<uint32_t>(flexRelationIds[kind].size()));
+    }
+    return index;
+}
+
+uint32_t FlexPackageStore::append(const FlexPackage& package) {
+    FlexPackageFields fields;
+    fields.name = package.name;
+    fields.version = package.version;
+    fields.architecture = package.architecture;
+    fields.description = package.description;
+    fields.status = package.status;
+    fields.installDate = package.installDate;
+    fields.maintainer = package.maintainer;
+    fields.section = package.section;
+    fields.availableVersion = package.availableVersion;
+    fields.size = package.size;
+    fields.priority = package.priority;
+    
+    uint32_t index = append(fields);
+    for (const auto& value : package.dependencies) addRelation(FlexRelationKind::DEPENDS, value);
+    for (const auto& value : package.provides) addRelation(FlexRelationKind::PROVIDES, value);
+    for (const auto& value : package.conflicts) addRelation(FlexRelationKind::CONFLICTS, value);
+    return index;
+}
+
+void FlexPackageStore::addRelation(FlexRelationKind kind, std::string_view value) {
+    if (flexNames.empty()) {
+        return;
+    }
+    flexRelationIds[static_cast<size_t>(kind)].push_back(flexIntern(value));
+}
+
+FlexPackageStore::RelationSpan FlexPackageStore::relations(FlexRelationKind kind, uint32_t index) const {
+    const auto& offsets = flexRelationOffsets[static_cast<size_t>(kind)];
+    const auto& ids = flexRelationIds[static_cast<size_t>(kind)];
+    uint32_t begin = offsets[index];
+    uint32_t end = index + 1 < offsets.size() ? offsets[index + 1] : static_cast<uint32_t>(ids.size());
+    return RelationSpan(this, ids.data() + begin, end - begin);
+}
+
+uint32_t FlexPackageStore::find(std::string_view name) const {
+    if (flexSorted) {
+        auto it = std::lower_bound(flexNames.begin(), flexNames.end(), name);
+        if (it != flexNames.end() && *it == name) {
+            return static_cast<uint32_t>(it - flexNames.begin());
+        }
+        return FLEX_NO_PACKAGE;
+    }
+    for (uint32_t i = 0; i < flexNames.size(); ++i) {
+        if (flexNames[i] == name) {
+            return i;
+        }
+    }
+    return FLEX_NO_PACKAGE;
+}
+
+FlexPackage FlexPackageStore::package(uint32_t index) const {
+    FlexPackage package{};
+    package.name = flexNames[index];
+    package.version = flexVersions[index];
+    package.architecture = architecture(index);
+    package.description = flexDescriptions[index];
+    package.status = status(index);
+    package.installDate = flexInstallDates[index];
+    package.size = static_cast<size_t>(flexSizes[index]);
+    package.maintainer = maintainer(index);
+    package.section = section(index);
+    package.priority = flexPriorities[index];
+    package.availableVersion = flexAvailableVersions[index];
+    
+    auto expand = [&](FlexRelationKind kind, std::vector<std::string>& out) {
+        RelationSpan span = relations(kind, index);
+        out.reserve(span.size());
+        for (std::string_view value : span) {
+            out.emplace_back(value);
+        }
+    };
+    expand(FlexRelationKind::DEPENDS, package.dependencies);
+    expand(FlexRelationKind::PROVIDES, package.provides);
+    expand(FlexRelationKind::CONFLICTS, package.conflicts);
+    return package;
+}
+
+std::vector<FlexPackage> FlexPackageStore::packages() const {
+    std::vector<FlexPackage> result;
+    result.reserve(size());
+    for (uint32_t i = 0; i < size(); ++i) {
+        result.push_back(package(i));
+    }
+    return result;
+}
+
+} // namespace FlexTools
@@ -0,0 +1,152 @@
+#ifndef FLEX_PACKAGE_STORE_H
+#define FLEX_PACKAGE_STORE_H
+
+#include "flex_common.h"
+#include "flex_package_info.h"
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+
+namespace FlexTools {
+
+enum class FlexRelationKind {
+    DEPENDS,
+    PROVIDES,
+    CONFLICTS
+};
+
+// 追加一个包时的标量字段, 字符串会被复制进仓库自己的内存池
+struct FlexPackageFields {
+    std::string_view name;
+    std::string_view version;
+    std::string_view architecture;
+    std::string_view description;
+    std::string_view status;
+    std::string_view installDate;
+    std::string_view maintainer;
+    std::string_view section;
+    std::string_view availableVersion;
+    uint64_t size = 0;
+    int priority = 0;
+};
+
+// 列式包仓库: 每个字段一列, 字符串放在分块内存池中.
+// 架构/段/维护者/状态以及依赖关系条目重复度高, 存为驻留后的 uint32_t ID;
+// 依赖、Provides、Conflicts 展平为 (偏移, ID 数组). FlexPackage 只在需要时展开
+class FlexPackageStore {
+public:
+    static constexpr uint32_t FLEX_NO_PACKAGE = 0xffffffffu;
+    
+    // 某个包某类关系的只读视图
+    class RelationSpan {
+    public:
+        class iterator {
+        public:
+            iterator(const FlexPackageStore* store, const uint32_t* id) : flexStore(store), flexId(id) {}
+            std::string_view operator*() const { return flexStore->symbol(*flexId); }
+            iterator& operator++() { ++flexId; return *this; }
+            bool operator!=(const iterator& other) const { return flexId != other.flexId; }
+        private:
+            const FlexPackageStore* flexStore;
+            const uint32_t* flexId;
+        };
+        
+        RelationSpan(const FlexPackageStore* store, const uint32_t* ids, size_t count)
+            : flexStore(store), flexIds(ids), flexCount(count) {}
+        
+        size_t size() const { return flexCount; }
+        bool empty() const { return flexCount == 0; }
+        uint32_t id(size_t index) const { return flexIds[index]; }
+        std::string_view operator[](size_t index) const { return flexStore->symbol(flexIds[index]); }
+        iterator begin() const { return iterator(flexStore, flexIds); }
+        iterator end() const { return iterator(flexStore, flexIds + flexCount); }
+        
+    private:
+        const FlexPackageStore* flexStore;
+        const uint32_t* flexIds;
+        size_t flexCount;
+    };
+    
+    FlexPackageStore();
+    
+    FlexPackageStore(FlexPackageStore&&) = default;
+    FlexPackageStore& operator=(FlexPackageStore&&) = default;
+    FlexPackageStore(const FlexPackageStore&) = delete;
+    FlexPackageStore& operator=(const FlexPackageStore&) = delete;
+    
+    void clear();
+    void reserve(size_t packages);
+    
+    // 追加一个包并返回其下标; 随后的 addRelation 作用于该包.
+    // 按名称升序追加时 find 走二分查找
+    uint32_t append(const FlexPackageFields& fields);
+    uint32_t append(const FlexPackage& package);
+    void addRelation(FlexRelationKind kind, std::string_view value);
+    
+    size_t size() const { return flexNames.size(); }
+    bool empty() const { return flexNames.empty(); }
+    
+    std::string_view name(uint32_t index) const { return flexNames[index]; }
+    std::string_view version(uint32_t index) const { return flexVersions[index]; }
+    std::string_view description(uint32_t index) const { return flexDescriptions[index]; }
+    std::string_view installDate(uint32_t index) const { return flexInstallDates[index]; }
+    std::string_view availableVersion(uint32_t index) const { return flexAvailableVersions[index]; }
+    std::string_view architecture(uint32_t index) const { return flexSymbols[flexArchitectures[index]]; }
+    std::string_view section(uint32_t index) const { return flexSymbols[flexSections[index]]; }
+    std::string_view maintainer(uint32_t index) const { return flexSymbols[flexMaintainers[index]]; }
+    std::string_view status(uint32_t index) const { return flexSymbols[flexStatuses[index]]; }
+    uint64_t installedSize(uint32_t index) const { return flexSizes[index]; }
+    int priority(uint32_t index) const { return flexPriorities[index]; }
+    RelationSpan relations(FlexRelationKind kind, uint32_t index) const;
+    
+    // 驻留字段的整列访问, 供统计等批量计算使用; ID 0 为空串
+    const std::vector<uint32_t>& architectureColumn() const { return flexArchitectures; }
+    const std::vector<uint32_t>& sectionColumn() const { return flexSections; }
+    const std::vector<uint32_t>& statusColumn() const { return flexStatuses; }
+    const std::vector<uint64_t>& sizeColumn() const { return flexSizes; }
+    std::string_view symbol(uint32_t id) const { return flexSymbols[id]; }
+    size_t symbolCount() const { return flexSymbols.size(); }
+    
+    // 已驻留字符串的 ID, 不存在时返回 FLEX_NO_PACKAGE
+    uint32_t symbolId(std::string_view value) const;
+    
+    uint32_t find(std::string_view name) const;
+    
+    FlexPackage package(uint32_t index) const;
+    std::vector<FlexPackage> packages() const;
+    
+private:
+    // 分块内存池: 块不搬迁, 已写入字符串的 string_view 始终有效
+    std::vector<std::unique_ptr<char[]>> flexBlocks;
+    size_t flexBlockUsed = 0;
+    size_t flexBlockSize = 0;
+    
+    std::vector<std::string_view> flexSymbols;
+    std::unordered_map<std::string_view, uint32_t> flexSymbolIds;
+    
+    std::vector<std::string_view> flexNames;
+    std::vector<std::string_view> flexVersions;
+    std::vector<std::string_view> flexDescriptions;
+    std::vector<std::string_view> flexInstallDates;
+    std::vector<std::string_view> flexAvailableVersions;
+    std::vector<uint32_t> flexArchitectures;
+    std::vector<uint32_t> flexSections;
+    std::vector<uint32_t> flexMaintainers;
+    std::vector<uint32_t> flexStatuses;
+    std::vector<uint64_t> flexSizes;
+    std::vector<int32_t> flexPriorities;
+    
+    // 每类关系: 每个包的起始偏移 + 展平的字符串 ID
+    std::vector<uint32_t> flexRelationOffsets[3];
+    std::vector<uint32_t> flexRelationIds[3];
+    
+    bool flexSorted = true;
+    
+    std::string_view flexCopy(std::string_view value);
+    uint32_t flexIntern(std::string_view value);
+};
+
+} // namespace FlexTools
+
+#endif // FLEX_PACKAGE_STORE_H
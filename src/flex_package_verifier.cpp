@@ -0,0 +1,436 @@
+#include "flex_package_verifier.h"
+#include "flex_package_snapshot.h"
+#include "flex_proc_file.h"
+#include "flex_md5.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+namespace FlexTools {
+
+namespace {
+
+constexpr const char* FLEX_VERIFY_CACHE_MAGIC = "FLEXVERIFY1";
+constexpr size_t FLEX_VERIFY_MAX_WORKERS = 16;
+constexpr size_t FLEX_VERIFY_READ_BUFFER = 1 << 20;
+// 超过该大小的文件改用 mmap, 省去一次内核到用户态的拷贝
+constexpr size_t FLEX_VERIFY_MMAP_THRESHOLD = 8 << 20;
+
+struct FlexVerifyTask {
+    uint32_t package;
+    std::string path;   // 实际检查的绝对路径 (已按 diversion 与根目录换算)
+    std::string listed; // md5sums 中记录的路径, 用于报告
+    uint8_t expected[16];
+};
+
+// 单个任务的结果, 与任务数组对齐, 只由处理该任务的线程写入
+struct FlexVerifyOutcome {
+    bool present = false;
+    bool readable = false;
+    bool fromCache = false;
+    uint64_t size = 0;
+    int64_t mtime = 0;
+    int64_t ctime = 0;
+    uint64_t inode = 0;
+    uint8_t digest[16] = {};
+};
+
+// 工作窃取: 每个线程持有一段连续任务区间, 从头部取; 自己的区间取完后,
+// 从其他线程区间的尾部窃取一半, 大文件集中的包不会拖慢整体
+class FlexStealRanges {
+public:
+    FlexStealRanges(size_t taskCount, size_t workers) : flexRanges(workers) {
+        for (size_t i = 0; i < workers; ++i) {
+            flexRanges[i].head = taskCount * i / workers;
+            flexRanges[i].tail = taskCount * (i + 1) / workers;
+        }
+    }
+    
+    bool take(size_t worker, size_t& task) {
+        {
+            Range& own = flexRanges[worker];
+            std::lock_guard<std::mutex> guard(own.lock);
+            if (own.head < own.tail) {
+                task = own.head++;
+                return true;
+            }
+        }
+        
+        for (size_t step = 1; step < flexRanges.size(); ++step) {
+            Range& victim = flexRanges[(worker + step) % flexRanges.size()];
+            size_t begin = 0;
+            size_t end = 0;
+            {
+                std::lock_guard<std::mutex> guard(victim.lock);
+                size_t remaining = victim.tail - victim.head;
+                if (remaining == 0) {
+                    continue;
+                }
+                begin = victim.tail - (remaining + 1) / 2;
+                end = victim.tail;
+                victim.tail = begin;
+            }
+            Range& own = flexRanges[worker];
+            std::lock_guard<std::mutex> guard(own.lock);
+            own.head = begin + 1;
+            own.tail = end;
+            task = begin;
+            return true;
+        }
+        return false;
+    }
+    
+private:
+    struct Range {
+        std::mutex lock;
+        size_t head = 0;
+        size_t tail = 0;
+    };
+    std::vector<Range> flexRanges;
+};
+
+int64_t flexNanoseconds(const struct timespec& ts) {
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+bool flexHashFile(int fd, size_t size, std::vector<char>& buffer, uint8_t digest[16]) {
+    FlexMD5 md5;
+    if (size >= FLEX_VERIFY_MMAP_THRESHOLD) {
+        void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped != MAP_FAILED) {
+            madvise(mapped, size, MADV_SEQUENTIAL);
+            md5.update(mapped, size);
+            munmap(mapped, size);
+            md5.finalize(digest);
+            return true;
+        }
+    }
+    
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    while (true) {
+        ssize_t count = read(fd, buffer.data(), buffer.size());
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        if (count == 0) break;
+        md5.update(buffer.data(), static_cast<size_t>(count));
+    }
+    md5.finalize(digest);
+    return true;
+}
+
+// dpkg 管理目录下的 diversions: 每三行一组 (原路径, 转移后路径, 持有者包)
+struct FlexDiversion {
+    std::string target;
+    std::string holder;
+};
+
+std::unordered_map<std::string, FlexDiversion> flexReadDiversions(const std::string& adminDir) {
+    std::unordered_map<std::string, FlexDiversion> diversions;
+    std::string content;
+    if (!flexReadWholeFile(adminDir + "diversions", content)) {
+        return diversions;
+    }
+    
+    std::vector<std::string_view> lines;
+    std::string_view view = content;
+    while (!view.empty()) {
+        size_t end = view.find('\n');
+        lines.push_back(view.substr(0, end));
+        if (end == std::string_view::npos) break;
+        view.remove_prefix(end + 1);
+    }
+    for (size_t i = 0; i + 2 < lines.size(); i += 3) {
+        diversions[std::string(lines[i])] = FlexDiversion{std::string(lines[i + 1]), std::string(lines[i + 2])};
+    }
+    return diversions;
+}
+
+bool flexPackageSelected(const std::string& package, const std::vector<std::string>& selected) {
+    if (selected.empty()) {
+        return true;
+    }
+    std::string bare = package.substr(0, package.find(':'));
+    for (const auto& name : selected) {
+        if (name == package || name == bare) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+const char* flexVerifyStatusName(FlexVerifyStatus status) {
+    switch (status) {
+        case FlexVerifyStatus::MODIFIED: return "modified";
+        case FlexVerifyStatus::MISSING: return "missing";
+        case FlexVerifyStatus::UNREADABLE: return "unreadable";
+    }
+    return "unknown";
+}
+
+FlexPackageVerifier::FlexPackageVerifier(const std::string& infoDir, const std::string& rootDir,
+                                         const std::string& cachePath)
+    : flexInfoDir(infoDir), flexRootDir(rootDir), flexCachePath(cachePath) {
+    if (!flexInfoDir.empty() && flexInfoDir.back() != '/') {
+        flexInfoDir += '/';
+    }
+    while (!flexRootDir.empty() && flexRootDir.back() == '/') {
+        flexRootDir.pop_back();
+    }
+    if (flexCachePath.empty()) {
+        flexCachePath = FlexPackageSnapshot::flexDefaultPath("verify-cache.tsv");
+    }
+}
+
+FlexVerifyReport FlexPackageVerifier::verify(const std::vector<std::string>& packages, size_t workers) {
+    FlexVerifyReport report;
+    
+    // 收集 md5sums 文件, 按包名排序保证输出稳定
+    std::vector<std::string> names;
+    if (DIR* dir = opendir(flexInfoDir.c_str())) {
+        while (struct dirent* entry = readdir(dir)) {
+            std::string_view file = entry->d_name;
+            constexpr std::string_view suffix = ".md5sums";
+            if (file.size() <= suffix.size() || file.substr(file.size() - suffix.size()) != suffix) {
+                continue;
+            }
+            std::string package(file.substr(0, file.size() - suffix.size()));
+            if (flexPackageSelected(package, packages)) {
+                names.push_back(std::move(package));
+            }
+        }
+        closedir(dir);
+    }
+    std::sort(names.begin(), names.end());
+    report.packages = names.size();
+    
+    // info 目录的上一级是 dpkg 管理目录
+    std::string adminDir = flexInfoDir.substr(0, flexInfoDir.find_last_of('/', flexInfoDir.size() - 2) + 1);
+    auto diversions = flexReadDiversions(adminDir);
+    
+    std::vector<FlexVerifyTask> tasks;
+    for (uint32_t package = 0; package < names.size(); ++package) {
+        std::string content;
+        if (!flexReadWholeFile(flexInfoDir + names[package] + ".md5sums", content)) {
+            continue;
+        }
+        std::string bare = names[package].substr(0, names[package].find(':'));
+        std::string_view view = content;
+        while (!view.empty()) {
+            size_t end = view.find('\n');
+            std::string_view line = view.substr(0, end);
+            view.remove_prefix(end == std::string_view::npos ? view.size() : end + 1);
+            
+            // "<32 位十六进制>  <相对路径>", 二进制模式为 " *"
+            if (line.size() < 35 || line[32] != ' ') {
+                continue;
+            }
+            FlexVerifyTask task;
+            if (!FlexMD5::fromHex(line.data(), task.expected)) {
+                continue;
+            }
+            std::string_view relative = line.substr(34);
+            task.package = package;
+            task.listed = "/" + std::string(relative);
+            
+            // 文件被其他包 divert 时, 本包的版本位于转移后的路径
+            std::string actual = task.listed;
+            auto diversion = diversions.find(actual);
+            if (diversion != diversions.end() && diversion->second.holder != bare) {
+                actual = diversion->second.target;
+            }
+            task.path = flexRootDir + actual;
+            tasks.push_back(std::move(task));
+        }
+    }
+    report.files = tasks.size();
+    
+    flexLoadCache();
+    
+    if (workers == 0) {
+        workers = std::max(1u, std::thread::hardware_concurrency());
+    }
+    workers = std::max<size_t>(1, std::min({workers, FLEX_VERIFY_MAX_WORKERS, tasks.size()}));
+    
+    std::vector<FlexVerifyOutcome> outcomes(tasks.size());
+    FlexStealRanges ranges(tasks.size(), workers);
+    std::atomic<uint64_t> bytesHashed{0};
+    
+    auto work = [&](size_t worker) {
+        std::vector<char> buffer(FLEX_VERIFY_READ_BUFFER);
+        uint64_t bytes = 0;
+        size_t index;
+        while (ranges.take(worker, index)) {
+            const FlexVerifyTask& task = tasks[index];
+            FlexVerifyOutcome& outcome = outcomes[index];
+            
+            struct stat st;
+            if (stat(task.path.c_str(), &st) != 0) {
+                // 权限不足以外的错误 (ENOENT/ENOTDIR 等) 都视为缺失
+                outcome.present = errno == EACCES;
+                continue;
+            }
+            outcome.present = true;
+            outcome.size = static_cast<uint64_t>(st.st_size);
+            outcome.mtime = flexNanoseconds(st.st_mtim);
+            outcome.ctime = flexNanoseconds(st.st_ctim);
+            outcome.inode = static_cast<uint64_t>(st.st_ino);
+            
+            // ctime 无法由用户态伪造, 与大小、mtime、inode 一起作为缓存键
+            auto cached = flexCache.find(task.path);
+            if (cached != flexCache.end() && cached->second.size == outcome.size &&
+                cached->second.mtime == outcome.mtime && cached->second.ctime == outcome.ctime &&
+                cached->second.inode == outcome.inode) {
+                std::memcpy(outcome.digest, cached->second.digest, sizeof(outcome.digest));
+                outcome.readable = true;
+                outcome.fromCache = true;
+                continue;
+            }
+            
+            int fd = open(task.path.c_str(), O_RDONLY | O_CLOEXEC | O_NOCTTY);
+            if (fd < 0) {
+                continue;
+            }
+            if (S_ISREG(st.st_mode) && flexHashFile(fd, outcome.size, buffer, outcome.digest)) {
+                outcome.readable = true;
+                bytes += outcome.size;
+            }
+            close(fd);
+        }
+        bytesHashed += bytes;
+    };
+    
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < workers; ++i) {
+        threads.emplace_back(work, i);
+    }
+    if (!tasks.empty()) {
+        work(0);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    report.bytesHashed = bytesHashed;
+    
+    // 汇总结果并用本次的元数据重建缓存 (只保留当前仍在校验范围内的文件)
+    std::unordered_map<std::string, CacheEntry> cache;
+    bool cacheChanged = false;
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        const FlexVerifyTask& task = tasks[i];
+        const FlexVerifyOutcome& outcome = outcomes[i];
+        
+        if (!outcome.present) {
+            report.issues.push_back({names[task.package], task.listed, FlexVerifyStatus::MISSING});
+            continue;
+        }
+        if (!outcome.readable) {
+            report.issues.push_back({names[task.package], task.listed, FlexVerifyStatus::UNREADABLE});
+            continue;
+        }
+        if (outcome.fromCache) {
+            ++report.cached;
+        } else {
+            ++report.hashed;
+            cacheChanged = true;
+        }
+        if (std::memcmp(outcome.digest, task.expected, sizeof(task.expected)) != 0) {
+            report.issues.push_back({names[task.package], task.listed, FlexVerifyStatus::MODIFIED});
+        }
+        
+        CacheEntry entry{outcome.size, outcome.mtime, outcome.ctime, outcome.inode, {}};
+        std::memcpy(entry.digest, outcome.digest, sizeof(entry.digest));
+        cache[task.path] = entry;
+    }
+    
+    // 只校验部分包时保留其他包的缓存条目
+    if (!packages.empty()) {
+        for (auto& [path, entry] : flexCache) {
+            cache.emplace(path, entry);
+        }
+    } else if (cache.size() != flexCache.size()) {
+        cacheChanged = true;
+    }
+    flexCache = std::move(cache);
+    if (cacheChanged) {
+        flexSaveCache();
+    }
+    
+    std::sort(report.issues.begin(), report.issues.end(), [](const FlexVerifyIssue& a, const FlexVerifyIssue& b) {
+        return a.package != b.package ? a.package < b.package : a.path < b.path;
+    });
+    return report;
+}
+
+bool FlexPackageVerifier::flexLoadCache() {
+    flexCache.clear();
+    std::string content;
+    if (flexCachePath.empty() || !flexReadWholeFile(flexCachePath, content)) {
+        return false;
+    }
+    
+    std::string_view view = content;
+    size_t end = view.find('\n');
+    if (end == std::string_view::npos || view.substr(0, end) != FLEX_VERIFY_CACHE_MAGIC) {
+        return false;
+    }
+    view.remove_prefix(end + 1);
+    
+    // 每行: 路径 \t 大小 \t mtime \t ctime \t inode \t md5
+    while (!view.empty()) {
+        end = view.find('\n');
+        if (end == std::string_view::npos) break;
+        std::string_view line = view.substr(0, end);
+        view.remove_prefix(end + 1);
+        
+        size_t tab = line.find('\t');
+        if (tab == std::string_view::npos) continue;
+        std::string path(line.substr(0, tab));
+        line.remove_prefix(tab + 1);
+        
+        uint64_t fields[4];
+        bool valid = true;
+        for (uint64_t& field : fields) {
+            if (!flexParseUnsigned(line, field) || line.empty() || line[0] != '\t') {
+                valid = false;
+                break;
+            }
+            line.remove_prefix(1);
+        }
+        CacheEntry entry;
+        if (!valid || line.size() != 32 || !FlexMD5::fromHex(line.data(), entry.digest)) {
+            continue;
+        }
+        entry.size = fields[0];
+        entry.mtime = static_cast<int64_t>(fields[1]);
+        entry.ctime = static_cast<int64_t>(fields[2]);
+        entry.inode = fields[3];
+        flexCache.emplace(std::move(path), entry);
+    }
+    return true;
+}
+
+bool FlexPackageVerifier::flexSaveCache() const {
+    std::ostringstream out;
+    out << FLEX_VERIFY_CACHE_MAGIC << "\n";
+    for (const auto& [path, entry] : flexCache) {
+        if (path.find_first_of("\t\n") != std::string::npos) {
+            continue;
+        }
+        out << path << "\t" << entry.size << "\t" << entry.mtime << "\t" << entry.ctime << "\t"
+            << entry.inode << "\t" << FlexMD5::toHex(entry.digest) << "\n";
+    }
+    return flexAtomicWriteFile(flexCachePath, out.str());
+}
+
+} // namespace FlexTools
@@ -0,0 +1,65 @@
+#ifndef FLEX_PACKAGE_VERIFIER_H
+#define FLEX_PACKAGE_VERIFIER_H
+
+#include "flex_common.h"
+#include <cstdint>
+#include <unordered_map>
+
+namespace FlexTools {
+
+enum class FlexVerifyStatus {
+    MODIFIED,
+    MISSING,
+    UNREADABLE
+};
+
+const char* flexVerifyStatusName(FlexVerifyStatus status);
+
+struct FlexVerifyIssue {
+    std::string package;
+    std::string path;
+    FlexVerifyStatus status;
+};
+
+struct FlexVerifyReport {
+    size_t packages = 0;
+    size_t files = 0;
+    size_t hashed = 0;       // 实际读取并计算摘要的文件数
+    size_t cached = 0;       // 大小/mtime/ctime 未变, 直接采用缓存结果的文件数
+    uint64_t bytesHashed = 0;
+    std::vector<FlexVerifyIssue> issues; // 按包名、路径排序
+};
+
+// 按 dpkg info/*.md5sums 校验已安装文件 (等价于 dpkg --verify 的摘要检查).
+// 文件校验任务分发到工作窃取线程池; 小文件用大块顺序 read, 大文件 mmap;
+// 文件元数据未变化时沿用上次的摘要, 缓存保存在用户缓存目录
+class FlexPackageVerifier {
+public:
+    explicit FlexPackageVerifier(const std::string& infoDir = "/var/lib/dpkg/info/",
+                                 const std::string& rootDir = "/",
+                                 const std::string& cachePath = "");
+    
+    // packages 为空时校验全部包; 包名可带 ":arch"
+    FlexVerifyReport verify(const std::vector<std::string>& packages = {}, size_t workers = 0);
+    
+private:
+    struct CacheEntry {
+        uint64_t size;
+        int64_t mtime; // 纳秒
+        int64_t ctime; // 纳秒
+        uint64_t inode;
+        uint8_t digest[16];
+    };
+    
+    std::string flexInfoDir;
+    std::string flexRootDir;
+    std::string flexCachePath;
+    std::unordered_map<std::string, CacheEntry> flexCache;
+    
+    bool flexLoadCache();
+    bool flexSaveCache() const;
+};
+
+} // namespace FlexTools
+
+#endif // FLEX_PACKAGE_VERIFIER_H
@@ -0,0 +1,103 @@
+#include "flex_proc_file.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+
+namespace FlexTools {
+
+bool flexReadWholeFile(const std::string& path, std::string& out) {
+    out.clear();
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    
+    char buffer[16384];
+    while (true) {
+        ssize_t n = read(fd, buffer, sizeof(buffer));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            close(fd);
+            return false;
+        }
+        if (n == 0) break;
+        out.append(buffer, static_cast<size_t>(n));
+    }
+    close(fd);
+    return true;
+}
+
+bool flexParseUnsigned(std::string_view& view, uint64_t& value) {
+    size_t i = 0;
+    uint64_t result = 0;
+    while (i < view.size() && view[i] >= '0' && view[i] <= '9') {
+        result = result * 10 + static_cast<uint64_t>(view[i] - '0');
+        ++i;
+    }
+    if (i == 0) {
+        return false;
+    }
+    value = result;
+    view.remove_prefix(i);
+    return true;
+}
+
+void flexSkipSpaces(std::string_view& view) {
+    size_t i = 0;
+    while (i < view.size() && (view[i] == ' ' || view[i] == '\t')) {
+        ++i;
+    }
+    view.remove_prefix(i);
+}
+
+FlexProcFile::FlexProcFile(const std::string& path) {
+    flexFd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+}
+
+FlexProcFile::~FlexProcFile() {
+    if (flexFd >= 0) {
+        close(flexFd);
+    }
+}
+
+FlexProcFile::FlexProcFile(FlexProcFile&& other) noexcept : flexFd(other.flexFd) {
+    other.flexFd = -1;
+}
+
+FlexProcFile& FlexProcFile::operator=(FlexProcFile&& other) noexcept {
+    if (this != &other) {
+        if (flexFd >= 0) {
+            close(flexFd);
+        }
+        flexFd = other.flexFd;
+        other.flexFd = -1;
+    }
+    return *this;
+}
+
+std::string_view FlexProcFile::flexRead(char* buffer, size_t capacity) const {
+    if (flexFd < 0 || capacity == 0) {
+        return {};
+    }
+    
+    size_t total = 0;
+    while (total < capacity) {
+        ssize_t n = pread(flexFd, buffer + total, capacity - total, static_cast<off_t>(total));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return {};
+        }
+        if (n == 0) break;
+        total += static_cast<size_t>(n);
+    }
+    return std::string_view(buffer, total);
+}
+
+bool FlexProcFile::flexReadUnsigned(uint64_t& value) const {
+    char buffer[32];
+    std::string_view content = flexRead(buffer, sizeof(buffer));
+    flexSkipSpaces(content);
+    return flexParseUnsigned(content, value);
+}
+
+} // namespace FlexTools
@@ -0,0 +1,46 @@
+#ifndef FLEX_PROC_FILE_H
+#define FLEX_PROC_FILE_H
+
+#include "flex_common.h"
+#include <string_view>
+#include <cstdint>
+
+namespace FlexTools {
+
+// 一次性读取整个文件 (procfs/sysfs 文件 st_size 为 0, 需要循环 read)
+bool flexReadWholeFile(const std::string& path, std::string& out);
+
+// 从 string_view 头部解析无符号整数, 成功后推进 view, 不抛异常
+bool flexParseUnsigned(std::string_view& view, uint64_t& value);
+
+// 跳过 view 头部的空白字符
+void flexSkipSpaces(std::string_view& view);
+
+// 保持打开的 procfs/sysfs 文件, 每次采样通过 pread 从偏移 0 重新读取,
+// 避免重复 open/close 与堆分配
+class FlexProcFile {
+public:
+    FlexProcFile() = default;
+    explicit FlexProcFile(const std::string& path);
+    ~FlexProcFile();
+    
+    FlexProcFile(FlexProcFile&& other) noexcept;
+    FlexProcFile& operator=(FlexProcFile&& other) noexcept;
+    FlexProcFile(const FlexProcFile&) = delete;
+    FlexProcFile& operator=(const FlexProcFile&) = delete;
+    
+    bool isOpen() const { return flexFd >= 0; }
+    
+    // 读入调用者提供的缓冲区, 失败时返回空视图
+    std::string_view flexRead(char* buffer, size_t capacity) const;
+    
+    // 读取只包含一个整数的文件 (如 sysfs 统计项)
+    bool flexReadUnsigned(uint64_t& value) const;
+    
+private:
+    int flexFd = -1;
+};
+
+} // namespace FlexTools
+
+#endif // FLEX_PROC_FILE_H
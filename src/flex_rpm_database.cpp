@@ -0,0 +1,357 @@
+#include "flex_rpm_database.h"
+#include <sys/stat.h>
+#include <cstring>
+#ifdef FLEX_HAVE_SQLITE3
+#include <sqlite3.h>
+#endif
+
+namespace FlexTools {
+
+namespace {
+
+// RPM 头部标签
+enum FlexRPMTag : uint32_t {
+    FLEX_RPMTAG_NAME = 1000,
+    FLEX_RPMTAG_VERSION = 1001,
+    FLEX_RPMTAG_RELEASE = 1002,
+    FLEX_RPMTAG_EPOCH = 1003,
+    FLEX_RPMTAG_SUMMARY = 1004,
+    FLEX_RPMTAG_INSTALLTIME = 1008,
+    FLEX_RPMTAG_SIZE = 1009,
+    FLEX_RPMTAG_PACKAGER = 1015,
+    FLEX_RPMTAG_GROUP = 1016,
+    FLEX_RPMTAG_ARCH = 1022,
+    FLEX_RPMTAG_OLDFILENAMES = 1027,
+    FLEX_RPMTAG_PROVIDENAME = 1047,
+    FLEX_RPMTAG_REQUIREFLAGS = 1048,
+    FLEX_RPMTAG_REQUIRENAME = 1049,
+    FLEX_RPMTAG_REQUIREVERSION = 1050,
+    FLEX_RPMTAG_CONFLICTFLAGS = 1053,
+    FLEX_RPMTAG_CONFLICTNAME = 1054,
+    FLEX_RPMTAG_CONFLICTVERSION = 1055,
+    FLEX_RPMTAG_PROVIDEFLAGS = 1112,
+    FLEX_RPMTAG_PROVIDEVERSION = 1113,
+    FLEX_RPMTAG_DIRINDEXES = 1116,
+    FLEX_RPMTAG_BASENAMES = 1117,
+    FLEX_RPMTAG_DIRNAMES = 1118,
+    FLEX_RPMTAG_LONGSIZE = 5009
+};
+
+// RPM 数据类型
+enum FlexRPMType : uint32_t {
+    FLEX_RPM_INT32_TYPE = 4,
+    FLEX_RPM_INT64_TYPE = 5,
+    FLEX_RPM_STRING_TYPE = 6,
+    FLEX_RPM_STRING_ARRAY_TYPE = 8,
+    FLEX_RPM_I18NSTRING_TYPE = 9
+};
+
+// 依赖比较标志 (RPMSENSE_*)
+constexpr uint32_t FLEX_RPMSENSE_LESS = 1u << 1;
+constexpr uint32_t FLEX_RPMSENSE_GREATER = 1u << 2;
+constexpr uint32_t FLEX_RPMSENSE_EQUAL = 1u << 3;
+constexpr uint32_t FLEX_RPMSENSE_RPMLIB = 1u << 24;
+
+uint32_t flexReadBE32(const unsigned char* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+uint64_t flexReadBE64(const unsigned char* p) {
+    return (static_cast<uint64_t>(flexReadBE32(p)) << 32) | flexReadBE32(p + 4);
+}
+
+// 已做边界检查的头部视图
+class FlexRPMHeaderView {
+public:
+    struct Entry {
+        uint32_t type = 0;
+        uint32_t offset = 0;
+        uint32_t count = 0;
+        bool present = false;
+    };
+    
+    bool load(const unsigned char* blob, size_t size) {
+        if (size < 8) return false;
+        uint32_t indexCount = flexReadBE32(blob);
+        uint32_t dataLength = flexReadBE32(blob + 4);
+        if (indexCount > 0xffff || 8 + static_cast<size_t>(indexCount) * 16 + dataLength > size) {
+            return false;
+        }
+        flexIndex = blob + 8;
+        flexIndexCount = indexCount;
+        flexData = flexIndex + static_cast<size_t>(indexCount) * 16;
+        flexDataLength = dataLength;
+        return true;
+    }
+    
+    Entry find(uint32_t tag) const {
+        Entry entry;
+        for (uint32_t i = 0; i < flexIndexCount; ++i) {
+            const unsigned char* item = flexIndex + static_cast<size_t>(i) * 16;
+            if (flexReadBE32(item) == tag) {
+                entry.type = flexReadBE32(item + 4);
+                entry.offset = flexReadBE32(item + 8);
+                entry.count = flexReadBE32(item + 12);
+                entry.present = entry.offset < flexDataLength;
+                return entry;
+            }
+        }
+        return entry;
+    }
+    
+    // STRING/STRING_ARRAY/I18NSTRING: 依次读取 count 个以 NUL 结尾的字符串
+    std::vector<std::string> strings(uint32_t tag) const {
+        std::vector<std::string> values;
+        Entry entry = find(tag);
+        if (!entry.present || (entry.type != FLEX_RPM_STRING_TYPE && entry.type != FLEX_RPM_STRING_ARRAY_TYPE &&
+                               entry.type != FLEX_RPM_I18NSTRING_TYPE)) {
+            return values;
+        }
+        uint32_t count = entry.type == FLEX_RPM_STRING_TYPE ? 1 : entry.count;
+        size_t pos = entry.offset;
+        for (uint32_t i = 0; i < count && pos < flexDataLength; ++i) {
+            const char* start = reinterpret_cast<const char*>(flexData + pos);
+            const void* nul = std::memchr(start, '\0', flexDataLength - pos);
+            if (nul == nullptr) break;
+            size_t len = static_cast<const char*>(nul) - start;
+            values.emplace_back(start, len);
+            pos += len + 1;
+        }
+        return values;
+    }
+    
+    std::string string(uint32_t tag) const {
+        auto values = strings(tag);
+        return values.empty() ? "" : values.front();
+    }
+    
+    std::vector<uint32_t> int32s(uint32_t tag) const {
+        std::vector<uint32_t> values;
+        Entry entry = find(tag);
+        if (!entry.present || entry.type != FLEX_RPM_INT32_TYPE ||
+            static_cast<size_t>(entry.offset) + static_cast<size_t>(entry.count) * 4 > flexDataLength) {
+            return values;
+        }
+        values.reserve(entry.count);
+        for (uint32_t i = 0; i < entry.count; ++i) {
+            values.push_back(flexReadBE32(flexData + entry.offset + i * 4));
+        }
+        return values;
+    }
+    
+    bool int64(uint32_t tag, uint64_t& value) const {
+        Entry entry = find(tag);
+        if (!entry.present || entry.type != FLEX_RPM_INT64_TYPE || entry.count < 1 ||
+            static_cast<size_t>(entry.offset) + 8 > flexDataLength) {
+            return false;
+        }
+        value = flexReadBE64(flexData + entry.offset);
+        return true;
+    }
+    
+private:
+    const unsigned char* flexIndex = nullptr;
+    const unsigned char* flexData = nullptr;
+    uint32_t flexIndexCount = 0;
+    uint32_t flexDataLength = 0;
+};
+
+// 组合依赖名、比较标志与版本为 "name (>= version)"
+void flexCollectRelations(const FlexRPMHeaderView& header, uint32_t nameTag, uint32_t flagsTag,
+                          uint32_t versionTag, std::vector<std::string>& out) {
+    auto names = header.strings(nameTag);
+    auto flags = header.int32s(flagsTag);
+    auto versions = header.strings(versionTag);
+    
+    for (size_t i = 0; i < names.size(); ++i) {
+        uint32_t sense = i < flags.size() ? flags[i] : 0;
+        // rpmlib(...) 是 rpm 自身的能力声明, 不是包依赖
+        if ((sense & FLEX_RPMSENSE_RPMLIB) || names[i].compare(0, 7, "rpmlib(") == 0) {
+            continue;
+        }
+        
+        std::string relation = names[i];
+        if (i < versions.size() && !versions[i].empty()) {
+            std::string op;
+            if (sense & FLEX_RPMSENSE_LESS) op += "<";
+            if (sense & FLEX_RPMSENSE_GREATER) op += ">";
+            if (sense & FLEX_RPMSENSE_EQUAL) op += "=";
+            if (!op.empty()) {
+                relation += " (" + op + " " + versions[i] + ")";
+            }
+        }
+        out.push_back(std::move(relation));
+    }
+}
+
+bool flexFileExists(const std::string& path) {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 && S_ISREG(st.st_mode);
+}
+
+} // namespace
+
+bool flexDecodeRPMHeader(const unsigned char* blob, size_t size, FlexPackage& package) {
+    FlexRPMHeaderView header;
+    if (!header.load(blob, size)) {
+        return false;
+    }
+    
+    package = FlexPackage{};
+    package.name = header.string(FLEX_RPMTAG_NAME);
+    if (package.name.empty() || package.name == "gpg-pubkey") {
+        return false;
+    }
+    
+    auto epoch = header.int32s(FLEX_RPMTAG_EPOCH);
+    package.version = header.string(FLEX_RPMTAG_VERSION) + "-" + header.string(FLEX_RPMTAG_RELEASE);
+    if (!epoch.empty() && epoch.front() != 0) {
+        package.version = std::to_string(epoch.front()) + ":" + package.version;
+    }
+    package.architecture = header.string(FLEX_RPMTAG_ARCH);
+    package.description = header.string(FLEX_RPMTAG_SUMMARY);
+    package.section = header.string(FLEX_RPMTAG_GROUP);
+    package.maintainer = header.string(FLEX_RPMTAG_PACKAGER);
+    package.status = "installed";
+    
+    uint64_t longSize = 0;
+    if (header.int64(FLEX_RPMTAG_LONGSIZE, longSize)) {
+        package.size = static_cast<size_t>(longSize);
+    } else {
+        auto sizes = header.int32s(FLEX_RPMTAG_SIZE);
+        package.size = sizes.empty() ? 0 : sizes.front();
+    }
+    
+    auto installTimes = header.int32s(FLEX_RPMTAG_INSTALLTIME);
+    if (!installTimes.empty() && installTimes.front() > 0) {
+        package.installDate = flexFormatTime(installTimes.front());
+    }
+    
+    flexCollectRelations(header, FLEX_RPMTAG_REQUIRENAME, FLEX_RPMTAG_REQUIREFLAGS,
+                         FLEX_RPMTAG_REQUIREVERSION, package.dependencies);
+    flexCollectRelations(header, FLEX_RPMTAG_PROVIDENAME, FLEX_RPMTAG_PROVIDEFLAGS,
+                         FLEX_RPMTAG_PROVIDEVERSION, package.provides);
+    flexCollectRelations(header, FLEX_RPMTAG_CONFLICTNAME, FLEX_RPMTAG_CONFLICTFLAGS,
+                         FLEX_RPMTAG_CONFLICTVERSION, package.conflicts);
+    return true;
+}
+
+bool flexDecodeRPMFiles(const unsigned char* blob, size_t size, std::vector<std::string>& files) {
+    FlexRPMHeaderView header;
+    if (!header.load(blob, size)) {
+        return false;
+    }
+    
+    // 文件名压缩存放: 目录表 + 每个文件的 (目录下标, 文件名); 很旧的包只有完整路径
+    auto basenames = header.strings(FLEX_RPMTAG_BASENAMES);
+    if (basenames.empty()) {
+        files = header.strings(FLEX_RPMTAG_OLDFILENAMES);
+        return true;
+    }
+    auto dirnames = header.strings(FLEX_RPMTAG_DIRNAMES);
+    auto dirIndexes = header.int32s(FLEX_RPMTAG_DIRINDEXES);
+    if (dirIndexes.size() != basenames.size()) {
+        return false;
+    }
+    files.clear();
+    files.reserve(basenames.size());
+    for (size_t i = 0; i < basenames.size(); ++i) {
+        if (dirIndexes[i] >= dirnames.size()) {
+            return false;
+        }
+        files.push_back(dirnames[dirIndexes[i]] + basenames[i]);
+    }
+    return true;
+}
+
+FlexRPMDatabase::FlexRPMDatabase(const std::string& path)
+    : flexPath(path.empty() ? flexFindDatabase() : path) {
+}
+
+std::string FlexRPMDatabase::flexFindDatabase() {
+    static const char* candidates[] = {
+        "/var/lib/rpm/rpmdb.sqlite",
+        "/usr/lib/sysimage/rpm/rpmdb.sqlite"
+    };
+    for (const char* candidate : candidates) {
+        if (flexFileExists(candidate)) {
+            return candidate;
+        }
+    }
+    return "";
+}
+
+bool FlexRPMDatabase::isAvailable() const {
+#ifdef FLEX_HAVE_SQLITE3
+    return !flexPath.empty() && flexFileExists(flexPath);
+#else
+    return false;
+#endif
+}
+
+bool FlexRPMDatabase::flexForEachHeader(const std::function<void(const unsigned char*, size_t)>& onHeader) const {
+#ifdef FLEX_HAVE_SQLITE3
+    if (!isAvailable()) {
+        return false;
+    }
+    
+    // 普通用户无法写 WAL 的 -shm 文件时, 以 immutable 方式重新打开
+    sqlite3* db = nullptr;
+    if (sqlite3_open_v2(flexPath.c_str(), &db, SQLITE_OPEN_READONLY, nullptr) != SQLITE_OK ||
+        sqlite3_exec(db, "SELECT 1 FROM Packages LIMIT 1", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        sqlite3_close(db);
+        db = nullptr;
+        std::string uri = "file:" + flexPath + "?immutable=1";
+        if (sqlite3_open_v2(uri.c_str(), &db, SQLITE_OPEN_READONLY | SQLITE_OPEN_URI, nullptr) != SQLITE_OK) {
+            sqlite3_close(db);
+            return false;
+        }
+    }
+    
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db, "SELECT blob FROM Packages", -1, &stmt, nullptr) != SQLITE_OK) {
+        sqlite3_close(db);
+        return false;
+    }
+    
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        const void* blob = sqlite3_column_blob(stmt, 0);
+        int size = sqlite3_column_bytes(stmt, 0);
+        if (blob != nullptr && size > 0) {
+            onHeader(static_cast<const unsigned char*>(blob), static_cast<size_t>(size));
+        }
+    }
+    
+    sqlite3_finalize(stmt);
+    sqlite3_close(db);
+    return rc == SQLITE_DONE;
+#else
+    (void)onHeader;
+    return false;
+#endif
+}
+
+bool FlexRPMDatabase::readPackages(std::vector<FlexPackage>& packages) const {
+    FlexPackage package;
+    return flexForEachHeader([&](const unsigned char* blob, size_t size) {
+        if (flexDecodeRPMHeader(blob, size, package)) {
+            packages.push_back(std::move(package));
+        }
+    });
+}
+
+bool FlexRPMDatabase::readFiles(const std::string& name, std::vector<std::string>& files) const {
+    // 只为名称匹配的头部解码文件表
+    bool found = false;
+    FlexPackage package;
+    bool ok = flexForEachHeader([&](const unsigned char* blob, size_t size) {
+        if (!found && flexDecodeRPMHeader(blob, size, package) && package.name == name) {
+            found = flexDecodeRPMFiles(blob, size, files);
+        }
+    });
+    return ok && found;
+}
+
+} // namespace FlexTools
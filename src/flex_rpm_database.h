@@ -0,0 +1,44 @@
+#ifndef FLEX_RPM_DATABASE_H
+#define FLEX_RPM_DATABASE_H
+
+#include "flex_common.h"
+#include "flex_package_info.h"
+#include <cstdint>
+#include <functional>
+
+namespace FlexTools {
+
+// 解码 rpmdb 中保存的 RPM 头部 blob (不含魔数的 il/dl + 索引 + 数据区),
+// 填充名称、版本、架构、大小、安装时间及 requires/provides/conflicts
+bool flexDecodeRPMHeader(const unsigned char* blob, size_t size, FlexPackage& package);
+
+// 解码头部中的文件表 (DIRNAMES + DIRINDEXES + BASENAMES, 旧格式为 OLDFILENAMES), 按头部中的顺序
+bool flexDecodeRPMFiles(const unsigned char* blob, size_t size, std::vector<std::string>& files);
+
+// 只读打开本地 rpmdb.sqlite, 直接解码每个头部, 不启动 rpm 子进程
+class FlexRPMDatabase {
+public:
+    // path 为空时自动探测 /var/lib/rpm 与 /usr/lib/sysimage/rpm
+    explicit FlexRPMDatabase(const std::string& path = "");
+    
+    bool isAvailable() const;
+    const std::string& path() const { return flexPath; }
+    
+    // 读取全部已安装包; 数据库不可读或未启用 SQLite 支持时返回 false
+    bool readPackages(std::vector<FlexPackage>& packages) const;
+    
+    // 已安装包 name 的文件列表; 包不存在或数据库不可读时返回 false
+    bool readFiles(const std::string& name, std::vector<std::string>& files) const;
+    
+    static std::string flexFindDatabase();
+    
+private:
+    std::string flexPath;
+    
+    // 依次交出 Packages 表中的每个头部 blob
+    bool flexForEachHeader(const std::function<void(const unsigned char*, size_t)>& onHeader) const;
+};
+
+} // namespace FlexTools
+
+#endif // FLEX_RPM_DATABASE_H
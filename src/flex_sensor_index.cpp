@@ -0,0 +1,202 @@
+#include "flex_sensor_index.h"
+#include <dirent.h>
+#include <cstring>
+#include <set>
+
+namespace FlexTools {
+
+namespace {
+
+std::vector<std::string> flexListDirectory(const std::string& path) {
+    std::vector<std::string> names;
+    DIR* dir = opendir(path.c_str());
+    if (dir == nullptr) {
+        return names;
+    }
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        if (entry->d_name[0] != '.') {
+            names.emplace_back(entry->d_name);
+        }
+    }
+    closedir(dir);
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+// 读取短小的 sysfs 文本属性并去掉行尾换行
+std::string flexReadAttribute(const std::string& path) {
+    std::string content;
+    if (!flexReadWholeFile(path, content)) {
+        return "";
+    }
+    while (!content.empty() && (content.back() == '\n' || content.back() == ' ')) {
+        content.pop_back();
+    }
+    return content;
+}
+
+std::string flexReadText(const FlexProcFile& file) {
+    char buffer[256];
+    std::string_view content = file.flexRead(buffer, sizeof(buffer));
+    while (!content.empty() && (content.back() == '\n' || content.back() == ' ')) {
+        content.remove_suffix(1);
+    }
+    return std::string(content);
+}
+
+bool flexReadSigned(const FlexProcFile& file, long long& value) {
+    char buffer[32];
+    std::string_view content = file.flexRead(buffer, sizeof(buffer));
+    flexSkipSpaces(content);
+    bool negative = !content.empty() && content.front() == '-';
+    if (negative) {
+        content.remove_prefix(1);
+    }
+    uint64_t magnitude = 0;
+    if (!flexParseUnsigned(content, magnitude)) {
+        return false;
+    }
+    value = negative ? -static_cast<long long>(magnitude) : static_cast<long long>(magnitude);
+    return true;
+}
+
+// 匹配 "<prefix><N>_input" 形式的文件名, 返回通道前缀 (如 "temp1")
+bool flexMatchInput(const std::string& name, const char* prefix, std::string& channel) {
+    size_t prefixLen = std::strlen(prefix);
+    const std::string suffix = "_input";
+    if (name.size() <= prefixLen + suffix.size() || name.compare(0, prefixLen, prefix) != 0 ||
+        name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0) {
+        return false;
+    }
+    channel = name.substr(0, name.size() - suffix.size());
+    return true;
+}
+
+} // namespace
+
+FlexSensorIndex::FlexSensorIndex(const std::string& sysClassRoot) : flexRoot(sysClassRoot) {
+    flexScanHwmon();
+    flexScanThermal();
+    flexScanPowerSupply();
+}
+
+void FlexSensorIndex::flexAddEntry(FlexSensorType type, const std::string& label, const std::string& path,
+                                   double scale) {
+    FlexProcFile file(path);
+    if (!file.isOpen()) {
+        return;
+    }
+    flexEntries.push_back({type, label, std::move(file), scale});
+}
+
+void FlexSensorIndex::flexScanHwmon() {
+    std::string base = flexRoot + "/hwmon/";
+    // 同型号的多个芯片 (两块 NVMe、双路 coretemp) 标签相同, 重复时附上 hwmon 目录名
+    std::set<std::string> seen;
+    for (const auto& hwmon : flexListDirectory(base)) {
+        std::string dir = base + hwmon;
+        std::string chip = flexReadAttribute(dir + "/name");
+        if (chip.empty()) {
+            chip = hwmon;
+        }
+        
+        // 旧内核把属性放在 device/ 子目录下
+        for (const std::string& attrDir : {dir, dir + "/device"}) {
+            for (const auto& name : flexListDirectory(attrDir)) {
+                std::string channel;
+                FlexSensorType type;
+                double scale;
+                if (flexMatchInput(name, "temp", channel)) {
+                    type = FlexSensorType::TEMPERATURE;
+                    scale = 0.001; // 毫摄氏度
+                } else if (flexMatchInput(name, "fan", channel)) {
+                    type = FlexSensorType::FAN;
+                    scale = 1.0;
+                } else {
+                    continue;
+                }
+                
+                std::string label = flexReadAttribute(attrDir + "/" + channel + "_label");
+                label = chip + "/" + (label.empty() ? channel : label);
+                if (!seen.insert(label).second) {
+                    label += " (" + hwmon + ")";
+                }
+                flexAddEntry(type, label, attrDir + "/" + name, scale);
+            }
+        }
+    }
+}
+
+void FlexSensorIndex::flexScanThermal() {
+    std::string base = flexRoot + "/thermal/";
+    std::set<std::string> seen;
+    for (const auto& zone : flexListDirectory(base)) {
+        if (zone.compare(0, 12, "thermal_zone") != 0) {
+            continue;
+        }
+        std::string type = flexReadAttribute(base + zone + "/type");
+        std::string label = "thermal/" + (type.empty() ? zone : type);
+        if (!seen.insert(label).second) {
+            label += " (" + zone + ")";
+        }
+        flexAddEntry(FlexSensorType::TEMPERATURE, label, base + zone + "/temp", 0.001);
+    }
+}
+
+void FlexSensorIndex::flexScanPowerSupply() {
+    static const char* attributes[] = {
+        "status", "capacity", "capacity_level", "health", "technology",
+        "energy_now", "energy_full", "energy_full_design", "charge_now",
+        "charge_full", "charge_full_design", "power_now", "current_now",
+        "voltage_now", "cycle_count", "manufacturer", "model_name"
+    };
+    
+    std::string base = flexRoot + "/power_supply/";
+    for (const auto& supply : flexListDirectory(base)) {
+        if (flexReadAttribute(base + supply + "/type") != "Battery") {
+            continue;
+        }
+        for (const char* attribute : attributes) {
+            flexAddEntry(FlexSensorType::BATTERY, supply + "." + attribute,
+                         base + supply + "/" + attribute, 1.0);
+        }
+    }
+}
+
+std::map<std::string, double> FlexSensorIndex::readTemperatures() const {
+    std::map<std::string, double> temperatures;
+    for (const auto& entry : flexEntries) {
+        long long raw;
+        if (entry.type == FlexSensorType::TEMPERATURE && flexReadSigned(entry.file, raw)) {
+            temperatures[entry.label] = static_cast<double>(raw) * entry.scale;
+        }
+    }
+    return temperatures;
+}
+
+std::map<std::string, int> FlexSensorIndex::readFans() const {
+    std::map<std::string, int> fans;
+    for (const auto& entry : flexEntries) {
+        long long raw;
+        if (entry.type == FlexSensorType::FAN && flexReadSigned(entry.file, raw)) {
+            fans[entry.label] = static_cast<int>(static_cast<double>(raw) * entry.scale);
+        }
+    }
+    return fans;
+}
+
+std::map<std::string, std::string> FlexSensorIndex::readBattery() const {
+    std::map<std::string, std::string> battery;
+    for (const auto& entry : flexEntries) {
+        if (entry.type == FlexSensorType::BATTERY) {
+            std::string value = flexReadText(entry.file);
+            if (!value.empty()) {
+                battery[entry.label] = value;
+            }
+        }
+    }
+    return battery;
+}
+
+} // namespace FlexTools
@@ -0,0 +1,54 @@
+#ifndef FLEX_SENSOR_INDEX_H
+#define FLEX_SENSOR_INDEX_H
+
+#include "flex_common.h"
+#include "flex_proc_file.h"
+
+namespace FlexTools {
+
+// 传感器类别
+enum class FlexSensorType {
+    TEMPERATURE,
+    FAN,
+    BATTERY
+};
+
+// 索引中的一个传感器文件
+struct FlexSensorEntry {
+    FlexSensorType type;
+    std::string label;
+    FlexProcFile file;
+    double scale; // 原始读数换算系数 (如 毫摄氏度 -> 摄氏度)
+};
+
+// 一次性扫描 hwmon / thermal / power_supply 建立传感器文件索引,
+// 之后每次读取只对已打开的文件做 pread, 不再遍历目录树
+class FlexSensorIndex {
+public:
+    explicit FlexSensorIndex(const std::string& sysClassRoot = "/sys/class");
+    
+    // 温度 (°C), 键为 "芯片名/标签"
+    std::map<std::string, double> readTemperatures() const;
+    
+    // 风扇转速 (RPM)
+    std::map<std::string, int> readFans() const;
+    
+    // 电池属性, 键为 "电池名.属性"
+    std::map<std::string, std::string> readBattery() const;
+    
+    size_t size() const { return flexEntries.size(); }
+    
+private:
+    std::string flexRoot;
+    std::vector<FlexSensorEntry> flexEntries;
+    
+    void flexScanHwmon();
+    void flexScanThermal();
+    void flexScanPowerSupply();
+    void flexAddEntry(FlexSensorType type, const std::string& label, const std::string& path,
+                      double scale);
+};
+
+} // namespace FlexTools
+
+#endif // FLEX_SENSOR_INDEX_H
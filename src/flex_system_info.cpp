@@ -1,4 +1,5 @@
 #include "flex_system_info.h"
+#include "flex_cpu_topology.h"
 #include <sys/sysinfo.h>
 #include <pwd.h>
 #include <fstream>
@@ -21,6 +22,11 @@ std::map<std::string, std::string> FlexSystemInfo::getBasicInfo() const {
     return flexBasicInfoCache;
 }
 
+std::map<std::string, std::string> FlexSystemInfo::getDetailedInfo() const {
+    flexEnsureCache();
+    return flexDetailedInfoCache;
+}
+
 void FlexSystemInfo::flexEnsureCache() const {
     if (flexCacheValid) {
         return;
@@ -39,30 +45,15 @@ void FlexSystemInfo::flexEnsureCache() const {
     
     // 填充详细信息缓存
     flexDetailedInfoCache = flexBasicInfoCache;
-    flexDetailedInfoCache["Domain Name"] = flexUnameData.__domainname;
+    flexDetailedInfoCache["Domain Name"] = flexUnameData.domainname;
     
-    // 处理器信息
-    std::ifstream cpuinfo("/proc/cpuinfo");
-    if (cpuinfo.is_open()) {
-        std::string line;
-        int processorCount = 0;
-        std::string cpuModel;
-        while (std::getline(cpuinfo, line)) {
-            if (line.find("processor") != std::string::npos) {
-                processorCount++;
-            }
-            if (line.find("model name") != std::string::npos && cpuModel.empty()) {
-                size_t colonPos = line.find(':');
-                if (colonPos != std::string::npos) {
-                    cpuModel = line.substr(colonPos + 2);
-                }
-            }
-        }
-        flexDetailedInfoCache["Processor Count"] = std::to_string(processorCount);
-        if (!cpuModel.empty()) {
-            flexDetailedInfoCache["CPU Model"] = cpuModel;
-        }
-        cpuinfo.close();
+    // 处理器信息 (与硬件模块共享同一次 cpuinfo 解析结果)
+    const FlexCPUTopology& topology = flexGetCPUTopology();
+    flexDetailedInfoCache["Processor Count"] = std::to_string(topology.logicalCPUs);
+    flexDetailedInfoCache["Physical Cores"] = std::to_string(topology.physicalCores);
+    flexDetailedInfoCache["Sockets"] = std::to_string(topology.sockets);
+    if (!topology.model.empty()) {
+        flexDetailedInfoCache["CPU Model"] = topology.model;
     }
     
     // 内存信息
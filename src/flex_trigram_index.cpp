@@ -0,0 +1,294 @@
+#include "flex_trigram_index.h"
+#include <cctype>
+
+namespace FlexTools {
+
+namespace {
+
+// 模糊匹配的 Dice 系数下限
+constexpr double FLEX_FUZZY_THRESHOLD = 0.5;
+
+enum FlexMatchRank {
+    FLEX_MATCH_EXACT = 0,
+    FLEX_MATCH_PREFIX,
+    FLEX_MATCH_NAME,
+    FLEX_MATCH_PROVIDES,
+    FLEX_MATCH_DESCRIPTION,
+    FLEX_MATCH_FUZZY,
+    FLEX_MATCH_NONE
+};
+
+std::string flexLower(std::string_view text) {
+    std::string lower(text);
+    for (char& c : lower) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return lower;
+}
+
+// 取出文本中所有不同的 trigram (已小写), 按值排序
+std::vector<uint32_t> flexTrigrams(std::string_view text) {
+    std::vector<uint32_t> trigrams;
+    if (text.size() < 3) {
+        return trigrams;
+    }
+    trigrams.reserve(text.size() - 2);
+    for (size_t i = 0; i + 2 < text.size(); ++i) {
+        trigrams.push_back((static_cast<uint32_t>(static_cast<unsigned char>(text[i])) << 16) |
+                           (static_cast<uint32_t>(static_cast<unsigned char>(text[i + 1])) << 8) |
+                           static_cast<uint32_t>(static_cast<unsigned char>(text[i + 2])));
+    }
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+    return trigrams;
+}
+
+void flexPutVarint(std::vector<uint8_t>& out, uint32_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+uint32_t flexGetVarint(const uint8_t*& p) {
+    uint32_t value = 0;
+    int shift = 0;
+    while (*p & 0x80) {
+        value |= static_cast<uint32_t>(*p++ & 0x7f) << shift;
+        shift += 7;
+    }
+    value |= static_cast<uint32_t>(*p++) << shift;
+    return value;
+}
+
+} // namespace
+
+void FlexTrigramPostings::add(uint32_t trigram, uint32_t document) {
+    // 文档按编号递增加入, 每个列表天然有序
+    std::vector<uint32_t>& documents = flexPending[trigram];
+    if (documents.empty() || documents.back() != document) {
+        documents.push_back(document);
+    }
+}
+
+void FlexTrigramPostings::finalize() {
+    std::vector<uint32_t> keys;
+    keys.reserve(flexPending.size());
+    for (const auto& [trigram, documents] : flexPending) {
+        keys.push_back(trigram);
+    }
+    std::sort(keys.begin(), keys.end());
+    
+    flexEntries.clear();
+    flexEntries.reserve(keys.size());
+    flexBytes.clear();
+    
+    for (uint32_t trigram : keys) {
+        const std::vector<uint32_t>& documents = flexPending[trigram];
+        Entry entry{trigram, static_cast<uint32_t>(flexBytes.size()), static_cast<uint32_t>(documents.size())};
+        uint32_t previous = 0;
+        for (uint32_t document : documents) {
+            flexPutVarint(flexBytes, document - previous);
+            previous = document;
+        }
+        flexEntries.push_back(entry);
+    }
+    
+    std::unordered_map<uint32_t, std::vector<uint32_t>>().swap(flexPending);
+}
+
+const FlexTrigramPostings::Entry* FlexTrigramPostings::flexFind(uint32_t trigram) const {
+    auto it = std::lower_bound(flexEntries.begin(), flexEntries.end(), trigram,
+                               [](const Entry& entry, uint32_t value) { return entry.trigram < value; });
+    return (it != flexEntries.end() && it->trigram == trigram) ? &*it : nullptr;
+}
+
+void FlexTrigramPostings::flexDecode(const Entry& entry, std::vector<uint32_t>& out) const {
+    out.resize(entry.length);
+    const uint8_t* p = flexBytes.data() + entry.offset;
+    uint32_t document = 0;
+    for (uint32_t i = 0; i < entry.length; ++i) {
+        document += flexGetVarint(p);
+        out[i] = document;
+    }
+}
+
+std::vector<uint32_t> FlexTrigramPostings::intersect(const std::vector<uint32_t>& trigrams) const {
+    std::vector<const Entry*> lists;
+    lists.reserve(trigrams.size());
+    for (uint32_t trigram : trigrams) {
+        const Entry* entry = flexFind(trigram);
+        if (entry == nullptr) {
+            return {};
+        }
+        lists.push_back(entry);
+    }
+    if (lists.empty()) {
+        return {};
+    }
+    
+    // 从最短的表开始, 候选集只会越来越小
+    std::sort(lists.begin(), lists.end(),
+              [](const Entry* a, const Entry* b) { return a->length < b->length; });
+    
+    std::vector<uint32_t> result;
+    flexDecode(*lists.front(), result);
+    
+    for (size_t i = 1; i < lists.size() && !result.empty(); ++i) {
+        const uint8_t* p = flexBytes.data() + lists[i]->offset;
+        uint32_t length = lists[i]->length;
+        uint32_t consumed = 0;
+        uint32_t document = 0;
+        auto next = [&]() {
+            if (consumed == length) return false;
+            document += flexGetVarint(p);
+            ++consumed;
+            return true;
+        };
+        
+        bool valid = next();
+        size_t kept = 0;
+        for (uint32_t candidate : result) {
+            while (valid && document < candidate) {
+                valid = next();
+            }
+            if (!valid) break;
+            if (document == candidate) {
+                result[kept++] = candidate;
+            }
+        }
+        result.resize(kept);
+    }
+    return result;
+}
+
+void FlexTrigramPostings::count(const std::vector<uint32_t>& trigrams, std::vector<uint16_t>& hits,
+                                std::vector<uint32_t>& touched) const {
+    for (uint32_t trigram : trigrams) {
+        const Entry* entry = flexFind(trigram);
+        if (entry == nullptr) continue;
+        const uint8_t* p = flexBytes.data() + entry->offset;
+        uint32_t document = 0;
+        for (uint32_t i = 0; i < entry->length; ++i) {
+            document += flexGetVarint(p);
+            if (hits[document]++ == 0) {
+                touched.push_back(document);
+            }
+        }
+    }
+}
+
+FlexTrigramIndex::FlexTrigramIndex(const FlexPackageStore& packages) {
+    uint32_t count = static_cast<uint32_t>(packages.size());
+    flexNames.reserve(count);
+    flexProvides.reserve(count);
+    flexDescriptions.reserve(count);
+    flexNameTrigrams.reserve(count);
+    
+    for (uint32_t doc = 0; doc < count; ++doc) {
+        flexNames.push_back(flexLower(packages.name(doc)));
+        
+        std::string provides;
+        for (std::string_view provide : packages.relations(FlexRelationKind::PROVIDES, doc)) {
+            provides += flexLower(provide);
+            provides += '\n';
+        }
+        flexProvides.push_back(std::move(provides));
+        flexDescriptions.push_back(flexLower(packages.description(doc)));
+        
+        auto nameTrigrams = flexTrigrams(flexNames.back());
+        flexNameTrigrams.push_back(static_cast<uint16_t>(std::min<size_t>(nameTrigrams.size(), 0xffff)));
+        for (uint32_t trigram : nameTrigrams) {
+            flexNameIndex.add(trigram, doc);
+        }
+        for (uint32_t trigram : flexTrigrams(flexProvides.back())) {
+            flexTextIndex.add(trigram, doc);
+        }
+        for (uint32_t trigram : flexTrigrams(flexDescriptions.back())) {
+            flexTextIndex.add(trigram, doc);
+        }
+    }
+    
+    flexNameIndex.finalize();
+    flexTextIndex.finalize();
+}
+
+std::vector<uint32_t> FlexTrigramIndex::search(const std::string& keyword) const {
+    std::string query = flexLower(keyword);
+    if (query.empty()) {
+        return {};
+    }
+    
+    struct Match {
+        uint32_t document;
+        int rank;
+        double similarity;
+    };
+    std::vector<Match> matches;
+    
+    auto classify = [&](uint32_t doc) {
+        const std::string& name = flexNames[doc];
+        if (name == query) return FLEX_MATCH_EXACT;
+        if (name.compare(0, query.size(), query) == 0) return FLEX_MATCH_PREFIX;
+        if (name.find(query) != std::string::npos) return FLEX_MATCH_NAME;
+        if (flexProvides[doc].find(query) != std::string::npos) return FLEX_MATCH_PROVIDES;
+        if (flexDescriptions[doc].find(query) != std::string::npos) return FLEX_MATCH_DESCRIPTION;
+        return FLEX_MATCH_NONE;
+    };
+    
+    std::vector<uint32_t> trigrams = flexTrigrams(query);
+    std::vector<uint8_t> matched(flexNames.size(), 0);
+    
+    if (trigrams.empty()) {
+        // 少于三个字符无法用 trigram 过滤, 直接逐个比较
+        for (uint32_t doc = 0; doc < flexNames.size(); ++doc) {
+            int rank = classify(doc);
+            if (rank != FLEX_MATCH_NONE) {
+                matches.push_back(Match{doc, rank, 1.0});
+            }
+        }
+    } else {
+        // 交集只是候选, 还需逐个确认子串
+        for (const FlexTrigramPostings* postings : {&flexNameIndex, &flexTextIndex}) {
+            for (uint32_t doc : postings->intersect(trigrams)) {
+                if (matched[doc]) continue;
+                int rank = classify(doc);
+                if (rank != FLEX_MATCH_NONE) {
+                    matched[doc] = 1;
+                    matches.push_back(Match{doc, rank, 1.0});
+                }
+            }
+        }
+        
+        // 模糊匹配: 包名与查询的 trigram Dice 系数
+        std::vector<uint16_t> hits(flexNames.size(), 0);
+        std::vector<uint32_t> touched;
+        flexNameIndex.count(trigrams, hits, touched);
+        for (uint32_t doc : touched) {
+            if (matched[doc]) continue;
+            double similarity = 2.0 * hits[doc] / (trigrams.size() + flexNameTrigrams[doc]);
+            if (similarity >= FLEX_FUZZY_THRESHOLD) {
+                matches.push_back(Match{doc, FLEX_MATCH_FUZZY, similarity});
+            }
+        }
+    }
+    
+    std::sort(matches.begin(), matches.end(), [this](const Match& a, const Match& b) {
+        if (a.rank != b.rank) return a.rank < b.rank;
+        if (a.similarity != b.similarity) return a.similarity > b.similarity;
+        if (flexNames[a.document].size() != flexNames[b.document].size()) {
+            return flexNames[a.document].size() < flexNames[b.document].size();
+        }
+        return flexNames[a.document] < flexNames[b.document];
+    });
+    
+    std::vector<uint32_t> result;
+    result.reserve(matches.size());
+    for (const auto& match : matches) {
+        result.push_back(match.document);
+    }
+    return result;
+}
+
+} // namespace FlexTools
@@ -0,0 +1,60 @@
+#ifndef FLEX_TRIGRAM_INDEX_H
+#define FLEX_TRIGRAM_INDEX_H
+
+#include "flex_common.h"
+#include "flex_package_store.h"
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+
+namespace FlexTools {
+
+// 三元组倒排表: 每个 trigram 对应一段按文档号升序、差分 varint 编码的字节序列
+class FlexTrigramPostings {
+public:
+    void add(uint32_t trigram, uint32_t document);
+    void finalize();
+    
+    // 所有 trigram 均出现的文档 (交集)
+    std::vector<uint32_t> intersect(const std::vector<uint32_t>& trigrams) const;
+    
+    // 统计每个文档命中的 trigram 数, 追加首次命中的文档到 touched
+    void count(const std::vector<uint32_t>& trigrams, std::vector<uint16_t>& hits,
+               std::vector<uint32_t>& touched) const;
+    
+private:
+    struct Entry {
+        uint32_t trigram;
+        uint32_t offset;
+        uint32_t length; // 文档数
+    };
+    
+    std::unordered_map<uint32_t, std::vector<uint32_t>> flexPending; // 构建期 trigram -> 文档
+    std::vector<Entry> flexEntries; // 按 trigram 排序
+    std::vector<uint8_t> flexBytes;
+    
+    const Entry* flexFind(uint32_t trigram) const;
+    void flexDecode(const Entry& entry, std::vector<uint32_t>& out) const;
+};
+
+// searchPackages 使用的索引: 包名与 provides+描述分开建表, 结果按
+// 完全匹配 > 前缀 > 名称子串 > provides > 描述 > 模糊 排序
+class FlexTrigramIndex {
+public:
+    explicit FlexTrigramIndex(const FlexPackageStore& packages);
+    
+    // 返回排序后的包下标
+    std::vector<uint32_t> search(const std::string& keyword) const;
+    
+private:
+    std::vector<std::string> flexNames;        // 小写包名
+    std::vector<std::string> flexProvides;     // 小写 provides, '\n' 分隔
+    std::vector<std::string> flexDescriptions; // 小写描述
+    std::vector<uint16_t> flexNameTrigrams;    // 包名中不同 trigram 的数量
+    FlexTrigramPostings flexNameIndex;
+    FlexTrigramPostings flexTextIndex;
+};
+
+} // namespace FlexTools
+
+#endif // FLEX_TRIGRAM_INDEX_H
@@ -0,0 +1,188 @@
+#include "flex_watch_monitor.h"
+#include "flex_hardware_info.h"
+#include <csignal>
+#include <cstdio>
+#include <cerrno>
+#include <ctime>
+
+namespace FlexTools {
+
+namespace {
+
+volatile std::sig_atomic_t flexWatchStopRequested = 0;
+
+void flexWatchSignalHandler(int) {
+    flexWatchStopRequested = 1;
+}
+
+// 在 meminfo 内容中查找 "Key:" 对应的数值 (KB)
+bool flexFindMeminfoValue(std::string_view content, std::string_view key, uint64_t& value) {
+    size_t pos = 0;
+    while (pos < content.size()) {
+        if (content.compare(pos, key.size(), key) == 0 &&
+            pos + key.size() < content.size() && content[pos + key.size()] == ':') {
+            std::string_view rest = content.substr(pos + key.size() + 1);
+            flexSkipSpaces(rest);
+            return flexParseUnsigned(rest, value);
+        }
+        size_t eol = content.find('\n', pos);
+        if (eol == std::string_view::npos) break;
+        pos = eol + 1;
+    }
+    return false;
+}
+
+double flexSecondsBetween(const struct timespec& from, const struct timespec& to) {
+    return static_cast<double>(to.tv_sec - from.tv_sec) +
+           static_cast<double>(to.tv_nsec - from.tv_nsec) / 1e9;
+}
+
+void flexAddSeconds(struct timespec& ts, double seconds) {
+    long long nanos = static_cast<long long>(seconds * 1e9);
+    ts.tv_sec += static_cast<time_t>(nanos / 1000000000LL);
+    ts.tv_nsec += static_cast<long>(nanos % 1000000000LL);
+    if (ts.tv_nsec >= 1000000000L) {
+        ts.tv_sec += 1;
+        ts.tv_nsec -= 1000000000L;
+    }
+}
+
+} // namespace
+
+FlexWatchMonitor::FlexWatchMonitor(double intervalSeconds, bool perCore)
+    : flexInterval(intervalSeconds > 0.0 ? intervalSeconds : 1.0),
+      flexPerCore(perCore),
+      flexMeminfoFile("/proc/meminfo") {
+    // 网卡列表只在启动时获取一次, 之后保持统计文件打开
+    FlexHardwareInfo hwInfo;
+    for (const auto& ni : hwInfo.getNetworkInfo()) {
+        FlexInterfaceCounters counters;
+        counters.name = ni.name;
+        std::string base = "/sys/class/net/" + ni.name + "/statistics/";
+        counters.rxFile = FlexProcFile(base + "rx_bytes");
+        counters.txFile = FlexProcFile(base + "tx_bytes");
+        counters.rxBytes = static_cast<uint64_t>(ni.rxBytes);
+        counters.txBytes = static_cast<uint64_t>(ni.txBytes);
+        if (counters.rxFile.isOpen() && counters.txFile.isOpen()) {
+            flexInterfaces.push_back(std::move(counters));
+        }
+    }
+}
+
+bool FlexWatchMonitor::flexSampleMemory(FlexMemorySample& sample) const {
+    char buffer[8192];
+    std::string_view content = flexMeminfoFile.flexRead(buffer, sizeof(buffer));
+    uint64_t swapTotal = 0;
+    uint64_t swapFree = 0;
+    
+    bool ok = flexFindMeminfoValue(content, "MemTotal", sample.total) &&
+              flexFindMeminfoValue(content, "MemAvailable", sample.available);
+    flexFindMeminfoValue(content, "Cached", sample.cached);
+    flexFindMeminfoValue(content, "SwapTotal", swapTotal);
+    flexFindMeminfoValue(content, "SwapFree", swapFree);
+    sample.swapUsed = swapTotal > swapFree ? swapTotal - swapFree : 0;
+    return ok;
+}
+
+void FlexWatchMonitor::run(std::ostream& out) {
+    flexWatchStopRequested = 0;
+    struct sigaction action = {};
+    action.sa_handler = flexWatchSignalHandler;
+    sigemptyset(&action.sa_mask);
+    struct sigaction oldInt, oldTerm;
+    sigaction(SIGINT, &action, &oldInt);
+    sigaction(SIGTERM, &action, &oldTerm);
+    
+    FlexMemorySample lastMemory;
+    flexCPUSampler.sample();
+    flexSampleMemory(lastMemory);
+    for (auto& ni : flexInterfaces) {
+        ni.rxFile.flexReadUnsigned(ni.rxBytes);
+        ni.txFile.flexReadUnsigned(ni.txBytes);
+    }
+    
+    struct timespec lastTime, nextTick;
+    clock_gettime(CLOCK_MONOTONIC, &lastTime);
+    nextTick = lastTime;
+    
+    char line[512];
+    while (!flexWatchStopRequested) {
+        flexAddSeconds(nextTick, flexInterval);
+        int rc;
+        do {
+            rc = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &nextTick, nullptr);
+        } while (rc == EINTR && !flexWatchStopRequested);
+        if (flexWatchStopRequested) {
+            break;
+        }
+        
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        double elapsed = flexSecondsBetween(lastTime, now);
+        if (elapsed <= 0.0) {
+            elapsed = flexInterval;
+        }
+        lastTime = now;
+        
+        // CPU 使用率
+        double cpuPercent = 0.0;
+        if (flexCPUSampler.sample() && flexCPUSampler.hasUsage()) {
+            cpuPercent = flexCPUSampler.usage().totalBusy;
+        }
+        
+        // 内存与增量
+        FlexMemorySample memory;
+        flexSampleMemory(memory);
+        double usedMB = static_cast<double>(memory.total - memory.available) / 1024.0;
+        double usedDeltaMB = usedMB - static_cast<double>(lastMemory.total - lastMemory.available) / 1024.0;
+        double cachedDeltaMB = (static_cast<double>(memory.cached) - static_cast<double>(lastMemory.cached)) / 1024.0;
+        double swapDeltaMB = (static_cast<double>(memory.swapUsed) - static_cast<double>(lastMemory.swapUsed)) / 1024.0;
+        lastMemory = memory;
+        
+        time_t wallClock = time(nullptr);
+        struct tm local;
+        localtime_r(&wallClock, &local);
+        char stamp[16];
+        strftime(stamp, sizeof(stamp), "%H:%M:%S", &local);
+        
+        int len = std::snprintf(line, sizeof(line),
+                                "[%s] cpu %5.1f%%  mem used %.1f MB (%+.1f MB)  cached %+.1f MB  swap %+.1f MB\n",
+                                stamp, cpuPercent, usedMB, usedDeltaMB, cachedDeltaMB, swapDeltaMB);
+        out.write(line, std::min<int>(len, sizeof(line) - 1));
+        
+        // 每核使用率与频率
+        if (flexPerCore && flexCPUSampler.hasUsage()) {
+            const FlexCPUUsage& usage = flexCPUSampler.usage();
+            const std::vector<double>& freqs = flexCPUSampler.frequencies();
+            for (size_t i = 0; i < flexCPUSampler.coreCount(); ++i) {
+                len = std::snprintf(line, sizeof(line),
+                                    "    cpu%-4d usr %5.1f%%  sys %5.1f%%  iowait %5.1f%%  steal %5.1f%%  %7.0f MHz\n",
+                                    flexCPUSampler.cpuIds()[i], usage.user[i], usage.system[i],
+                                    usage.iowait[i], usage.steal[i], freqs[i]);
+                out.write(line, std::min<int>(len, sizeof(line) - 1));
+            }
+        }
+        
+        // 网卡速率
+        for (auto& ni : flexInterfaces) {
+            uint64_t rx = ni.rxBytes;
+            uint64_t tx = ni.txBytes;
+            ni.rxFile.flexReadUnsigned(rx);
+            ni.txFile.flexReadUnsigned(tx);
+            double rxRate = rx >= ni.rxBytes ? static_cast<double>(rx - ni.rxBytes) / elapsed : 0.0;
+            double txRate = tx >= ni.txBytes ? static_cast<double>(tx - ni.txBytes) / elapsed : 0.0;
+            ni.rxBytes = rx;
+            ni.txBytes = tx;
+            
+            len = std::snprintf(line, sizeof(line), "    %-16s rx %10.1f KB/s  tx %10.1f KB/s\n",
+                                ni.name.c_str(), rxRate / 1024.0, txRate / 1024.0);
+            out.write(line, std::min<int>(len, sizeof(line) - 1));
+        }
+        out.flush();
+    }
+    
+    sigaction(SIGINT, &oldInt, nullptr);
+    sigaction(SIGTERM, &oldTerm, nullptr);
+}
+
+} // namespace FlexTools
@@ -0,0 +1,47 @@
+#ifndef FLEX_WATCH_MONITOR_H
+#define FLEX_WATCH_MONITOR_H
+
+#include "flex_common.h"
+#include "flex_proc_file.h"
+#include "flex_cpu_sampler.h"
+#include <cstdint>
+
+namespace FlexTools {
+
+// 持续监控模式: 启动时打开 /proc/stat、/proc/meminfo 与各网卡统计文件,
+// 之后每个周期只做 pread 与增量计算, 稳态下不分配内存、不 fork
+class FlexWatchMonitor {
+public:
+    explicit FlexWatchMonitor(double intervalSeconds, bool perCore = false);
+    
+    // 运行直到收到 SIGINT/SIGTERM
+    void run(std::ostream& out);
+    
+private:
+    struct FlexMemorySample {
+        uint64_t total = 0;     // KB
+        uint64_t available = 0; // KB
+        uint64_t cached = 0;    // KB
+        uint64_t swapUsed = 0;  // KB
+    };
+    
+    struct FlexInterfaceCounters {
+        std::string name;
+        FlexProcFile rxFile;
+        FlexProcFile txFile;
+        uint64_t rxBytes = 0;
+        uint64_t txBytes = 0;
+    };
+    
+    double flexInterval;
+    bool flexPerCore;
+    FlexCPUSampler flexCPUSampler;
+    FlexProcFile flexMeminfoFile;
+    std::vector<FlexInterfaceCounters> flexInterfaces;
+    
+    bool flexSampleMemory(FlexMemorySample& sample) const;
+};
+
+} // namespace FlexTools
+
+#endif // FLEX_WATCH_MONITOR_H
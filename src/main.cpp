@@ -1,11 +1,23 @@
 #include "flex_system_info.h"
 #include "flex_hardware_info.h"
 #include "flex_package_info.h"
+#include "flex_watch_monitor.h"
+#include "flex_install_history.h"
+#include "flex_package_verifier.h"
+#include "flex_log_collector.h"
+#include "flex_journal_reader.h"
+#include "flex_log_follower.h"
+#include "flex_log_search.h"
+#include "flex_log_templates.h"
+#include "flex_log_bursts.h"
+#include "flex_compressed_file.h"
 #include <iostream>
 #include <string>
 #include <cstdlib>
 #include <getopt.h>
 #include <memory>
+#include <limits>
+#include <cstring>
 
 using namespace FlexTools;
 
@@ -18,9 +30,28 @@ void printFlexToolsUsage(const char* programName) {
     std::cout << "  -h, --hardware      Display hardware information" << std::endl;
     std::cout << "  -p, --packages      Display installed packages" << std::endl;
     std::cout << "  -l, --logs          Collect and display system logs" << std::endl;
+    std::cout << "  --follow            With --logs: print lines as they are appended (like tail -F)" << std::endl;
+    std::cout << "  --log-since DATE    With --logs: only lines at or after DATE (YYYY-MM-DD [HH:MM[:SS]])" << std::endl;
+    std::cout << "  --log-until DATE    With --logs: only lines at or before DATE" << std::endl;
+    std::cout << "  --search[=FILE]     With --logs: count lines matching built-in or FILE patterns (name<TAB>regex)" << std::endl;
+    std::cout << "  --templates         With --logs: collapse lines into templates with counts and first/last time" << std::endl;
+    std::cout << "  --bursts            With --logs: top log sources and sudden bursts per identifier and level" << std::endl;
+    std::cout << "  --journal           Read systemd journal files directly (no journalctl)" << std::endl;
+    std::cout << "  --unit UNIT         Only journal entries of UNIT (repeatable, implies --journal)" << std::endl;
+    std::cout << "  --priority LEVEL    Only journal entries at LEVEL or more severe (0-7 or emerg..debug)" << std::endl;
     std::cout << "  -a, --all           Display all information" << std::endl;
     std::cout << "  -o, --output FILE   Export output to file" << std::endl;
     std::cout << "  -f, --format FORMAT Output format (text, json, csv)" << std::endl;
+    std::cout << "  -w, --watch SECONDS Continuously print CPU/memory/network rates" << std::endl;
+    std::cout << "  --updates           List upgradable packages from local apt/dnf metadata (offline)" << std::endl;
+    std::cout << "  --history[=PKG]     Show package install/upgrade/remove history" << std::endl;
+    std::cout << "  --since DATE        Only history events at or after DATE (YYYY-MM-DD[ HH:MM[:SS]])" << std::endl;
+    std::cout << "  --until DATE        Only history events before DATE" << std::endl;
+    std::cout << "  --owner PATH        Show which package owns PATH (repeatable, '-' reads stdin)" << std::endl;
+    std::cout << "  --depends PKG       Show the full transitive dependency closure of PKG" << std::endl;
+    std::cout << "  --rdepends PKG      Show every package that (transitively) depends on PKG" << std::endl;
+    std::cout << "  --impact PKG        Show packages broken by removing PKG (repeatable)" << std::endl;
+    std::cout << "  --verify[=PKG]      Check installed files against package checksums (repeatable; exit 1 on problems)" << std::endl;
     std::cout << "  -v, --verbose       Verbose output" << std::endl;
     std::cout << "  -q, --quiet         Quiet mode (minimal output)" << std::endl;
     std::cout << "  --version           Display version information" << std::endl;
@@ -29,7 +60,18 @@ void printFlexToolsUsage(const char* programName) {
     std::cout << "  " << programName << " --system --hardware" << std::endl;
     std::cout << "  " << programName << " --packages --format json" << std::endl;
     std::cout << "  " << programName << " --logs --output system_logs.txt" << std::endl;
+    std::cout << "  " << programName << " --logs --follow" << std::endl;
+    std::cout << "  " << programName << " --log-since \"2026-10-17 14:02\" --log-until \"2026-10-17 14:10\"" << std::endl;
+    std::cout << "  " << programName << " --search=patterns.txt --format json" << std::endl;
+    std::cout << "  " << programName << " --templates --bursts" << std::endl;
+    std::cout << "  " << programName << " --bursts --format csv" << std::endl;
+    std::cout << "  " << programName << " --journal --unit ssh --priority warning" << std::endl;
     std::cout << "  " << programName << " --all --format csv --output report.csv" << std::endl;
+    std::cout << "  " << programName << " --watch 1" << std::endl;
+    std::cout << "  " << programName << " --owner /usr/bin/ls --owner /etc/passwd" << std::endl;
+    std::cout << "  " << programName << " --impact libssl3 --format json" << std::endl;
+    std::cout << "  " << programName << " --history --since 2024-05-01 --until 2024-05-02" << std::endl;
+    std::cout << "  " << programName << " --verify=openssh-server --verify=sudo" << std::endl;
 }
 
 void printFlexToolsVersion() {
@@ -49,15 +91,164 @@ void printFlexToolsBanner() {
 )" << FLEX_COLOR_RESET << std::endl;
 }
 
+// 依赖查询结果: 包名列表
+void printFlexPackageList(const std::string& query, const std::string& subject,
+                          const std::vector<std::string>& names, FlexOutputFormat format) {
+    if (format == FlexOutputFormat::JSON) {
+        std::cout << "{\n  \"flex_dependency_query\": {\n";
+        std::cout << "    \"query\": \"" << query << "\",\n";
+        std::cout << "    \"package\": \"" << flexEscapeJSON(subject) << "\",\n";
+        std::cout << "    \"count\": " << names.size() << ",\n";
+        std::cout << "    \"packages\": [";
+        for (size_t i = 0; i < names.size(); ++i) {
+            std::cout << (i ? ", " : "") << "\"" << flexEscapeJSON(names[i]) << "\"";
+        }
+        std::cout << "]\n  }\n}" << std::endl;
+    } else if (format == FlexOutputFormat::CSV) {
+        std::cout << "Query,Package,Result" << std::endl;
+        for (const auto& name : names) {
+            std::cout << query << "," << flexEscapeCSV(subject) << "," << flexEscapeCSV(name) << std::endl;
+        }
+    } else {
+        std::cout << FLEX_COLOR_CYAN << "\n=== " << query << ": " << subject << " (" << names.size()
+                  << " packages) ===" << FLEX_COLOR_RESET << std::endl;
+        for (const auto& name : names) {
+            std::cout << "  " << name << std::endl;
+        }
+    }
+}
+
+// 解析本地时间 "YYYY-MM-DD[ HH:MM[:SS]]"
+bool parseFlexDate(const char* text, time_t& out) {
+    // %n 记录各形式结束处的位置, 必须恰好消耗整个字符串, 不接受 "2024-05-01garbage"
+    struct tm tm = {};
+    int dateEnd = -1, minuteEnd = -1, secondEnd = -1;
+    int parsed = std::sscanf(text, "%d-%d-%d%n %d:%d%n:%d%n", &tm.tm_year, &tm.tm_mon, &tm.tm_mday, &dateEnd,
+                             &tm.tm_hour, &tm.tm_min, &minuteEnd, &tm.tm_sec, &secondEnd);
+    int length = static_cast<int>(std::strlen(text));
+    if (!((parsed == 3 && dateEnd == length) || (parsed == 5 && minuteEnd == length) ||
+          (parsed == 6 && secondEnd == length))) {
+        return false;
+    }
+    tm.tm_year -= 1900;
+    tm.tm_mon -= 1;
+    tm.tm_isdst = -1;
+    out = mktime(&tm);
+    return out != static_cast<time_t>(-1);
+}
+
+void printFlexHistory(const std::vector<FlexPackageEvent>& events, FlexOutputFormat format) {
+    if (format == FlexOutputFormat::JSON) {
+        std::cout << "{\n  \"flex_package_history\": {\n    \"total\": " << events.size() << ",\n    \"events\": [";
+        for (size_t i = 0; i < events.size(); ++i) {
+            const auto& event = events[i];
+            std::cout << (i ? ",\n" : "\n") << "      {\"time\": \"" << flexFormatTime(event.timestamp)
+                      << "\", \"timestamp\": " << event.timestamp
+                      << ", \"action\": \"" << flexPackageActionName(event.action)
+                      << "\", \"package\": \"" << flexEscapeJSON(event.package)
+                      << "\", \"architecture\": \"" << flexEscapeJSON(event.architecture)
+                      << "\", \"old_version\": \"" << flexEscapeJSON(event.oldVersion)
+                      << "\", \"new_version\": \"" << flexEscapeJSON(event.newVersion)
+                      << "\", \"source\": \"" << flexEscapeJSON(event.source) << "\"}";
+        }
+        std::cout << "\n    ]\n  }\n}" << std::endl;
+    } else if (format == FlexOutputFormat::CSV) {
+        std::cout << "Time,Action,Package,Architecture,Old Version,New Version,Source" << std::endl;
+        for (const auto& event : events) {
+            std::cout << flexFormatTime(event.timestamp) << "," << flexPackageActionName(event.action) << ","
+                      << flexEscapeCSV(event.package) << "," << flexEscapeCSV(event.architecture) << ","
+                      << flexEscapeCSV(event.oldVersion) << "," << flexEscapeCSV(event.newVersion) << ","
+                      << flexEscapeCSV(event.source) << std::endl;
+        }
+    } else {
+        std::cout << FLEX_COLOR_CYAN << "\n=== FlexTools Package History ===" << FLEX_COLOR_RESET << std::endl;
+        for (const auto& event : events) {
+            std::cout << flexFormatTime(event.timestamp) << "  " << std::left << std::setw(10)
+                      << flexPackageActionName(event.action) << std::setw(36)
+                      << (event.package + (event.architecture.empty() ? "" : ":" + event.architecture))
+                      << (event.oldVersion.empty() ? "" : event.oldVersion + " -> ")
+                      << event.newVersion << std::endl;
+        }
+        std::cout << FLEX_COLOR_GREEN << "\nTotal: " << events.size() << " events" << FLEX_COLOR_RESET << std::endl;
+    }
+}
+
+void printFlexVerifyReport(const FlexVerifyReport& report, FlexOutputFormat format) {
+    if (format == FlexOutputFormat::JSON) {
+        std::cout << "{\n  \"flex_package_verify\": {\n    \"packages\": " << report.packages
+                  << ",\n    \"files\": " << report.files << ",\n    \"hashed\": " << report.hashed
+                  << ",\n    \"cached\": " << report.cached << ",\n    \"bytes_hashed\": " << report.bytesHashed
+                  << ",\n    \"issues\": [";
+        for (size_t i = 0; i < report.issues.size(); ++i) {
+            const auto& issue = report.issues[i];
+            std::cout << (i ? ",\n" : "\n") << "      {\"package\": \"" << flexEscapeJSON(issue.package)
+                      << "\", \"path\": \"" << flexEscapeJSON(issue.path)
+                      << "\", \"status\": \"" << flexVerifyStatusName(issue.status) << "\"}";
+        }
+        std::cout << "\n    ]\n  }\n}" << std::endl;
+    } else if (format == FlexOutputFormat::CSV) {
+        std::cout << "Package,Path,Status" << std::endl;
+        for (const auto& issue : report.issues) {
+            std::cout << flexEscapeCSV(issue.package) << "," << flexEscapeCSV(issue.path) << ","
+                      << flexVerifyStatusName(issue.status) << std::endl;
+        }
+    } else {
+        // 与 dpkg --verify 相同的标记: "??5??????" 为内容不符
+        std::cout << FLEX_COLOR_CYAN << "\n=== FlexTools Package Verification ===" << FLEX_COLOR_RESET << std::endl;
+        std::string current;
+        for (const auto& issue : report.issues) {
+            if (issue.package != current) {
+                current = issue.package;
+                std::cout << FLEX_COLOR_YELLOW << current << FLEX_COLOR_RESET << std::endl;
+            }
+            const char* mark = issue.status == FlexVerifyStatus::MODIFIED ? "??5??????" :
+                               issue.status == FlexVerifyStatus::MISSING ? "missing  " : "?????????";
+            std::cout << "  " << mark << "   " << issue.path << std::endl;
+        }
+        std::cout << FLEX_COLOR_GREEN << "\nChecked " << report.files << " files in " << report.packages
+                  << " packages (" << report.hashed << " hashed, " << report.cached << " unchanged since last run), "
+                  << report.issues.size() << " problems" << FLEX_COLOR_RESET << std::endl;
+    }
+}
+
+// 分析阶段的报告里没有文件表, 读不了的文件提示到 stderr
+void printFlexLogErrors(const FlexLogCollector& collector) {
+    for (const auto& error : collector.errors()) {
+        std::cerr << FLEX_COLOR_YELLOW << "Warning: " << error << FLEX_COLOR_RESET << std::endl;
+    }
+}
+
 int main(int argc, char* argv[]) {
     bool showSystem = false;
     bool showHardware = false;
     bool showPackages = false;
     bool showLogs = false;
+    bool followLogs = false;
+    bool logRange = false;
+    time_t logSince = 0;
+    time_t logUntil = std::numeric_limits<time_t>::max();
+    bool searchLogs = false;
+    std::string searchPatterns;
+    bool mineTemplates = false;
+    bool detectBursts = false;
+    bool showJournal = false;
+    FlexJournalFilter journalFilter;
     bool showAll = false;
     bool verbose = false;
     bool quiet = false;
     bool showVersion = false;
+    double watchInterval = 0.0;
+    bool showUpdates = false;
+    bool showHistory = false;
+    std::string historyPackage;
+    time_t historySince = 0;
+    time_t historyUntil = std::numeric_limits<time_t>::max();
+    std::vector<std::string> ownerPaths;
+    std::string dependsPackage;
+    std::string rdependsPackage;
+    std::vector<std::string> impactPackages;
+    bool verifyPackages = false;
+    std::vector<std::string> verifyNames;
     std::string outputFile;
     FlexOutputFormat format = FlexOutputFormat::TEXT;
     
@@ -67,11 +258,30 @@ int main(int argc, char* argv[]) {
         {"hardware", no_argument, 0, 'h'},
         {"packages", no_argument, 0, 'p'},
         {"logs", no_argument, 0, 'l'},
+        {"follow", no_argument, 0, 0},
+        {"log-since", required_argument, 0, 0},
+        {"log-until", required_argument, 0, 0},
+        {"search", optional_argument, 0, 0},
+        {"templates", no_argument, 0, 0},
+        {"bursts", no_argument, 0, 0},
+        {"journal", no_argument, 0, 0},
+        {"unit", required_argument, 0, 0},
+        {"priority", required_argument, 0, 0},
         {"all", no_argument, 0, 'a'},
         {"output", required_argument, 0, 'o'},
         {"format", required_argument, 0, 'f'},
+        {"watch", required_argument, 0, 'w'},
         {"verbose", no_argument, 0, 'v'},
         {"quiet", no_argument, 0, 'q'},
+        {"updates", no_argument, 0, 0},
+        {"history", optional_argument, 0, 0},
+        {"since", required_argument, 0, 0},
+        {"until", required_argument, 0, 0},
+        {"owner", required_argument, 0, 0},
+        {"depends", required_argument, 0, 0},
+        {"rdepends", required_argument, 0, 0},
+        {"impact", required_argument, 0, 0},
+        {"verify", optional_argument, 0, 0},
         {"version", no_argument, 0, 0},
         {"help", no_argument, 0, 0},
         {0, 0, 0, 0}
@@ -80,7 +290,7 @@ int main(int argc, char* argv[]) {
     int opt;
     int option_index = 0;
     
-    while ((opt = getopt_long(argc, argv, "shpla:o:f:vq", 
+    while ((opt = getopt_long(argc, argv, "shplao:f:w:vq", 
                               long_options, &option_index)) != -1) {
         switch (opt) {
             case 's':
@@ -112,6 +322,14 @@ int main(int argc, char* argv[]) {
                     format = FlexOutputFormat::TEXT;
                 }
                 break;
+            case 'w':
+                watchInterval = std::atof(optarg);
+                if (watchInterval <= 0.0) {
+                    std::cerr << FLEX_COLOR_RED << "Error: Invalid watch interval: " 
+                              << optarg << FLEX_COLOR_RESET << std::endl;
+                    return 1;
+                }
+                break;
             case 'v':
                 verbose = true;
                 break;
@@ -125,6 +343,74 @@ int main(int argc, char* argv[]) {
                 } else if (long_options[option_index].name == std::string("version")) {
                     printFlexToolsVersion();
                     return 0;
+                } else if (long_options[option_index].name == std::string("follow")) {
+                    followLogs = true;
+                    showLogs = true;
+                } else if (long_options[option_index].name == std::string("log-since") ||
+                           long_options[option_index].name == std::string("log-until")) {
+                    bool since = long_options[option_index].name == std::string("log-since");
+                    if (!parseFlexDate(optarg, since ? logSince : logUntil)) {
+                        std::cerr << FLEX_COLOR_RED << "Error: Invalid date: " << optarg
+                                  << FLEX_COLOR_RESET << std::endl;
+                        return 1;
+                    }
+                    logRange = true;
+                    showLogs = true;
+                } else if (long_options[option_index].name == std::string("search")) {
+                    searchLogs = true;
+                    showLogs = true;
+                    if (optarg) searchPatterns = optarg;
+                } else if (long_options[option_index].name == std::string("templates")) {
+                    mineTemplates = true;
+                    showLogs = true;
+                } else if (long_options[option_index].name == std::string("bursts")) {
+                    detectBursts = true;
+                    showLogs = true;
+                } else if (long_options[option_index].name == std::string("journal")) {
+                    showJournal = true;
+                } else if (long_options[option_index].name == std::string("unit")) {
+                    journalFilter.units.push_back(optarg);
+                    showJournal = true;
+                } else if (long_options[option_index].name == std::string("priority")) {
+                    journalFilter.maxPriority = flexParseJournalPriority(optarg);
+                    if (journalFilter.maxPriority < 0) {
+                        std::cerr << FLEX_COLOR_RED << "Error: Invalid priority: " << optarg
+                                  << FLEX_COLOR_RESET << std::endl;
+                        return 1;
+                    }
+                    showJournal = true;
+                } else if (long_options[option_index].name == std::string("updates")) {
+                    showUpdates = true;
+                } else if (long_options[option_index].name == std::string("history")) {
+                    showHistory = true;
+                    if (optarg != nullptr) historyPackage = optarg;
+                } else if (long_options[option_index].name == std::string("since") ||
+                           long_options[option_index].name == std::string("until")) {
+                    bool since = long_options[option_index].name == std::string("since");
+                    if (!parseFlexDate(optarg, since ? historySince : historyUntil)) {
+                        std::cerr << FLEX_COLOR_RED << "Error: Invalid date: " << optarg
+                                  << FLEX_COLOR_RESET << std::endl;
+                        return 1;
+                    }
+                    showHistory = true;
+                } else if (long_options[option_index].name == std::string("owner")) {
+                    if (std::string(optarg) == "-") {
+                        std::string line;
+                        while (std::getline(std::cin, line)) {
+                            if (!line.empty()) ownerPaths.push_back(line);
+                        }
+                    } else {
+                        ownerPaths.push_back(optarg);
+                    }
+                } else if (long_options[option_index].name == std::string("depends")) {
+                    dependsPackage = optarg;
+                } else if (long_options[option_index].name == std::string("rdepends")) {
+                    rdependsPackage = optarg;
+                } else if (long_options[option_index].name == std::string("impact")) {
+                    impactPackages.push_back(optarg);
+                } else if (long_options[option_index].name == std::string("verify")) {
+                    verifyPackages = true;
+                    if (optarg != nullptr) verifyNames.push_back(optarg);
                 }
                 break;
             default:
@@ -134,7 +420,9 @@ int main(int argc, char* argv[]) {
     }
     
     // 如果没有指定任何选项，显示帮助
-    if (!showSystem && !showHardware && !showPackages && !showLogs && !showAll && !showVersion) {
+    if (!showSystem && !showHardware && !showPackages && !showLogs && !showJournal && !showAll && !showVersion &&
+        watchInterval <= 0.0 && !showUpdates && !showHistory && ownerPaths.empty() &&
+        dependsPackage.empty() && rdependsPackage.empty() && impactPackages.empty() && !verifyPackages) {
         if (!quiet) {
             printFlexToolsBanner();
         }
@@ -142,6 +430,13 @@ int main(int argc, char* argv[]) {
         return 0;
     }
     
+    // 跟随模式逐行打印, 不做汇总分析
+    if (followLogs && (searchLogs || mineTemplates || detectBursts)) {
+        std::cerr << FLEX_COLOR_RED << "Error: --follow cannot be combined with --search, --templates or --bursts"
+                  << FLEX_COLOR_RESET << std::endl;
+        return 1;
+    }
+    
     // 如果指定了--all，显示所有信息
     if (showAll) {
         showSystem = true;
@@ -150,9 +445,15 @@ int main(int argc, char* argv[]) {
         showLogs = true;
     }
     
+    int exitCode = 0;
     try {
         // 重定向输出到文件
         std::unique_ptr<std::ofstream> outFile;
+        // 恢复cout在退出时
+        struct RestoreCout {
+            std::streambuf* old;
+            ~RestoreCout() { std::cout.rdbuf(old); }
+        } restore{std::cout.rdbuf()};
         if (!outputFile.empty()) {
             outFile = std::make_unique<std::ofstream>(outputFile);
             if (!outFile->is_open()) {
@@ -160,16 +461,8 @@ int main(int argc, char* argv[]) {
                           << outputFile << FLEX_COLOR_RESET << std::endl;
                 return 1;
             }
-            // 保存原cout缓冲区
-            auto oldCoutBuffer = std::cout.rdbuf();
             // 重定向cout到文件
             std::cout.rdbuf(outFile->rdbuf());
-            
-            // 恢复cout在退出时
-            struct RestoreCout {
-                std::streambuf* old;
-                ~RestoreCout() { std::cout.rdbuf(old); }
-            } restore{oldCoutBuffer};
         }
         
         if (!quiet && outputFile.empty()) {
@@ -212,9 +505,227 @@ int main(int argc, char* argv[]) {
             if (format == FlexOutputFormat::TEXT && !quiet) {
                 pkgInfo.printPackages(packages, format);
             } else if (format == FlexOutputFormat::JSON) {
-                // 需要实现toJSON方法
-                std::cout << "{\"packages\": []}" << std::endl; // 占位符
+                std::cout << pkgInfo.toJSON(packages) << std::endl;
+            } else if (format == FlexOutputFormat::CSV) {
+                std::cout << pkgInfo.toCSV(packages) << std::endl;
+            }
+        }
+        
+        // 日志收集
+        if (showLogs && followLogs) {
+            // 只跟随当前文件, 轮转出的旧代次不会再增长
+            FlexLogCollector logCollector;
+            FlexLogPrinter printer(logCollector, std::cout, format);
+            logCollector.addStage(&printer);
+            FlexLogFollower follower(logCollector);
+            if (!follower.isOpen()) {
+                std::cerr << FLEX_COLOR_RED << "Error: inotify is not available" << FLEX_COLOR_RESET << std::endl;
+                return 1;
             }
+            size_t followed = 0;
+            for (const auto& file : logCollector.discoverFiles()) {
+                if (!flexIsGzipPath(file) && !flexIsRotatedLog(file) && follower.addFile(file)) {
+                    followed++;
+                }
+            }
+            if (format == FlexOutputFormat::TEXT && !quiet) {
+                std::cout << FLEX_COLOR_CYAN << "Following " << followed << " log files (Ctrl-C to stop)"
+                          << FLEX_COLOR_RESET << std::endl;
+            }
+            follower.run();
+        } else if (showLogs && (logRange || searchLogs || mineTemplates || detectBursts)) {
+            // 所请求的各阶段挂在同一个收集器上, 日志只读一遍; 限定时间范围时只分析范围内的行,
+            // 没有分析阶段时逐行打印范围内的行
+            FlexLogCollector logCollector;
+            std::unique_ptr<FlexLogPrinter> printer;
+            std::unique_ptr<FlexLogSearch> search;
+            std::unique_ptr<FlexLogTemplateMiner> miner;
+            std::unique_ptr<FlexLogBurstDetector> detector;
+            if (searchLogs) {
+                search = std::make_unique<FlexLogSearch>();
+                if (searchPatterns.empty()) {
+                    search->addDefaultPatterns();
+                } else {
+                    std::string error;
+                    if (!search->loadPatterns(searchPatterns, &error)) {
+                        std::cerr << FLEX_COLOR_RED << "Error: " << error << FLEX_COLOR_RESET << std::endl;
+                        return 1;
+                    }
+                }
+                logCollector.addStage(search.get());
+            }
+            if (mineTemplates) {
+                miner = std::make_unique<FlexLogTemplateMiner>();
+                logCollector.addStage(miner.get());
+            }
+            if (detectBursts) {
+                detector = std::make_unique<FlexLogBurstDetector>();
+                logCollector.addStage(detector.get());
+            }
+            if (!search && !miner && !detector) {
+                printer = std::make_unique<FlexLogPrinter>(logCollector, std::cout, format);
+                logCollector.addStage(printer.get());
+            }
+            size_t files = logRange ? logCollector.collectTimeRange(logSince, logUntil) : logCollector.collect();
+            printFlexLogErrors(logCollector);
+            if (printer && format == FlexOutputFormat::TEXT && !quiet) {
+                std::cout << FLEX_COLOR_GREEN << "\nTotal: " << logCollector.totalLines() << " lines in range, "
+                          << logCollector.totalBytes() << " bytes scanned in " << files << " files"
+                          << FLEX_COLOR_RESET << std::endl;
+            }
+            if (search) {
+                if (format == FlexOutputFormat::TEXT && !quiet) {
+                    search->printResults(format);
+                } else if (format == FlexOutputFormat::JSON) {
+                    std::cout << search->toJSON() << std::endl;
+                } else if (format == FlexOutputFormat::CSV) {
+                    std::cout << search->toCSV() << std::endl;
+                }
+            }
+            if (miner) {
+                if (format == FlexOutputFormat::TEXT && !quiet) {
+                    miner->printTemplates(format, verbose ? SIZE_MAX : 50);
+                } else if (format == FlexOutputFormat::JSON) {
+                    std::cout << miner->toJSON() << std::endl;
+                } else if (format == FlexOutputFormat::CSV) {
+                    std::cout << miner->toCSV() << std::endl;
+                }
+            }
+            if (detector) {
+                if (format == FlexOutputFormat::TEXT && !quiet) {
+                    detector->printBursts(format);
+                } else if (format == FlexOutputFormat::JSON) {
+                    std::cout << detector->toJSON() << std::endl;
+                } else if (format == FlexOutputFormat::CSV) {
+                    std::cout << detector->toCSV() << std::endl;
+                }
+            }
+        } else if (showLogs) {
+            FlexLogCollector logCollector;
+            logCollector.collect();
+            if (format == FlexOutputFormat::TEXT && !quiet) {
+                logCollector.printLogs(format);
+            } else if (format == FlexOutputFormat::JSON) {
+                std::cout << logCollector.toJSON() << std::endl;
+            } else if (format == FlexOutputFormat::CSV) {
+                std::cout << logCollector.toCSV() << std::endl;
+            }
+        }
+        
+        // journald 日志
+        if (showJournal) {
+            // 逐条输出, 不把整个 journal 读进内存
+            FlexJournalReader journal;
+            if (format != FlexOutputFormat::TEXT || !quiet) {
+                journal.printStream(journalFilter, format);
+            }
+        }
+        
+        // 可升级的包
+        if (showUpdates) {
+            FlexPackageInfo pkgInfo;
+            auto updates = pkgInfo.checkForUpdates();
+            if (format == FlexOutputFormat::TEXT && !quiet) {
+                pkgInfo.printPackages(updates, format);
+            } else if (format == FlexOutputFormat::JSON) {
+                std::cout << pkgInfo.toJSON(updates) << std::endl;
+            } else if (format == FlexOutputFormat::CSV) {
+                std::cout << pkgInfo.toCSV(updates) << std::endl;
+            }
+        }
+        
+        // 安装历史
+        if (showHistory) {
+            FlexInstallHistory history;
+            history.load();
+            std::vector<FlexPackageEvent> events;
+            if (historyPackage.empty()) {
+                events = history.events(historySince, historyUntil);
+            } else {
+                for (auto& event : history.packageEvents(historyPackage)) {
+                    if (event.timestamp >= historySince && event.timestamp < historyUntil) {
+                        events.push_back(std::move(event));
+                    }
+                }
+            }
+            printFlexHistory(events, format);
+        }
+        
+        // 已安装文件完整性校验
+        if (verifyPackages) {
+            FlexPackageInfo pkgInfo;
+            FlexVerifyReport report = pkgInfo.verifyPackages(verifyNames);
+            printFlexVerifyReport(report, format);
+            // 供批量巡检脚本判断: 发现问题时以非零状态退出
+            if (!report.issues.empty()) {
+                exitCode = 1;
+            }
+        }
+        
+        // 文件归属反查
+        if (!ownerPaths.empty()) {
+            FlexPackageInfo pkgInfo;
+            auto owners = pkgInfo.getFileOwners(ownerPaths);
+            if (format == FlexOutputFormat::JSON) {
+                std::cout << "{\n  \"flex_file_owners\": [";
+                bool first = true;
+                for (const auto& [path, packages] : owners) {
+                    std::cout << (first ? "\n" : ",\n") << "    {\"path\": \"" << flexEscapeJSON(path)
+                              << "\", \"packages\": [";
+                    for (size_t i = 0; i < packages.size(); ++i) {
+                        std::cout << (i ? ", " : "") << "\"" << flexEscapeJSON(packages[i]) << "\"";
+                    }
+                    std::cout << "]}";
+                    first = false;
+                }
+                std::cout << "\n  ]\n}" << std::endl;
+            } else if (format == FlexOutputFormat::CSV) {
+                std::cout << "Path,Packages" << std::endl;
+                for (const auto& [path, packages] : owners) {
+                    std::string joined;
+                    for (const auto& package : packages) {
+                        joined += (joined.empty() ? "" : " ") + package;
+                    }
+                    std::cout << flexEscapeCSV(path) << "," << flexEscapeCSV(joined) << std::endl;
+                }
+            } else {
+                for (const auto& [path, packages] : owners) {
+                    std::cout << path << ": ";
+                    if (packages.empty()) {
+                        std::cout << FLEX_COLOR_RED << "no owning package" << FLEX_COLOR_RESET;
+                    }
+                    for (size_t i = 0; i < packages.size(); ++i) {
+                        std::cout << (i ? ", " : "") << packages[i];
+                    }
+                    std::cout << std::endl;
+                }
+            }
+        }
+        
+        // 依赖图查询
+        if (!dependsPackage.empty() || !rdependsPackage.empty() || !impactPackages.empty()) {
+            FlexPackageInfo pkgInfo;
+            if (!dependsPackage.empty()) {
+                printFlexPackageList("depends", dependsPackage,
+                                     pkgInfo.getDependencyClosure(dependsPackage), format);
+            }
+            if (!rdependsPackage.empty()) {
+                printFlexPackageList("rdepends", rdependsPackage,
+                                     pkgInfo.getReverseDependencies(rdependsPackage, true), format);
+            }
+            if (!impactPackages.empty()) {
+                std::string subject;
+                for (const auto& name : impactPackages) {
+                    subject += (subject.empty() ? "" : " ") + name;
+                }
+                printFlexPackageList("impact", subject, pkgInfo.getRemovalImpact(impactPackages), format);
+            }
+        }
+        
+        // 持续监控模式, 直到 Ctrl+C
+        if (watchInterval > 0.0) {
+            FlexWatchMonitor monitor(watchInterval, verbose);
+            monitor.run(std::cout);
         }
         
         if (!outputFile.empty() && !quiet) {
@@ -233,5 +744,5 @@ int main(int argc, char* argv[]) {
         return 1;
     }
     
-    return 0;
+    return exitCode;
 }
@@ -0,0 +1,296 @@
+#!/usr/bin/env python3
+"""生成 tests/fixtures/journal/<machine-id>/ 下的两个小型 .journal 文件 (格式见 systemd 的 journal-def.h):
+
+system.journal    常规格式, Jenkins 哈希, 一条 LZ4 压缩的 MESSAGE
+user-1000.journal compact + keyed hash (SipHash), 一条 zstd 压缩的 MESSAGE
+
+两个文件的记录时间交错, 用于测试多文件归并. 压缩经 ctypes 调用 liblz4 / libzstd.
+生成后可用 journalctl --file=<path> --verify 校验.
+"""
+import ctypes
+import ctypes.util
+import os
+import struct
+import sys
+
+SIGNATURE = b"LPKSHHRH"
+INCOMPAT_LZ4, INCOMPAT_KEYED_HASH, INCOMPAT_ZSTD, INCOMPAT_COMPACT = 2, 4, 8, 16
+OBJ_DATA, OBJ_FIELD, OBJ_ENTRY, OBJ_DATA_HASH, OBJ_FIELD_HASH, OBJ_ENTRY_ARRAY = 1, 2, 3, 4, 5, 6
+OBJ_LZ4, OBJ_ZSTD = 2, 4
+HEADER_SIZE = 272
+DATA_BUCKETS, FIELD_BUCKETS = 64, 16
+MASK64 = (1 << 64) - 1
+
+MACHINE_ID = bytes.fromhex("0123456789abcdef0123456789abcdef")
+BOOT_ID = bytes.fromhex("b007b007b007b007b007b007b007b007")
+BASE_REALTIME = 1760000000 * 1000000  # 2025-10-09 08:53:20 UTC
+
+
+def rotl32(x, bits):
+    return ((x << bits) | (x >> (32 - bits))) & 0xffffffff
+
+
+def jenkins_hash64(data):
+    """lookup3 hashlittle2, 与 flexJenkinsHash64 相同"""
+    a = b = c = (0xdeadbeef + len(data)) & 0xffffffff
+    if not data:
+        return (c << 32) | b
+    k, size = 0, len(data)
+    while size > 12:
+        a = (a + int.from_bytes(data[k:k + 4], "little")) & 0xffffffff
+        b = (b + int.from_bytes(data[k + 4:k + 8], "little")) & 0xffffffff
+        c = (c + int.from_bytes(data[k + 8:k + 12], "little")) & 0xffffffff
+        a = (a - c) & 0xffffffff; a ^= rotl32(c, 4); c = (c + b) & 0xffffffff
+        b = (b - a) & 0xffffffff; b ^= rotl32(a, 6); a = (a + c) & 0xffffffff
+        c = (c - b) & 0xffffffff; c ^= rotl32(b, 8); b = (b + a) & 0xffffffff
+        a = (a - c) & 0xffffffff; a ^= rotl32(c, 16); c = (c + b) & 0xffffffff
+        b = (b - a) & 0xffffffff; b ^= rotl32(a, 19); a = (a + c) & 0xffffffff
+        c = (c - b) & 0xffffffff; c ^= rotl32(b, 4); b = (b + a) & 0xffffffff
+        size -= 12
+        k += 12
+    tail = data[k:] + b"\0" * (12 - size)
+    a = (a + int.from_bytes(tail[0:4], "little")) & 0xffffffff
+    b = (b + int.from_bytes(tail[4:8], "little")) & 0xffffffff
+    c = (c + int.from_bytes(tail[8:12], "little")) & 0xffffffff
+    c ^= b; c = (c - rotl32(b, 14)) & 0xffffffff
+    a ^= c; a = (a - rotl32(c, 11)) & 0xffffffff
+    b ^= a; b = (b - rotl32(a, 25)) & 0xffffffff
+    c ^= b; c = (c - rotl32(b, 16)) & 0xffffffff
+    a ^= c; a = (a - rotl32(c, 4)) & 0xffffffff
+    b ^= a; b = (b - rotl32(a, 14)) & 0xffffffff
+    c ^= b; c = (c - rotl32(b, 24)) & 0xffffffff
+    return (c << 32) | b
+
+
+def rotl64(x, bits):
+    return ((x << bits) | (x >> (64 - bits))) & MASK64
+
+
+def siphash24(data, key):
+    k0, k1 = struct.unpack("<QQ", key)
+    v0, v1 = 0x736f6d6570736575 ^ k0, 0x646f72616e646f6d ^ k1
+    v2, v3 = 0x6c7967656e657261 ^ k0, 0x7465646279746573 ^ k1
+
+    def rounds(v0, v1, v2, v3, n):
+        for _ in range(n):
+            v0 = (v0 + v1) & MASK64; v1 = rotl64(v1, 13); v1 ^= v0; v0 = rotl64(v0, 32)
+            v2 = (v2 + v3) & MASK64; v3 = rotl64(v3, 16); v3 ^= v2
+            v0 = (v0 + v3) & MASK64; v3 = rotl64(v3, 21); v3 ^= v0
+            v2 = (v2 + v1) & MASK64; v1 = rotl64(v1, 17); v1 ^= v2; v2 = rotl64(v2, 32)
+        return v0, v1, v2, v3
+
+    blocks = len(data) // 8
+    for i in range(blocks):
+        m = int.from_bytes(data[i * 8:i * 8 + 8], "little")
+        v3 ^= m
+        v0, v1, v2, v3 = rounds(v0, v1, v2, v3, 2)
+        v0 ^= m
+    last = (len(data) << 56) & MASK64
+    for i, byte in enumerate(data[blocks * 8:]):
+        last |= byte << (8 * i)
+    v3 ^= last
+    v0, v1, v2, v3 = rounds(v0, v1, v2, v3, 2)
+    v0 ^= last
+    v2 ^= 0xff
+    v0, v1, v2, v3 = rounds(v0, v1, v2, v3, 4)
+    return v0 ^ v1 ^ v2 ^ v3
+
+
+def compress_lz4(payload):
+    lib = ctypes.CDLL(ctypes.util.find_library("lz4") or "liblz4.so.1")
+    out = ctypes.create_string_buffer(len(payload) + 64)
+    n = lib.LZ4_compress_default(payload, out, len(payload), len(out))
+    assert n > 0
+    # journald 在 LZ4 块前写 8 字节原始长度
+    return struct.pack("<Q", len(payload)) + out.raw[:n]
+
+
+def compress_zstd(payload):
+    lib = ctypes.CDLL(ctypes.util.find_library("zstd") or "libzstd.so.1")
+    lib.ZSTD_compress.restype = ctypes.c_size_t
+    out = ctypes.create_string_buffer(len(payload) + 64)
+    n = lib.ZSTD_compress(out, ctypes.c_size_t(len(out)), payload, ctypes.c_size_t(len(payload)), 3)
+    assert lib.ZSTD_isError(ctypes.c_size_t(n)) == 0
+    return out.raw[:n]
+
+
+def align8(n):
+    return (n + 7) & ~7
+
+
+class JournalWriter:
+    def __init__(self, file_id, compact, keyed, compression=None):
+        self.file_id = file_id
+        self.compact = compact
+        self.keyed = keyed
+        self.compression = compression  # None, "lz4" 或 "zstd": 对 MESSAGE 中含 "compressed" 的数据对象压缩
+        self.buf = bytearray(HEADER_SIZE)
+        self.n_objects = self.n_data = self.n_fields = self.n_entries = self.n_arrays = 0
+        self.tail_object = 0
+        self.data = {}    # payload -> offset
+        self.fields = {}  # name -> offset
+        self.data_entries = {}  # data offset -> [entry offsets]
+        self.entries = []
+        self.first_realtime = self.last_realtime = self.last_monotonic = 0
+        self.data_table = self.object(OBJ_DATA_HASH, 0, b"\0" * (16 * DATA_BUCKETS)) + 16
+        self.field_table = self.object(OBJ_FIELD_HASH, 0, b"\0" * (16 * FIELD_BUCKETS)) + 16
+
+    def hash(self, payload):
+        return siphash24(payload, self.file_id) if self.keyed else jenkins_hash64(payload)
+
+    def u64(self, offset, value):
+        struct.pack_into("<Q", self.buf, offset, value)
+
+    def r64(self, offset):
+        return struct.unpack_from("<Q", self.buf, offset)[0]
+
+    def object(self, kind, flags, body):
+        offset = len(self.buf)
+        size = 16 + len(body)
+        self.buf += struct.pack("<BB6xQ", kind, flags, size) + body
+        self.buf += b"\0" * (align8(len(self.buf)) - len(self.buf))
+        self.n_objects += 1
+        self.tail_object = offset
+        return offset
+
+    def link(self, table, buckets, hash_value, offset, next_field):
+        bucket = table + (hash_value % buckets) * 16
+        tail = self.r64(bucket + 8)
+        if tail == 0:
+            self.u64(bucket, offset)
+        else:
+            self.u64(tail + next_field, offset)
+        self.u64(bucket + 8, offset)
+
+    def field(self, name):
+        if name in self.fields:
+            return self.fields[name]
+        h = self.hash(name)
+        offset = self.object(OBJ_FIELD, 0, struct.pack("<QQQ", h, 0, 0) + name)
+        self.link(self.field_table, FIELD_BUCKETS, h, offset, 24)
+        self.fields[name] = offset
+        self.n_fields += 1
+        return offset
+
+    def datum(self, payload):
+        if payload in self.data:
+            return self.data[payload]
+        h = self.hash(payload)
+        flags, stored = 0, payload
+        if self.compression and payload.startswith(b"MESSAGE=") and b"compressed" in payload:
+            if self.compression == "lz4":
+                flags, stored = OBJ_LZ4, compress_lz4(payload)
+            else:
+                flags, stored = OBJ_ZSTD, compress_zstd(payload)
+        body = struct.pack("<QQQQQQ", h, 0, 0, 0, 0, 0)
+        if self.compact:
+            body += struct.pack("<II", 0, 0)
+        offset = self.object(OBJ_DATA, flags, body + stored)
+        self.link(self.data_table, DATA_BUCKETS, h, offset, 24)
+        # 同一字段的数据对象串成链, 新对象放在链头
+        field = self.field(payload.split(b"=", 1)[0])
+        self.u64(offset + 32, self.r64(field + 32))
+        self.u64(field + 32, offset)
+        self.data[payload] = offset
+        self.data_entries[offset] = []
+        self.n_data += 1
+        return offset
+
+    def add(self, realtime, monotonic, fields):
+        items = []
+        xor_hash = 0
+        for name, value in fields:
+            payload = name.encode() + b"=" + value.encode()
+            offset = self.datum(payload)
+            items.append((offset, self.r64(offset + 16)))
+            xor_hash ^= jenkins_hash64(payload)
+        items.sort()
+        if self.compact:
+            packed = b"".join(struct.pack("<I", o) for o, _ in items)
+        else:
+            packed = b"".join(struct.pack("<QQ", o, h) for o, h in items)
+        seqnum = self.n_entries + 1
+        entry = self.object(OBJ_ENTRY, 0, struct.pack("<QQQ", seqnum, realtime, monotonic) + BOOT_ID +
+                            struct.pack("<Q", xor_hash) + packed)
+        for offset, _ in items:
+            self.data_entries[offset].append(entry)
+        self.entries.append(entry)
+        self.n_entries += 1
+        if self.first_realtime == 0:
+            self.first_realtime = realtime
+        self.last_realtime = realtime
+        self.last_monotonic = monotonic
+
+    def entry_array(self, entries):
+        """一个数组对象容纳全部条目 (条目少时 journald 也是如此), 返回偏移"""
+        width = "<I" if self.compact else "<Q"
+        self.n_arrays += 1
+        return self.object(OBJ_ENTRY_ARRAY, 0, struct.pack("<Q", 0) + b"".join(struct.pack(width, e) for e in entries))
+
+    def finish(self, path):
+        for offset, entries in self.data_entries.items():
+            self.u64(offset + 40, entries[0])
+            self.u64(offset + 56, len(entries))
+            if len(entries) > 1:
+                array = self.entry_array(entries[1:])
+                self.u64(offset + 48, array)
+                if self.compact:
+                    struct.pack_into("<II", self.buf, offset + 64, array, len(entries) - 1)
+        global_array = self.entry_array(self.entries)
+
+        incompatible = (INCOMPAT_COMPACT if self.compact else 0) | (INCOMPAT_KEYED_HASH if self.keyed else 0)
+        incompatible |= {"lz4": INCOMPAT_LZ4, "zstd": INCOMPAT_ZSTD}.get(self.compression, 0)
+        header = struct.pack("<8sIIB7x16s16s16s16s", SIGNATURE, 0, incompatible, 0, self.file_id, MACHINE_ID,
+                             BOOT_ID, self.file_id)
+        header += struct.pack("<20Q", HEADER_SIZE, len(self.buf) - HEADER_SIZE,
+                              self.data_table, 16 * DATA_BUCKETS, self.field_table, 16 * FIELD_BUCKETS,
+                              self.tail_object, self.n_objects, self.n_entries, self.n_entries, 1,
+                              global_array, self.first_realtime, self.last_realtime, self.last_monotonic,
+                              self.n_data, self.n_fields, 0, self.n_arrays, 1)
+        header += struct.pack("<QIIQ", 1, global_array, len(self.entries), self.entries[-1])
+        assert len(header) == HEADER_SIZE
+        self.buf[:HEADER_SIZE] = header
+        with open(path, "wb") as out:
+            out.write(self.buf)
+
+
+def entry(unit, identifier, pid, priority, message):
+    fields = [("_SYSTEMD_UNIT", unit), ("SYSLOG_IDENTIFIER", identifier), ("_PID", pid), ("MESSAGE", message)]
+    if priority is not None:
+        fields.append(("PRIORITY", str(priority)))
+    return fields
+
+
+def main():
+    root = sys.argv[1] if len(sys.argv) > 1 else os.path.join(os.path.dirname(os.path.abspath(__file__)), "journal")
+    directory = os.path.join(root, MACHINE_ID.hex())
+    os.makedirs(directory, exist_ok=True)
+
+    system = JournalWriter(bytes.fromhex("11111111111111111111111111111111"), compact=False, keyed=False,
+                           compression="lz4")
+    system_entries = [
+        entry("sshd.service", "sshd", "812", 6, "Accepted publickey for admin from 10.0.0.5 port 51022"),
+        entry("kernel.service", "kernel", "0", 3, "nvme0n1: I/O error, dev nvme0n1, sector 2048"),
+        entry("sshd.service", "sshd", "812", 4, "Failed password for invalid user test"),
+        entry("cron.service", "CRON", "901", None, "error: job exited with status 1"),
+        entry("app.service", "app", "1234", 6, "compressed " + "payload " * 40),
+    ]
+    for i, fields in enumerate(system_entries):
+        system.add(BASE_REALTIME + i * 2000000, 1000000 + i * 2000000, fields)
+    system.finish(os.path.join(directory, "system.journal"))
+
+    user = JournalWriter(bytes.fromhex("22222222222222222222222222222222"), compact=True, keyed=True,
+                         compression="zstd")
+    user_entries = [
+        entry("user@1000.service", "pipewire", "2001", 6, "Starting audio session"),
+        entry("sshd.service", "sshd", "2002", 2, "fatal: buffer overflow detected"),
+        entry("user@1000.service", "gnome-shell", "2003", 6, "compressed " + "frame " * 50),
+        entry("user@1000.service", "pipewire", "2001", 7, "Audio session ready"),
+    ]
+    for i, fields in enumerate(user_entries):
+        user.add(BASE_REALTIME + 1000000 + i * 2000000, 2000000 + i * 2000000, fields)
+    user.finish(os.path.join(directory, "user-1000.journal"))
+
+
+if __name__ == "__main__":
+    main()
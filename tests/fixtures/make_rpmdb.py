@@ -0,0 +1,77 @@
+#!/usr/bin/env python3
+"""生成 tests/fixtures/rpmdb.sqlite: 与 rpm >= 4.16 相同的 Packages(hnum, blob) 表, blob 为不带签名区的头部."""
+import os
+import sqlite3
+import struct
+import sys
+
+INT32, INT64, STRING, STRING_ARRAY, I18NSTRING = 4, 5, 6, 8, 9
+
+NAME, VERSION, RELEASE, EPOCH, SUMMARY = 1000, 1001, 1002, 1003, 1004
+INSTALLTIME, SIZE, GROUP, ARCH = 1008, 1009, 1016, 1022
+OLDFILENAMES = 1027
+REQUIREFLAGS, REQUIRENAME, REQUIREVERSION = 1048, 1049, 1050
+PROVIDENAME, PROVIDEFLAGS, PROVIDEVERSION = 1047, 1112, 1113
+DIRINDEXES, BASENAMES, DIRNAMES = 1116, 1117, 1118
+
+SENSE_GREATER, SENSE_EQUAL, SENSE_RPMLIB = 1 << 2, 1 << 3, 1 << 24
+
+
+def header(tags):
+    index, data = [], b""
+    for tag, kind, value in tags:
+        if kind == INT32:
+            data += b"\0" * (-len(data) % 4)
+            payload, count = b"".join(struct.pack(">I", v) for v in value), len(value)
+        elif kind == INT64:
+            data += b"\0" * (-len(data) % 8)
+            payload, count = b"".join(struct.pack(">Q", v) for v in value), len(value)
+        elif kind == STRING:
+            payload, count = value.encode() + b"\0", 1
+        else:
+            payload, count = b"".join(v.encode() + b"\0" for v in value), len(value)
+        index.append(struct.pack(">IIII", tag, kind, len(data), count))
+        data += payload
+    return struct.pack(">II", len(index), len(data)) + b"".join(index) + data
+
+
+PACKAGES = [
+    header([
+        (NAME, STRING, "alpha"), (VERSION, STRING, "1.2"), (RELEASE, STRING, "3"),
+        (SUMMARY, I18NSTRING, ["Alpha test package"]), (GROUP, I18NSTRING, ["Testing"]),
+        (ARCH, STRING, "x86_64"), (SIZE, INT32, [4096]), (INSTALLTIME, INT32, [1700000000]),
+        (PROVIDENAME, STRING_ARRAY, ["alpha", "libalpha.so.1()(64bit)"]),
+        (PROVIDEFLAGS, INT32, [SENSE_EQUAL, 0]), (PROVIDEVERSION, STRING_ARRAY, ["1.2-3", ""]),
+        (DIRNAMES, STRING_ARRAY, ["/usr/bin/", "/usr/lib64/", "/usr/share/doc/alpha/"]),
+        (DIRINDEXES, INT32, [0, 1, 2, 2]),
+        (BASENAMES, STRING_ARRAY, ["alpha", "libalpha.so.1", "README", "COPYING"]),
+    ]),
+    header([
+        (NAME, STRING, "beta"), (VERSION, STRING, "0.9"), (RELEASE, STRING, "1.el9"),
+        (EPOCH, INT32, [2]), (SUMMARY, I18NSTRING, ["Beta test package"]),
+        (ARCH, STRING, "noarch"), (SIZE, INT32, [128]),
+        (REQUIRENAME, STRING_ARRAY, ["alpha", "rpmlib(PayloadFilesHavePrefix)", "/bin/sh"]),
+        (REQUIREFLAGS, INT32, [SENSE_GREATER | SENSE_EQUAL, SENSE_RPMLIB | SENSE_EQUAL, 0]),
+        (REQUIREVERSION, STRING_ARRAY, ["1.0", "4.0-1", ""]),
+        (OLDFILENAMES, STRING_ARRAY, ["/etc/beta.conf", "/usr/bin/beta"]),
+    ]),
+    header([
+        (NAME, STRING, "gpg-pubkey"), (VERSION, STRING, "fd431d51"), (RELEASE, STRING, "4ae0493b"),
+    ]),
+]
+
+
+def main():
+    out = sys.argv[1] if len(sys.argv) > 1 else os.path.join(os.path.dirname(os.path.abspath(__file__)), "rpmdb.sqlite")
+    if os.path.exists(out):
+        os.remove(out)
+    db = sqlite3.connect(out)
+    db.execute("CREATE TABLE Packages (hnum INTEGER PRIMARY KEY AUTOINCREMENT, blob BLOB NOT NULL)")
+    db.executemany("INSERT INTO Packages (blob) VALUES (?)", [(blob,) for blob in PACKAGES])
+    db.commit()
+    db.execute("VACUUM")
+    db.close()
+
+
+if __name__ == "__main__":
+    main()
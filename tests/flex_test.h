@@ -0,0 +1,66 @@
+#ifndef FLEX_TEST_H
+#define FLEX_TEST_H
+
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace FlexTools {
+namespace Test {
+
+// 极简测试登记表: FLEX_TEST 定义的用例在静态初始化时注册, 由 flex_test_main.cpp 依次运行
+struct Case {
+    const char* name;
+    std::function<void()> body;
+};
+
+inline std::vector<Case>& cases() {
+    static std::vector<Case> registry;
+    return registry;
+}
+
+inline int& failures() {
+    static int count = 0;
+    return count;
+}
+
+struct Registrar {
+    Registrar(const char* name, std::function<void()> body) {
+        cases().push_back({name, std::move(body)});
+    }
+};
+
+inline void fail(const char* file, int line, const std::string& message) {
+    ++failures();
+    std::cerr << file << ":" << line << ": " << message << std::endl;
+}
+
+} // namespace Test
+} // namespace FlexTools
+
+#define FLEX_TEST_CONCAT2(a, b) a##b
+#define FLEX_TEST_CONCAT(a, b) FLEX_TEST_CONCAT2(a, b)
+
+#define FLEX_TEST(name)                                                                   \
+    static void name();                                                                   \
+    static ::FlexTools::Test::Registrar FLEX_TEST_CONCAT(flexRegistrar_, name)(#name, name); \
+    static void name()
+
+#define FLEX_CHECK(expr)                                                                  \
+    do {                                                                                  \
+        if (!(expr)) {                                                                    \
+            ::FlexTools::Test::fail(__FILE__, __LINE__, "check failed: " #expr);          \
+        }                                                                                 \
+    } while (0)
+
+#define FLEX_CHECK_EQ(actual, expected)                                                   \
+    do {                                                                                  \
+        const auto& flexActual = (actual);                                                \
+        const auto& flexExpected = (expected);                                            \
+        if (!(flexActual == flexExpected)) {                                              \
+            ::FlexTools::Test::fail(__FILE__, __LINE__, "check failed: " #actual " == " #expected); \
+        }                                                                                 \
+    } while (0)
+
+#endif // FLEX_TEST_H
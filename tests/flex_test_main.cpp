@@ -0,0 +1,18 @@
+#include "flex_test.h"
+
+int main() {
+    using namespace FlexTools::Test;
+    
+    for (const auto& test : cases()) {
+        int before = failures();
+        try {
+            test.body();
+        } catch (const std::exception& e) {
+            fail(test.name, 0, std::string("uncaught exception: ") + e.what());
+        }
+        std::cout << (failures() == before ? "[ OK ] " : "[FAIL] ") << test.name << std::endl;
+    }
+    
+    std::cout << cases().size() << " tests, " << failures() << " failures" << std::endl;
+    return failures() == 0 ? 0 : 1;
+}
@@ -0,0 +1,64 @@
+#include "flex_test.h"
+#include "flex_debian_version.h"
+
+using namespace FlexTools;
+
+namespace {
+
+int flexSign(int value) {
+    return (value > 0) - (value < 0);
+}
+
+} // namespace
+
+FLEX_TEST(debianVersionOrdering) {
+    // 与 dpkg --compare-versions 的结果一致
+    struct Case {
+        const char* a;
+        const char* b;
+        int expected;
+    };
+    const Case cases[] = {
+        {"1.0~rc1", "1.0", -1},      // ~ 排在一切之前, 包括结尾
+        {"1.0~rc1", "1.0~rc2", -1},
+        {"1.0~~", "1.0~", -1},
+        {"1:0.9", "2.0", 1},         // epoch 优先
+        {"0:2.0", "2.0", 0},
+        {"1.0-0", "1.0", 0},         // 缺省 revision 等同于 0
+        {"1.0-1", "1.0", 1},
+        {"1.0a", "1.0+", -1},        // 字母排在非字母之前
+        {"1.0a", "1.0.", -1},
+        {"1.0", "1.0a", -1},         // 结尾排在字母之前
+        {"1.10", "1.9", 1},          // 数字段按数值比较
+        {"1.010", "1.10", 0},
+        {"2.30-1ubuntu1", "2.30-1", 1},
+        {"1.2.3-1+b1", "1.2.3-1", 1},
+    };
+    for (const auto& c : cases) {
+        int result = flexSign(flexCompareDebianVersions(c.a, c.b));
+        if (result != c.expected) {
+            ::FlexTools::Test::fail(__FILE__, __LINE__, std::string(c.a) + " vs " + c.b + ": got " +
+                                    std::to_string(result) + ", expected " + std::to_string(c.expected));
+        }
+        FLEX_CHECK_EQ(flexSign(flexCompareDebianVersions(c.b, c.a)), -c.expected);
+    }
+}
+
+FLEX_TEST(debianVersionRelations) {
+    FLEX_CHECK(flexDebianVersionSatisfies("1.0", "<<", "1.1"));
+    FLEX_CHECK(!flexDebianVersionSatisfies("1.1", "<<", "1.1"));
+    FLEX_CHECK(flexDebianVersionSatisfies("1.1", "<=", "1.1"));
+    FLEX_CHECK(!flexDebianVersionSatisfies("1.2", "<=", "1.1"));
+    FLEX_CHECK(flexDebianVersionSatisfies("1.1-0", "=", "1.1"));
+    FLEX_CHECK(!flexDebianVersionSatisfies("1.1-1", "=", "1.1"));
+    FLEX_CHECK(flexDebianVersionSatisfies("1.1", ">=", "1.1"));
+    FLEX_CHECK(!flexDebianVersionSatisfies("1.1~rc1", ">=", "1.1"));
+    FLEX_CHECK(flexDebianVersionSatisfies("1:0.1", ">>", "9.9"));
+    FLEX_CHECK(!flexDebianVersionSatisfies("1.1", ">>", "1.1"));
+    // 旧式 < 与 > 即 <= 与 >=
+    FLEX_CHECK(flexDebianVersionSatisfies("1.1", "<", "1.1"));
+    FLEX_CHECK(flexDebianVersionSatisfies("1.1", ">", "1.1"));
+    // 无约束时总是满足, 未知关系不满足
+    FLEX_CHECK(flexDebianVersionSatisfies("1.0", "", ""));
+    FLEX_CHECK(!flexDebianVersionSatisfies("1.0", "!=", "2.0"));
+}
@@ -0,0 +1,98 @@
+#include "flex_test.h"
+#include "flex_dependency_graph.h"
+
+using namespace FlexTools;
+
+namespace {
+
+struct FlexTestPackage {
+    const char* name;
+    const char* version;
+    std::vector<const char*> depends;
+    std::vector<const char*> provides;
+};
+
+// 按名称升序追加
+void flexFillStore(FlexPackageStore& store, const std::vector<FlexTestPackage>& packages) {
+    for (const auto& package : packages) {
+        FlexPackageFields fields;
+        fields.name = package.name;
+        fields.version = package.version;
+        fields.status = "installed";
+        store.append(fields);
+        for (const char* depend : package.depends) {
+            store.addRelation(FlexRelationKind::DEPENDS, depend);
+        }
+        for (const char* provide : package.provides) {
+            store.addRelation(FlexRelationKind::PROVIDES, provide);
+        }
+    }
+}
+
+std::vector<std::string> flexNames(const FlexDependencyGraph& graph, const std::vector<uint32_t>& nodes) {
+    std::vector<std::string> names;
+    for (uint32_t node : nodes) {
+        names.push_back(graph.nodeName(node));
+    }
+    return names;
+}
+
+} // namespace
+
+FLEX_TEST(dependencyGraphEvaluatesVersionConstraints) {
+    FlexPackageStore store;
+    flexFillStore(store, {
+        {"app", "1.0", {"libfoo (>= 2.0)"}, {}},
+        {"client", "1.0", {"mta (>= 1.0)", "www-browser"}, {}},
+        {"libbar", "2.1", {}, {}},
+        {"libbaz-compat", "3.0", {}, {"libbaz (= 1.5)"}},
+        {"libfoo", "1.0", {}, {}},
+        {"lynx", "2.9", {}, {"www-browser"}},
+        {"postfix", "3.7", {}, {"mta"}},
+        {"svc", "1.0", {"libbaz (>> 1.0) | libbaz-legacy"}, {}},
+        {"tool", "1.0", {"libbar (>= 2.0)", "libfoo (<< 1:0)"}, {}},
+    });
+    FlexDependencyGraph graph(store);
+    
+    // libfoo 1.0 不满足 >= 2.0
+    FLEX_CHECK(graph.dependencies(graph.nodeId("app")).empty());
+    // 无版本的 Provides 不满足带版本的依赖, 但满足无版本依赖
+    FLEX_CHECK(flexNames(graph, graph.dependencies(graph.nodeId("client"))) == std::vector<std::string>{"lynx"});
+    // 带版本的 Provides 参与比较
+    FLEX_CHECK(flexNames(graph, graph.dependencies(graph.nodeId("svc"))) ==
+               std::vector<std::string>{"libbaz-compat"});
+    // epoch 0 的 1.0 低于 1:0
+    FLEX_CHECK(flexNames(graph, graph.dependencies(graph.nodeId("tool"))) ==
+               (std::vector<std::string>{"libbar", "libfoo"}));
+    
+    auto clauses = graph.clauses(graph.nodeId("app"));
+    FLEX_CHECK_EQ(clauses.size(), size_t(1));
+    if (clauses.size() == 1 && clauses[0].size() == 1) {
+        FLEX_CHECK_EQ(clauses[0][0].relation, std::string(">="));
+        FLEX_CHECK_EQ(clauses[0][0].version, std::string("2.0"));
+        FLEX_CHECK(clauses[0][0].providers.empty());
+    }
+    
+    // 移除 libfoo 不影响原本就不满足的 app; 移除 libbar 使 tool 损坏
+    FLEX_CHECK(graph.removalImpact({graph.nodeId("libfoo")}) == std::vector<uint32_t>{graph.nodeId("tool")});
+    FLEX_CHECK(graph.removalImpact({graph.nodeId("postfix")}).empty());
+    FLEX_CHECK(graph.removalImpact({graph.nodeId("libbar")}) == std::vector<uint32_t>{graph.nodeId("tool")});
+}
+
+FLEX_TEST(dependencyGraphUsesRPMRelations) {
+    FlexPackageStore store;
+    flexFillStore(store, {
+        {"app", "1.0-1", {"glibc (< 2.34)"}, {}},
+        {"glibc", "2.34-100.el9", {}, {}},
+        {"tool", "1.0-1", {"glibc (>= 2.34)", "glibc (= 2.34)"}, {}},
+    });
+    FlexDependencyGraph graph(store, FlexSystemType::RPM_BASED);
+    // RPM 的 "<" 为严格小于
+    FLEX_CHECK(graph.dependencies(graph.nodeId("app")).empty());
+    // 不带 release 的约束匹配任意 release
+    auto clauses = graph.clauses(graph.nodeId("tool"));
+    FLEX_CHECK_EQ(clauses.size(), size_t(2));
+    for (const auto& clause : clauses) {
+        FLEX_CHECK(clause.size() == 1 && clause[0].providers == std::vector<uint32_t>{graph.nodeId("glibc")});
+    }
+}
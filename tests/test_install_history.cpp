@@ -0,0 +1,44 @@
+#include "flex_test.h"
+#include "flex_install_history.h"
+#include <unistd.h>
+#include <limits>
+
+using namespace FlexTools;
+
+FLEX_TEST(installHistoryFollowsDaylightSaving) {
+    // 中欧时间 2026-03-29 02:00 进入夏令时, 之后的时刻比当天零点多出的秒数少一小时
+    const char* saved = getenv("TZ");
+    std::string previous = saved != nullptr ? saved : "";
+    setenv("TZ", "CET-1CEST,M3.5.0,M10.5.0/3", 1);
+    tzset();
+    
+    char name[] = "/tmp/flextest.XXXXXX";
+    std::string dir = mkdtemp(name) != nullptr ? name : "/tmp";
+    {
+        std::ofstream out(dir + "/dpkg.log");
+        out << "2026-03-29 01:30:00 install foo:amd64 <none> 1.0\n"
+            << "2026-03-29 03:30:00 upgrade foo:amd64 1.0 1.1\n"
+            << "2026-03-29 03:45:00 remove foo:amd64 1.1 <none>\n";
+    }
+    FlexInstallHistory history(dir, dir + "/history.cache");
+    FLEX_CHECK(history.load());
+    auto events = history.events(0, std::numeric_limits<time_t>::max());
+    FLEX_CHECK_EQ(events.size(), size_t(3));
+    if (events.size() == 3) {
+        FLEX_CHECK_EQ(events[0].timestamp, time_t(1774744200)); // 00:30 UTC
+        FLEX_CHECK_EQ(events[1].timestamp, time_t(1774747800)); // 01:30 UTC
+        FLEX_CHECK_EQ(events[2].timestamp, time_t(1774748700)); // 01:45 UTC
+    }
+    // --since 取夏令时后的第一个事件
+    FLEX_CHECK_EQ(history.events(1774747800, std::numeric_limits<time_t>::max()).size(), size_t(2));
+    
+    unlink((dir + "/dpkg.log").c_str());
+    unlink((dir + "/history.cache").c_str());
+    rmdir(dir.c_str());
+    if (saved != nullptr) {
+        setenv("TZ", previous.c_str(), 1);
+    } else {
+        unsetenv("TZ");
+    }
+    tzset();
+}
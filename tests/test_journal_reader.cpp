@@ -0,0 +1,136 @@
+#include "flex_test.h"
+#include "flex_journal_reader.h"
+
+#include <algorithm>
+
+using namespace FlexTools;
+
+namespace {
+
+// 由 tests/fixtures/make_journal.py 生成: system.journal (常规格式, LZ4) 与
+// user-1000.journal (compact + keyed hash, zstd), 两者的记录时间交错
+const std::string flexJournalDir = std::string(FLEX_TEST_FIXTURES) + "/journal";
+constexpr uint64_t flexBaseRealtime = 1760000000ULL * 1000000;
+
+std::vector<FlexJournalEntry> flexRead(const FlexJournalFilter& filter) {
+    FlexJournalReader reader({flexJournalDir});
+    return reader.entries(filter);
+}
+
+} // namespace
+
+FLEX_TEST(journalReaderMergesFiles) {
+    FlexJournalReader reader({flexJournalDir});
+    FLEX_CHECK_EQ(reader.discoverFiles().size(), size_t(2));
+    
+    std::vector<size_t> files;
+    std::vector<FlexJournalEntry> entries;
+    size_t count = reader.read(FlexJournalFilter(), [&](const FlexJournalEntry& entry, size_t file) {
+        entries.push_back(entry);
+        files.push_back(file);
+    });
+    FLEX_CHECK_EQ(count, size_t(9));
+    FLEX_CHECK_EQ(entries.size(), size_t(9));
+    // 每秒一条, 两个文件交替
+    for (size_t i = 0; i < entries.size(); ++i) {
+        FLEX_CHECK_EQ(entries[i].realtime, flexBaseRealtime + i * 1000000);
+        FLEX_CHECK_EQ(files[i], i % 2);
+    }
+}
+
+FLEX_TEST(journalReaderParsesFields) {
+    auto entries = flexRead(FlexJournalFilter());
+    FLEX_CHECK_EQ(entries.size(), size_t(9));
+    if (entries.size() != 9) return;
+    
+    FLEX_CHECK_EQ(entries[0].unit, std::string("sshd.service"));
+    FLEX_CHECK_EQ(entries[0].identifier, std::string("sshd"));
+    FLEX_CHECK_EQ(entries[0].pid, std::string("812"));
+    FLEX_CHECK_EQ(entries[0].priority, 6);
+    FLEX_CHECK(entries[0].level == FlexLogLevel::INFO);
+    FLEX_CHECK_EQ(entries[0].message, std::string("Accepted publickey for admin from 10.0.0.5 port 51022"));
+    FLEX_CHECK_EQ(entries[0].seqnum, uint64_t(1));
+    
+    // compact 文件
+    FLEX_CHECK_EQ(entries[3].identifier, std::string("sshd"));
+    FLEX_CHECK_EQ(entries[3].priority, 2);
+    FLEX_CHECK(entries[3].level == FlexLogLevel::CRITICAL);
+    
+    // 没有 PRIORITY 时按消息关键字分级
+    FLEX_CHECK_EQ(entries[6].identifier, std::string("CRON"));
+    FLEX_CHECK_EQ(entries[6].priority, -1);
+    FLEX_CHECK(entries[6].level == FlexLogLevel::ERROR);
+}
+
+FLEX_TEST(journalReaderDecompressesData) {
+    FlexJournalReader reader({flexJournalDir});
+    auto entries = reader.entries(FlexJournalFilter());
+    FLEX_CHECK_EQ(entries.size(), size_t(9));
+    if (entries.size() != 9) return;
+    
+    std::string lz4Message = "compressed ";
+    for (int i = 0; i < 40; ++i) lz4Message += "payload ";
+    std::string zstdMessage = "compressed ";
+    for (int i = 0; i < 50; ++i) zstdMessage += "frame ";
+    
+#ifdef FLEX_HAVE_LZ4
+    FLEX_CHECK_EQ(entries[8].message, lz4Message);
+#else
+    FLEX_CHECK(entries[8].message.empty());
+#endif
+#ifdef FLEX_HAVE_ZSTD
+    FLEX_CHECK_EQ(entries[5].message, zstdMessage);
+#else
+    FLEX_CHECK(entries[5].message.empty());
+#endif
+    uint64_t expected = 0;
+#ifndef FLEX_HAVE_LZ4
+    expected++;
+#endif
+#ifndef FLEX_HAVE_ZSTD
+    expected++;
+#endif
+    FLEX_CHECK_EQ(reader.undecodable(), expected);
+}
+
+FLEX_TEST(journalReaderFilters) {
+    // 不含 '.' 的单元名按 .service 匹配, 两个文件的哈希方式不同
+    FlexJournalFilter byUnit;
+    byUnit.units = {"sshd"};
+    auto entries = flexRead(byUnit);
+    FLEX_CHECK_EQ(entries.size(), size_t(3));
+    for (const auto& entry : entries) {
+        FLEX_CHECK_EQ(entry.unit, std::string("sshd.service"));
+    }
+    
+    FlexJournalFilter byPriority;
+    byPriority.maxPriority = 3;
+    entries = flexRead(byPriority);
+    FLEX_CHECK_EQ(entries.size(), size_t(2));
+    for (const auto& entry : entries) {
+        FLEX_CHECK(entry.priority >= 0 && entry.priority <= 3);
+    }
+    
+    FlexJournalFilter both;
+    both.units = {"sshd.service", "user@1000.service"};
+    both.maxPriority = 4;
+    entries = flexRead(both);
+    FLEX_CHECK_EQ(entries.size(), size_t(2));
+    if (entries.size() == 2) {
+        FLEX_CHECK_EQ(entries[0].message, std::string("fatal: buffer overflow detected"));
+        FLEX_CHECK_EQ(entries[1].message, std::string("Failed password for invalid user test"));
+    }
+    
+    FlexJournalFilter none;
+    none.units = {"missing"};
+    FLEX_CHECK(flexRead(none).empty());
+}
+
+FLEX_TEST(journalReaderListsFieldValues) {
+    FlexJournalFile file(flexJournalDir + "/0123456789abcdef0123456789abcdef/user-1000.journal");
+    FLEX_CHECK(file.isOpen());
+    FLEX_CHECK_EQ(file.entryCount(), uint64_t(4));
+    auto units = file.fieldValues("_SYSTEMD_UNIT");
+    std::sort(units.begin(), units.end());
+    FLEX_CHECK_EQ(units, (std::vector<std::string>{"sshd.service", "user@1000.service"}));
+}
@@ -0,0 +1,64 @@
+#include "flex_test.h"
+#include "flex_log_bursts.h"
+
+using namespace FlexTools;
+
+namespace {
+
+// journal 记录: 文本中没有时间戳, 时间由 line.time 给出
+void flexRecord(FlexLogBurstDetector& detector, uint32_t source, int64_t time, const std::string& text) {
+    detector.consume(FlexLogLine{text, FlexLogLevel::INFO, 0, source, time});
+}
+
+} // namespace
+
+FLEX_TEST(burstDetectorSharesTimelineAcrossOpenSources) {
+    // 与 collectJournal 相同的顺序: 第二个文件在第一个文件读到一半时开始, 两者最后统一结束
+    FlexLogBurstDetector detector(60, 10, 20, 10.0, 50);
+    const int64_t base = 1792238400; // 2026-10-17T12:00:00Z
+    detector.beginSource(0, "/nonexistent/system.journal");
+    for (int64_t window = 0; window < 9; ++window) {
+        if (window == 6) {
+            // 突增的行来自新打开的源, 之前的窗口历史仍应作为基线
+            detector.beginSource(1, "/nonexistent/user-1000.journal");
+        }
+        if (window == 6 || window == 7) {
+            // 第二窗的基线已包含第一窗, 需要更多行才仍算突增
+            for (int i = 0; i < (window == 6 ? 100 : 300); ++i) {
+                flexRecord(detector, 1, base + window * 60 + 10, "worker[7]: retry");
+            }
+        }
+        // 每个窗口的最后一行来自另一个源, 突增仍归于它自己的源, 连续两窗合并为一条
+        flexRecord(detector, 0, base + window * 60, "app[1]: tick");
+        flexRecord(detector, 0, base + window * 60 + 30, "app[1]: tick");
+    }
+    detector.endSource(1);
+    detector.endSource(0);
+    
+    const auto& bursts = detector.bursts();
+    FLEX_CHECK_EQ(bursts.size(), size_t(1));
+    if (bursts.size() == 1) {
+        FLEX_CHECK_EQ(bursts[0].identifier, std::string("worker"));
+        FLEX_CHECK_EQ(bursts[0].source, uint32_t(1));
+        FLEX_CHECK_EQ(bursts[0].window, base + 6 * 60);
+        FLEX_CHECK_EQ(bursts[0].last, base + 7 * 60);
+        FLEX_CHECK_EQ(bursts[0].count, uint64_t(400));
+    }
+}
+
+FLEX_TEST(burstDetectorResetsBetweenSequentialSources) {
+    // 文本日志逐个读完, 后一个源的时间线不接续前一个源
+    FlexLogBurstDetector detector(60, 10, 20, 10.0, 50);
+    const int64_t base = 1792238400;
+    detector.beginSource(0, "/nonexistent/app.log.1");
+    for (int64_t window = 0; window < 8; ++window) {
+        flexRecord(detector, 0, base + window * 60, "app[1]: tick");
+    }
+    detector.endSource(0);
+    detector.beginSource(1, "/nonexistent/app.log");
+    for (int i = 0; i < 100; ++i) {
+        flexRecord(detector, 1, base - 3600, "app[1]: retry");
+    }
+    detector.endSource(1);
+    FLEX_CHECK(detector.bursts().empty());
+}
@@ -0,0 +1,109 @@
+#include "flex_test.h"
+#include "flex_log_collector.h"
+
+#include <fstream>
+#include <iterator>
+#include <unistd.h>
+
+using namespace FlexTools;
+
+namespace {
+
+std::string flexTempLog(size_t lines) {
+    char name[] = "/tmp/flextest.XXXXXX";
+    int fd = mkstemp(name);
+    if (fd >= 0) close(fd);
+    std::ofstream out(name);
+    for (size_t i = 0; i < lines; ++i) {
+        out << "Oct 17 14:02:03 host app[" << i << "]: " << (i % 10 == 0 ? "error: disk failure" : "all good")
+            << " padding padding padding padding padding\n";
+    }
+    return name;
+}
+
+// 收到第一行时把文件截成 0 字节, 模拟 logrotate 的 copytruncate
+class FlexTruncatingStage : public FlexLogStage {
+public:
+    explicit FlexTruncatingStage(std::string path) : flexPath(std::move(path)) {}
+    void consume(const FlexLogLine& line) override {
+        (void)line;
+        if (lines++ == 0) {
+            FLEX_CHECK(truncate(flexPath.c_str(), 0) == 0);
+        }
+    }
+    uint64_t lines = 0;
+
+private:
+    std::string flexPath;
+};
+
+class FlexCountingStage : public FlexLogStage {
+public:
+    void consume(const FlexLogLine& line) override {
+        ++lines;
+        errors += line.level == FlexLogLevel::ERROR ? 1 : 0;
+    }
+    uint64_t lines = 0;
+    uint64_t errors = 0;
+};
+
+} // namespace
+
+FLEX_TEST(logCollectorCountsLines) {
+    std::string path = flexTempLog(1000);
+    FlexLogCollector collector("/nonexistent");
+    FlexCountingStage stage;
+    collector.addStage(&stage);
+    uint64_t end = collector.collectFile(path);
+    FLEX_CHECK_EQ(stage.lines, uint64_t(1000));
+    FLEX_CHECK_EQ(stage.errors, uint64_t(100));
+    FLEX_CHECK_EQ(collector.totalLines(), uint64_t(1000));
+    
+    // 从上次的偏移继续时没有新行
+    FlexCountingStage again;
+    FlexLogCollector resumed("/nonexistent");
+    resumed.addStage(&again);
+    FLEX_CHECK_EQ(resumed.collectFile(path, end), end);
+    FLEX_CHECK_EQ(again.lines, uint64_t(0));
+    unlink(path.c_str());
+}
+
+FLEX_TEST(logCollectorSurvivesTruncation) {
+    // 远大于一次读取的块, 截短发生在扫描中途
+    std::string path = flexTempLog(200000);
+    FlexLogCollector collector("/nonexistent");
+    FlexTruncatingStage stage(path);
+    collector.addStage(&stage);
+    collector.collectFile(path);
+    FLEX_CHECK(stage.lines > 0);
+    FLEX_CHECK(stage.lines < 200000);
+    unlink(path.c_str());
+}
+
+FLEX_TEST(logCollectorReportsBrokenArchives) {
+    // 完好的 .gz 与截去后半部分的副本
+    std::string good = std::string(FLEX_TEST_FIXTURES) + "/app.log.2.gz";
+    std::ifstream in(good, std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    FLEX_CHECK(bytes.size() > 100);
+    char name[] = "/tmp/flextest.XXXXXX";
+    int fd = mkstemp(name);
+    FLEX_CHECK(fd >= 0);
+    if (fd < 0) return;
+    close(fd);
+    std::string truncated = std::string(name) + ".gz";
+    std::ofstream(truncated, std::ios::binary) << bytes.substr(0, bytes.size() / 2);
+    
+    FlexLogCollector collector("/nonexistent");
+    FlexCountingStage stage;
+    collector.addStage(&stage);
+    collector.collectRotated({good, truncated, "/nonexistent/app.log.3.gz"}, 2);
+    FLEX_CHECK(stage.lines >= 400);
+    FLEX_CHECK_EQ(collector.errors().size(), size_t(2));
+    if (collector.errors().size() == 2) {
+        FLEX_CHECK_EQ(collector.errors()[0].compare(0, truncated.size(), truncated), 0);
+        FLEX_CHECK(collector.errors()[1].find("/nonexistent/app.log.3.gz") == 0);
+    }
+    unlink(truncated.c_str());
+    unlink(name);
+}
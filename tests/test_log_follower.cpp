@@ -0,0 +1,112 @@
+#include "flex_test.h"
+#include "flex_log_follower.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace FlexTools;
+
+namespace {
+
+class FlexCapturingStage : public FlexLogStage {
+public:
+    void consume(const FlexLogLine& line) override {
+        lines.emplace_back(line.text);
+    }
+    std::vector<std::string> lines;
+};
+
+// 目录与其中的日志文件; 跟随器监视所在目录以发现轮转
+struct FlexFollowDir {
+    std::string dir;
+    std::string path;
+    FlexFollowDir() {
+        char name[] = "/tmp/flextest.XXXXXX";
+        dir = mkdtemp(name) != nullptr ? name : "/tmp";
+        std::string file = dir + "/app.log.XXXXXX";
+        int fd = mkstemp(&file[0]);
+        if (fd >= 0) close(fd);
+        path = file;
+    }
+    ~FlexFollowDir() {
+        unlink(path.c_str());
+        unlink((path + ".1").c_str());
+        rmdir(dir.c_str());
+    }
+};
+
+void flexWriteLines(int fd, std::vector<std::string>& written, int from, int to) {
+    for (int i = from; i < to; ++i) {
+        std::string line = "line " + std::to_string(i) + " of the test log";
+        written.push_back(line);
+        line.push_back('\n');
+        FLEX_CHECK_EQ(write(fd, line.data(), line.size()), static_cast<ssize_t>(line.size()));
+    }
+}
+
+// 处理到事件队列空闲为止
+void flexSettle(FlexLogFollower& follower) {
+    for (int i = 0; i < 5; ++i) {
+        follower.processEvents(50);
+    }
+}
+
+} // namespace
+
+FLEX_TEST(logFollowerHandlesRenameRotation) {
+    FlexFollowDir files;
+    FlexLogCollector collector("/nonexistent");
+    FlexCapturingStage stage;
+    collector.addStage(&stage);
+    FlexLogFollower follower(collector);
+    FLEX_CHECK(follower.isOpen());
+    FLEX_CHECK(follower.addFile(files.path));
+    
+    std::vector<std::string> written;
+    int fd = open(files.path.c_str(), O_WRONLY | O_APPEND);
+    flexWriteLines(fd, written, 0, 100);
+    flexSettle(follower);
+    
+    // logrotate 改名并新建文件, 写入方重新打开前仍往旧 inode 写
+    FLEX_CHECK(rename(files.path.c_str(), (files.path + ".1").c_str()) == 0);
+    flexWriteLines(fd, written, 100, 150);
+    flexSettle(follower);
+    int fresh = open(files.path.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+    flexWriteLines(fd, written, 150, 160);
+    close(fd);
+    flexWriteLines(fresh, written, 160, 300);
+    flexSettle(follower);
+    close(fresh);
+    
+    FLEX_CHECK_EQ(stage.lines.size(), written.size());
+    FLEX_CHECK(stage.lines == written);
+}
+
+FLEX_TEST(logFollowerHandlesCopyTruncate) {
+    FlexFollowDir files;
+    FlexLogCollector collector("/nonexistent");
+    FlexCapturingStage stage;
+    collector.addStage(&stage);
+    FlexLogFollower follower(collector);
+    FLEX_CHECK(follower.addFile(files.path));
+    
+    std::vector<std::string> written;
+    int fd = open(files.path.c_str(), O_WRONLY | O_APPEND);
+    flexWriteLines(fd, written, 0, 100);
+    flexSettle(follower);
+    
+    // copytruncate 后追加得比原来短
+    FLEX_CHECK(ftruncate(fd, 0) == 0);
+    flexSettle(follower);
+    flexWriteLines(fd, written, 100, 120);
+    flexSettle(follower);
+    
+    // 截断后在跟随器看到之前就追加得比原来长
+    FLEX_CHECK(ftruncate(fd, 0) == 0);
+    flexWriteLines(fd, written, 1000, 1300);
+    flexSettle(follower);
+    close(fd);
+    
+    FLEX_CHECK_EQ(stage.lines.size(), written.size());
+    FLEX_CHECK(stage.lines == written);
+}
@@ -0,0 +1,100 @@
+#include "flex_test.h"
+#include "flex_log_search.h"
+
+#include <random>
+
+using namespace FlexTools;
+
+namespace {
+
+// 字面量提取只是预过滤: 任何模式的命中数都必须与逐行 std::regex_search 一致
+const std::vector<std::string> flexPatterns = {
+    "foo(?=bar)",
+    "(?!error)warn\\w+",
+    "(?=.*disk)fail",
+    "foo(?!bar)baz",
+    "path\\\\to",
+    "(abc)x\\1",
+    "(\\w+) \\1 again",
+    "ab{2}cde",
+    "x(yz){2}end",
+    "(err){0}ok",
+    "lo{0}ng",
+    "(?i)kernel panic",
+    "(?i)OOM(?=-killer)",
+    "timeout|refused conn",
+    "(eth0|wlan0) down",
+    "start.*?stop",
+    "(?:disk|ssd) error",
+};
+
+const std::vector<std::string> flexTokens = {
+    "foo", "bar", "baz", "warn", "warning", "error", "disk", "ssd", "fail", "path\\to", "path/to",
+    "abc", "x", "abbcde", "abcde", "yzyzend", "yzend", "ok", "lng", "long", "Kernel PANIC", "oom-killer",
+    "OOM", "eth0 down", "WLAN0 down", "wlan0", "timeout", "refused conn", "start", "stop", "again", "word",
+    " ", " ", " "};
+
+std::vector<std::string> flexLines() {
+    std::vector<std::string> lines = {
+        "foobar", "foobaz", "warning: disk almost full", "error warned", "disk fail", "fail disk",
+        "c:\\path\\to\\file", "abcxabc", "word word again", "abbcde", "xyzyzend", "ok", "lng",
+        "KERNEL Panic - not syncing", "Out of memory: OOM-killer", "OOM", "eth0 down", "start then stop",
+        "ssd error", "", "x"};
+    std::mt19937 random(42);
+    for (int i = 0; i < 3000; ++i) {
+        std::string line;
+        size_t count = 1 + random() % 6;
+        for (size_t k = 0; k < count; ++k) {
+            line += flexTokens[random() % flexTokens.size()];
+        }
+        lines.push_back(std::move(line));
+    }
+    return lines;
+}
+
+} // namespace
+
+FLEX_TEST(logSearchMatchesRegexSearch) {
+    auto lines = flexLines();
+    FlexLogSearch search(1);
+    for (const auto& pattern : flexPatterns) {
+        FLEX_CHECK(search.addPattern(pattern, pattern));
+    }
+    
+    search.beginSource(0, "test");
+    uint64_t offset = 0;
+    for (const auto& line : lines) {
+        search.consume(FlexLogLine{line, FlexLogLevel::INFO, offset, 0});
+        offset += line.size() + 1;
+    }
+    search.endSource(0);
+    
+    const auto& results = search.results();
+    FLEX_CHECK_EQ(results.size(), flexPatterns.size());
+    for (size_t i = 0; i < results.size() && i < flexPatterns.size(); ++i) {
+        std::string body = flexPatterns[i];
+        auto flags = std::regex::ECMAScript;
+        if (body.compare(0, 4, "(?i)") == 0) {
+            body.erase(0, 4);
+            flags |= std::regex::icase;
+        }
+        std::regex regex(body, flags);
+        uint64_t expected = 0;
+        for (const auto& line : lines) {
+            expected += std::regex_search(line, regex) ? 1 : 0;
+        }
+        if (results[i].hits != expected) {
+            ::FlexTools::Test::fail(__FILE__, __LINE__,
+                                    flexPatterns[i] + ": " + std::to_string(results[i].hits) +
+                                        " hits, std::regex_search " + std::to_string(expected));
+        }
+    }
+}
+
+FLEX_TEST(logSearchRejectsBadPatterns) {
+    FlexLogSearch search;
+    std::string error;
+    FLEX_CHECK(!search.addPattern("bad", "(unclosed", &error));
+    FLEX_CHECK(!error.empty());
+    FLEX_CHECK(!search.addPattern("empty", "(?i)", &error));
+}
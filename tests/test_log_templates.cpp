@@ -0,0 +1,70 @@
+#include "flex_test.h"
+#include "flex_log_templates.h"
+
+using namespace FlexTools;
+
+namespace {
+
+void flexFeed(FlexLogTemplateMiner& miner, uint32_t source, const std::vector<std::string>& lines) {
+    miner.beginSource(source, "/nonexistent/source" + std::to_string(source));
+    uint64_t offset = 0;
+    for (const auto& line : lines) {
+        miner.consume(FlexLogLine{line, FlexLogLevel::INFO, offset, source});
+        offset += line.size() + 1;
+    }
+    miner.endSource(source);
+}
+
+} // namespace
+
+FLEX_TEST(templateMinerMergesParameters) {
+    FlexLogTemplateMiner miner;
+    flexFeed(miner, 0, {
+        "2026-10-17T10:00:00Z sshd[100]: Accepted publickey for alice from 10.0.0.1 port 5000",
+        "2026-10-17T10:00:01Z sshd[101]: Accepted publickey for bob from 10.0.0.2 port 5001",
+        "2026-10-17T10:00:02Z kernel: eth0 link up",
+    });
+    auto templates = miner.templates();
+    FLEX_CHECK_EQ(templates.size(), size_t(2));
+    if (templates.size() == 2) {
+        FLEX_CHECK_EQ(templates[0].text, std::string("sshd[<*>]: Accepted publickey for <*> from <*> port <*>"));
+        FLEX_CHECK_EQ(templates[0].count, uint64_t(2));
+    }
+}
+
+FLEX_TEST(templateMinerKeepsTimeBounds) {
+    // 第二个源 (如较早的轮转代次) 的时间早于第一个源
+    FlexLogTemplateMiner miner;
+    flexFeed(miner, 0, {
+        "2026-10-17T10:00:00Z app: job 1 done",
+        "2026-10-17T12:00:00Z app: job 2 done",
+    });
+    flexFeed(miner, 1, {
+        "app: job 3 done",                       // 新源开头没有时间戳, 不影响范围
+        "2026-10-16T08:00:00Z app: job 4 done",
+        "2026-10-17T11:00:00Z app: job 5 done",
+    });
+    auto templates = miner.templates();
+    FLEX_CHECK_EQ(templates.size(), size_t(1));
+    if (templates.size() == 1) {
+        FLEX_CHECK_EQ(templates[0].count, uint64_t(5));
+        FLEX_CHECK_EQ(templates[0].first, int64_t(1792137600)); // 2026-10-16T08:00:00Z
+        FLEX_CHECK_EQ(templates[0].last, int64_t(1792238400));  // 2026-10-17T12:00:00Z
+    }
+}
+
+FLEX_TEST(templateMinerUsesRecordTime) {
+    // journal 记录的文本不以时间戳开头, 时间由收集器填入
+    FlexLogTemplateMiner miner;
+    miner.beginSource(0, "/nonexistent/system.journal");
+    miner.consume(FlexLogLine{"2026 plans: job 1 done", FlexLogLevel::INFO, 0, 0, 1792238400});
+    miner.consume(FlexLogLine{"2026 plans: job 2 done", FlexLogLevel::INFO, 0, 0, 1792137600});
+    miner.endSource(0);
+    auto templates = miner.templates();
+    FLEX_CHECK_EQ(templates.size(), size_t(1));
+    if (templates.size() == 1) {
+        FLEX_CHECK_EQ(templates[0].text, std::string("<*> plans: job <*> done"));
+        FLEX_CHECK_EQ(templates[0].first, int64_t(1792137600));
+        FLEX_CHECK_EQ(templates[0].last, int64_t(1792238400));
+    }
+}
@@ -0,0 +1,115 @@
+#include "flex_test.h"
+#include "flex_log_time_index.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <unistd.h>
+
+using namespace FlexTools;
+
+namespace {
+
+// 每行间隔 10 秒, 行长约 64 字节; 返回第 i 行的时间
+constexpr time_t flexBase = 1700000000;
+constexpr int flexLineCount = 2000;
+
+std::string flexWriteLog(const std::string& dir) {
+    std::string path = dir + "/app.log";
+    std::ofstream out(path);
+    for (int i = 0; i < flexLineCount; ++i) {
+        time_t when = flexBase + i * 10;
+        struct tm utc;
+        gmtime_r(&when, &utc);
+        char stamp[32];
+        strftime(stamp, sizeof(stamp), "%Y-%m-%dT%H:%M:%SZ", &utc);
+        out << stamp << " host app[42]: request " << i << " handled in 3 ms\n";
+    }
+    return path;
+}
+
+struct FlexTempDir {
+    std::string path;
+    FlexTempDir() {
+        char name[] = "/tmp/flextest.XXXXXX";
+        path = mkdtemp(name) != nullptr ? name : "/tmp";
+    }
+    ~FlexTempDir() {
+        unlink((path + "/app.log").c_str());
+        unlink((path + "/app.idx").c_str());
+        rmdir(path.c_str());
+    }
+};
+
+} // namespace
+
+FLEX_TEST(timeParserFormats) {
+    FlexLogTimeParser parser(flexBase);
+    time_t value = 0;
+    FLEX_CHECK(parser.parse("2023-11-14T22:13:20Z sshd[1]: x", value));
+    FLEX_CHECK_EQ(value, flexBase);
+    FLEX_CHECK(parser.parse("2023-11-14T23:13:20.125+01:00 x", value));
+    FLEX_CHECK_EQ(value, flexBase);
+    FLEX_CHECK(!parser.parse("not a timestamp", value));
+}
+
+FLEX_TEST(timeParserFollowsDaylightSaving) {
+    // POSIX 规则串不依赖 tzdata: 中欧时间, 三月最后一个周日进入夏令时
+    const char* saved = getenv("TZ");
+    std::string previous = saved != nullptr ? saved : "";
+    setenv("TZ", "CET-1CEST,M3.5.0,M10.5.0/3", 1);
+    tzset();
+    
+    FlexLogTimeParser parser(1790000000); // 2026-09
+    time_t winter = 0, summer = 0, syslog = 0;
+    FLEX_CHECK(parser.parse("2026-03-28 12:00:00 x", winter));
+    FLEX_CHECK(parser.parse("2026-03-30T12:00:00 x", summer));
+    FLEX_CHECK(parser.parse("Mar 30 12:00:00 host x", syslog));
+    FLEX_CHECK_EQ(winter, time_t(1774695600)); // 11:00Z
+    FLEX_CHECK_EQ(summer, time_t(1774864800)); // 10:00Z
+    FLEX_CHECK_EQ(syslog, summer);
+    
+    if (saved != nullptr) {
+        setenv("TZ", previous.c_str(), 1);
+    } else {
+        unsetenv("TZ");
+    }
+    tzset();
+}
+
+FLEX_TEST(timeIndexLocatesRanges) {
+    FlexTempDir dir;
+    FlexLogTimeIndex index(flexWriteLog(dir.path), dir.path + "/app.idx", 4096);
+    FLEX_CHECK(index.update());
+    FLEX_CHECK(index.samples().size() > 10);
+    
+    uint64_t begin = 0, end = 0;
+    time_t from = flexBase + 1000 * 10;
+    time_t to = flexBase + 1100 * 10;
+    FLEX_CHECK(index.locate(from, to, begin, end));
+    FLEX_CHECK(begin > 0);
+    FLEX_CHECK(end < index.indexedSize());
+    
+    // 只给起点: 终点为 time_t 最大值, 放宽时不能溢出成负数
+    FLEX_CHECK(index.locate(from, std::numeric_limits<time_t>::max(), begin, end));
+    FLEX_CHECK(begin > 0);
+    FLEX_CHECK_EQ(end, index.indexedSize());
+    
+    // 只给终点: 起点为 0 或 time_t 最小值
+    FLEX_CHECK(index.locate(0, to, begin, end));
+    FLEX_CHECK_EQ(begin, uint64_t(0));
+    FLEX_CHECK(end < index.indexedSize());
+    FLEX_CHECK(index.locate(std::numeric_limits<time_t>::min(), to, begin, end));
+    FLEX_CHECK_EQ(begin, uint64_t(0));
+    FLEX_CHECK(end < index.indexedSize());
+    
+    // 早于第一行
+    FLEX_CHECK(!index.locate(std::numeric_limits<time_t>::min(), flexBase - 3600, begin, end));
+    FLEX_CHECK(!index.locate(5, 4, begin, end));
+    
+    // 旁路索引可被重新载入
+    FlexLogTimeIndex reloaded(dir.path + "/app.log", dir.path + "/app.idx", 4096);
+    FLEX_CHECK(reloaded.update());
+    FLEX_CHECK_EQ(reloaded.samples().size(), index.samples().size());
+}
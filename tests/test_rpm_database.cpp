@@ -0,0 +1,81 @@
+#include "flex_test.h"
+#include "flex_rpm_database.h"
+
+#include <algorithm>
+
+using namespace FlexTools;
+
+#ifdef FLEX_HAVE_SQLITE3
+
+namespace {
+
+// 由 tests/fixtures/make_rpmdb.py 生成
+const std::string flexFixture = std::string(FLEX_TEST_FIXTURES) + "/rpmdb.sqlite";
+
+const FlexPackage* flexFind(const std::vector<FlexPackage>& packages, const std::string& name) {
+    auto it = std::find_if(packages.begin(), packages.end(),
+                           [&](const FlexPackage& package) { return package.name == name; });
+    return it == packages.end() ? nullptr : &*it;
+}
+
+} // namespace
+
+FLEX_TEST(rpmDatabaseReadsPackages) {
+    FlexRPMDatabase db(flexFixture);
+    FLEX_CHECK(db.isAvailable());
+    
+    std::vector<FlexPackage> packages;
+    FLEX_CHECK(db.readPackages(packages));
+    // gpg-pubkey 不是真正的包
+    FLEX_CHECK_EQ(packages.size(), size_t(2));
+    
+    const FlexPackage* alpha = flexFind(packages, "alpha");
+    FLEX_CHECK(alpha != nullptr);
+    if (alpha != nullptr) {
+        FLEX_CHECK_EQ(alpha->version, std::string("1.2-3"));
+        FLEX_CHECK_EQ(alpha->architecture, std::string("x86_64"));
+        FLEX_CHECK_EQ(alpha->description, std::string("Alpha test package"));
+        FLEX_CHECK_EQ(alpha->section, std::string("Testing"));
+        FLEX_CHECK_EQ(alpha->size, size_t(4096));
+        FLEX_CHECK_EQ(alpha->provides, (std::vector<std::string>{"alpha (= 1.2-3)", "libalpha.so.1()(64bit)"}));
+    }
+    
+    const FlexPackage* beta = flexFind(packages, "beta");
+    FLEX_CHECK(beta != nullptr);
+    if (beta != nullptr) {
+        FLEX_CHECK_EQ(beta->version, std::string("2:0.9-1.el9"));
+        FLEX_CHECK_EQ(beta->architecture, std::string("noarch"));
+        // rpmlib(...) 依赖被过滤
+        FLEX_CHECK_EQ(beta->dependencies, (std::vector<std::string>{"alpha (>= 1.0)", "/bin/sh"}));
+    }
+}
+
+FLEX_TEST(rpmDatabaseReadsFileLists) {
+    FlexRPMDatabase db(flexFixture);
+    std::vector<std::string> files;
+    
+    FLEX_CHECK(db.readFiles("alpha", files));
+    FLEX_CHECK_EQ(files, (std::vector<std::string>{"/usr/bin/alpha", "/usr/lib64/libalpha.so.1",
+                                                   "/usr/share/doc/alpha/README",
+                                                   "/usr/share/doc/alpha/COPYING"}));
+    
+    // 旧格式: OLDFILENAMES
+    files.clear();
+    FLEX_CHECK(db.readFiles("beta", files));
+    FLEX_CHECK_EQ(files, (std::vector<std::string>{"/etc/beta.conf", "/usr/bin/beta"}));
+    
+    files.clear();
+    FLEX_CHECK(!db.readFiles("gpg-pubkey", files));
+    FLEX_CHECK(!db.readFiles("missing", files));
+}
+
+#endif // FLEX_HAVE_SQLITE3
+
+FLEX_TEST(rpmDatabaseRejectsTruncatedHeaders) {
+    // il=1, dl=100 但数据不足
+    const unsigned char blob[] = {0, 0, 0, 1, 0, 0, 0, 100, 0, 0, 3, 232, 0, 0, 0, 6, 0, 0, 0, 0, 0, 0, 0, 1};
+    FlexPackage package;
+    std::vector<std::string> files;
+    FLEX_CHECK(!flexDecodeRPMHeader(blob, sizeof(blob), package));
+    FLEX_CHECK(!flexDecodeRPMFiles(blob, sizeof(blob), files));
+}